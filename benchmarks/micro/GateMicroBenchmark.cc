@@ -0,0 +1,269 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+/*
+ *	\file GateMicroBenchmark.cc
+ *	\brief Component level benchmarks:
+ *	- 'GateMicroBenchmark' runs all the benchmarks
+ *	- 'GateMicroBenchmark --scale 0.1' runs 10 times less iterations
+ *	- 'GateMicroBenchmark --only dose,image' runs the selected benchmarks
+ *	- 'GateMicroBenchmark --output results.csv' also writes the report in a file
+ */
+
+#include "GateMicroBenchmark.hh"
+
+#include <getopt.h>
+#include <cstdlib>
+#include <fstream>
+
+#include "G4UImanager.hh"
+#include "GateRunManager.hh"
+#include "GateMessageManager.hh"
+#include "GateSteppingVerbose.hh"
+#include "GateRandomEngine.hh"
+#include "GateApplicationMgr.hh"
+#include "GateSourceMgr.hh"
+#include "GateDetectorConstruction.hh"
+#include "GatePhysicsList.hh"
+#include "GateConfiguration.h"
+#include "GateOutputMgr.hh"
+#include "GatePrimaryGeneratorAction.hh"
+#include "GateUserActions.hh"
+#include "GateDigitizer.hh"
+#include "GatePulseProcessorChain.hh"
+#include "GateClock.hh"
+
+//-----------------------------------------------------------------------------
+// Geometry, actor and digitizer used by the benchmarks: a small
+// cylindricalPET (60 rsectors x 4 modules x 8x8 crystals) around a water
+// box with a 100x100x100 dose actor.
+static const char * gSetupCommands[] = {
+  "/gate/random/setEngineName MersenneTwister",
+  "/gate/random/setEngineSeed 123456",
+  "/gate/world/geometry/setXLength 2 m",
+  "/gate/world/geometry/setYLength 2 m",
+  "/gate/world/geometry/setZLength 2 m",
+  "/gate/world/setMaterial G4_AIR",
+  "/gate/world/daughters/name cylindricalPET",
+  "/gate/world/daughters/insert cylinder",
+  "/gate/cylindricalPET/geometry/setRmax 45 cm",
+  "/gate/cylindricalPET/geometry/setRmin 35 cm",
+  "/gate/cylindricalPET/geometry/setHeight 20 cm",
+  "/gate/cylindricalPET/setMaterial G4_AIR",
+  "/gate/cylindricalPET/daughters/name rsector",
+  "/gate/cylindricalPET/daughters/insert box",
+  "/gate/rsector/placement/setTranslation 40 0 0 cm",
+  "/gate/rsector/geometry/setXLength 2 cm",
+  "/gate/rsector/geometry/setYLength 4 cm",
+  "/gate/rsector/geometry/setZLength 16 cm",
+  "/gate/rsector/setMaterial G4_AIR",
+  "/gate/rsector/daughters/name module",
+  "/gate/rsector/daughters/insert box",
+  "/gate/module/geometry/setXLength 2 cm",
+  "/gate/module/geometry/setYLength 4 cm",
+  "/gate/module/geometry/setZLength 4 cm",
+  "/gate/module/setMaterial G4_AIR",
+  "/gate/module/daughters/name crystal",
+  "/gate/module/daughters/insert box",
+  "/gate/crystal/geometry/setXLength 2 cm",
+  "/gate/crystal/geometry/setYLength 5 mm",
+  "/gate/crystal/geometry/setZLength 5 mm",
+  "/gate/crystal/setMaterial G4_BGO",
+  "/gate/crystal/repeaters/insert cubicArray",
+  "/gate/crystal/cubicArray/setRepeatNumberX 1",
+  "/gate/crystal/cubicArray/setRepeatNumberY 8",
+  "/gate/crystal/cubicArray/setRepeatNumberZ 8",
+  "/gate/crystal/cubicArray/setRepeatVector 0 5 5 mm",
+  "/gate/module/repeaters/insert cubicArray",
+  "/gate/module/cubicArray/setRepeatNumberX 1",
+  "/gate/module/cubicArray/setRepeatNumberY 1",
+  "/gate/module/cubicArray/setRepeatNumberZ 4",
+  "/gate/module/cubicArray/setRepeatVector 0 0 4 cm",
+  "/gate/rsector/repeaters/insert ring",
+  "/gate/rsector/ring/setRepeatNumber 60",
+  "/gate/systems/cylindricalPET/rsector/attach rsector",
+  "/gate/systems/cylindricalPET/module/attach module",
+  "/gate/systems/cylindricalPET/crystal/attach crystal",
+  "/gate/crystal/attachCrystalSD",
+  "/gate/world/daughters/name phantom",
+  "/gate/world/daughters/insert box",
+  "/gate/phantom/geometry/setXLength 20 cm",
+  "/gate/phantom/geometry/setYLength 20 cm",
+  "/gate/phantom/geometry/setZLength 20 cm",
+  "/gate/phantom/setMaterial G4_WATER",
+  "/gate/physics/addPhysicsList emstandard_opt3",
+  "/gate/actor/addActor DoseActor dose",
+  "/gate/actor/dose/save micro-benchmark-dose.mhd",
+  "/gate/actor/dose/attachTo phantom",
+  "/gate/actor/dose/setResolution 100 100 100",
+  "/gate/actor/dose/enableEdep true",
+  "/gate/actor/dose/enableUncertaintyEdep true",
+  "/gate/actor/dose/enableDose true",
+  "/gate/actor/dose/enableNumberOfHits false",
+  "/gate/digitizer/Singles/insert adder",
+  "/gate/digitizer/Singles/insert readout",
+  "/gate/digitizer/Singles/readout/setDepth 1",
+  "/gate/digitizer/Singles/insert blurring",
+  "/gate/digitizer/Singles/blurring/setResolution 0.26",
+  "/gate/digitizer/Singles/blurring/setEnergyOfReference 511. keV",
+  "/gate/digitizer/Singles/insert thresholder",
+  "/gate/digitizer/Singles/thresholder/setThreshold 350. keV",
+  "/gate/digitizer/Singles/insert upholder",
+  "/gate/digitizer/Singles/upholder/setUphold 650. keV",
+  "/gate/digitizer/Coincidences/setWindow 10. ns",
+  "/gate/run/initialize",
+  0
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+struct GateMicroBenchmarkEntry {
+  const char * name;
+  void (*function)(GateMicroBenchmarkReport &, double);
+};
+
+static const GateMicroBenchmarkEntry gBenchmarks[] = {
+  { "dose",         BenchmarkDoseActor },
+  { "pulses",       BenchmarkPulseProcessorChain },
+  { "coincidences", BenchmarkCoincidenceSorter },
+  { "voxelreader",  BenchmarkSourceVoxelReader },
+  { "image",        BenchmarkImageIO },
+  { 0, 0 }
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateMicroBenchmarkReport::Add(const G4String & name, const G4String & unit,
+                                   double items, double seconds)
+{
+  Result r;
+  r.name = name;
+  r.unit = unit;
+  r.items = items;
+  r.seconds = seconds;
+  mResults.push_back(r);
+  GateMessage("Core", 0, "Benchmark " << name << ": " << items/seconds << " " << unit << "/s" << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateMicroBenchmarkReport::Write(std::ostream & os) const
+{
+  os << "benchmark,unit,items,seconds,items_per_second" << std::endl;
+  for(unsigned int i=0; i<mResults.size(); i++) {
+    const Result & r = mResults[i];
+    os << r.name << "," << r.unit << "," << r.items << "," << r.seconds << ","
+       << (r.seconds > 0 ? r.items/r.seconds : 0.0) << std::endl;
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void printHelpAndQuit(const G4String & msg)
+{
+  GateMessage("Core", 0, msg << Gateendl);
+  GateMessage("Core", 0, "Usage: GateMicroBenchmark [OPTION]..." << Gateendl);
+  GateMessage("Core", 0, "  -h, --help             print the help" << Gateendl);
+  GateMessage("Core", 0, "  -s, --scale X          multiply the number of iterations by X (default 1)" << Gateendl);
+  GateMessage("Core", 0, "  -o, --output FILE      write the CSV report in FILE" << Gateendl);
+  GateMessage("Core", 0, "  -b, --only LIST        comma separated list of benchmarks among" << Gateendl);
+  GateMessage("Core", 0, "                         dose,pulses,coincidences,voxelreader,image" << Gateendl);
+  exit(EXIT_FAILURE);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  double scale = 1.0;
+  G4String outputFilename = "";
+  G4String selection = "";
+
+  static struct option longOptions[] = {
+    { "help",   no_argument,       0, 'h' },
+    { "scale",  required_argument, 0, 's' },
+    { "output", required_argument, 0, 'o' },
+    { "only",   required_argument, 0, 'b' },
+    { 0, 0, 0, 0 }
+  };
+  int c;
+  while ((c = getopt_long(argc, argv, "hs:o:b:", longOptions, 0)) != -1) {
+    switch (c) {
+    case 's': scale = atof(optarg); break;
+    case 'o': outputFilename = optarg; break;
+    case 'b': selection = optarg; break;
+    case 'h': printHelpAndQuit("GateMicroBenchmark command line help"); break;
+    default: printHelpAndQuit("Unknown option"); break;
+    }
+  }
+  if (scale <= 0) printHelpAndQuit("The scale must be positive");
+
+  GateMessageManager* theGateMessageManager = GateMessageManager::GetInstance();
+  G4UImanager::GetUIpointer()->SetCoutDestination(theGateMessageManager);
+
+  GateSteppingVerbose* verbosity = new GateSteppingVerbose;
+  G4VSteppingVerbose::SetInstance(verbosity);
+  GateRandomEngine::GetInstance();
+
+  // Same initialisation as Gate.cc
+  GateRunManager* runManager = new GateRunManager;
+  runManager->SetUserInitialization(new GateDetectorConstruction());
+  runManager->SetUserInitialization(GatePhysicsList::GetInstance());
+  new GateUserActions(runManager, 0);
+  runManager->InitializeAll();
+  runManager->SetUserAction(new GatePrimaryGeneratorAction());
+#ifdef G4ANALYSIS_USE_GENERAL
+  GateOutputMgr::GetInstance();
+  GateDigitizer* digitizer = GateDigitizer::GetInstance();
+  GatePulseProcessorChain* singleChain = new GatePulseProcessorChain(digitizer, "Singles");
+  digitizer->StoreNewPulseProcessorChain(singleChain);
+#endif
+  GateSourceMgr::GetInstance();
+  GateApplicationMgr::GetInstance();
+  GateClock::GetInstance()->SetTime(0);
+
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  for(int i=0; gSetupCommands[i] != 0; i++) {
+#ifndef G4ANALYSIS_USE_GENERAL
+    // no digitizer
+    if (G4String(gSetupCommands[i]).find("/gate/digitizer/") == 0) continue;
+#endif
+    if (UImanager->ApplyCommand(gSetupCommands[i]) != 0)
+      GateError("GateMicroBenchmark: the setup command '" << gSetupCommands[i] << "' failed.");
+  }
+
+  GateMicroBenchmarkReport report;
+  for(int i=0; gBenchmarks[i].name != 0; i++) {
+    G4String name = gBenchmarks[i].name;
+    if (selection != "" && (","+selection+",").find(","+name+",") == std::string::npos) continue;
+#ifndef G4ANALYSIS_USE_GENERAL
+    if (name == "pulses" || name == "coincidences") {
+      GateWarning("GateMicroBenchmark: Gate is compiled without the digitizer, '" << name << "' skipped.");
+      continue;
+    }
+#endif
+    GateMessage("Core", 0, "Running benchmark " << name << Gateendl);
+    gBenchmarks[i].function(report, scale);
+  }
+
+  report.Write(std::cout);
+  if (outputFilename != "") {
+    std::ofstream os(outputFilename.c_str());
+    if (!os) GateError("GateMicroBenchmark: cannot write the report in " << outputFilename);
+    report.Write(os);
+  }
+
+  delete verbosity;
+  return 0;
+}
+//-----------------------------------------------------------------------------
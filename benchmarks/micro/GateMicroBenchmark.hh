@@ -0,0 +1,78 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+/*
+  \file   GateMicroBenchmark.hh
+  \brief  Component level timings of the Gate hot paths, fed with
+          synthetic step/pulse/voxel streams (see readme.txt).
+
+  Each benchmark prepares its input outside of the timed section, then
+  reports the number of processed items and the elapsed time. The
+  report is written as CSV (one line per benchmark) so that the
+  throughput can be compared from one commit to another.
+*/
+
+#ifndef GATEMICROBENCHMARK_HH
+#define GATEMICROBENCHMARK_HH
+
+#include "globals.hh"
+#include <vector>
+#include <iostream>
+#include <sys/time.h>
+
+//-----------------------------------------------------------------------------
+class GateMicroBenchmarkTimer
+{
+ public:
+  GateMicroBenchmarkTimer() { Start(); }
+  void Start() { gettimeofday(&mStart, NULL); }
+  // Elapsed time in seconds since Start
+  double GetElapsed() const {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - mStart.tv_sec) + 1e-6*(now.tv_usec - mStart.tv_usec);
+  }
+ protected:
+  struct timeval mStart;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GateMicroBenchmarkReport
+{
+ public:
+  // Number of items (steps, pulses, samples, bytes ...) processed in
+  // the given time
+  void Add(const G4String & name, const G4String & unit, double items, double seconds);
+  void Write(std::ostream & os) const;
+
+ protected:
+  struct Result {
+    G4String name;
+    G4String unit;
+    double items;
+    double seconds;
+  };
+  std::vector<Result> mResults;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// The benchmarks. 'scale' multiplies the default number of iterations
+// (use a small value for a quick check). The actor and digitizer
+// benchmarks need the geometry built by GateMicroBenchmark.cc.
+void BenchmarkDoseActor(GateMicroBenchmarkReport & report, double scale);
+void BenchmarkPulseProcessorChain(GateMicroBenchmarkReport & report, double scale);
+void BenchmarkCoincidenceSorter(GateMicroBenchmarkReport & report, double scale);
+void BenchmarkSourceVoxelReader(GateMicroBenchmarkReport & report, double scale);
+void BenchmarkImageIO(GateMicroBenchmarkReport & report, double scale);
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEMICROBENCHMARK_HH */
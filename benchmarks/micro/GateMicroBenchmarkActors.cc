@@ -0,0 +1,85 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateMicroBenchmark.hh"
+#include "GateActorManager.hh"
+#include "GateDoseActor.hh"
+#include "GateMessageManager.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4Event.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Proton.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Steps of synthetic proton tracks crossing the 100x100x100 dose actor
+// along z, with a small lateral spread. Each event is one track.
+void BenchmarkDoseActor(GateMicroBenchmarkReport & report, double scale)
+{
+  GateDoseActor * actor = 0;
+  std::vector<GateVActor*> & actors = GateActorManager::GetInstance()->GetTheListOfActors();
+  for(unsigned int i=0; i<actors.size() && !actor; i++) actor = dynamic_cast<GateDoseActor*>(actors[i]);
+  if (!actor) GateError("BenchmarkDoseActor: no DoseActor found.");
+
+  const int resolution = 100;
+  const int nbOfEvents = std::max(1, (int)(20000*scale));
+  const int nbOfStepsPerEvent = resolution;
+
+  // The stream is built before timing
+  std::vector<int> indices(nbOfEvents*nbOfStepsPerEvent);
+  std::vector<double> edeps(indices.size());
+  std::vector<double> energies(indices.size());
+  for(int e=0; e<nbOfEvents; e++) {
+    double x = resolution*(0.25 + 0.5*G4UniformRand());
+    double y = resolution*(0.25 + 0.5*G4UniformRand());
+    double energy = 150*MeV;
+    for(int z=0; z<nbOfStepsPerEvent; z++) {
+      x += G4RandGauss::shoot(0, 0.2);
+      y += G4RandGauss::shoot(0, 0.2);
+      int ix = std::min(resolution-1, std::max(0, (int)x));
+      int iy = std::min(resolution-1, std::max(0, (int)y));
+      int i = e*nbOfStepsPerEvent + z;
+      indices[i] = ix + resolution*(iy + resolution*z);
+      edeps[i] = 0.5*MeV*(1.0 + G4UniformRand());
+      energies[i] = energy;
+      energy = std::max(1*MeV, energy - edeps[i]);
+    }
+  }
+
+  G4Material * water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
+  G4DynamicParticle * particle = new G4DynamicParticle(G4Proton::Definition(), G4ThreeVector(0,0,1), 150*MeV);
+  G4Track * track = new G4Track(particle, 0., G4ThreeVector());
+  track->SetWeight(1.0);
+  G4Step step;
+  step.SetTrack(track);
+  step.GetPreStepPoint()->SetMaterial(water);
+
+  GateMicroBenchmarkTimer timer;
+  int i = 0;
+  for(int e=0; e<nbOfEvents; e++) {
+    for(int s=0; s<nbOfStepsPerEvent; s++, i++) {
+      step.SetTotalEnergyDeposit(edeps[i]);
+      step.GetPreStepPoint()->SetKineticEnergy(energies[i]);
+      actor->UserSteppingActionInVoxel(indices[i], &step);
+    }
+    G4Event event(e);
+    actor->EndOfEventAction(&event);
+  }
+  double seconds = timer.GetElapsed();
+  report.Add("GateDoseActor::UserSteppingActionInVoxel", "steps", indices.size(), seconds);
+
+  actor->ResetData();
+  delete track;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,193 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateMicroBenchmark.hh"
+#include "GateDigitizer.hh"
+#include "GatePulseProcessorChain.hh"
+#include "GateCoincidenceSorter.hh"
+#include "GateDetectorConstruction.hh"
+#include "GateVSystem.hh"
+#include "GatePulse.hh"
+#include "GateHitConvertor.hh"
+#include "GateMessageManager.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include "CLHEP/Random/RandExponential.h"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+struct GateMicroBenchmarkCrystal {
+  GateVolumeID volumeID;
+  GateOutputVolumeID outputVolumeID;
+};
+
+struct GateMicroBenchmarkHit {
+  int eventID;
+  int crystal;
+  double energy;
+  double time;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Volume IDs of all the crystals of the cylindricalPET built by
+// GateMicroBenchmark.cc (world/cylindricalPET/rsector/module/crystal)
+static void BuildCrystalTable(GateVSystem * system, std::vector<GateMicroBenchmarkCrystal> & crystals)
+{
+  if (!system) GateError("BuildCrystalTable: no system attached to the digitizer.");
+  G4LogicalVolume * world = GateDetectorConstruction::GetGateDetectorConstruction()->GetWorldVolume()->GetLogicalVolume();
+  int scannerIndex = -1;
+  for(int i=0; i<world->GetNoDaughters(); i++)
+    if (world->GetDaughter(i)->GetName().find("cylindricalPET") == 0) scannerIndex = i;
+  if (scannerIndex < 0) GateError("BuildCrystalTable: cylindricalPET not found.");
+
+  crystals.clear();
+  G4LogicalVolume * scanner = world->GetDaughter(scannerIndex)->GetLogicalVolume();
+  for(int r=0; r<scanner->GetNoDaughters(); r++) {
+    G4LogicalVolume * rsector = scanner->GetDaughter(r)->GetLogicalVolume();
+    for(int m=0; m<rsector->GetNoDaughters(); m++) {
+      G4LogicalVolume * module = rsector->GetDaughter(m)->GetLogicalVolume();
+      for(int c=0; c<module->GetNoDaughters(); c++) {
+        G4int path[5] = { 0, scannerIndex, r, m, c };
+        GateMicroBenchmarkCrystal crystal;
+        crystal.volumeID = GateVolumeID(path, 5);
+        crystal.outputVolumeID = system->ComputeOutputVolumeID(crystal.volumeID);
+        crystals.push_back(crystal);
+      }
+    }
+  }
+  if (crystals.empty()) GateError("BuildCrystalTable: no crystal found.");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Back-to-back 511 keV photons, each one detected with a probability of
+// 0.7 and depositing its energy in 1 to maxInteractions interactions in
+// one crystal.
+// Events are separated by 200 ns on average.
+static void BuildHitStream(int nbOfEvents, int nbOfCrystals, int maxInteractions,
+                           std::vector<GateMicroBenchmarkHit> & hits)
+{
+  hits.clear();
+  double time = 0;
+  for(int e=0; e<nbOfEvents; e++) {
+    time += CLHEP::RandExponential::shoot(200*ns);
+    int crystal = (int)(G4UniformRand()*nbOfCrystals);
+    for(int photon=0; photon<2; photon++) {
+      if (G4UniformRand() > 0.7) continue;
+      if (photon == 1) crystal = (crystal + nbOfCrystals/2) % nbOfCrystals;
+      int nbOfInteractions = 1 + (int)(maxInteractions*G4UniformRand());
+      double energy = 511*keV;
+      for(int i=0; i<nbOfInteractions; i++) {
+        GateMicroBenchmarkHit hit;
+        hit.eventID = e;
+        hit.crystal = crystal;
+        hit.energy = (i == nbOfInteractions-1 ? energy : energy*G4UniformRand());
+        hit.time = time + 0.01*ns*i;
+        energy -= hit.energy;
+        hits.push_back(hit);
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+static GatePulse * CreatePulse(const GateMicroBenchmarkHit & hit,
+                               const std::vector<GateMicroBenchmarkCrystal> & crystals)
+{
+  GatePulse * pulse = new GatePulse();
+  pulse->SetRunID(0);
+  pulse->SetEventID(hit.eventID);
+  pulse->SetTime(hit.time);
+  pulse->SetEnergy(hit.energy);
+  pulse->SetVolumeID(crystals[hit.crystal].volumeID);
+  pulse->SetOutputVolumeID(crystals[hit.crystal].outputVolumeID);
+  return pulse;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Singles chain of GateMicroBenchmark.cc (adder, readout, blurring,
+// thresholder, upholder), one hit list per event as after the hit
+// conversion.
+void BenchmarkPulseProcessorChain(GateMicroBenchmarkReport & report, double scale)
+{
+  GateDigitizer * digitizer = GateDigitizer::GetInstance();
+  GatePulseProcessorChain * chain = digitizer->GetChain(0);
+  if (!chain) GateError("BenchmarkPulseProcessorChain: no Singles chain.");
+
+  std::vector<GateMicroBenchmarkCrystal> crystals;
+  BuildCrystalTable(chain->GetSystem(), crystals);
+  std::vector<GateMicroBenchmarkHit> hits;
+  const int nbOfEvents = std::max(1, (int)(500000*scale));
+  BuildHitStream(nbOfEvents, crystals.size(), 3, hits);
+
+  double nbOfSingles = 0;
+  GateMicroBenchmarkTimer timer;
+  unsigned int i = 0;
+  while (i < hits.size()) {
+    digitizer->ErasePulseListVector();
+    GatePulseList * pulseList = new GatePulseList(GateHitConvertor::GetOutputAlias());
+    int eventID = hits[i].eventID;
+    for(; i < hits.size() && hits[i].eventID == eventID; i++) pulseList->push_back(CreatePulse(hits[i], crystals));
+    digitizer->StorePulseList(pulseList);
+    digitizer->StorePulseListAlias(GateHitConvertor::GetOutputAlias(), pulseList);
+    GatePulseList * singles = chain->ProcessPulseList();
+    if (singles) nbOfSingles += singles->size();
+  }
+  digitizer->ErasePulseListVector();
+  double seconds = timer.GetElapsed();
+
+  report.Add("GatePulseProcessorChain::ProcessPulseList", "pulses", hits.size(), seconds);
+  GateMessage("Core", 1, "BenchmarkPulseProcessorChain: " << nbOfSingles << " singles for "
+              << hits.size() << " hits" << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Coincidence sorter of the cylindricalPET, fed with the singles of one
+// event at a time.
+void BenchmarkCoincidenceSorter(GateMicroBenchmarkReport & report, double scale)
+{
+  GateDigitizer * digitizer = GateDigitizer::GetInstance();
+  if (digitizer->GetCoinSorterList().empty()) GateError("BenchmarkCoincidenceSorter: no coincidence sorter.");
+  GateCoincidenceSorter * sorter = digitizer->GetCoinSorterList()[0];
+
+  std::vector<GateMicroBenchmarkCrystal> crystals;
+  BuildCrystalTable(sorter->GetSystem(), crystals);
+
+  // One interaction per photon: the hits are the singles
+  std::vector<GateMicroBenchmarkHit> singles;
+  const int nbOfEvents = std::max(1, (int)(1000000*scale));
+  BuildHitStream(nbOfEvents, crystals.size(), 1, singles);
+
+  GateMicroBenchmarkTimer timer;
+  unsigned int i = 0;
+  while (i < singles.size()) {
+    digitizer->ErasePulseListVector();
+    GatePulseList pulseList("Singles");
+    int eventID = singles[i].eventID;
+    for(; i < singles.size() && singles[i].eventID == eventID; i++) pulseList.push_back(CreatePulse(singles[i], crystals));
+    sorter->ProcessSinglePulseList(&pulseList);
+  }
+  digitizer->ErasePulseListVector();
+  double seconds = timer.GetElapsed();
+
+  report.Add("GateCoincidenceSorter::ProcessSinglePulseList", "singles", singles.size(), seconds);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,62 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateMicroBenchmark.hh"
+#include "GateImage.hh"
+#include "GateMessageManager.hh"
+
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cstdio>
+
+//-----------------------------------------------------------------------------
+// Write and read back a float image, as done by the image actors and
+// the voxelized volumes/sources. The throughput is in MB of voxel data.
+void BenchmarkImageIO(GateMicroBenchmarkReport & report, double scale)
+{
+  const int n = 128;
+  const int nbOfRepeats = std::max(1, (int)(10*scale));
+
+  GateImageFloat image;
+  image.SetResolutionAndVoxelSize(G4ThreeVector(n, n, n), G4ThreeVector(1, 1, 1));
+  image.Allocate();
+  // dose-like content: smooth with noise, zero outside a cylinder
+  for(int iz=0; iz<n; iz++)
+    for(int iy=0; iy<n; iy++)
+      for(int ix=0; ix<n; ix++) {
+        double x = ix-n/2, y = iy-n/2;
+        float v = 0;
+        if (x*x + y*y < n*n/4) v = (1.0 + iz/(double)n)*(0.9 + 0.2*G4UniformRand());
+        image.SetValue(ix, iy, iz, v);
+      }
+  double megabytes = nbOfRepeats*image.GetNumberOfValues()*sizeof(float)/(1024.0*1024.0);
+
+  GateMicroBenchmarkTimer timer;
+  for(int i=0; i<nbOfRepeats; i++) image.Write("micro-benchmark-image.mhd");
+  report.Add("GateImageT::Write(mhd)", "MB", megabytes, timer.GetElapsed());
+
+  GateImageFloat readImage;
+  timer.Start();
+  for(int i=0; i<nbOfRepeats; i++) readImage.Read("micro-benchmark-image.mhd");
+  report.Add("GateImageT::Read(mhd)", "MB", megabytes, timer.GetElapsed());
+
+  image.SetCompression(true);
+  timer.Start();
+  for(int i=0; i<nbOfRepeats; i++) image.Write("micro-benchmark-image.mha");
+  report.Add("GateImageT::Write(compressed mha)", "MB", megabytes, timer.GetElapsed());
+
+  timer.Start();
+  for(int i=0; i<nbOfRepeats; i++) readImage.Read("micro-benchmark-image.mha");
+  report.Add("GateImageT::Read(compressed mha)", "MB", megabytes, timer.GetElapsed());
+
+  std::remove("micro-benchmark-image.mhd");
+  std::remove("micro-benchmark-image.raw");
+  std::remove("micro-benchmark-image.mha");
+}
+//-----------------------------------------------------------------------------
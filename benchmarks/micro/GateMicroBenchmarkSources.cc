@@ -0,0 +1,67 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateMicroBenchmark.hh"
+#include "GateVSourceVoxelReader.hh"
+#include "GateMessageManager.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Reader filled directly with AddVoxel (no file)
+class GateMicroBenchmarkVoxelReader : public GateVSourceVoxelReader
+{
+ public:
+  GateMicroBenchmarkVoxelReader() : GateVSourceVoxelReader(0) {}
+  virtual void ReadFile(G4String) {}
+  virtual void ReadRTFile(G4String, G4String) {}
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// 128x128x128 activity image: a uniform background cylinder with hot
+// spheres, then voxel sampling as done for each primary of a voxelized
+// source.
+void BenchmarkSourceVoxelReader(GateMicroBenchmarkReport & report, double scale)
+{
+  const int n = 128;
+  GateMicroBenchmarkVoxelReader reader;
+  reader.SetImageResolution(n, n, n);
+
+  GateMicroBenchmarkTimer timer;
+  int nbOfVoxels = 0;
+  for(int iz=0; iz<n; iz++)
+    for(int iy=0; iy<n; iy++)
+      for(int ix=0; ix<n; ix++) {
+        double x = ix-n/2+0.5, y = iy-n/2+0.5, z = iz-n/2+0.5;
+        if (x*x + y*y > n*n/4.5) continue;
+        double activity = 1*becquerel;
+        if ((x-20)*(x-20) + y*y + z*z < 100) activity = 10*becquerel;
+        if ((x+20)*(x+20) + y*y + z*z < 25) activity = 20*becquerel;
+        reader.AddVoxel(ix, iy, iz, activity);
+        nbOfVoxels++;
+      }
+  report.Add("GateVSourceVoxelReader::AddVoxel", "voxels", nbOfVoxels, timer.GetElapsed());
+
+  // the first sample builds the sampler
+  timer.Start();
+  reader.GetNextSource();
+  report.Add("GateVSourceVoxelReader::PrepareIntegratedActivityMap", "voxels", nbOfVoxels, timer.GetElapsed());
+
+  const int nbOfSamples = std::max(1, (int)(20000000*scale));
+  long checksum = 0;
+  timer.Start();
+  for(int i=0; i<nbOfSamples; i++) checksum += reader.GetNextSource();
+  report.Add("GateVSourceVoxelReader::GetNextSource", "samples", nbOfSamples, timer.GetElapsed());
+  GateMessage("Core", 2, "BenchmarkSourceVoxelReader: checksum " << checksum << Gateendl);
+}
+//-----------------------------------------------------------------------------
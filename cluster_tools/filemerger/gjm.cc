@@ -14,6 +14,7 @@ See GATE/LICENSE.txt for further details
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <unistd.h>
 #include "GateMergeManager.hh"
 using namespace std;
 
@@ -27,7 +28,13 @@ void showhelp(){
  cout<<"  Usage: gjm [-options] your_file.split"<<endl;
  cout<<endl;
  cout<<"  You may give the name of the split file created by gjs (see inside the .Gate directory)."<<endl;
- cout<<"  !! This merger is only designed to ROOT output. !!"<<endl;
+ cout<<"  !! This merger is only designed to ROOT output and to the actor outputs. !!"<<endl;
+ cout<<"  Actor outputs: the .mhd images of the DoseActor/TLEDoseActor/FluenceActor are summed (uncertainties"<<endl;
+ cout<<"  recomputed from the summed images and squared images, the number of events comes from"<<endl;
+ cout<<"  a SimulationStatisticActor), the .root histograms of the EnergySpectrumActor are summed,"<<endl;
+ cout<<"  the .root trees of the PhaseSpaceActor are concatenated."<<endl;
+ cout<<"  Images normalised in the jobs are summed without their normalisation, then normalised again."<<endl;
+ cout<<"  Other images saved with different scale factors cannot be merged."<<endl;
  cout<<endl;
  cout<<"  Options: "<<endl;
  cout<<"  -outDir path              : where to save the output files default is PWD"<<endl;
@@ -41,6 +48,7 @@ void showhelp(){
  cout<<"  -cleanonlyTest            : just tells you what will be erased by the -cleanonly"<<endl;
  cout<<"  -clean                    : merge and then do the cleanup automatically"<<endl;
  cout<<"  -fastMerge                : correct the output in each file, to be used with a TChain (only for Root output)"<<endl;
+ cout<<"  -j n                      : number of files (images: threads) processed at the same time - default number of cores"<<endl;
  cout<<endl;
  cout<<"  Environment variable: "<<endl;
  cout<<"  GC_DOT_GATE_DIR : points to the .Gate directory"<<endl<<endl;
@@ -58,6 +66,7 @@ int main(int argc,char** argv)
   bool          test   = false;
   bool          merge  = true;
   bool       fastMerge = false;
+  int            nJobs = sysconf(_SC_NPROCESSORS_ONLN);
 
   // Parse the command line
   if (argc==1) showhelp();
@@ -87,6 +96,13 @@ int main(int argc,char** argv)
        test  = true;
     } else if (!strcmp(argv[nextArg],"-fastMerge")){
        fastMerge=true;
+    } else if (!strcmp(argv[nextArg],"-j") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) ) {
+          cout<<"-j "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       nJobs=atoi(argv[nextArg]);
     } else if (!strcmp(argv[nextArg],"-cleanonly")){
        clean = true;
        merge = false;
@@ -139,6 +155,7 @@ int main(int argc,char** argv)
 
   //create a merge manager
   GateMergeManager* manager = new GateMergeManager(fastMerge,verboseLevel,forced,maxRoot,outDir);
+  manager->SetNumberOfJobs(nJobs);
 
   if(merge) manager->StartMerging(splitfileName);
   if(clean) manager->StartCleaning(splitfileName,test);
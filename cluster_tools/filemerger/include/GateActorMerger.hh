@@ -0,0 +1,99 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#ifndef GateActorMerger_h
+#define GateActorMerger_h 1
+#include <string>
+#include <vector>
+#include <map>
+
+/* Merges the files saved by the actors of the split jobs (see the
+   "Actor filename:" lines of the split file). Only the outputs known to add
+   up over the jobs are merged (see IsAdditive):
+   - .mhd images of the dose and fluence actors (dose, edep, squared, ...)
+     are summed voxel by voxel, if saved with the same scale factor. The
+     normalised images are summed without the normalisation of each job,
+     then normalised again. The uncertainty images are recomputed from the
+     merged value and squared images with the number of events of all the
+     jobs;
+   - .root files of the EnergySpectrumActor have their histograms summed;
+   - .root files of the PhaseSpaceActor have their trees concatenated;
+   - .txt files of the SimulationStatisticActor have their counts summed.
+   The histogram and tree merges are also used by Gate to merge the outputs
+   of its workers (see GateApplicationMgr::StartDAQWorkers). */
+
+class GateActorMerger
+{
+public:
+
+  GateActorMerger(int verboseLevel,bool forced,std::string outDir);
+  ~GateActorMerger() {};
+
+  void SetNumberOfThreads(int n) { m_nThreads = (n>0 ? n : 1); }
+  void AddActorFile(std::string type,std::string name,std::string original,std::string splitName);
+  bool HasActors() const { return !m_actors.empty(); }
+  void Merge();
+
+  // false if an input cannot be read or the output cannot be written
+  bool MergeHistograms(const std::vector<std::string>& inputs,std::string output);
+  bool MergeTrees(const std::vector<std::string>& inputs,std::string output);
+
+private:
+  struct ActorOutput {
+     std::string type;
+     std::string name;
+     std::string original;                 // file name of the unsplit macro
+     std::vector<std::string> splitNames;  // file names of the jobs
+  };
+
+  // raw data of a (not compressed) MetaImage, mapped in memory
+  struct MHDImage {
+     std::vector<std::string> header;      // all the lines but ElementDataFile
+     std::string elementType;
+     std::string dataFile;
+     bool     hasScaleFactor;              // ScaleFactor/Normalised header fields
+     double   scaleFactor;                 // of the values (their square for a -Squared image)
+     int      normalisation;               // 0 (no), 1 (to the max), 2 (to the integral)
+     size_t   nValues;
+     size_t   elementSize;
+     void*    data;
+     size_t   dataSize;
+  };
+
+  void MergeOutputs(const ActorOutput& actor,bool statistics);
+  void MergeImages(const std::vector<std::string>& inputs,std::string output);
+  bool SumNormalisedImages(const std::vector<MHDImage*>& images,const std::vector<std::string>& inputs,
+                           std::string output,std::vector<double>& sum);
+  void MergeUncertainty(std::string value,std::string squared,
+                        std::string model,std::string output);
+  void MergeStatistics(const std::vector<std::string>& inputs,std::string output);
+
+  bool MapImage(std::string filename,MHDImage& image);
+  void UnmapImage(MHDImage& image);
+  bool WriteImage(const MHDImage& model,std::string filename,const std::vector<double>& values);
+  void SumImages(const std::vector<MHDImage*>& images,const std::vector<double>& weights,
+                 std::vector<double>& sum);
+  std::string OutputName(std::string original);
+  bool CheckOutput(std::string filename);
+
+  int                      m_verboseLevel;
+  bool                           m_forced;  // if to overwrite existing files
+  std::string                    m_outDir;  // where to save the output files
+  int                          m_nThreads;  // number of threads for the image sums
+  double                       m_nEvents;   // number of events of all jobs, 0 if unknown
+  std::vector<double>        m_jobEvents;   // number of events of each job, empty if unknown
+  std::map<std::string,double> m_mergedScales; // scale factor of the merged normalised values
+  std::vector<ActorOutput>       m_actors;
+  std::map<std::string,int> m_actorIndex;   // position of each actor in m_actors
+};
+
+
+#endif
@@ -17,6 +17,7 @@ See GATE/LICENSE.txt for further details
 #include <cstdlib>
 #include <TFile.h>
 #include <TChain.h>
+#include "GateActorMerger.hh"
 
 class GateMergeManager
 {
@@ -29,6 +30,9 @@ public:
      m_outDir       =       outDir;
      m_CompLevel    =            1;
      m_fastMerge    =    fastMerge;
+     m_nJobs        =            1;
+     filearr        =         NULL;
+     m_actorMerger  = new GateActorMerger(verboseLevel,forced,outDir);
 
      //check if a .Gate directory can be found
      if (!getenv("GC_DOT_GATE_DIR")) {
@@ -49,6 +53,7 @@ public:
   ~GateMergeManager()
   {
    if (filearr) delete filearr;
+   delete m_actorMerger;
   }
 
 
@@ -56,8 +61,9 @@ public:
   void ReadSplitFile(std::string splitfileName);
   bool MergeTree(std::string name);
   bool MergeGate(TChain* chain);
-  bool MergeSing(TChain* chain);
-  bool MergeCoin(TChain* chain);
+
+  // number of input files processed at the same time (one process each)
+  void SetNumberOfJobs(int n) { m_nJobs = (n>0 ? n : 1); m_actorMerger->SetNumberOfThreads(m_nJobs); }
 
   // the cleanup after succesful merging
   void StartCleaning(std::string splitfileName,bool test);
@@ -66,10 +72,28 @@ public:
   void MergeRoot();
 
 private:
+  // eventID correction of one input file: the entries [0,nToShift) get
+  // the offset (see ScanRunIDs)
+  struct FileShift {
+     Long64_t nentries;
+     Long64_t nToShift;
+     int        offset;
+     double  firstTime;
+     double    maxTime;
+  };
+  typedef bool (GateMergeManager::*FileTask)(int fileIndex);
+
   void FastMergeRoot(); 
   bool FastMergeGate(std::string name);
-  bool FastMergeSing(std::string name);
-  bool FastMergeCoin(std::string name); 
+  bool FastMergeIDTree(std::string name,const std::vector<std::string>& idBranches);
+  bool MergeIDTree(std::string name,const std::vector<std::string>& idBranches,
+                   const std::vector<std::string>& timeBranches);
+  bool ScanRunIDs(std::string name,const std::vector<std::string>& timeBranches,
+                  float lastRun,std::vector<FileShift>& shifts);
+  bool RunInWorkers(const std::vector<int>& files,FileTask task);
+  bool ShiftIDs(int fileIndex);
+  bool AddClusterIDs(int fileIndex);
+  std::string TemporaryFileName(int fileIndex);
   bool                 m_forced;             // if to overwrite existing files
   int            m_verboseLevel;  
   TFile**               filearr;
@@ -83,6 +107,11 @@ private:
   TFile*           m_RootTarget;             // root output file
   std::string  m_RootTargetName;             // name of target i.e. root output file
   bool              m_fastMerge;             // fast merge option, corrects the eventIDs locally
+  int                   m_nJobs;             // number of worker processes
+  std::string    m_taskTreeName;             // tree processed by the workers
+  std::vector<std::string> m_taskIDBranches; // eventID branches rewritten by the workers
+  std::vector<FileShift>    m_shifts;        // eventID corrections of all files
+  GateActorMerger*    m_actorMerger;         // merger of the actor outputs
 };
 
 
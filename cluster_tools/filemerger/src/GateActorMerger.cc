@@ -0,0 +1,704 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#include <TROOT.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TH1.h>
+#include <TClass.h>
+#include <TChain.h>
+#include <TTree.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <glob.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "GateActorMerger.hh"
+
+using namespace std;
+
+/*******************************************************************************************/
+// element type conversions of the image data
+
+static size_t ElementSize(string type){
+   if(type=="MET_DOUBLE") return sizeof(double);
+   if(type=="MET_FLOAT")  return sizeof(float);
+   if(type=="MET_INT"   || type=="MET_UINT")   return sizeof(int);
+   if(type=="MET_SHORT" || type=="MET_USHORT") return sizeof(short);
+   if(type=="MET_CHAR"  || type=="MET_UCHAR")  return sizeof(char);
+   return 0;
+}
+
+template<class T>
+static void AddValues(const void* data,size_t begin,size_t end,double* sum,double weight){
+   const T* p=(const T*)data;
+   for(size_t i=begin;i<end;i++) sum[i]+=weight*p[i];
+}
+
+static void AddValues(const string& type,const void* data,size_t begin,size_t end,double* sum,double weight=1){
+   if(type=="MET_DOUBLE")      AddValues<double>(data,begin,end,sum,weight);
+   else if(type=="MET_FLOAT")  AddValues<float>(data,begin,end,sum,weight);
+   else if(type=="MET_INT")    AddValues<int>(data,begin,end,sum,weight);
+   else if(type=="MET_UINT")   AddValues<unsigned int>(data,begin,end,sum,weight);
+   else if(type=="MET_SHORT")  AddValues<short>(data,begin,end,sum,weight);
+   else if(type=="MET_USHORT") AddValues<unsigned short>(data,begin,end,sum,weight);
+   else if(type=="MET_CHAR")   AddValues<char>(data,begin,end,sum,weight);
+   else if(type=="MET_UCHAR")  AddValues<unsigned char>(data,begin,end,sum,weight);
+}
+
+template<class T>
+static void ConvertValues(const double* values,size_t n,void* buffer){
+   T* p=(T*)buffer;
+   if(numeric_limits<T>::is_integer)
+      for(size_t i=0;i<n;i++) p[i]=(T)floor(values[i]+0.5);
+   else
+      for(size_t i=0;i<n;i++) p[i]=(T)values[i];
+}
+
+static void ConvertValues(const string& type,const double* values,size_t n,void* buffer){
+   if(type=="MET_DOUBLE")      ConvertValues<double>(values,n,buffer);
+   else if(type=="MET_FLOAT")  ConvertValues<float>(values,n,buffer);
+   else if(type=="MET_INT")    ConvertValues<int>(values,n,buffer);
+   else if(type=="MET_UINT")   ConvertValues<unsigned int>(values,n,buffer);
+   else if(type=="MET_SHORT")  ConvertValues<short>(values,n,buffer);
+   else if(type=="MET_USHORT") ConvertValues<unsigned short>(values,n,buffer);
+   else if(type=="MET_CHAR")   ConvertValues<char>(values,n,buffer);
+   else if(type=="MET_UCHAR")  ConvertValues<unsigned char>(values,n,buffer);
+}
+
+static string Trim(string s){
+   size_t b=s.find_first_not_of(" \t\r");
+   size_t e=s.find_last_not_of(" \t\r");
+   if(b==string::npos) return "";
+   return s.substr(b,e-b+1);
+}
+
+static bool EndsWith(const string& s,const string& end){
+   return s.length()>=end.length() && s.compare(s.length()-end.length(),end.length(),end)==0;
+}
+
+// The outputs known to add up over the jobs: counts, energies, doses and
+// fluences, and their squares, and the particles of the phase spaces. The
+// others (averages, ...) are not merged.
+static bool IsAdditive(const string& type,const string& suffix){
+   if(type=="SimulationStatisticActor") return suffix==".txt";
+   if(type=="EnergySpectrumActor" || type=="PhaseSpaceActor") return suffix==".root";
+   vector<string> quantities;
+   if(type=="DoseActor" || type=="TLEDoseActor") {
+      quantities.push_back("-Edep");
+      quantities.push_back("-Dose");
+      quantities.push_back("-DoseToWater");
+      quantities.push_back("-NbOfHits");
+   }
+   if(type=="FluenceActor") {
+      quantities.push_back("");
+      quantities.push_back("-scatter");
+      quantities.push_back("-NbOfHits");
+   }
+   for(unsigned int q=0;q<quantities.size();q++) {
+      const string& s=quantities[q];
+      if(suffix==s+".mhd" || suffix==s+"-Squared.mhd" || suffix==s+"-Uncertainty.mhd") return true;
+   }
+   return false;
+}
+
+// Normalised images are summed with a weight per job which undoes its
+// normalisation: the inverse of its scale factor (their square for a
+// -Squared image), or, for images saved without it, the number of events
+// of the job
+static bool IsSquaredImage(const string& name){
+   return EndsWith(name,"-Squared.mhd");
+}
+
+/*******************************************************************************************/
+GateActorMerger::GateActorMerger(int verboseLevel,bool forced,string outDir){
+   m_verboseLevel = verboseLevel;
+   m_forced       =       forced;
+   m_outDir       =       outDir;
+   m_nThreads     =            1;
+   m_nEvents      =            0;
+}
+
+/*******************************************************************************************/
+void GateActorMerger::AddActorFile(string type,string name,string original,string splitName){
+   map<string,int>::iterator it=m_actorIndex.find(name);
+   if(it==m_actorIndex.end()) {
+      ActorOutput actor;
+      actor.type     = type;
+      actor.name     = name;
+      actor.original = original;
+      m_actorIndex[name]=m_actors.size();
+      m_actors.push_back(actor);
+      it=m_actorIndex.find(name);
+   }
+   m_actors[it->second].splitNames.push_back(splitName);
+   if(m_verboseLevel>2) cout<<"Actor "<<name<<" input file name: "<<splitName<<endl;
+}
+
+/*******************************************************************************************/
+void GateActorMerger::Merge(){
+   // the statistics first: they give the number of events for the uncertainties
+   for(unsigned int i=0;i<m_actors.size();i++)
+      if(m_actors[i].type=="SimulationStatisticActor") MergeOutputs(m_actors[i],true);
+   for(unsigned int i=0;i<m_actors.size();i++)
+      if(m_actors[i].type!="SimulationStatisticActor") MergeOutputs(m_actors[i],false);
+}
+
+/*******************************************************************************************/
+// An actor saved as base.ext writes base.ext and/or files named base-xxx.ext
+// (e.g. dose-Edep.mhd, dose-Dose-Squared.mhd): they are found in the output
+// of the first job, the other jobs have the same ones.
+void GateActorMerger::MergeOutputs(const ActorOutput& actor,bool statistics){
+
+   size_t dot=actor.splitNames[0].rfind('.');
+   size_t originalDot=actor.original.rfind('.');
+   if(dot==string::npos || originalDot==string::npos) {
+      cout<<"Cannot merge the output of actor "<<actor.name<<" (no extension)"<<endl;
+      return;
+   }
+   string ext=actor.splitNames[0].substr(dot);
+   vector<string> bases;
+   for(unsigned int j=0;j<actor.splitNames.size();j++)
+      bases.push_back(actor.splitNames[j].substr(0,actor.splitNames[j].rfind('.')));
+   string originalBase=actor.original.substr(0,originalDot);
+
+   vector<string> suffixes;
+   glob_t files;
+   string patterns[2]={ bases[0]+ext, bases[0]+"-*"+ext };
+   for(int p=0;p<2;p++) {
+      if(glob(patterns[p].c_str(),0,NULL,&files)==0) {
+         for(size_t k=0;k<files.gl_pathc;k++) suffixes.push_back(string(files.gl_pathv[k]).substr(bases[0].length()));
+      }
+      globfree(&files);
+   }
+   if(suffixes.empty()) {
+      cout<<"No output of actor "<<actor.name<<" found ("<<actor.splitNames[0]<<")"<<endl;
+      return;
+   }
+
+   // the squared images after the values: a normalised squared image is
+   // scaled like the merged values
+   vector<string> ordered;
+   for(int squared=0;squared<2;squared++)
+      for(unsigned int k=0;k<suffixes.size();k++)
+         if(IsSquaredImage(suffixes[k])==(squared==1)) ordered.push_back(suffixes[k]);
+   suffixes=ordered;
+
+   vector<string> uncertainties;
+   for(unsigned int k=0;k<suffixes.size();k++) {
+      if(!IsAdditive(actor.type,suffixes[k])) {
+         cout<<"Cannot merge the "<<suffixes[k]<<" output of actor "<<actor.name
+             <<" ("<<actor.type<<"), its values do not add up"<<endl;
+         continue;
+      }
+      vector<string> inputs;
+      for(unsigned int j=0;j<bases.size();j++) inputs.push_back(bases[j]+suffixes[k]);
+      string output=OutputName(originalBase+suffixes[k]);
+
+      if(statistics) MergeStatistics(inputs,output);
+      else if(ext==".mhd") {
+         // recomputed from the merged images
+         if(EndsWith(suffixes[k],"-Uncertainty.mhd")) uncertainties.push_back(suffixes[k]);
+         else MergeImages(inputs,output);
+      }
+      else if(ext==".root" && actor.type=="PhaseSpaceActor") MergeTrees(inputs,output);
+      else if(ext==".root") MergeHistograms(inputs,output);
+      else cout<<"Cannot merge the "<<ext<<" output of actor "<<actor.name<<endl;
+   }
+
+   for(unsigned int k=0;k<uncertainties.size();k++) {
+      string value=uncertainties[k].substr(0,uncertainties[k].length()-16);
+      MergeUncertainty(OutputName(originalBase+value+".mhd"),OutputName(originalBase+value+"-Squared.mhd"),
+                       bases[0]+uncertainties[k],OutputName(originalBase+uncertainties[k]));
+   }
+}
+
+/*******************************************************************************************/
+// the threads of SumImages share the images, each one sums a range of voxels
+struct GateImageSumTask {
+   const vector<void*>*  data;
+   const vector<string>* types;
+   const vector<double>* weights;
+   double*               sum;
+   size_t                begin;
+   size_t                end;
+};
+
+static void* SumImageRange(void* arg){
+   GateImageSumTask* task=(GateImageSumTask*)arg;
+   // by blocks, so that the partial sum stays in cache while all images are added
+   const size_t blockSize=16384;
+   for(size_t b=task->begin;b<task->end;b+=blockSize) {
+      size_t e=(b+blockSize<task->end ? b+blockSize : task->end);
+      for(unsigned int j=0;j<task->data->size();j++)
+         AddValues((*task->types)[j],(*task->data)[j],b,e,task->sum,(*task->weights)[j]);
+   }
+   return NULL;
+}
+
+void GateActorMerger::SumImages(const vector<MHDImage*>& images,const vector<double>& weights,
+                                vector<double>& sum){
+   size_t n=images[0]->nValues;
+   sum.assign(n,0);
+   vector<void*>  data;
+   vector<string> types;
+   for(unsigned int j=0;j<images.size();j++) {
+      data.push_back(images[j]->data);
+      types.push_back(images[j]->elementType);
+   }
+
+   int nThreads=m_nThreads;
+   if((size_t)nThreads>n/65536+1) nThreads=n/65536+1;
+   vector<GateImageSumTask> tasks(nThreads);
+   vector<pthread_t> threads(nThreads);
+   for(int t=0;t<nThreads;t++) {
+      tasks[t].data  = &data;
+      tasks[t].types = &types;
+      tasks[t].weights = &weights;
+      tasks[t].sum   = &sum[0];
+      tasks[t].begin = n*t/nThreads;
+      tasks[t].end   = n*(t+1)/nThreads;
+   }
+   // the last range is done by this thread
+   int started=0;
+   for(int t=0;t<nThreads-1;t++) {
+      if(pthread_create(&threads[t],NULL,SumImageRange,&tasks[t])!=0) break;
+      started++;
+   }
+   for(int t=started;t<nThreads;t++) SumImageRange(&tasks[t]);
+   for(int t=0;t<started;t++) pthread_join(threads[t],NULL);
+}
+
+/*******************************************************************************************/
+void GateActorMerger::MergeImages(const vector<string>& inputs,string output){
+
+   if(!CheckOutput(output)) return;
+   vector<MHDImage> images(inputs.size());
+   vector<MHDImage*> mapped;
+   bool ok=true;
+   for(unsigned int j=0;j<inputs.size() && ok;j++) {
+      ok=MapImage(inputs[j],images[j]);
+      if(ok) mapped.push_back(&images[j]);
+      if(ok && images[j].nValues!=images[0].nValues) {
+         cout<<"Image "<<inputs[j]<<" has not the size of "<<inputs[0]<<endl;
+         ok=false;
+      }
+      if(ok && images[j].normalisation!=images[0].normalisation) {
+         cout<<"Image "<<inputs[j]<<" is not normalised like "<<inputs[0]<<endl;
+         ok=false;
+      }
+      if(ok && !images[0].normalisation &&
+         (images[j].hasScaleFactor!=images[0].hasScaleFactor ||
+          fabs(images[j].scaleFactor-images[0].scaleFactor)>1e-9*fabs(images[0].scaleFactor))) {
+         cout<<"Image "<<inputs[j]<<" has not the scale factor of "<<inputs[0]<<endl;
+         ok=false;
+      }
+   }
+   if(ok) {
+      vector<double> sum;
+      if(images[0].normalisation) ok=SumNormalisedImages(mapped,inputs,output,sum);
+      else SumImages(mapped,vector<double>(mapped.size(),1.0),sum);
+      if(ok) ok=WriteImage(images[0],output,sum);
+   }
+   for(unsigned int j=0;j<mapped.size();j++) UnmapImage(*mapped[j]);
+   if(ok && m_verboseLevel>0) cout<<"Combining "<<inputs.size()<<" images -> "<<output<<endl;
+}
+
+/*******************************************************************************************/
+// Sum of the images of the jobs without their normalisation, normalised
+// again like the first job (same maximum, or same integral): the scale
+// factor of the merged value image is kept for its squared image. The
+// ScaleFactor header field of the first image is updated.
+bool GateActorMerger::SumNormalisedImages(const vector<MHDImage*>& images,const vector<string>& inputs,
+                                          string output,vector<double>& sum){
+
+   bool squared=IsSquaredImage(output);
+   vector<double> weights;
+   for(unsigned int j=0;j<images.size();j++) {
+      double w;
+      if(images[j]->hasScaleFactor) {
+         if(images[j]->scaleFactor==0) {
+            cout<<"Image "<<inputs[j]<<" is normalised with a null scale factor, the jobs cannot be merged"<<endl;
+            return false;
+         }
+         w=1.0/images[j]->scaleFactor;
+      }
+      else {
+         if(m_jobEvents.size()!=images.size()) {
+            cout<<"Image "<<inputs[j]<<" is normalised without scale factor and the number of events of each job"
+                <<" is unknown (no SimulationStatisticActor), the jobs cannot be merged"<<endl;
+            return false;
+         }
+         w=m_jobEvents[j];
+      }
+      weights.push_back(squared ? w*w : w);
+   }
+   SumImages(images,weights,sum);
+
+   double scale;
+   if(squared) {
+      string value=output.substr(0,output.length()-12)+".mhd";
+      map<string,double>::const_iterator it=m_mergedScales.find(value);
+      if(it==m_mergedScales.end()) {
+         cout<<"The normalised image "<<value<<" is not merged, "<<output<<" cannot be"<<endl;
+         return false;
+      }
+      scale=it->second;
+   }
+   else {
+      // the normalisation of the first job, from its own values
+      size_t n=images[0]->nValues;
+      vector<double> first(n,0);
+      AddValues(images[0]->elementType,images[0]->data,0,n,&first[0]);
+      double firstNorm=0, sumNorm=0;
+      for(size_t i=0;i<n;i++) {
+         if(images[0]->normalisation==1) {
+            if(first[i]>firstNorm) firstNorm=first[i];
+            if(sum[i]>sumNorm) sumNorm=sum[i];
+         }
+         else {
+            firstNorm+=first[i];
+            sumNorm+=sum[i];
+         }
+      }
+      scale=(sumNorm!=0 ? firstNorm/sumNorm : 1);
+      m_mergedScales[output]=scale;
+   }
+
+   double valueScale=(squared ? scale*scale : scale);
+   for(size_t i=0;i<sum.size();i++) sum[i]*=valueScale;
+   for(unsigned int i=0;i<images[0]->header.size();i++) {
+      string& line=images[0]->header[i];
+      if(Trim(line.substr(0,line.find('=')))!="ScaleFactor") continue;
+      ostringstream field;
+      field.precision(17);
+      field<<"ScaleFactor = "<<scale;
+      line=field.str();
+   }
+   return true;
+}
+
+/*******************************************************************************************/
+// same formula as GateImageWithStatistic::ComputeUncertainty, with the number
+// of events of all jobs
+void GateActorMerger::MergeUncertainty(string value,string squared,
+                                       string modelName,string output){
+
+   if(m_nEvents<=0) {
+      cout<<"Warning - unknown number of events (no SimulationStatisticActor), "
+          <<output<<" is not written"<<endl;
+      return;
+   }
+   if(!CheckOutput(output)) return;
+
+   MHDImage valueImage, squaredImage, model;
+   if(!MapImage(value,valueImage)) return;
+   if(!MapImage(squared,squaredImage)) {
+      UnmapImage(valueImage);
+      return;
+   }
+   // images saved before the ScaleFactor field have a squared image which is
+   // not scaled like the values
+   if(!valueImage.hasScaleFactor || !squaredImage.hasScaleFactor ||
+      valueImage.scaleFactor!=squaredImage.scaleFactor) {
+      cout<<"Warning - "<<value<<" and "<<squared<<" have no common scale factor, "
+          <<output<<" is not written"<<endl;
+   }
+   else if(MapImage(modelName,model)) {
+      size_t n=valueImage.nValues;
+      vector<double> mean(n,0), sq(n,0), uncertainty(n);
+      AddValues(valueImage.elementType,valueImage.data,0,n,&mean[0]);
+      AddValues(squaredImage.elementType,squaredImage.data,0,n,&sq[0]);
+      double N=m_nEvents;
+      for(size_t i=0;i<n;i++) {
+         if(mean[i]!=0.0 && N!=1 && sq[i]!=0.0)
+            uncertainty[i]=sqrt((1.0/(N-1))*(sq[i]/N-pow(mean[i]/N,2)))/(mean[i]/N);
+         else uncertainty[i]=1;
+      }
+      if(WriteImage(model,output,uncertainty) && m_verboseLevel>0)
+         cout<<"Uncertainty for "<<N<<" events -> "<<output<<endl;
+      UnmapImage(model);
+   }
+   UnmapImage(valueImage);
+   UnmapImage(squaredImage);
+}
+
+/*******************************************************************************************/
+bool GateActorMerger::MergeHistograms(const vector<string>& inputs,string output){
+
+   if(!CheckOutput(output)) return false;
+   vector<TFile*> files;
+   for(unsigned int j=0;j<inputs.size();j++) {
+      TFile* file=TFile::Open(inputs[j].c_str(),"READ");
+      if(file==NULL) {
+         cout<<"Not a readable file "<<inputs[j]<<endl;
+         for(unsigned int k=0;k<files.size();k++) { files[k]->Close(); delete files[k]; }
+         return false;
+      }
+      files.push_back(file);
+   }
+   TFile* target=TFile::Open(output.c_str(),"RECREATE");
+   if(target==NULL) {
+      cout<<"Cannot create "<<output<<endl;
+      for(unsigned int k=0;k<files.size();k++) { files[k]->Close(); delete files[k]; }
+      return false;
+   }
+   TIter nextkey(files[0]->GetListOfKeys());
+   TKey *key=0;
+   while ((key = (TKey*)nextkey())) {
+      files[0]->cd();
+      TObject* obj = (TObject*)key->ReadObj();
+      if(!obj->IsA()->InheritsFrom("TH1")) continue;
+      target->cd();
+      TH1 *h1 = (TH1 *)obj->Clone();
+      for(unsigned int j=1;j<files.size();j++) {
+         TH1 *h2 = (TH1*)files[j]->Get(h1->GetName());
+         if(h2) h1->Add(h2);
+      }
+      h1->Write();
+   }
+   target->Close();
+   delete target;
+   for(unsigned int k=0;k<files.size();k++) { files[k]->Close(); delete files[k]; }
+   if(m_verboseLevel>0) cout<<"Combining "<<inputs.size()<<" histogram files -> "<<output<<endl;
+   return true;
+}
+
+/*******************************************************************************************/
+// the entries are independent (one particle each): the trees of the jobs
+// are concatenated
+bool GateActorMerger::MergeTrees(const vector<string>& inputs,string output){
+
+   if(!CheckOutput(output)) return false;
+   vector<string> treeNames;
+   for(unsigned int j=0;j<inputs.size();j++) {
+      TFile* file=TFile::Open(inputs[j].c_str(),"READ");
+      if(file==NULL) {
+         cout<<"Not a readable file "<<inputs[j]<<endl;
+         return false;
+      }
+      if(j==0) {
+         TIter nextkey(file->GetListOfKeys());
+         TKey *key=0;
+         while ((key = (TKey*)nextkey())) {
+            TClass* c=TClass::GetClass(key->GetClassName());
+            if(c==NULL || !c->InheritsFrom("TTree")) continue;
+            bool singleName=true;
+            for(unsigned int t=0;t<treeNames.size();t++) if(treeNames[t]==key->GetName()) singleName=false;
+            if(singleName) treeNames.push_back(key->GetName());
+         }
+      }
+      file->Close();
+      delete file;
+   }
+   TFile* target=TFile::Open(output.c_str(),"RECREATE");
+   if(target==NULL) {
+      cout<<"Cannot create "<<output<<endl;
+      return false;
+   }
+   bool ok=true;
+   for(unsigned int t=0;t<treeNames.size() && ok;t++) {
+      TChain chain(treeNames[t].c_str());
+      for(unsigned int j=0;j<inputs.size();j++) chain.Add(inputs[j].c_str());
+      target->cd();
+      TTree* tree=chain.CloneTree(-1,"fast");
+      if(tree==NULL) {
+         cout<<"Cannot merge the tree "<<treeNames[t]<<" of "<<inputs[0]<<", ..."<<endl;
+         ok=false;
+      }
+      else tree->Write();
+   }
+   target->Close();
+   delete target;
+   if(ok && m_verboseLevel>0) cout<<"Combining "<<inputs.size()<<" tree files -> "<<output<<endl;
+   return ok;
+}
+
+/*******************************************************************************************/
+// the counts are summed, the times and dates of the jobs are not kept
+void GateActorMerger::MergeStatistics(const vector<string>& inputs,string output){
+
+   const char* counts[]={ "NumberOfRun", "NumberOfEvents", "NumberOfTracks", "NumberOfSteps",
+                          "NumberOfGeometricalSteps", "NumberOfPhysicalSteps",
+                          "ElapsedTime", "ElapsedTimeWoInit" };
+   const int nCounts=8;
+   vector<double> sums(nCounts,0);
+   vector<double> jobEvents(inputs.size(),0);
+
+   for(unsigned int j=0;j<inputs.size();j++) {
+      ifstream stat(inputs[j].c_str());
+      if(!stat) {
+         cout<<"Not a readable file "<<inputs[j]<<endl;
+         return;
+      }
+      string line;
+      while(getline(stat,line)) {
+         size_t eq=line.find('=');
+         if(line.empty() || line[0]!='#' || eq==string::npos) continue;
+         string key=Trim(line.substr(1,eq-1));
+         for(int c=0;c<nCounts;c++)
+            if(key==counts[c]) sums[c]+=atof(line.substr(eq+1).c_str());
+         if(key=="NumberOfEvents") jobEvents[j]=atof(line.substr(eq+1).c_str());
+      }
+   }
+   m_nEvents=sums[1];
+   m_jobEvents.clear();
+   for(unsigned int j=0;j<inputs.size();j++) m_jobEvents.push_back(jobEvents[j]);
+
+   if(!CheckOutput(output)) return;
+   ofstream os(output.c_str());
+   for(int c=0;c<nCounts;c++) os<<"# "<<counts[c]<<" = "<<sums[c]<<endl;
+   if(m_verboseLevel>0) cout<<"Combining "<<inputs.size()<<" statistics ("
+                            <<m_nEvents<<" events) -> "<<output<<endl;
+}
+
+/*******************************************************************************************/
+bool GateActorMerger::MapImage(string filename,MHDImage& image){
+
+   image.data=NULL;
+   image.dataSize=0;
+   image.hasScaleFactor=false;
+   image.scaleFactor=1;
+   image.normalisation=0;
+   ifstream header(filename.c_str());
+   if(!header) {
+      cout<<"Not a readable file "<<filename<<endl;
+      return false;
+   }
+   size_t nValues=1;
+   int channels=1;
+   bool supported=true;
+   string line;
+   while(getline(header,line)) {
+      size_t eq=line.find('=');
+      if(eq==string::npos) continue;
+      string key=Trim(line.substr(0,eq));
+      string value=Trim(line.substr(eq+1));
+      if(key=="ElementDataFile") {
+         image.dataFile=value;
+         continue;
+      }
+      if(key=="DimSize") {
+         stringstream dims(value);
+         size_t d;
+         while(dims>>d) nValues*=d;
+      }
+      else if(key=="ElementNumberOfChannels") channels=atoi(value.c_str());
+      else if(key=="ElementType") image.elementType=value;
+      else if(key=="ScaleFactor") {
+         image.hasScaleFactor=true;
+         image.scaleFactor=atof(value.c_str());
+      }
+      else if(key=="Normalised") image.normalisation=atoi(value.c_str());
+      else if(key=="NumberOfEvents") continue; // of this job only, not of the merged image
+      else if(key=="CompressedData" && value=="True") supported=false;
+      else if((key=="BinaryDataByteOrderMSB" || key=="ElementByteOrderMSB") && value=="True") supported=false;
+      image.header.push_back(line);
+   }
+   image.nValues=nValues*channels;
+   image.elementSize=ElementSize(image.elementType);
+   if(!supported || image.elementSize==0 || image.dataFile=="" || image.dataFile=="LOCAL") {
+      cout<<"Only uncompressed .mhd/.raw images can be merged: "<<filename<<endl;
+      return false;
+   }
+
+   string data=image.dataFile;
+   size_t slash=filename.rfind('/');
+   if(data[0]!='/' && slash!=string::npos) data=filename.substr(0,slash+1)+data;
+   int fd=open(data.c_str(),O_RDONLY);
+   struct stat st;
+   if(fd<0 || fstat(fd,&st)!=0 || (size_t)st.st_size<image.nValues*image.elementSize) {
+      cout<<"Not a readable file "<<data<<endl;
+      if(fd>=0) close(fd);
+      return false;
+   }
+   image.dataSize=image.nValues*image.elementSize;
+   image.data=mmap(NULL,image.dataSize,PROT_READ,MAP_PRIVATE,fd,0);
+   close(fd);
+   if(image.data==MAP_FAILED) {
+      cout<<"Cannot map "<<data<<endl;
+      image.data=NULL;
+      return false;
+   }
+   madvise(image.data,image.dataSize,MADV_SEQUENTIAL);
+   return true;
+}
+
+/*******************************************************************************************/
+void GateActorMerger::UnmapImage(MHDImage& image){
+   if(image.data) munmap(image.data,image.dataSize);
+   image.data=NULL;
+}
+
+/*******************************************************************************************/
+bool GateActorMerger::WriteImage(const MHDImage& model,string filename,const vector<double>& values){
+
+   string raw=filename.substr(0,filename.rfind('.'))+".raw";
+   size_t slash=raw.rfind('/');
+   string rawName=(slash==string::npos ? raw : raw.substr(slash+1));
+
+   ofstream header(filename.c_str());
+   if(!header) {
+      cout<<"Cannot create "<<filename<<endl;
+      return false;
+   }
+   for(unsigned int i=0;i<model.header.size();i++) header<<model.header[i]<<endl;
+   header<<"ElementDataFile = "<<rawName<<endl;
+   header.close();
+
+   FILE* file=fopen(raw.c_str(),"wb");
+   if(file==NULL) {
+      cout<<"Cannot create "<<raw<<endl;
+      return false;
+   }
+   const size_t blockSize=65536;
+   vector<char> buffer(blockSize*model.elementSize);
+   bool ok=true;
+   for(size_t b=0;b<values.size() && ok;b+=blockSize) {
+      size_t n=(b+blockSize<values.size() ? blockSize : values.size()-b);
+      ConvertValues(model.elementType,&values[b],n,&buffer[0]);
+      ok=(fwrite(&buffer[0],model.elementSize,n,file)==n);
+   }
+   if(fclose(file)!=0) ok=false;
+   if(!ok) cout<<"Error writing "<<raw<<endl;
+   return ok;
+}
+
+/*******************************************************************************************/
+string GateActorMerger::OutputName(string original){
+   if(m_outDir=="") return original;
+   // output directory option used: replace path with outDir
+   size_t pos=original.rfind('/');
+   if(pos==string::npos) return m_outDir+original;
+   return m_outDir+original.substr(pos+1);
+}
+
+/*******************************************************************************************/
+bool GateActorMerger::CheckOutput(string filename){
+   if(m_forced) return true;
+   ifstream exists(filename.c_str());
+   if(!exists) return true;
+   cout<<"The ouput file "<<filename<<" already exists! Try -f to overwrite it."<<endl;
+   return false;
+}
+/*******************************************************************************************/
@@ -28,7 +28,10 @@ See GATE/LICENSE.txt for further details
 #include <sstream>
 #include <vector>
 #include <cstdlib>
+#include <cstdio>
 #include <cmath>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "GateMergeManager.hh"
 
@@ -39,8 +42,11 @@ void GateMergeManager::StartMerging(string splitfileName){
   // get the files to merge
   ReadSplitFile(splitfileName);
   //do the merging
-  if (m_fastMerge==true) FastMergeRoot();
-  else MergeRoot();
+  if (m_RootTargetName!="" || !m_actorMerger->HasActors()) {
+     if (m_fastMerge==true) FastMergeRoot();
+     else MergeRoot();
+  }
+  m_actorMerger->Merge();
 
   //if we are here the merging has been successful
   //we mark the directory as ready for cleanup
@@ -99,6 +105,13 @@ void GateMergeManager::ReadSplitFile(string splitfileName){
         }
         if(m_verboseLevel>2) cout<<"Root output file name: "<<m_RootTargetName<<endl;
      }
+     // actor outputs: type, name, original and split file names
+     else if(!strncmp(cline,"Actor filename:",15)){
+        stringstream ssactor(cline+15);
+        string type,name,original,splitName;
+        ssactor>>type>>name>>original>>splitName;
+        if(splitName!="") m_actorMerger->AddActorFile(type,name,original,splitName);
+     }
   }
 
   // check if number of root files correct
@@ -178,6 +191,14 @@ void GateMergeManager::FastMergeRoot()
        if(singleName) treeNames.push_back(obj->GetName());
      }
    }
+   // the trees are updated in place by FastMergeGate and by the worker
+   // processes, each opening its own handle: the read handles must go
+   node->Close();
+   for(int i=0;i<nfiles;i++) {
+      filearr[i]->Close();
+      delete filearr[i];
+      filearr[i]=NULL;
+   }
    //take care of all trees
    for(unsigned int i=0;i<treeNames.size();i++) 
    {
@@ -358,45 +379,74 @@ void GateMergeManager::StartCleaning(string splitfileName,bool test){
 bool GateMergeManager::MergeTree(string chainName){
 if (m_fastMerge==false)
  {
-   TChain* chain = new TChain(chainName.c_str());
+   if(chainName=="Gate") {
+     TChain* chain = new TChain(chainName.c_str());
 
-   // number of files to merge
-   int nfiles=m_vRootFileNames.size();
+     // number of files to merge
+     int nfiles=m_vRootFileNames.size();
 
-   for(int i=0;i<nfiles;i++) chain->Add(m_vRootFileNames[i].c_str());
-   int nentries=chain->GetEntries();
-   if(nentries<=0) {
-      if(m_verboseLevel>1) cout<<chain->GetName()<<" is empty!"<<endl;
-      return false;
+     for(int i=0;i<nfiles;i++) chain->Add(m_vRootFileNames[i].c_str());
+     int nentries=chain->GetEntries();
+     if(nentries<=0) {
+        if(m_verboseLevel>1) cout<<chain->GetName()<<" is empty!"<<endl;
+        return false;
+     }
+     return MergeGate(chain);
    }
 
-   if(chainName=="Gate") MergeGate(chain);
-
-   if(chain->FindBranch("eventID1")!=NULL) {
-     if(  (chain->FindBranch("runID")==NULL)
-        ||(chain->FindBranch("time1")==NULL) 
-        ||(chain->FindBranch("time2")==NULL) ) {
-        cout<<"Cannot find one of:  runID, time1, time2 in "<<chain->GetName()<<endl;
+   // the branches are looked for in the first file only, all files
+   // come from the same macro
+   TFile* file = TFile::Open(m_vRootFileNames[0].c_str(),"READ");
+   TTree* tree = file ? (TTree*)file->Get(chainName.c_str()) : NULL;
+   if(tree==NULL) {
+      cout<<"Cannot find "<<chainName<<" in "<<m_vRootFileNames[0]<<endl;
+      if(file) { file->Close(); delete file; }
+      return false;
+   }
+   bool coincidences = tree->FindBranch("eventID1")!=NULL;
+   bool complete;
+   if(coincidences) complete = tree->FindBranch("runID")!=NULL && tree->FindBranch("eventID2")!=NULL
+                             && tree->FindBranch("time1")!=NULL && tree->FindBranch("time2")!=NULL;
+   else             complete = tree->FindBranch("runID")!=NULL && tree->FindBranch("eventID")!=NULL
+                             && tree->FindBranch("time")!=NULL;
+   file->Close();
+   delete file;
+
+   vector<string> idBranches;
+   vector<string> timeBranches;
+   if(coincidences) {
+     if(!complete) {
+        cout<<"Cannot find one of:  runID, eventID2, time1, time2 in "<<chainName<<endl;
+        return false;
+     }
+     idBranches.push_back("eventID1");
+     idBranches.push_back("eventID2");
+     timeBranches.push_back("time1");
+     timeBranches.push_back("time2");
+   } else {
+     if(!complete) {
+        cout<<"Cannot find one of: runID, eventID, time in "<<chainName<<endl;
         return false;
      }
-     // coincidence
-     return MergeCoin(chain);
-
-   } else if(  (chain->FindBranch("runID")==NULL)||(chain->FindBranch("eventID")==NULL)
-                                                  ||(chain->FindBranch("time")==NULL) )
-            {
-             cout<<"Cannot find one of: runID, eventID, time in "<<chain->GetName()<<endl;
-             return false;
-            }
-           // Singles or Hits
-           return MergeSing(chain);
+     // Singles or Hits
+     idBranches.push_back("eventID");
+     timeBranches.push_back("time");
+   }
+   return MergeIDTree(chainName,idBranches,timeBranches);
    }
    else
    {
-     if (chainName.find("Hits",0)!=string::npos) return FastMergeSing(chainName);
-     if (chainName.find("Singles",0)!=string::npos) return FastMergeSing(chainName);
+     vector<string> idBranches;
      if (chainName.find("Gate",0)!=string::npos) return FastMergeGate(chainName);
-     if (chainName.find("Coincidences",0)!=string::npos) return FastMergeCoin(chainName);
+     if (chainName.find("Coincidences",0)!=string::npos) {
+       idBranches.push_back("eventID1");
+       idBranches.push_back("eventID2");
+       return FastMergeIDTree(chainName,idBranches);
+     }
+     if (chainName.find("Hits",0)!=string::npos || chainName.find("Singles",0)!=string::npos) {
+       idBranches.push_back("eventID");
+       return FastMergeIDTree(chainName,idBranches);
+     }
    }
    return 0;
 }
@@ -414,8 +464,12 @@ string clusterName=name+"_cluster";
 
 for(int j=0;j<m_Nfiles;j++)
  {
-   filearr[j]->ReOpen("UPDATE");
-   TTree *oldTree = (TTree*)gDirectory->Get(name.c_str());
+   TFile* file = TFile::Open(m_vRootFileNames[j].c_str(),"UPDATE");
+   if(file==NULL){
+      cout<<"Not a writable file "<<m_vRootFileNames[j]<<endl;
+      return false;
+   }
+   TTree *oldTree = (TTree*)file->Get(name.c_str());
    TBranch *branch  = oldTree->GetBranch("event");
    branch->SetAddress(&event);
    TBranch* newBranch=oldTree->Branch("eventcluster",&event,"event");
@@ -453,103 +507,66 @@ for(int j=0;j<m_Nfiles;j++)
         }
       }
     oldTree->Write();
+    file->Close();
+    delete file;
  }
  return true;
 }
 
 /*******************************************************************************************/
-bool GateMergeManager::FastMergeSing(string name)
+// Hits, Singles and Coincidences: the corrected eventIDs are written to
+// <id>cluster branches of the input files, one worker process per file
+bool GateMergeManager::FastMergeIDTree(string name,const vector<string>& idBranches)
 {
-int eventID = 0;
-int runID = 0; 
-int offset      = 0;
-int currentfile = 0;
-float lastRun =-1;
-string clusterName=name+"_cluster"; 
-
-for(int j=0;j<m_Nfiles;j++)
- {
-   filearr[j]->ReOpen("UPDATE");
-   TTree *oldTree = (TTree*)gDirectory->Get(name.c_str());
-   TBranch *branch  = oldTree->GetBranch("eventID");
-   branch->SetAddress(&eventID);
-   TBranch *branch2  = oldTree->GetBranch("runID");
-   branch2->SetAddress(&runID);
-   TBranch* newBranch=oldTree->Branch("eventIDcluster",&eventID,"eventID/I");
-
-   Int_t nentries=(Int_t)oldTree->GetEntries();
+   vector<string> noTime;
+   if(!ScanRunIDs(name,noTime,-1,m_shifts)) return false;
 
-   if (j==0) offset=0;
-   else offset+=m_lastEvents[currentfile];
-   currentfile++;
-
-   for(int i=0;i<nentries;i++)
-     {
-      branch->GetEvent(i);
-      if(lastRun!=runID)
-        {
-         lastRun=runID;
-         offset=0;
-        }
-      eventID+=offset;
-      newBranch->Fill();
-    }
-  oldTree->Write();
-  }
-  return true;
+   vector<int> files;
+   for(unsigned int j=0;j<m_shifts.size();j++) if(m_shifts[j].nentries>0) files.push_back(j);
+   if(files.empty()) {
+      if(m_verboseLevel>1) cout<<name<<" is empty!"<<endl;
+      return false;
+   }
+   m_taskTreeName   = name;
+   m_taskIDBranches = idBranches;
+   if(m_verboseLevel>1) cout<<"Correcting the eventIDs of "<<name<<" in "<<files.size()<<" files"<<endl;
+   return RunInWorkers(files,&GateMergeManager::AddClusterIDs);
 }
 
 /*******************************************************************************************/
-bool GateMergeManager::FastMergeCoin(string name)
+// worker of FastMergeIDTree
+bool GateMergeManager::AddClusterIDs(int j)
 {
-//create the output file
-int eventID1 = 0;
-int eventID2 = 0;
-int runID = 0;
-int offset      = 0;
-int currentfile = 0;
-float lastRun =-1;
-string clusterName=name+"_cluster";
-cout<<"starting coincidence merging..."<<endl;
-for(int j=0;j<m_Nfiles;j++)
- {
-cout<<"working on file..."<<j<<endl;
-   filearr[j]->ReOpen("UPDATE");
-   TTree *oldTree = (TTree*)gDirectory->Get(name.c_str());
-   TBranch *branch1  = oldTree->GetBranch("eventID1");
-   branch1->SetAddress(&eventID1);
-   TBranch *branch2  = oldTree->GetBranch("eventID2");
-   branch2->SetAddress(&eventID2);
-   TBranch *branch3  = oldTree->GetBranch("runID");
-   branch3->SetAddress(&runID);
-
-   TBranch* newBranch1=oldTree->Branch("eventID1cluster",&eventID1,"eventID1/I");
-   TBranch* newBranch2=oldTree->Branch("eventID2cluster",&eventID2,"eventID2/I");
-
-   Int_t nentries=(Int_t)oldTree->GetEntries();
-
-   if (j==0) offset=0;
-   else offset+=m_lastEvents[currentfile];
-   cout<<"the offset in this file is: "<<offset<<endl;
-   currentfile++;
+   const FileShift& shift=m_shifts[j];
+   TFile* file = TFile::Open(m_vRootFileNames[j].c_str(),"UPDATE");
+   if(file==NULL){
+      cout<<"Not a writable file "<<m_vRootFileNames[j]<<endl;
+      return false;
+   }
+   TTree *oldTree = (TTree*)file->Get(m_taskTreeName.c_str());
+
+   unsigned int nIDs=m_taskIDBranches.size();
+   vector<int> ids(nIDs,0);
+   vector<TBranch*> branches(nIDs);
+   vector<TBranch*> newBranches(nIDs);
+   for(unsigned int k=0;k<nIDs;k++) {
+      const string& id=m_taskIDBranches[k];
+      branches[k]=oldTree->GetBranch(id.c_str());
+      branches[k]->SetAddress(&ids[k]);
+      newBranches[k]=oldTree->Branch((id+"cluster").c_str(),&ids[k],(id+"/I").c_str());
+   }
 
-   for(int i=0;i<nentries;i++){
-       branch1->GetEvent(i);
-       branch2->GetEvent(i);
-       branch3->GetEvent(i);
-       if(lastRun!=runID) 
-        {
-         lastRun=runID;
-         offset=0; 
-        }
-       eventID1+=offset;
-       eventID2+=offset;
-       newBranch1->Fill();
-       newBranch2->Fill();
-    }
-    oldTree->Write();
- }
-    return true;
+   for(Long64_t i=0;i<shift.nentries;i++) {
+      for(unsigned int k=0;k<nIDs;k++) {
+         branches[k]->GetEntry(i);
+         if(i<shift.nToShift) ids[k]+=shift.offset;
+         newBranches[k]->Fill();
+      }
+   }
+   oldTree->Write();
+   file->Close();
+   delete file;
+   return true;
 }
 
 /*******************************************************************************************/
@@ -629,124 +646,234 @@ bool GateMergeManager::MergeGate(TChain* chainG) {
 }
 
 /*******************************************************************************************/
-// Singles and Hits tree merger
-bool GateMergeManager::MergeSing(TChain* chainS){
+// Hits, Singles and Coincidences tree merger
+// The eventIDs of each file are shifted by the last eventIDs of the files
+// before it, until the first change of runID (a new run in a file must not
+// be changed). Only the files with a non zero shift are rewritten, by worker
+// processes, then all the files are appended to the output tree by copying
+// their compressed baskets.
+bool GateMergeManager::MergeIDTree(string name,const vector<string>& idBranches,
+                                   const vector<string>& timeBranches){
+
+   if(!ScanRunIDs(name,timeBranches,0,m_shifts)) return false;
+
+   Long64_t nentries=0;
+   for(unsigned int j=0;j<m_shifts.size();j++) nentries+=m_shifts[j].nentries;
+   if(nentries<=0) {
+      if(m_verboseLevel>1) cout<<name<<" is empty!"<<endl;
+      return false;
+   }
+
+   // check for overlaping time intervalls between different files
+   // (not within the same file i.e. no time order assumed)
+   double maxtime   =-999999999;
+   for(unsigned int j=0;j<m_shifts.size();j++) {
+      if(m_shifts[j].nentries==0) continue;
+      if(m_shifts[j].firstTime<maxtime && m_verboseLevel>0)
+         cout<<"Warning - overlapping "<<name<<" time ("
+             <<m_shifts[j].firstTime<<") in file: "<<m_vRootFileNames[j].c_str()<<endl;
+      if(maxtime<m_shifts[j].maxTime) maxtime=m_shifts[j].maxTime;
+   }
+
+   // the files whose eventIDs change
+   vector<int>  shifted;
+   vector<bool> isShifted(m_shifts.size(),false);
+   for(unsigned int j=0;j<m_shifts.size();j++) {
+      if(m_shifts[j].nToShift>0 && m_shifts[j].offset!=0) {
+         shifted.push_back(j);
+         isShifted[j]=true;
+      }
+   }
+   m_taskTreeName   = name;
+   m_taskIDBranches = idBranches;
+   if(m_verboseLevel>1) cout<<"Correcting the eventIDs of "<<name<<" in "<<shifted.size()<<" files"<<endl;
+   bool ok=RunInWorkers(shifted,&GateMergeManager::ShiftIDs);
+
+   TTree* newTree=NULL;
+   for(unsigned int j=0;ok && j<m_shifts.size();j++) {
+      if(m_shifts[j].nentries==0) continue;
+      string source = isShifted[j] ? TemporaryFileName(j) : m_vRootFileNames[j];
+      TFile* file = TFile::Open(source.c_str(),"READ");
+      if(file==NULL) {
+         cout<<"Not a readable file "<<source<<endl;
+         ok=false;
+         break;
+      }
+      TTree* tree = (TTree*)file->Get(name.c_str());
+      m_RootTarget->cd();
+      if(newTree==NULL) {
+         newTree = tree->CloneTree(0);
+         newTree->SetAutoSave(2000000000);
+         if(m_maxRoot!=0) newTree->SetMaxTreeSize(m_maxRoot);
+         else newTree->SetMaxTreeSize(17179869184LL);
+
+         // changing CompLevel everywhere
+         TBranch *br;
+         TIter next(newTree->GetListOfBranches());
+         while ((br=(TBranch*)next())) br->SetCompressionLevel(m_CompLevel);
+      }
+      newTree->CopyEntries(tree,-1,"fast");
+      file->Close();
+      delete file;
+   }
+   for(unsigned int k=0;k<shifted.size();k++) remove(TemporaryFileName(shifted[k]).c_str());
 
-   int nentriesS=chainS->GetEntries();
+   if(newTree) {
+      newTree->Write();
+      delete newTree;
+   }
+   return ok;
+}
 
-   int eventID = 0;
-   int runID   = 0;
-   double time = 0;
+/*******************************************************************************************/
+// worker of MergeIDTree: copy of one file with the shifted eventIDs
+bool GateMergeManager::ShiftIDs(int j){
 
-   chainS->SetBranchAddress("eventID",&eventID);
-   chainS->SetBranchAddress("runID",&runID);
-   chainS->SetBranchAddress("time",&time);
+   const FileShift& shift=m_shifts[j];
+   TFile* input = TFile::Open(m_vRootFileNames[j].c_str(),"READ");
+   if(input==NULL) {
+      cout<<"Not a readable file "<<m_vRootFileNames[j]<<endl;
+      return false;
+   }
+   TTree* tree = (TTree*)input->Get(m_taskTreeName.c_str());
 
-   m_RootTarget->cd();
-   TTree * newSing = chainS->CloneTree(0);
-   newSing->SetAutoSave(2000000000);
-   if(m_maxRoot!=0) newSing->SetMaxTreeSize(m_maxRoot);
-   else newSing->SetMaxTreeSize(17179869184LL);
+   vector<int> ids(m_taskIDBranches.size(),0);
+   for(unsigned int k=0;k<ids.size();k++) tree->SetBranchAddress(m_taskIDBranches[k].c_str(),&ids[k]);
 
-   // changing CompLevel everywhere
+   string outputName=TemporaryFileName(j);
+   TFile* output = TFile::Open(outputName.c_str(),"RECREATE");
+   if(output==NULL) {
+      cout<<"Cannot create "<<outputName<<endl;
+      input->Close();
+      delete input;
+      return false;
+   }
+   TTree* newTree = tree->CloneTree(0);
+   newTree->SetAutoSave(2000000000);
+   // the baskets are written every 32 MB: the memory does not grow with the file
+   newTree->SetAutoFlush(-32000000);
    TBranch *br;
-   TIter next(newSing->GetListOfBranches());
+   TIter next(newTree->GetListOfBranches());
    while ((br=(TBranch*)next())) br->SetCompressionLevel(m_CompLevel);
 
-   //the main part: changing eventID
-   int offset      = 0;
-   int currentTree = 0;
-   float lastRun   = 0;
-   float maxtime   =-999999999;
-   for(int i=0;i<nentriesS;i++){
-         if(chainS->GetEntry(i) <= 0) break; //end of chain
-         if(chainS->GetTreeNumber()>currentTree) {
-           currentTree++;
-            offset+=m_lastEvents[currentTree];
-           // check for overlaping time intervalls between different files
-           // (not within the same file i.e. no time order assumed)
-           if(time<maxtime) 
-               if(m_verboseLevel>0) 
-                  cout<<"Warning - overlapping Singles time ("
-                      <<time<<") in file: "<<m_vRootFileNames[currentTree].c_str()<<endl;
+   for(Long64_t i=0;i<shift.nentries;i++) {
+      tree->GetEntry(i);
+      if(i<shift.nToShift)
+         for(unsigned int k=0;k<ids.size();k++) ids[k]+=shift.offset;
+      newTree->Fill();
+   }
+   output->cd();
+   newTree->Write();
+   output->Close();
+   delete output;
+   input->Close();
+   delete input;
+   return true;
+}
+
+/*******************************************************************************************/
+// copy of file j with the shifted eventIDs, next to the output file
+std::string GateMergeManager::TemporaryFileName(int j){
+   stringstream name;
+   name<<m_RootTargetName.substr(0,m_RootTargetName.rfind(".root"))<<".mergetmp"<<j<<".root";
+   return name.str();
+}
+
+/*******************************************************************************************/
+// Reads only the runID (and time) columns of all the files and replays the
+// offset bookkeeping of the sequential merge: file j gets the offset
+// accumulated from m_lastEvents, which is dropped at the first runID change
+bool GateMergeManager::ScanRunIDs(string name,const vector<string>& timeBranches,
+                                  float lastRun,vector<FileShift>& shifts){
+
+   shifts.resize(m_vRootFileNames.size());
+   int offset = 0;
+   for(unsigned int j=0;j<m_vRootFileNames.size();j++) {
+      FileShift& shift=shifts[j];
+      shift.nentries  = 0;
+      shift.nToShift  = 0;
+      shift.firstTime = 0;
+      shift.maxTime   =-999999999;
+      if(j>0) offset+=m_lastEvents[j];
+      shift.offset    = offset;
+
+      TFile* file = TFile::Open(m_vRootFileNames[j].c_str(),"READ");
+      if(file==NULL) {
+         cout<<"Not a readable file "<<m_vRootFileNames[j]<<endl;
+         return false;
+      }
+      TTree* tree = (TTree*)file->Get(name.c_str());
+      if(tree==NULL) {
+         file->Close();
+         delete file;
+         continue;
+      }
+      int runID = 0;
+      vector<double> times(timeBranches.size(),0);
+      tree->SetBranchStatus("*",0);
+      tree->SetBranchStatus("runID",1);
+      tree->SetBranchAddress("runID",&runID);
+      for(unsigned int k=0;k<times.size();k++) {
+         tree->SetBranchStatus(timeBranches[k].c_str(),1);
+         tree->SetBranchAddress(timeBranches[k].c_str(),&times[k]);
+      }
+
+      shift.nentries = tree->GetEntries();
+      shift.nToShift = shift.nentries;
+      for(Long64_t i=0;i<shift.nentries;i++) {
+         tree->GetEntry(i);
+         for(unsigned int k=0;k<times.size();k++) {
+            if(i==0 && (k==0 || times[k]<shift.firstTime)) shift.firstTime=times[k];
+            if(shift.maxTime<times[k]) shift.maxTime=times[k];
          }
-         // the offset to get a unique event numbering
          if(lastRun!=runID) {
-            // run end 
+            // run end: new run in file we must not change the eventID anymore
             lastRun=runID;
-            offset=0;     //new run in file we must not change the eventID anymore
+            if(shift.nToShift==shift.nentries) shift.nToShift=i;
+            offset=0;
          }
-         eventID+=offset;
-         newSing->Fill();
-         if(maxtime<time)maxtime=time;
-    }
-    newSing->Write();
-    delete newSing;
-    return true;
+      }
+      file->Close();
+      delete file;
+   }
+   return true;
 }
 
 /*******************************************************************************************/
-// Coincidences tree merger
-bool GateMergeManager::MergeCoin(TChain* chainC){
-
-   int nentriesC=chainC->GetEntries();
-
-    int eventID1 = 0;
-    chainC->SetBranchAddress("eventID1",&eventID1);
-    double time1 = 0;
-    chainC->SetBranchAddress("time1",&time1);
-    int eventID2 = 0;
-    chainC->SetBranchAddress("eventID2",&eventID2);
-    double time2 = 0;
-    chainC->SetBranchAddress("time2",&time2);
-    int runID    = 0;
-    chainC->SetBranchAddress("runID",&runID);
-
-    m_RootTarget->cd();
-    TTree * newCoin = chainC->CloneTree(0);
-    newCoin->SetAutoSave(2000000000);
-    if(m_maxRoot!=0) newCoin->SetMaxTreeSize(m_maxRoot);
-    else newCoin->SetMaxTreeSize(17179869184LL);
-
-    // changing CompLevel everywhere
-    TBranch *br;
-    TIter next(newCoin->GetListOfBranches());
-    while ((br=(TBranch*)next())) br->SetCompressionLevel(m_CompLevel);
-
-    int offset      = 0;
-    int currentTree = 0;
-    float lastRun   = 0;
-    float maxtime   =-999999999;
-    for(int i=0;i<nentriesC;i++){
-       if(chainC->GetEntry(i) <= 0) break; //end of chain
-       if(chainC->GetTreeNumber()>currentTree) {
-         currentTree++;
-         offset+=m_lastEvents[currentTree];
-         // check for overlaping time intervalls between different files
-         // (not within the same file i.e. no time order assumed)
-         if(time1<maxtime) 
-           if(m_verboseLevel>0)
-               cout<<"Warning - overlapping Coincidences time1 ("
-                   <<time1<<") in file: "<<m_vRootFileNames[currentTree].c_str()<<endl;
-         if(time2<maxtime) 
-           if(m_verboseLevel>0)
-               cout<<"Warning - overlapping Coincidences time2 ("
-                   <<time2<<") in file: "<<m_vRootFileNames[currentTree].c_str()<<endl;
-       }
-       // the offset to get a unique event numbering
-       if(lastRun!=runID) {
-          // run end
-          lastRun=runID;
-          offset=0; //new run in file we must not change the eventID anymore
-       }
-       eventID1+=offset;
-       eventID2+=offset;
-       newCoin->Fill();
-       if(maxtime<time1)maxtime=time1;
-       if(maxtime<time2)maxtime=time2;
-    }
-    newCoin->Write();
-    delete newCoin;
-    return true;
+// Runs task(j) for all the given files, in at most m_nJobs child processes
+// at the same time. The children share nothing with the parent but the
+// input files, and must leave with _exit: the ROOT cleanup at exit would
+// write the parent's output file.
+bool GateMergeManager::RunInWorkers(const vector<int>& files,FileTask task){
+
+   bool ok=true;
+   if(m_nJobs<=1 || files.size()<=1) {
+      for(unsigned int k=0;k<files.size();k++) ok = (this->*task)(files[k]) && ok;
+      return ok;
+   }
+
+   unsigned int next=0;
+   int running=0;
+   while(next<files.size() || running>0) {
+      while(running<m_nJobs && next<files.size()) {
+         cout.flush();
+         pid_t pid=fork();
+         if(pid<0) {
+            // no more processes: do it here
+            ok = (this->*task)(files[next]) && ok;
+         } else if(pid==0) {
+            bool done=(this->*task)(files[next]);
+            cout.flush();
+            _exit(done ? 0 : 1);
+         } else running++;
+         next++;
+      }
+      if(running==0) continue;
+      int status=0;
+      if(wait(&status)<0) break;
+      running--;
+      if(!WIFEXITED(status) || WEXITSTATUS(status)!=0) ok=false;
+   }
+   return ok;
 }
 /*******************************************************************************************/
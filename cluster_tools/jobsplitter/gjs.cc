@@ -13,6 +13,7 @@ See GATE/LICENSE.txt for further details
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <unistd.h>
 #include "GateSplitManager.hh"
 using std::string;
 using namespace std;
@@ -30,13 +31,17 @@ void showhelp()
 	cout<<"  -a value alias             : use any alias"<<endl;
 	cout<<"  -numberofsplits, -n   n    : the number of job splits; default=1"<<endl;
 	cout<<"  -clusterplatform, -c  name : the cluster platform, name is one of the following:"<<endl;
-	cout<<"                               openmosix - condor - openPBS - xgrid"<<endl;
+	cout<<"                               openmosix - condor - openPBS - xgrid - local"<<endl;
+	cout<<"                               local runs the splits on this machine and merges the outputs with gjm"<<endl;
 	cout<<"                               This executable is compiled with "<<GC_DEFAULT_PLATFORM<<" as default"<<endl<<endl;
 	cout<<"  -openPBSscript, os         : template for an openPBS script "<<endl;
 	cout<<"                               see the example that comes with the source code (script/openPBS.script)"<<endl;
 	cout<<"                               overrules the environment variable below"<<endl<<endl; 
 	cout<<"  -condorscript, cs          : template for a condor submit file"<<endl;
 	cout<<"                               see the example that comes with the source code (script/condor.script)"<<endl;
+	cout<<"  -j n                       : local platform: number of Gate processes; default=number of cores"<<endl;
+	cout<<"                               each process takes the next split when it is done, use more splits"<<endl;
+	cout<<"                               than processes (default=4 splits per process)"<<endl;
 	cout<<"  -v                         : verbosity 0 1 2 3 - 1 default "<<endl;
 	cout<<endl;
 	cout<<"  Environment variables:"<<endl;
@@ -53,6 +58,7 @@ void showhelp()
 	cout<<"    gjs -numberofsplits 10 -clusterplatform openmosix -a /somedir/rootfilename ROOT_FILE macro.mac"<<endl<<endl;
 	cout<<"    gjs -numberofsplits 10 -clusterplatform openPBS -openPBSscript /somedir/script macro.mac"<<endl<<endl;
 	cout<<"    gjs -numberofsplits 10 -clusterplatform xgrid macro.mac"<<endl<<endl;
+	cout<<"    gjs -numberofsplits 256 -clusterplatform local -j 64 macro.mac"<<endl<<endl;
 	cout<<"    gjs -numberofsplits 10  /somedir/script macro.mac"<<endl<<endl;
 	exit(0);
 }
@@ -70,6 +76,7 @@ int main(int argc,char** argv)
 	G4int nAliases=0;
 	G4int time=0;
 	G4int verb=1;
+	G4int nJobs=sysconf(_SC_NPROCESSORS_ONLN);
 	aliases=new G4String[argc];
 	
 	int debug=0;
@@ -102,6 +109,13 @@ int main(int argc,char** argv)
 			nextArg-=1;
 			if(debug)cout<<"found -time "<<time<<endl;
 		}   
+		if (!strcmp(argv[nextArg],"-j") && indicator==0)
+		{
+			indicator=1;
+			stringstream ss(argv[nextArg+1]);
+			ss>>nJobs;
+			if(debug)cout<<"found -j "<<nJobs<<endl;
+		} 
 		if (!strcmp(argv[nextArg],"-v") && indicator==0)
 		{
 			indicator=1;
@@ -158,7 +172,7 @@ int main(int argc,char** argv)
 		}
 	} 
 	
-	if (platform=="" || platform=="openmosix" || platform=="openPBS" || platform=="condor"|| platform=="xgrid")
+	if (platform=="" || platform=="openmosix" || platform=="openPBS" || platform=="condor"|| platform=="xgrid" || platform=="local")
 	{  
 		if (platform=="")
 		{
@@ -199,6 +213,12 @@ int main(int argc,char** argv)
 	}
 	
 	if(debug) cout<<"nSplits "<<nSplits<<endl;
+	if (nJobs<=0) nJobs=1;
+	if (platform=="local" && nSplits<=0)
+	{
+		nSplits=4*nJobs;
+		if(verb>1)cout<<"Information : using "<<nSplits<<" splits for "<<nJobs<<" local processes"<<endl; 
+	}
 	if (nSplits<=0)
 	{
 		nSplits=1;
@@ -208,6 +228,7 @@ int main(int argc,char** argv)
 	GateSplitManager* manager;
 	manager=new GateSplitManager(nAliases,aliases,platform,pbsscript,condorscript,macfile,nSplits,time);
 	manager->SetVerboseLevel(verb);
+	manager->SetNumberOfLocalJobs(nJobs);
 	manager->StartSplitting();
 	
 	delete[] aliases;   
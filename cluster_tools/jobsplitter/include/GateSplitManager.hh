@@ -24,6 +24,7 @@ public:
   GateSplitManager(G4int nAliases,G4String* aliases,G4String platform,G4String pbsscript,G4String condorscript,G4String macfile,G4int nSplits,G4int time);
   ~GateSplitManager();
   void SetVerboseLevel(G4int value) { m_verboseLevel = value; };
+  void SetNumberOfLocalJobs(G4int value) { toPlatform->SetNumberOfLocalJobs(value); };
   void StartSplitting();
 
 protected:
@@ -23,6 +23,7 @@ public:
   GateToPlatform(G4int numberOfSplits, G4String thePlatform, G4String pbsscript,G4String theCondorScript,G4String outputMacName,G4int time);
   ~GateToPlatform();
   void SetVerboseLevel(G4int value) { m_verboseLevel = value; };
+  void SetNumberOfLocalJobs(G4int value) { localJobs = value; };
   int GenerateSubmitfile(G4String outputMacDir);
 
 protected: 
@@ -31,6 +32,7 @@ protected:
   int GenerateOpenPBSScriptfile();
   int GenerateCondorSubmitfile();
   int GenerateXgridSubmitfile();    
+  int RunLocalJobs();
   G4int m_verboseLevel;  
   G4int nSplits;
   G4String platform;
@@ -39,6 +41,7 @@ protected:
   G4String outputMacfilename;
   G4String outputDir;
   G4int useTiming;
+  G4int localJobs;
 };
 #endif
 
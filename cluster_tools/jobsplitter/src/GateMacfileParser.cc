@@ -897,8 +897,13 @@ void GateMacfileParser::SearchForActors(G4int splitNumber,ofstream& output, ofst
     // If it is the case we registered this actor as enabled and we split its filename
     if (findInList)
     {
+      G4String key = "/gate/actor/"+actorName+"/save";
+      G4String originalFileName = ExtractFileName(key);
       AddSplitNumberWithExtension(splitNumber);
-      AddPWD("/gate/actor/"+actorName+"/save");
+      AddPWD(key);
+      // for the merger: type, name, original and split file names
+      splitfile<<"Actor filename: "<<listOfEnabledActorType.back()<<" "<<actorName<<" "
+               <<originalFileName<<" "<<ExtractFileName(key)<<endl;
     }
     // Else, it is an error, this actor does not exist !
     else
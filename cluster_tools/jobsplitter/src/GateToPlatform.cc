@@ -15,7 +15,13 @@ See GATE/LICENSE.txt for further details
 #include <sstream> 
 #include <fstream> 
 #include <cstdlib> 
+#include <map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
 
 #include "GateToPlatform.hh"
 
@@ -32,6 +38,7 @@ GateToPlatform::GateToPlatform(G4int numberOfSplits, G4String thePlatform, G4Str
 	pbsScript=thePbsscript;
 	condorScript=theCondorScript;
 	useTiming=time;
+	localJobs=1;
 	outputMacfilename=outputMacName.substr(0,outputMacName.length()-4);
 }
 
@@ -62,6 +69,10 @@ int GateToPlatform::GenerateSubmitfile(G4String outputMacDir)
 		err+=GenerateXgridSubmitfile();
 		if (err>0) return 1;
 	} 
+	if (platform=="local"){
+		err+=RunLocalJobs();
+		if (err>0) return 1;
+	} 
 	return(0);
 }
 
@@ -286,4 +297,105 @@ int GateToPlatform::GenerateXgridSubmitfile()
 	return 0;
 }
 
+/*the local platform: localJobs Gate processes run the splits on this machine.
+A process takes the next split as soon as it is done with the previous one,
+so many short splits keep all the processes busy until the end. The outputs
+are merged with gjm when all splits are done.*/
+int GateToPlatform::RunLocalJobs()
+{
+	G4String dir=getenv("GC_GATE_EXE_DIR");
+	if (dir.substr(dir.length()-1,dir.length())!="/") dir=dir+"/"; 
+	
+	//check if we have an existing directory
+	ifstream dirstream(dir.c_str());
+	if (!dirstream) { 
+		cout<<"Error : Failed to detect the Gate executable directory"<<endl;
+		cout<<"Please check your environment variables!"<<endl; 
+		return(1);
+	}
+	dirstream.close();
+	G4String gate=dir+"Gate";
+	G4String splitfileName=outputDir+".split";
+
+	std::map<pid_t,G4int> running;
+	std::map<G4int,timeval> startTimes;
+	std::vector<G4int> failed;
+	G4int next=1;
+	G4int done=0;
+	if (m_verboseLevel>0) cout<<"Running "<<nSplits<<" splits with "<<localJobs<<" processes"<<endl;
+	cout.flush();
+	while (next<=nSplits || running.size()>0)
+	{
+		while ((G4int)running.size()<localJobs && next<=nSplits)
+		{
+			ostringstream mac, log;
+			mac<<outputDir<<next<<".mac";
+			log<<outputDir<<next<<".log";
+			pid_t pid=fork();
+			if (pid<0)
+			{
+				cout<<"Error : could not start a Gate process for split "<<next<<endl;
+				failed.push_back(next);
+			}
+			else if (pid==0)
+			{
+				int fd=open(log.str().c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+				if (fd>=0)
+				{
+					dup2(fd,1);
+					dup2(fd,2);
+					close(fd);
+				}
+				execl(gate.c_str(),"Gate",mac.str().c_str(),(char*)0);
+				_exit(127);
+			}
+			else
+			{
+				running[pid]=next;
+				gettimeofday(&startTimes[next],NULL);
+				if (m_verboseLevel>1) cout<<"Information : starting split "<<next<<endl;
+			}
+			next++;
+		}
+		if (running.size()==0) continue;
+		int status=0;
+		pid_t pid=wait(&status);
+		if (pid<0) break;
+		std::map<pid_t,G4int>::iterator job=running.find(pid);
+		if (job==running.end()) continue;
+		G4int split=job->second;
+		running.erase(job);
+		done++;
+		if (!WIFEXITED(status) || WEXITSTATUS(status)!=0)
+		{
+			cout<<"Error : split "<<split<<" failed, see "<<outputDir<<split<<".log"<<endl;
+			failed.push_back(split);
+		}
+		else if (m_verboseLevel>0)
+		{
+			cout<<"Split "<<split<<" done ("<<done<<"/"<<nSplits<<")";
+			if (useTiming==1)
+			{
+				timeval end;
+				gettimeofday(&end,NULL);
+				cout<<" in "<<(end.tv_sec-startTimes[split].tv_sec)+(end.tv_usec-startTimes[split].tv_usec)*1e-6<<" s";
+			}
+			cout<<endl;
+		}
+	}
 
+	// the macros and the logs are kept for the failed splits
+	if (failed.size()>0)
+	{
+		cout<<"Error : "<<failed.size()<<" split(s) failed, the outputs are not merged"<<endl;
+		cout<<"Rerun them with: "<<gate<<" "<<outputDir<<"<split>.mac, then: gjm "<<splitfileName<<endl;
+		return 0;
+	}
+	ostringstream merge;
+	merge<<"gjm -j "<<localJobs<<" "<<splitfileName;
+	if (m_verboseLevel>0) cout<<"Merging: "<<merge.str()<<endl;
+	cout.flush();
+	if (system(merge.str().c_str())!=0)
+		cout<<"Error : the merge failed, run it with: "<<merge.str()<<endl;
+	return 0;
+}
@@ -102,6 +102,10 @@ public:
 
   G4int GetCurrentEventId() const { return mCurrentEventId; }
 
+  /// Identifies the current step for the results shared by the actors
+  /// during a step (filters, voxel index). See UserSteppingAction.
+  unsigned long GetStepStamp() const { return mStepStamp; }
+
 protected:
   //std::vector<GateMultiSensitiveDetector*> theListOfMultiSensitiveDetector;
   std::vector<GateVActor*> theListOfActors;
@@ -115,6 +119,7 @@ protected:
 
   GateActorManagerMessenger* pActorManagerMessenger;  //pointer to the Messenger
   G4int mCurrentEventId;
+  unsigned long mStepStamp;
 
 private:
   int IsInitialized;
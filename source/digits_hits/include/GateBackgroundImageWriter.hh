@@ -0,0 +1,80 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+/*
+  \class  GateBackgroundImageWriter
+  \brief  Thread writing image snapshots while the simulation goes on.
+
+  Jobs (GateVBackgroundImageJob) are run one after the other, in the
+  order of submission, by a single thread started at the first
+  submission. A job is not owned by the writer and can be submitted
+  again once it is done (see Wait). All jobs are waited for at the end
+  of each run (GateUserActions::EndOfRunAction).
+
+  A job must not print (GateMessage is not thread-safe) nor use ROOT: it
+  gives its status lines in mMessages, printed later by the main thread.
+*/
+
+#ifndef GATEBACKGROUNDIMAGEWRITER_HH
+#define GATEBACKGROUNDIMAGEWRITER_HH
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+//-----------------------------------------------------------------------------
+class GateVBackgroundImageJob
+{
+ public:
+  virtual ~GateVBackgroundImageJob() {}
+  virtual void Run() = 0;
+
+  // Status lines of the last Run
+  std::vector<std::string> mMessages;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GateBackgroundImageWriter
+{
+ public:
+  static GateBackgroundImageWriter * GetInstance() {
+    if (pInstance == 0) pInstance = new GateBackgroundImageWriter();
+    return pInstance;
+  }
+  ~GateBackgroundImageWriter();
+
+  void Submit(GateVBackgroundImageJob * job);
+  // Wait until this job is neither pending nor running
+  void Wait(GateVBackgroundImageJob * job);
+  void WaitAll();
+
+ protected:
+  GateBackgroundImageWriter();
+  static void * ThreadMain(void * writer);
+  void Loop();
+  bool IsInProgress(GateVBackgroundImageJob * job) const;
+  // Prints the messages of the jobs done (main thread only)
+  void PrintMessages();
+
+  static GateBackgroundImageWriter * pInstance;
+  pthread_t mThread;
+  pthread_mutex_t mMutex;
+  pthread_cond_t mJobSubmitted;
+  pthread_cond_t mJobDone;
+  std::deque<GateVBackgroundImageJob*> mJobs;
+  GateVBackgroundImageJob * pRunningJob;
+  std::vector<std::string> mMessages;
+  bool mIsThreadStarted;
+  bool mStop;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEBACKGROUNDIMAGEWRITER_HH */
@@ -68,6 +68,10 @@ class GateBlurring : public GateVPulseProcessor
     //! The result of the pulse-processing is incorporated into the output pulse-list
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
 
+    //! In-place version of ProcessOnePulse(), used when in-place processing is enabled for the chain
+    G4bool IsInPlaceProcessingSupported() const { return true; }
+    G4bool ProcessOnePulseInPlace(GatePulse* pulse);
+
   private:
     GateVBlurringLaw* m_blurringLaw;
     GateBlurringMessenger *m_messenger;   //!< Messenger
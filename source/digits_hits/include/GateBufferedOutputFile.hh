@@ -0,0 +1,89 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+/*!
+  \class  GateBufferedOutputFile
+  \brief  Output file written by large blocks, used by GateToBinary and GateToASCII
+
+  The records are copied (binary) or formatted (ASCII) in a block in memory.
+  When the block is full, it is written by a background thread while the
+  records are stored in a second block, so that the simulation does not
+  wait for the disk.
+*/
+
+#ifndef GATEBUFFEREDOUTPUTFILE_HH
+#define GATEBUFFEREDOUTPUTFILE_HH
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "globals.hh"
+
+class GateBufferedOutputFile
+{
+public:
+  GateBufferedOutputFile(size_t blockSize = 4*1024*1024);
+  ~GateBufferedOutputFile();
+
+  //! Opens (truncates) the file and starts the writing thread
+  bool Open(const G4String& fileName);
+  //! Writes the last block and closes the file
+  void Close();
+  inline bool IsOpen() const { return m_file != 0; }
+  //! Number of bytes stored since Open (written or not)
+  inline long Tellp() const { return m_bytes + m_size; }
+
+  //! Binary output: raw copy of the data (nothing if the file is not open)
+  inline void Write(const void* data, size_t size) {
+    if (!m_file) return;
+    if (m_size + size > m_blockSize) WriteLarge(data, size);
+    else {
+      memcpy(&m_blocks[m_current][m_size], data, size);
+      m_size += size;
+    }
+  }
+
+  //! ASCII output, same result as the std::ostream operators
+  inline void Put(char c) {
+    if (!m_file) return;
+    if (m_size == m_blockSize) Flush();
+    m_blocks[m_current][m_size++] = c;
+  }
+  inline void PutString(const std::string& s) { Write(s.data(), s.size()); }
+  //! like << std::setw(width) << value
+  void PutInt(long value, int width = 0);
+  //! like << std::scientific << std::setw(width) << std::setprecision(precision) << value
+  void PutScientific(double value, int width, int precision);
+
+private:
+  //! Hands the current block to the writing thread
+  void Flush();
+  void WriteLarge(const void* data, size_t size);
+  static void* WriteBlocks(void* file);
+
+  size_t            m_blockSize;
+  std::vector<char> m_blocks[2];
+  int               m_current;       //!< block being filled
+  size_t            m_size;          //!< bytes in the current block
+  long              m_bytes;         //!< bytes of the blocks already handed
+  FILE*             m_file;
+
+  pthread_t         m_thread;
+  bool              m_threadStarted;
+  pthread_mutex_t   m_mutex;
+  pthread_cond_t    m_condition;
+  bool              m_pending;       //!< the other block is being written
+  int               m_pendingBlock;
+  size_t            m_pendingSize;
+  bool              m_stop;
+};
+
+#endif
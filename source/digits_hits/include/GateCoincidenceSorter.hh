@@ -14,6 +14,7 @@ See GATE/LICENSE.txt for further details
 #include <iostream>
 #include <list>
 #include <deque>
+#include <vector>
 #include "G4ThreeVector.hh"
 
 #include "GateCoincidencePulse.hh"
@@ -49,6 +50,9 @@ typedef enum {kKillAll,
               kKeepIfAnyIsGood,
               kKeepAll} multiple_policy_t;
 
+typedef enum {kPresortList,
+              kPresortHeap} presort_method_t;
+
 
 class GateCoincidenceSorter : public GateClockDependent
 {
@@ -117,6 +121,10 @@ class GateCoincidenceSorter : public GateClockDependent
      void SetPresortBufferSize(G4int size)
        { m_presortBufferSize = size; }
 
+     //! Presort buffer implementation: "list" (sorted list, linear insertion)
+     //! or "heap" (binary heap). Both give the same coincidences.
+     void SetPresortMethod(const G4String& method);
+
      //@}
 
      //! \name Methods for coincidence sorting
@@ -158,10 +166,27 @@ class GateCoincidenceSorter : public GateClockDependent
     //! \name Work storage variable
     //@{
 
+    //! Entry of the heap presort buffer. Pulses with the same time are
+    //! ordered by arrival, as in the list presort buffer.
+    struct PresortEntry {
+      G4double   time;
+      G4long     order;
+      GatePulse* pulse;
+      inline bool operator<(const PresortEntry& right) const
+        { return (time > right.time) || (time == right.time && order > right.order); }
+    };
+
     std::list<GatePulse*> m_presortBuffer;      // incoming pulses are presorted and buffered
+    std::vector<PresortEntry> m_presortHeap;    // same, kPresortHeap method (front is the earliest)
+    G4long                m_presortOrder;       // arrival counter, kPresortHeap method
+    presort_method_t      m_presortMethod;
     G4int                 m_presortBufferSize;
     G4bool                m_presortWarning;     // avoid repeat warnings
 
+    void PresortPulse(GatePulse* pulse);
+    G4int GetPresortedPulseNumber() const;
+    GatePulse* PopEarliestPresortedPulse();
+
     std::deque<GateCoincidencePulse*> m_coincidencePulses;  // open coincidence windows
 
     void ProcessCompletedCoincidenceWindow(GateCoincidencePulse*);
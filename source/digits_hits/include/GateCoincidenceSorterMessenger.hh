@@ -64,6 +64,7 @@ class GateCoincidenceSorterMessenger: public GateClockDependentMessenger
     G4UIcmdWithAnInteger        *minSectorDiffCmd;   //!< the UI command 'minSectorDifference'
     G4UIcmdWithAnInteger        *setDepthCmd;        //!< the UI command 'setDepth'
     G4UIcmdWithAnInteger        *setPresortBufferSizeCmd;  //!< the UI command 'setPresortBufferSize'
+    G4UIcmdWithAString          *setPresortMethodCmd;      //!< the UI command 'setPresortMethod'
     G4UIcmdWithAString          *SetInputNameCmd;    //!< The UI command "set input name"
     G4UIcmdWithAString          *MultiplePolicyCmd;  //!< The UI command "MultiplesPolicy"
     G4UIcmdWithABool            *AllPulseOpenCoincGateCmd;  //!< The UI command "allowMultiples"
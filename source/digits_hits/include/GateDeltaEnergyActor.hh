@@ -70,7 +70,6 @@ protected:
 
   int mCurrentEvent;
 
-  bool mIsLastHitEventImageEnabled;
   bool mIsStopPowerImageEnabled;
   bool mIsRelStopPowerImageEnabled;
   bool mIsNumberOfHitsImageEnabled;
@@ -83,7 +82,6 @@ protected:
   GateImageWithStatistic mStopPowerImage;
   GateImageWithStatistic mRelStopPowerImage;
   GateImage mNumberOfHitsImage;
-  GateImage mLastHitEventImage;
 
   G4String mStopPowerFilename;
   G4String mRelStopPowerFilename;
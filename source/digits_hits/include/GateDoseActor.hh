@@ -30,6 +30,7 @@ See GATE/LICENSE.txt for further details
 #include "GateDoseActorMessenger.hh"
 #include "GateImageWithStatistic.hh"
 #include "GateVoxelizedMass.hh"
+#include "GateStoppingPowerRatioTable.hh"
 
 class G4EmCalculator;
 
@@ -61,6 +62,8 @@ class GateDoseActor : public GateVImageActor
   void EnableDoseNormalisationToIntegral(bool b);
   void EnableDoseToWaterNormalisation(bool b) { mIsDoseToWaterNormalisationEnabled = b; mDoseToWaterImage.SetScaleFactor(1.0); }
   void SetDoseAlgorithmType(G4String b) { mDoseAlgorithmType = b; }
+  void SetDoseToWaterTableNumberOfBinsPerDecade(int n) { mDoseToWaterTableNumberOfBinsPerDecade = n; }
+  void EnableDoseToWaterTableCheck(bool b) { mIsDoseToWaterTableCheckEnabled = b; }
   void ImportMassImage(G4String b) { mImportMassImage = b; }
   void ExportMassImage(G4String b) { mExportMassImage = b; }
 
@@ -80,6 +83,8 @@ class GateDoseActor : public GateVImageActor
   virtual void EndOfEvent(G4HCofThisEvent*){}
 
 protected:
+  void BuildListOfMaterials(std::vector<G4Material*> & materials);
+
   GateDoseActor(G4String name, G4int depth=0);
   GateDoseActorMessenger* pMessenger;
   GateVoxelizedMass mVoxelizedMass;
@@ -87,7 +92,6 @@ protected:
   int mCurrentEvent;
   StepHitType mUserStepHitType;
 
-  bool mIsLastHitEventImageEnabled;
   bool mIsEdepImageEnabled;
   bool mIsEdepSquaredImageEnabled;
   bool mIsEdepUncertaintyImageEnabled;
@@ -100,12 +104,13 @@ protected:
   bool mIsNumberOfHitsImageEnabled;
   bool mIsDoseNormalisationEnabled;
   bool mIsDoseToWaterNormalisationEnabled;
+  bool mIsDoseToWaterTableCheckEnabled;
+  int mDoseToWaterTableNumberOfBinsPerDecade;
 
   GateImageWithStatistic mEdepImage;
   GateImageWithStatistic mDoseImage;
   GateImageWithStatistic mDoseToWaterImage;
   GateImageInt mNumberOfHitsImage;
-  GateImageInt mLastHitEventImage;
   GateImageDouble mMassImage;
 
   G4String mEdepFilename;
@@ -117,6 +122,7 @@ protected:
   G4String mExportMassImage;
 
   G4EmCalculator* emcalc;
+  GateStoppingPowerRatioTable mStoppingPowerRatioTable;
 };
 
 MAKE_AUTO_CREATOR_ACTOR(DoseActor,GateDoseActor)
@@ -18,6 +18,7 @@ See GATE/LICENSE.txt for further details
 
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "GateImageActorMessenger.hh"
 
 class GateDoseActor;
@@ -49,6 +50,8 @@ protected:
   G4UIcmdWithAString * pSetDoseAlgorithmCmd;
   G4UIcmdWithAString * pImportMassImageCmd;
   G4UIcmdWithAString * pExportMassImageCmd;
+  G4UIcmdWithAnInteger * pSetDoseToWaterTableBinsCmd;
+  G4UIcmdWithABool * pEnableDoseToWaterTableCheckCmd;
 };
 
 #endif /* end #define GATEDOSEACTORMESSENGER_HH*/
@@ -38,6 +38,13 @@ class GateEnergyEfficiency : public GateVPulseProcessor
     //! It is is called by ProcessPulseList() for each of the input pulses
     //! The result of the pulse-processing is incorporated into the output pulse-list
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
+
+    //! In-place version of ProcessOnePulse(), used when in-place processing is enabled for the chain
+    G4bool IsInPlaceProcessingSupported() const { return true; }
+    G4bool ProcessOnePulseInPlace(GatePulse* pulse);
+
+    //! Draw whether the pulse is detected
+    G4bool IsPulseDetected(const GatePulse* pulse);
   private:
     GateVDistribution* m_efficiency;    	   //!< efficiency table
     GateEnergyEfficiencyMessenger *m_messenger;   //!< Messenger
@@ -60,6 +60,8 @@ public:
   /// Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
+  virtual bool CanMergeWorkerOutputs();
+  virtual void MergeWorkerOutputs(const std::vector<G4String> & workerFilenames);
 
   virtual void Initialize(G4HCofThisEvent*){}
   virtual void EndOfEvent(G4HCofThisEvent*){}
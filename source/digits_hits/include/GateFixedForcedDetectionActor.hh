@@ -91,6 +91,7 @@ public:
   void SetNoisePrimary(G4int n) { mNoisePrimary = n; }
   void SetInputRTKGeometryFilename(G4String name) { mInputRTKGeometryFilename = name; }
   void SetEnergyResolvedBinSize(const double e) { mEnergyResolvedBinSize = e; }
+  void SetBatchSize(G4int n) { mBatchSize = n; }
 
   // Typedef for rtk
   static const unsigned int Dimension = 3;
@@ -121,16 +122,18 @@ public:
   InputImageType::Pointer FirstSliceProjection(InputImageType::Pointer &input);
   virtual void CreatePhaseSpace(const G4String phaseSpaceFilename, TFile *&phaseSpaceFile, TTree *&phaseSpace);
 
-  // The actual forced detection functions
+  // The actual forced detection functions. Interactions are queued per
+  // process and projected by batches of mBatchSize.
   virtual void ForceDetectionOfInteraction(G4int runID, G4int eventID, G4int trackID,
                                            G4String prodVol, G4String creatorProc,
                                            G4String processName, G4String interVol,
                                            G4ThreeVector pt, G4ThreeVector dir,
                                            double energy, double weight,
                                            G4String material, int Z);
+  void ForceDetectionOfQueuedInteractions();
+  void ForceDetectionOfQueuedInteractions(ProcessType pt);
   template <ProcessType VProcess, class TProjectorType>
-  void ForceDetectionOfInteraction(TProjectorType *projector,
-                                   InputImageType::Pointer &input);
+  void ForceDetectionOfQueuedInteractions(TProjectorType *projector);
 
 protected:
   GateFixedForcedDetectionActorMessenger * pActorMessenger;
@@ -209,13 +212,27 @@ protected:
   typedef GateFixedForcedDetectionProjector<GateFixedForcedDetectionFunctor::FluorescenceValueAccumulation> FluorescenceProjectionType;
   FluorescenceProjectionType::Pointer mFluorescenceProjector;
 
+  // Interactions waiting for their projection (world coordinates)
+  struct QueuedInteraction {
+    G4ThreeVector position;
+    G4ThreeVector direction;
+    double        energy;
+    double        weight;
+    int           Z;
+    int           eventID;
+    int           order;
+    G4String      processName;
+  };
+  G4int mBatchSize;
+  std::map<ProcessType, std::vector<QueuedInteraction> > mQueuedInteractions;
+  std::vector<float> mBatchBuffer;
+
   // Phase space variables
   G4String mPhaseSpaceFilename;
   TFile   *mPhaseSpaceFile;
   TTree   *mPhaseSpace;
   G4ThreeVector mInteractionDirection;
   G4ThreeVector mInteractionPosition;
-  PointType     mInteractionITKPosition;
   double        mInteractionEnergy;
   double        mInteractionWeight;
   Char_t        mInteractionProductionVolume[256];
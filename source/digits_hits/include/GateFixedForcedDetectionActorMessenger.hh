@@ -55,6 +55,7 @@ protected:
   G4UIcmdWithAString * pSetInputRTKGeometryFilenameCmd;
   G4UIcmdWithAnInteger * pSetNoisePrimaryCmd;
   G4UIcmdWithADoubleAndUnit * pEnergyResolvedBinSizeCmd;
+  G4UIcmdWithAnInteger * pSetBatchSizeCmd;
 };
 
 #endif /* end #define GATEFIXEDFORCEDDECTECTIONACTORMESSENGER_HH*/
@@ -71,7 +71,11 @@ public:
 
   VAccumulation():
     m_NumberOfPrimaries(0),
-    m_EnergyResolvedBinSize(0.)
+    m_EnergyResolvedBinSize(0.),
+    m_NumberOfThreads(1),
+    m_BatchBuffer(NULL),
+    m_BatchSliceSize(1),
+    m_NumberOfInteractions(1)
   {
     for(int i=0; i<ITK_MAX_THREADS; i++)
       {
@@ -93,6 +97,7 @@ public:
   void SetInterpolationWeights(std::vector<double> *_arg){ m_InterpolationWeights = _arg; }
   void SetEnergyWeightList(std::vector<double> *_arg) { m_EnergyWeightList = _arg; }
   void Init(unsigned int nthreads) {
+    m_NumberOfThreads = nthreads;
     for(unsigned int i=0; i<nthreads; i++) {
       m_InterpolationWeights[i].resize(m_MaterialMu->GetLargestPossibleRegion().GetSize()[0]);
       std::fill(m_InterpolationWeights[i].begin(), m_InterpolationWeights[i].end(), 0.);
@@ -225,6 +230,31 @@ public:
     m_EnergyResolvedSliceSize = slice;
   }
 
+  // Batched projection of interactions: the output image contains one slice
+  // per interaction and the interaction of a ray is deduced from the position
+  // of its output pixel in the buffer. Energy bin b of interaction i is in
+  // slice i+b*numberOfInteractions.
+  void SetBatchParameters(const float *buffer,
+                          const unsigned int sliceSize,
+                          const unsigned int numberOfInteractions)
+  {
+    m_BatchBuffer = buffer;
+    m_BatchSliceSize = sliceSize;
+    m_NumberOfInteractions = numberOfInteractions;
+    m_InteractionIntegrals.assign(m_NumberOfThreads*numberOfInteractions, 0.);
+  }
+  unsigned int GetInteractionIndex(const float &output) const
+  {
+    return (&output - m_BatchBuffer) / m_BatchSliceSize;
+  }
+  double GetInteractionIntegral(const unsigned int i) const
+  {
+    double result = 0.;
+    for(unsigned int t=0; t<m_NumberOfThreads; t++)
+      result += m_InteractionIntegrals[t*m_NumberOfInteractions+i];
+    return result;
+  }
+
 protected:
   inline void Accumulate(const rtk::ThreadIdType threadId,
                          float &output,
@@ -233,13 +263,15 @@ protected:
   {
     if(m_EnergyResolvedBinSize>0)
       {
-      const std::ptrdiff_t offset = m_EnergyResolvedSliceSize * itk::Math::Floor<unsigned int>(energy/m_EnergyResolvedBinSize+0.5);
+      const std::ptrdiff_t offset = m_EnergyResolvedSliceSize * m_NumberOfInteractions * itk::Math::Floor<unsigned int>(energy/m_EnergyResolvedBinSize+0.5);
       *(&output+offset) += valueToAccumulate;
       }
     else
       output += valueToAccumulate;
     m_IntegralOverDetector[threadId] += valueToAccumulate;
     m_SquaredIntegralOverDetector[threadId] += valueToAccumulate * valueToAccumulate;
+    if(m_BatchBuffer)
+      m_InteractionIntegrals[threadId*m_NumberOfInteractions+GetInteractionIndex(output)] += valueToAccumulate;
   }
 
   VectorType                    m_VolumeSpacing;
@@ -254,6 +286,11 @@ protected:
   std::vector<double>           m_EnergyList;
   double                        m_EnergyResolvedBinSize;
   unsigned int                  m_EnergyResolvedSliceSize;
+  unsigned int                  m_NumberOfThreads;
+  const float                  *m_BatchBuffer;
+  unsigned int                  m_BatchSliceSize;
+  unsigned int                  m_NumberOfInteractions;
+  std::vector<double>           m_InteractionIntegrals;
 };
 //-----------------------------------------------------------------------------
 
@@ -367,15 +404,16 @@ public:
     for(int i=0; i<3; i++)
       worldVector[i] *= m_VolumeSpacing[i];
     const double worldVectorNorm = worldVector.GetNorm();
+    const Interaction &interaction = m_Interactions[GetInteractionIndex(output)];
 
     // This is taken from G4LivermoreComptonModel.cc
-    double cosT = worldVector * m_Direction / worldVectorNorm;
-    double x = std::sqrt(1.-cosT) * m_InvWlPhoton;// 1-cosT=2*sin(T/2)^2
-    double scatteringFunction = m_ScatterFunctionData->FindValue(x,m_Z-1);
+    double cosT = worldVector * interaction.direction / worldVectorNorm;
+    double x = std::sqrt(1.-cosT) * interaction.invWlPhoton;// 1-cosT=2*sin(T/2)^2
+    double scatteringFunction = m_ScatterFunctionData->FindValue(x,interaction.Z-1);
 
     // This is taken from GateDiffCrossSectionActor.cc and simplified
-    double Eratio = 1./(1.+m_E0m*(1.-cosT));
-    double DCSKleinNishina = m_eRadiusOverCrossSectionTerm*Eratio*(1.+Eratio*(Eratio-1.+cosT*cosT));
+    double Eratio = 1./(1.+interaction.E0m*(1.-cosT));
+    double DCSKleinNishina = interaction.eRadiusOverCrossSectionTerm*Eratio*(1.+Eratio*(Eratio-1.+cosT*cosT));
     double DCScompton = DCSKleinNishina * scatteringFunction;
 
     // Multiply interpolation weights by step norm in MM to convert voxel
@@ -388,7 +426,7 @@ public:
     // the length from farthest point to pixel point.
     m_InterpolationWeights[threadId].back() = worldVectorNorm;
 
-    const double energy = Eratio*m_Energy;
+    const double energy = Eratio*interaction.energy;
     unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
     double *p = m_MaterialMu->GetPixelContainer()->GetBufferPointer() +
                 e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
@@ -410,26 +448,30 @@ public:
               0.);
   }
 
-  void SetDirection(const VectorType &_arg){ m_Direction = _arg; }
-
-  void SetEnergyZAndWeight(const double  &energy, const unsigned int &Z, const double &weight) {
-
-    m_Energy = energy;
-    m_E0m = m_Energy / electron_mass_c2;
-    m_InvWlPhoton = std::sqrt(0.5) * cm * m_Energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
+  void ClearInteractions() { m_Interactions.clear(); }
+  void AddInteraction(const double &energy, const unsigned int &Z, const double &weight, const VectorType &direction) {
+    Interaction interaction;
+    interaction.direction = direction;
+    interaction.energy = energy;
+    interaction.E0m = energy / electron_mass_c2;
+    interaction.invWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
 
     G4double cs = m_CrossSectionHandler->FindValue(Z, energy);
-    m_Z = Z;
-    m_eRadiusOverCrossSectionTerm = weight * ( classic_electr_radius*classic_electr_radius) / (2.*cs);
+    interaction.Z = Z;
+    interaction.eRadiusOverCrossSectionTerm = weight * ( classic_electr_radius*classic_electr_radius) / (2.*cs);
+    m_Interactions.push_back(interaction);
   }
 
 private:
-  VectorType                 m_Direction;
-  double                     m_Energy;
-  double                     m_E0m;
-  double                     m_InvWlPhoton;
-  unsigned int               m_Z;
-  double                     m_eRadiusOverCrossSectionTerm;
+  struct Interaction {
+    VectorType               direction;
+    double                   energy;
+    double                   E0m;
+    double                   invWlPhoton;
+    unsigned int             Z;
+    double                   eRadiusOverCrossSectionTerm;
+  };
+  std::vector<Interaction>   m_Interactions;
 
   // Compton data
   G4VEMDataSet* m_ScatterFunctionData;
@@ -476,13 +518,14 @@ public:
     for(int i=0; i<3; i++)
       worldVector[i] *= m_VolumeSpacing[i];
     const double worldVectorNorm = worldVector.GetNorm();
+    const Interaction &interaction = m_Interactions[GetInteractionIndex(output)];
 
     // This is taken from GateDiffCrossSectionActor.cc and simplified
-    double cosT = worldVector * m_Direction / worldVectorNorm;
+    double cosT = worldVector * interaction.direction / worldVectorNorm;
     double DCSThomsonTerm1 = (1 + cosT * cosT);
-    double DCSThomson = m_eRadiusOverCrossSectionTerm * DCSThomsonTerm1;
-    double x = std::sqrt(1.-cosT) * m_InvWlPhoton;// 1-cosT=2*sin(T/2)^2
-    double formFactor = m_FormFactorData->FindValue(x, m_Z-1);
+    double DCSThomson = interaction.eRadiusOverCrossSectionTerm * DCSThomsonTerm1;
+    double x = std::sqrt(1.-cosT) * interaction.invWlPhoton;// 1-cosT=2*sin(T/2)^2
+    double formFactor = m_FormFactorData->FindValue(x, interaction.Z-1);
     double DCSrayleigh = DCSThomson * formFactor * formFactor;
 
     // Multiply interpolation weights by step norm in MM to convert voxel
@@ -498,13 +541,13 @@ public:
     // Ray integral
     double rayIntegral = 0.;
     for(unsigned int j=0; j<m_InterpolationWeights[threadId].size(); j++)
-      rayIntegral += m_InterpolationWeights[threadId][j] * *(m_MaterialMuPointer+j);
+      rayIntegral += m_InterpolationWeights[threadId][j] * *(interaction.materialMuPointer+j);
 
     // Final computation
     Accumulate(threadId,
                output,
                vcl_exp(-rayIntegral) * DCSrayleigh * GetSolidAngle(sourceToPixel),
-               m_Energy);
+               interaction.energy);
 
     // Reset weights for next ray in thread.
     std::fill(m_InterpolationWeights[threadId].begin(),
@@ -512,26 +555,32 @@ public:
               0.);
   }
 
-  void SetDirection(const VectorType &_arg){ m_Direction = _arg; }
-  void SetEnergyZAndWeight(const double  &energy, const unsigned int &Z, const double &weight) {
+  void ClearInteractions() { m_Interactions.clear(); }
+  void AddInteraction(const double &energy, const unsigned int &Z, const double &weight, const VectorType &direction) {
+    Interaction interaction;
     unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
-    m_InvWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
-    m_Energy = energy;
-    m_MaterialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
-    m_MaterialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+    interaction.direction = direction;
+    interaction.invWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
+    interaction.energy = energy;
+    interaction.materialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
+    interaction.materialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
 
     G4double cs = m_CrossSectionHandler->FindValue(Z, energy);
-    m_Z = Z;
-    m_eRadiusOverCrossSectionTerm = weight * ( classic_electr_radius*classic_electr_radius) / (2.*cs);
+    interaction.Z = Z;
+    interaction.eRadiusOverCrossSectionTerm = weight * ( classic_electr_radius*classic_electr_radius) / (2.*cs);
+    m_Interactions.push_back(interaction);
   }
 
 private:
-  VectorType           m_Direction;
-  double              *m_MaterialMuPointer;
-  double               m_InvWlPhoton;
-  double               m_Energy;
-  unsigned int         m_Z;
-  double               m_eRadiusOverCrossSectionTerm;
+  struct Interaction {
+    VectorType         direction;
+    double            *materialMuPointer;
+    double             invWlPhoton;
+    double             energy;
+    unsigned int       Z;
+    double             eRadiusOverCrossSectionTerm;
+  };
+  std::vector<Interaction> m_Interactions;
 
   // G4 data
   G4VEMDataSet* m_FormFactorData;
@@ -565,6 +614,7 @@ public:
     for(int i=0; i<3; i++)
       worldVector[i] *= m_VolumeSpacing[i];
     const double worldVectorNorm = worldVector.GetNorm();
+    const Interaction &interaction = m_Interactions[GetInteractionIndex(output)];
 
     // Multiply interpolation weights by step norm in MM to convert voxel
     // intersection length to MM.
@@ -579,13 +629,13 @@ public:
     // Ray integral
     double rayIntegral = 0.;
     for(unsigned int j=0; j<m_InterpolationWeights[threadId].size(); j++)
-      rayIntegral += m_InterpolationWeights[threadId][j] * *(m_MaterialMuPointer+j);
+      rayIntegral += m_InterpolationWeights[threadId][j] * *(interaction.materialMuPointer+j);
 
     // Final computation
     Accumulate(threadId,
                output,
-               m_Weight * vcl_exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi),
-               m_Energy);
+               interaction.weight * vcl_exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi),
+               interaction.energy);
 
     // Reset weights for next ray in thread.
     std::fill(m_InterpolationWeights[threadId].begin(),
@@ -593,19 +643,24 @@ public:
               0.);
   }
 
-  void SetDirection(const VectorType &itkNotUsed(_arg)){}
-  void SetEnergyZAndWeight(const double &energy, const unsigned int &itkNotUsed(Z), const double &weight) {
+  void ClearInteractions() { m_Interactions.clear(); }
+  void AddInteraction(const double &energy, const unsigned int &itkNotUsed(Z), const double &weight, const VectorType &itkNotUsed(direction)) {
+    Interaction interaction;
     unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
-    m_Weight = weight;
-    m_Energy = energy;
-    m_MaterialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
-    m_MaterialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+    interaction.weight = weight;
+    interaction.energy = energy;
+    interaction.materialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
+    interaction.materialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+    m_Interactions.push_back(interaction);
   }
 
 private:
-  double    *m_MaterialMuPointer;
-  double     m_Weight;
-  double     m_Energy;
+  struct Interaction {
+    double  *materialMuPointer;
+    double   weight;
+    double   energy;
+  };
+  std::vector<Interaction> m_Interactions;
 };
 //-----------------------------------------------------------------------------
 
@@ -68,7 +68,6 @@ protected:
 
   GateImageWithStatistic mImage;
   GateImageWithStatistic mImageProcess;
-  GateImage mLastHitEventImage;
   GateImage mNumberOfHitsImage;
 
   //GateImage mImageScatter;
@@ -76,7 +75,6 @@ protected:
   GateFluenceActorMessenger * pMessenger;
 
   int mCurrentEvent;
-  bool mIsLastHitEventImageEnabled;
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
   bool mIsNormalisationEnabled;
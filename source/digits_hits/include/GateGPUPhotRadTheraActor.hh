@@ -49,6 +49,8 @@ class GateGPUPhotRadTheraActor: public GateVActor
 
   void SetGPUDeviceID(int n);
   void SetGPUBufferSize(int n);
+  void EnableCPU(bool b);
+  void SetNumberOfCPUThreads(int n);
 
   //-----------------------------------------------------------------------------
 protected:
@@ -71,6 +73,7 @@ protected:
   unsigned int max_buffer_size;
   unsigned int ct_photons;
   int mGPUDeviceID;
+  bool mCPUEnabled;
 };
 
 MAKE_AUTO_CREATOR_ACTOR(GPUPhotRadTheraActor,GateGPUPhotRadTheraActor)
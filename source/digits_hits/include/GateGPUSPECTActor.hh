@@ -50,6 +50,8 @@ class GateGPUSPECTActor: public GateVActor
 
   void SetGPUDeviceID(G4int n);
   void SetGPUBufferSize(G4int n);
+  void EnableCPU(bool b);
+  void SetNumberOfCPUThreads(G4int n);
   void SetHoleHexaHeight(G4double d);
   void SetHoleHexaRadius(G4double d);
   void SetHoleHexaRotAxis(G4ThreeVector v);
@@ -84,6 +86,7 @@ protected:
   unsigned int max_buffer_size;
   unsigned int ct_photons;
   G4int mGPUDeviceID;
+  bool mCPUEnabled;
  
   // collimator features (hexagonal hole)
   G4double mHoleHexaHeight;
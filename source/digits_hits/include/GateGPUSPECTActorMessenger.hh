@@ -17,6 +17,7 @@ See GATE/LICENSE.txt for further details
 #include "GateImageActorMessenger.hh"
 
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithADoubleAndUnit;
@@ -37,6 +38,8 @@ protected:
   GateGPUSPECTActor * pSPECTActor;
   G4UIcmdWithAnInteger * pSetGPUDeviceIDCmd;
   G4UIcmdWithAnInteger * pSetGPUBufferCmd;
+  G4UIcmdWithABool * pEnableCPUCmd;
+  G4UIcmdWithAnInteger * pSetCPUThreadsCmd;
   G4UIcmdWithADoubleAndUnit * pSetHoleHexaHeightCmd;
   G4UIcmdWithADoubleAndUnit * pSetHoleHexaRadiusCmd;
   G4UIcmdWith3Vector * pSetHoleHexaRotAxisCmd;
@@ -14,6 +14,7 @@ See GATE/LICENSE.txt for further details
 #define GATEGPUTRANSTOMOACTORMESSENGER_HH
 
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
 #include "GateImageActorMessenger.hh"
 
 class GateGPUTransTomoActor;
@@ -30,6 +31,8 @@ protected:
   GateGPUTransTomoActor * pTransTomoActor;
   G4UIcmdWithAnInteger * pSetGPUDeviceIDCmd;
   G4UIcmdWithAnInteger * pSetGPUBufferCmd;
+  G4UIcmdWithABool * pEnableCPUCmd;
+  G4UIcmdWithAnInteger * pSetCPUThreadsCmd;
 };
 
 #endif /* end #define GATEGPUTRANSTOMOACTOR_HH*/
@@ -22,6 +22,7 @@ See GATE/LICENSE.txt for further details
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
 
 #include "GateActorMessenger.hh"
 
@@ -55,6 +56,8 @@ protected:
   G4UIcmdWith3VectorAndUnit * pHalfSizeCmd;
   G4UIcmdWith3VectorAndUnit * pSizeCmd;
   G4UIcmdWith3VectorAndUnit * pPositionCmd;
+  G4UIcmdWithABool          * pSaveInBackgroundCmd;
+  G4UIcmdWithABool          * pEnableCompressionCmd;
 
 }; // end class GateImageActorMessenger
 //-----------------------------------------------------------------------------
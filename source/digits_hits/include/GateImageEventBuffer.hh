@@ -0,0 +1,85 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+/*
+  \class  GateImageEventBuffer
+  \brief  Sparse list of the voxels touched during the current event.
+
+  Voxel indices are mapped to compact slots (open addressing hash
+  table), in order of first touch. GateImageWithStatistic images
+  registered to the buffer store their per-event values by slot, and
+  are flushed into their value and squared images at the end of the
+  event. Memory is proportional to the number of voxels touched by one
+  event, not to the image size. All the images of an actor share the
+  same buffer (see GateVImageActor).
+*/
+
+#ifndef GATEIMAGEEVENTBUFFER_HH
+#define GATEIMAGEEVENTBUFFER_HH
+
+#include <vector>
+
+class GateImageWithStatistic;
+
+//-----------------------------------------------------------------------------
+class GateImageEventBuffer
+{
+ public:
+  GateImageEventBuffer();
+  ~GateImageEventBuffer() {}
+
+  // Slot of the voxel index for the current event (created if needed)
+  inline int GetSlot(const int index);
+
+  // Voxel index of each slot, in slot order
+  const std::vector<int> & GetTouchedVoxels() const { return mTouched; }
+  int GetNumberOfTouchedVoxels() const { return mTouched.size(); }
+
+  void AddImage(GateImageWithStatistic * image);
+  void RemoveImage(GateImageWithStatistic * image);
+
+  // Flush the event values of all registered images, then clear
+  void EndOfEvent();
+
+ protected:
+  void Clear();
+  void Grow();
+  inline unsigned int Hash(const int index) const {
+    return (static_cast<unsigned int>(index)*2654435761u) & mMask;
+  }
+
+  std::vector<int> mKeys;      // voxel index, -1 if the entry is free
+  std::vector<int> mSlots;     // slot of the entry
+  std::vector<int> mTouched;   // slot -> voxel index
+  std::vector<int> mPositions; // slot -> entry in the hash table
+  unsigned int mMask;
+  std::vector<GateImageWithStatistic*> mImages;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+inline int GateImageEventBuffer::GetSlot(const int index)
+{
+  unsigned int h = Hash(index);
+  while (mKeys[h] != -1) {
+    if (mKeys[h] == index) return mSlots[h];
+    h = (h+1) & mMask;
+  }
+  int slot = mTouched.size();
+  mKeys[h] = index;
+  mSlots[h] = slot;
+  mTouched.push_back(index);
+  mPositions.push_back(h);
+  // keep the load factor below 1/2
+  if (2*mTouched.size() > mKeys.size()) Grow();
+  return slot;
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEIMAGEEVENTBUFFER_HH */
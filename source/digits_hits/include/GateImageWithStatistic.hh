@@ -18,6 +18,10 @@ See GATE/LICENSE.txt for further details
 #define GATEIMAGEWITHSTATISTIC_HH
 
 #include "GateImage.hh"
+#include "GateImageEventBuffer.hh"
+#include "GateBackgroundImageWriter.hh"
+
+class GateImageWithStatisticSnapshot;
 
 //-----------------------------------------------------------------------------
 /// \brief
@@ -36,10 +40,21 @@ class GateImageWithStatistic
   void Allocate();
   void Reset(double val=0.0);
 
+  // Per-event values (for squared/uncertainty images) are accumulated
+  // in a sparse event buffer and flushed into the value and squared
+  // images at the end of the event (see GateImageEventBuffer).
+  // AddValueAndUpdate is kept for compatibility and is the same as
+  // AddTempValue.
   void AddTempValue(const int index, double value);
   void AddValueAndUpdate(const int index, double value);
   void AddValue(const int index, double value);
 
+  // Share the event buffer of the actor (by default each image has its own)
+  void SetEventBuffer(GateImageEventBuffer * buffer);
+  GateImageEventBuffer * GetEventBuffer() { return pEventBuffer; }
+  void EndOfEvent() { pEventBuffer->EndOfEvent(); }
+  void FlushEventValues(const std::vector<int> & touchedVoxels);
+
   double GetValue(const int index);
   void  SetValue(const int index, double value );
   void Fill(double value);
@@ -53,11 +68,26 @@ class GateImageWithStatistic
   void SetFilename(G4String f);
   void SaveData(int numberOfEvents, bool normalise=false);
 
+  // When enabled, SaveData only copies the value and squared images;
+  // scaling, uncertainty and writing are done by the background writer
+  void EnableBackgroundWriting(bool b) { mIsBackgroundWritingEnabled = b; }
+  void SetCompression(bool b);
+
   inline G4double GetVoxelVolume() const { return mValueImage.GetVoxelVolume(); }
 
   virtual void UpdateImage();
   virtual void UpdateSquaredImage();
   virtual void UpdateUncertaintyImage(int numberOfEvents);
+  static void ComputeUncertainty(const GateImageDouble & value, const GateImageDouble & squared,
+                                 GateImageDouble & uncertainty, int numberOfEvents);
+
+  // Sums the .mhd/.mha images saved by the workers of a multi-process run
+  // (and their squared images), and recomputes the uncertainty of the sum.
+  // Normalised images are summed unscaled, and normalised again.
+  static bool MergeWorkerFiles(const std::vector<G4String> & inputs, const G4String & output);
+  // Header fields of the saved images (false if not saved by this class).
+  // normalisation: 0 (none), 1 (to the max) or 2 (to the integral).
+  static bool ReadHeaderFields(const G4String & filename, double & scale, int & normalisation, int & numberOfEvents);
 
   GateVImage & GetValueImage() { return mValueImage; }
   GateVImage & GetUncertaintyImage() { return mUncertaintyImage; }
@@ -67,9 +97,11 @@ class GateImageWithStatistic
   void SetTransformMatrix(const G4RotationMatrix & m);
 
   protected:
+  void SaveDataInBackground(int numberOfEvents, bool normalise);
+  static bool IsWrittenInBackground(const G4String & filename);
+
   GateImageDouble mValueImage;
   GateImageDouble mSquaredImage;
-  GateImageDouble mTempImage;
   GateImageDouble mUncertaintyImage;
   GateImageDouble mScaledValueImage;
   GateImageDouble mScaledSquaredImage;
@@ -91,10 +123,48 @@ class GateImageWithStatistic
   G4String mSquaredInitialFilename;
   G4String mUncertaintyInitialFilename;
 
+  GateImageEventBuffer mOwnEventBuffer;
+  GateImageEventBuffer * pEventBuffer;
+  std::vector<double> mEventValues; // by event buffer slot
+
   int mValueFD;
   int mSquaredFD;
   int mUncertaintyFD;
 
+  bool mIsBackgroundWritingEnabled;
+  GateImageWithStatisticSnapshot * pSnapshot;
+
 }; // end class GateImageWithStatistic
 
+
+//-----------------------------------------------------------------------------
+/// \brief Copy of the images of a GateImageWithStatistic, written by the
+/// background writer (second buffer of the double buffering)
+class GateImageWithStatisticSnapshot : public GateVBackgroundImageJob
+{
+ public:
+  virtual void Run();
+  void Write(GateImageDouble & image, const G4String & filename);
+
+  GateImageDouble mValueImage;
+  GateImageDouble mSquaredImage;
+  GateImageDouble mUncertaintyImage;
+  GateImageDouble mScaledValueImage;
+  GateImageDouble mScaledSquaredImage;
+
+  bool mIsSquaredImageEnabled;
+  bool mIsUncertaintyImageEnabled;
+  bool mIsValuesMustBeScaled;
+  bool mNormalise;
+  bool mNormalizedToMax;
+  bool mNormalizedToIntegral;
+  double mScaleFactor;
+  int mNumberOfEvents;
+
+  G4String mFilename;
+  G4String mSquaredFilename;
+  G4String mUncertaintyFilename;
+};
+//-----------------------------------------------------------------------------
+
 #endif /* end #define GATEIMAGEWITHSTATISTIC_HH */
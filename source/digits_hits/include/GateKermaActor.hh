@@ -75,7 +75,6 @@ protected:
 
   int mCurrentEvent;
 
-  bool mIsLastHitEventImageEnabled;
   bool mIsEdepImageEnabled;
   bool mIsEdepSquaredImageEnabled;
   bool mIsEdepUncertaintyImageEnabled;
@@ -93,7 +92,6 @@ protected:
   GateImageWithStatistic mDoseImage;
   GateImageWithStatistic mDoseToWaterImage;
   GateImage mNumberOfHitsImage;
-  GateImage mLastHitEventImage;
 
   G4String mEdepFilename;
   G4String mDoseFilename;
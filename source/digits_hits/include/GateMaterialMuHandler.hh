@@ -24,6 +24,7 @@ See GATE/LICENSE.txt for further details
 #include "G4LossTableManager.hh"
 
 #include <map>
+#include <vector>
 
 
 using std::map;
@@ -114,10 +115,16 @@ private:
 
   static GateMaterialMuHandler *singleton_MaterialMuHandler;
   
-  // - fast acces
-  void CheckLastCall(const G4MaterialCutsCouple *);
-  const G4MaterialCutsCouple *mLastCouple;
-  GateMuTable *mLastMuTable;
+  // - fast acces: tables by couple index (G4MaterialCutsCouple::GetIndex)
+  inline GateMuTable *FindMuTable(const G4MaterialCutsCouple *couple)
+  {
+    if(!mIsInitialized) { Initialize(); }
+    int index = couple->GetIndex();
+    if(index >= 0 && index < (int)mCoupleIndexTable.size() && mCoupleIndexTable[index]) { return mCoupleIndexTable[index]; }
+    return AddCoupleIndex(couple);
+  }
+  GateMuTable *AddCoupleIndex(const G4MaterialCutsCouple *);
+  std::vector<GateMuTable *> mCoupleIndexTable;
 
 };
 
@@ -19,6 +19,8 @@ See GATE/LICENSE.txt for further details
 #include "G4MaterialCutsCouple.hh"
 #include "G4Material.hh"
 
+#include <vector>
+
 class GateMuTable
 {
 public:
@@ -30,6 +32,8 @@ public:
   double GetMuEnOverRho(double energy);
   double GetMu(double energy);
   double GetMuOverRho(double energy);
+  // both coefficients with a single lookup
+  void GetMuAndMuEnOverRho(double energy, double & muOverRho, double & muenOverRho);
   
   const G4MaterialCutsCouple *GetMaterialCutsCouple() { return mCouple; }
   const G4Material *GetMaterial() { return mMaterial; }
@@ -41,7 +45,13 @@ public:
   double* GetMuTable() {return mMu;}
 
 private:
-  
+
+  // Segment [index, index+1] of the table used for the log energy x, the
+  // same as the one of a binary search
+  inline int FindIndex(double x);
+  void BuildIndexGrid();
+  inline double Interpolate(const double *values, const std::vector<double> & slopes, int index, double x);
+
   const G4MaterialCutsCouple *mCouple;
   const G4Material *mMaterial;
   double mDensity;
@@ -54,6 +64,15 @@ private:
   double lastMu;
   double lastMuen;
   G4int mSize;
+
+  // Uniform grid in log energy: first segment of each bin, and slopes of
+  // the segments
+  bool mIndexGridIsValid;
+  double mGridMin;
+  double mGridInverseStep;
+  std::vector<int> mGridIndex;
+  std::vector<double> mMuSlope;
+  std::vector<double> mMuEnSlope;
 };
 
 
@@ -106,6 +106,9 @@ public:
   //! If it is not the case the module is disabled and a warning is sent.
   void CheckFileNameForAllOutput();
 
+  //! Add a suffix to the file names of all enabled output modules (worker processes)
+  void AddFileNameSuffixForAllOutput(const G4String& suffix);
+
   //! Return the current crystal-hit collection (if nay)
   GateCrystalHitsCollection*  	  GetCrystalHitCollection();
   //! Return the current phantom-hit collection (if nay)
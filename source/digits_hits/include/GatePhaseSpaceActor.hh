@@ -21,6 +21,7 @@
 
 #include "GateVActor.hh"
 #include "GatePhaseSpaceActorMessenger.hh"
+#include "GateBinaryPhaseSpace.hh"
 
 struct iaea_header_type;
 struct iaea_record_type;
@@ -50,6 +51,8 @@ class GatePhaseSpaceActor : public GateVActor
   /// Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
+  virtual bool CanMergeWorkerOutputs();
+  virtual void MergeWorkerOutputs(const std::vector<G4String> & workerFilenames);
 
   void SetIsXPositionEnabled(bool b){EnableXPosition = b;}
   void SetIsYPositionEnabled(bool b){EnableYPosition = b;}
@@ -161,6 +164,8 @@ protected:
 
   iaea_record_type *pIAEARecordType;
   iaea_header_type *pIAEAheader;
+
+  GateBinaryPhaseSpaceWriter * pBinaryWriter;
 };
 
 MAKE_AUTO_CREATOR_ACTOR(PhaseSpaceActor,GatePhaseSpaceActor)
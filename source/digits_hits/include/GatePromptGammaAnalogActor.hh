@@ -35,6 +35,8 @@ public:
   void SetInputDataFilename(std::string filename);
   virtual void SaveData();
   virtual void ResetData();
+  // images of histograms per primary: the workers cannot be summed
+  virtual bool CanMergeWorkerOutputs() { return false; }
 
   void SetOutputCount(bool b) { mSetOutputCount = b; }  //output counts instead of yield
 
@@ -60,6 +60,8 @@ public:
   // Return the gamma energy spectrum for the proton at given energy,
   // for the given material
   TH1D * GetGammaEnergySpectrum(const int & matIndex, const double & energy); //backward compat.
+  // Same, for the proton energy bin of GetHEp (from 1 to GetProtonNbBins)
+  TH1D * GetGammaEnergySpectrumOfBin(const int & matIndex, const int & protonBin);
   TH2D * GetGammaM(const int & materialIndex);
   TH2D * GetNgammaM(const int & materialIndex);
   bool DataForMaterialExist(const int & materialIndex);
@@ -41,9 +41,13 @@ public:
   void SetInputDataFilename(std::string filename);
   virtual void SaveData();
   virtual void ResetData();
+  // images of histograms per primary: the workers cannot be summed
+  virtual bool CanMergeWorkerOutputs() { return false; }
 
   void EnableDebugOutput(bool b) { mIsDebugOutputEnabled = b; }
   void EnableOutputMatch(bool b) { mIsOutputMatchEnabled = b; }
+  void EnableDeferredSpectrum(bool b) { mIsDeferredSpectrumEnabled = b; }
+  void EnableSparseOutput(bool b) { mIsSparseOutputEnabled = b; }
   //void EnableSysVarianceImage(bool b) { mIsSysVarianceImageEnabled = b; }
   //void EnableIntermediaryUncertaintyOutput(bool b) { mIsIntermediaryUncertaintyOutputEnabled = b; }
 
@@ -57,12 +61,15 @@ protected:
 
   bool mIsDebugOutputEnabled;
   bool mIsOutputMatchEnabled;
+  bool mIsDeferredSpectrumEnabled;
+  bool mIsSparseOutputEnabled;
 
   //helper functions
   void SetTrackIoH(GateImageOfHistograms*&);
   void SetTLEIoH(GateImageOfHistograms*&);
   GateVImageVolume* GetPhantom();
   void BuildVarianceOutput(); //converts trackl,tracklsq into mImageGamma and tlevar per voxel. Not used.
+  void BuildDeferredSpectrum(); //converts mDeferredTrackl into mImageGamma, at the end of the simu.
   //void BuildSysVarianceOutput(); //converts trackl into mImageGamma and tlesysvarv. Not used.
 
   //used and reset each track
@@ -78,6 +85,11 @@ protected:
   GateImageOfHistograms * tlesysvar;    //systematic variance per voxel, per E_gamma. Not used.
   GateImageOfHistograms * tlevariance;  //uncertainty per voxel, per E_gamma. Not used.
 
+  //deferred spectrum: density * track length per voxel per E_proton, for the material
+  //of the first step in the voxel (steps in other materials are added to mImageGamma directly).
+  GateImageOfHistograms * mDeferredTrackl;
+  std::vector<int> mDeferredMaterial;   //material index per voxel, -1 if no step yet.
+
   GateImageInt mLastHitEventImage;      //store eventID when last updated.
   int mCurrentEvent;                    //monitor event. TODO: not sure if necesary
 };
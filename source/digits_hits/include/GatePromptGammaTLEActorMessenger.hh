@@ -32,6 +32,8 @@ protected:
   G4UIcmdWithAString * pSetInputDataFileCmd;
   G4UIcmdWithABool * pEnableDebugOutputCmd;
   G4UIcmdWithABool * pEnableOutputMatchCmd;
+  G4UIcmdWithABool * pEnableDeferredSpectrumCmd;
+  G4UIcmdWithABool * pEnableSparseOutputCmd;
 };
 //-----------------------------------------------------------------------------
 
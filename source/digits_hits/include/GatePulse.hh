@@ -15,6 +15,7 @@ See GATE/LICENSE.txt for further details
 #include <iostream>
 #include <vector>
 #include "G4ThreeVector.hh"
+#include "G4Allocator.hh"
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
@@ -50,6 +51,10 @@ class GatePulse
     //! Destructor
     virtual inline ~GatePulse() {}
 
+    //! Pulses are allocated from a pool (see GatePulseAllocator)
+    inline void* operator new(size_t size);
+    inline void  operator delete(void* aPulse, size_t size);
+
   public:
     //! \name getters and setters to acces the content of the pulse
     //@{
@@ -189,6 +194,10 @@ class GatePulseList: public std::vector<GatePulse*>
     GatePulseList(const GatePulseList& src);
     virtual ~GatePulseList();
 
+    //! Pulse-lists are allocated from a pool (see GatePulseListAllocator)
+    inline void* operator new(size_t size);
+    inline void  operator delete(void* aList, size_t size);
+
     //! Return the min-time of all pulses
     virtual GatePulse* FindFirstPulse() const ;
     virtual G4double ComputeStartTime() const ;
@@ -214,4 +223,37 @@ typedef GatePulseList::iterator GatePulseIterator;
 typedef GatePulseList::const_iterator GatePulseConstIterator;
 
 
+/* Pulses and pulse-lists are created and deleted for every event and
+   every module of the digitizer chains. They are allocated from
+   G4Allocator pools: the memory released at the end of an event (see
+   GateDigitizer::ErasePulseListVector) is reused by the next one.
+   Derived classes (different size) use the default allocation. */
+extern G4Allocator<GatePulse> GatePulseAllocator;
+extern G4Allocator<GatePulseList> GatePulseListAllocator;
+
+inline void* GatePulse::operator new(size_t size)
+{
+  if (size != sizeof(GatePulse)) return ::operator new(size);
+  return (void*) GatePulseAllocator.MallocSingle();
+}
+
+inline void GatePulse::operator delete(void* aPulse, size_t size)
+{
+  if (size != sizeof(GatePulse)) ::operator delete(aPulse);
+  else GatePulseAllocator.FreeSingle((GatePulse*) aPulse);
+}
+
+inline void* GatePulseList::operator new(size_t size)
+{
+  if (size != sizeof(GatePulseList)) return ::operator new(size);
+  return (void*) GatePulseListAllocator.MallocSingle();
+}
+
+inline void GatePulseList::operator delete(void* aList, size_t size)
+{
+  if (size != sizeof(GatePulseList)) ::operator delete(aList);
+  else GatePulseListAllocator.FreeSingle((GatePulseList*) aList);
+}
+
+
 #endif
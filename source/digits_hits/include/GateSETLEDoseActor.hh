@@ -52,6 +52,7 @@ class GateSETLEDoseActor : public GateVImageActor
 
   virtual void BeginOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
+  virtual void EndOfEventAction(const G4Event * event);
   
   virtual void PreUserTrackingAction(const GateVVolume *, const G4Track* t);
   virtual void PostUserTrackingAction(const GateVVolume *, const G4Track* t);
@@ -70,6 +71,24 @@ class GateSETLEDoseActor : public GateVImageActor
   void InitializeMaterialAndMuTable();
   bool IntersectionBox(G4ThreeVector, G4ThreeVector);
   double RayCast(bool, double, double, G4ThreeVector, G4ThreeVector);
+  void UpdateMaterialCoefficients(int material, double energy);
+
+  // Ray ready for the traversal of the voxels, from its entry in the box
+  struct VoxelRay {
+    bool isPrimary;
+    double energy;
+    double weight;
+    int index;              // first voxel
+    int step[3];            // index increment when crossing a x, y or z boundary
+    double remaining[3];    // distance to the next x, y or z boundary
+    double voxelLength[3];  // distance between two x, y or z boundaries
+    double length;          // length in the box
+  };
+  void InitializeRay(VoxelRay & ray, G4ThreeVector position, G4ThreeVector momentum);
+  // Casts the rays of the event by packets of rays of the same energy
+  void CastPendingRays();
+  // Images receiving the dose of a primary or secondary ray
+  int GetDoseImages(bool isPrimary, GateImageWithStatistic ** images, bool * isUncertaintyEnabled);
  /// Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
@@ -85,20 +104,14 @@ protected:
   GateSETLEDoseActorMessenger *pMessenger;
   
   GateImageWithStatistic mDoseImage;
-  GateImage mLastHitEventImage;
-  bool mIsLastHitEventImageEnabled;
   bool mIsDoseImageEnabled;
   bool mIsDoseUncertaintyImageEnabled;
   
   GateImageWithStatistic mPrimaryDoseImage;
-  GateImage mPrimaryLastHitEventImage;
-  bool mIsPrimaryLastHitEventImageEnabled;
   bool mIsPrimaryDoseImageEnabled;
   bool mIsPrimaryDoseUncertaintyImageEnabled;
   
   GateImageWithStatistic mSecondaryDoseImage;
-  GateImage mSecondaryLastHitEventImage;
-  bool mIsSecondaryLastHitEventImageEnabled;
   bool mIsSecondaryDoseImageEnabled;
   bool mIsSecondaryDoseUncertaintyImageEnabled;
   
@@ -118,7 +131,16 @@ protected:
   std::vector<RaycastingStruct> *mListOfRaycasting;
 
   bool mIsMuTableInitialized;
+  // Material of each voxel, as an index in mListOfMuTable
+  std::vector<int> mVoxelMaterials;
   std::vector<GateMuTable *> mListOfMuTable;
+  // Coefficients of each material for the energy of the current ray
+  // (computed once per ray and material instead of once per voxel)
+  std::vector<double> mMaterialEnergy;
+  std::vector<double> mMaterialMu;         // mm-1
+  std::vector<double> mMaterialDoseFactor; // dose per unit of attenuated weight
+  // Rays of the current event, cast at its end (without hybridino)
+  std::vector<VoxelRay> mPendingRays;
   
   int mCurrentEvent;
   G4SteppingManager *mSteppingManager;
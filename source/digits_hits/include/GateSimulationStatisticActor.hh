@@ -49,6 +49,8 @@ class GateSimulationStatisticActor : public GateVActor
   /// Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
+  virtual bool CanMergeWorkerOutputs() { return true; }
+  virtual void MergeWorkerOutputs(const std::vector<G4String> & workerFilenames);
 
 protected:
   GateSimulationStatisticActor(G4String name, G4int depth=0);
@@ -0,0 +1,99 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+/*!
+  \class  GateStoppingPowerRatioTable
+  \brief  Precomputed water/material stopping power ratios, per
+          (material, particle), on a regular log-energy grid. Used by
+          GateDoseActor for dose-to-water, in place of two calls to
+          G4EmCalculator::ComputeTotalDEDX at each step.
+ */
+
+#ifndef GATESTOPPINGPOWERRATIOTABLE_HH
+#define GATESTOPPINGPOWERRATIOTABLE_HH
+
+#include "globals.hh"
+#include "G4Material.hh"
+#include <vector>
+#include <cmath>
+
+class G4ParticleDefinition;
+class G4EmCalculator;
+
+class GateStoppingPowerRatioTable
+{
+public:
+  GateStoppingPowerRatioTable();
+  ~GateStoppingPowerRatioTable() {}
+
+  void SetNumberOfBinsPerDecade(int n) { mNumberOfBinsPerDecade = n; }
+  int GetNumberOfBinsPerDecade() const { return mNumberOfBinsPerDecade; }
+  void SetEnergyRange(double emin, double emax) { mEnergyMin = emin; mEnergyMax = emax; }
+
+  // Build the table for the given materials (previous content is
+  // discarded). The reference material is G4_WATER.
+  void Build(const std::vector<G4Material*> & materials, G4EmCalculator * calc);
+
+  // DEDX(water)/DEDX(material) for this particle and energy. Particles
+  // other than proton, deuteron, e- and e+ use the 100 MeV proton ratio
+  // (same convention as the previous exact computation). Materials not
+  // given to Build are added on the fly.
+  inline double GetRatio(const G4Material * m, const G4ParticleDefinition * p, double energy);
+
+  // Exact ratio, with the same conventions, computed with G4EmCalculator
+  double ComputeRatio(const G4Material * m, const G4ParticleDefinition * p, double energy);
+
+  // Compare the interpolated values to the exact ones at the middle of
+  // every bin; print and return the maximum relative deviation.
+  double CheckDeviation();
+
+protected:
+  void AddMaterial(const G4Material * m);
+  inline int GetParticleSlot(const G4ParticleDefinition * p) const {
+    for(unsigned int i=0; i<mParticles.size(); i++) if (mParticles[i] == p) return i;
+    return -1;
+  }
+
+  G4EmCalculator * mEmCalculator;
+  const G4Material * mWater;
+  std::vector<const G4ParticleDefinition*> mParticles;
+  std::vector<const G4Material*> mMaterials;
+  std::vector<int> mMaterialIndexToRow; // G4Material::GetIndex() -> row, -1 if none
+  std::vector<double> mRatios;          // [row][particle][bin]
+  std::vector<double> mDefaultRatios;   // [row], for the other particles
+
+  int mNumberOfBinsPerDecade;
+  int mNumberOfBins;
+  double mEnergyMin;
+  double mEnergyMax;
+  double mLogEnergyMin;
+  double mInvLogBinWidth;
+};
+
+//-----------------------------------------------------------------------------
+inline double GateStoppingPowerRatioTable::GetRatio(const G4Material * m,
+                                                    const G4ParticleDefinition * p,
+                                                    double energy)
+{
+  int index = m->GetIndex();
+  if (index >= (int)mMaterialIndexToRow.size() || mMaterialIndexToRow[index] < 0) AddMaterial(m);
+  int row = mMaterialIndexToRow[index];
+
+  int slot = GetParticleSlot(p);
+  if (slot < 0) return mDefaultRatios[row];
+
+  double x = (std::log(energy) - mLogEnergyMin) * mInvLogBinWidth;
+  if (x <= 0) x = 0;
+  int i = (int)x;
+  const double * v = &mRatios[(row*mParticles.size() + slot)*mNumberOfBins];
+  if (i >= mNumberOfBins-1) return v[mNumberOfBins-1];
+  return v[i] + (x-i)*(v[i+1]-v[i]);
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATESTOPPINGPOWERRATIOTABLE_HH */
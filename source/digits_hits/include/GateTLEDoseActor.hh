@@ -70,7 +70,6 @@ protected:
   //GateImageWithStatistic mPrimaryDoseImage;
   //GateImageWithStatistic mSecondaryDoseImage;
   GateImageWithStatistic mEdepImage;
-  GateImage mLastHitEventImage;
 
   GateMaterialMuHandler* mMaterialHandler;
   G4String mDoseFilename;
@@ -81,7 +80,6 @@ protected:
   G4double VoxelVolume;
   bool mIsEdepImageEnabled;
   bool mIsDoseUncertaintyImageEnabled;
-  bool mIsLastHitEventImageEnabled;
   bool mIsEdepSquaredImageEnabled;
   bool mIsEdepUncertaintyImageEnabled;
   bool mIsDoseImageEnabled;
@@ -60,6 +60,13 @@ class GateThresholder : public GateVPulseProcessor
     //! The result of the pulse-processing is incorporated into the output pulse-list
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&  outputPulseList);
 
+    //! In-place version of ProcessOnePulse(), used when in-place processing is enabled for the chain
+    G4bool IsInPlaceProcessingSupported() const { return true; }
+    G4bool ProcessOnePulseInPlace(GatePulse* pulse);
+
+    //! True if the pulse passes the threshold
+    G4bool IsAboveThreshold(const GatePulse* pulse);
+
   private:
     G4double m_threshold;     	      	      //!< Threshold value
     GateThresholderMessenger *m_messenger;    //!< Messenger
@@ -13,6 +13,8 @@
 
 #ifdef G4ANALYSIS_USE_FILE
 
+#include "GateBufferedOutputFile.hh"
+
 class GateToASCIIMessenger;
 class GateVVolume;
 
@@ -25,6 +27,7 @@ public:
 
   virtual ~GateToASCII();
   const G4String& GiveNameOfFile();
+  void AddFileNameSuffix(const G4String& suffix) { m_fileName += suffix; }
 
   //! It opens the ASCII files
   void RecordBeginOfAcquisition();
@@ -76,9 +79,8 @@ public:
       G4String          m_fileBaseName;
       G4String          m_collectionName;
       G4int             m_fileCounter;
-      long              m_outputFileBegin;
       G4int	        m_collectionID;
-      std::ofstream   m_outputFile;
+      GateBufferedOutputFile m_outputFile;
 
       static long       m_outputFileSizeLimit;
   };
@@ -145,7 +147,7 @@ private:
   GateToASCIIMessenger* m_asciiMessenger;
 
   std::ofstream m_outFileRun;
-  std::ofstream m_outFileHits;
+  GateBufferedOutputFile m_outFileHits;
 
   G4String m_fileName;
 
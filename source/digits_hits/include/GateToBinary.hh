@@ -29,6 +29,7 @@
 #include "GateSingleDigi.hh"
 #include "GatePrimaryGeneratorAction.hh"
 #include "GateRunManager.hh"
+#include "GateBufferedOutputFile.hh"
 
 class GateToBinaryMessenger;
 
@@ -123,6 +124,13 @@ public:
    */
   inline virtual G4String const& GiveNameOfFile() { return m_fileName; }
 
+	/*!
+	 *	\fn inline virtual void AddFileNameSuffix( G4String const& suffix )
+	 *	\param suffix added to the name of the output file
+	 */
+  inline virtual void AddFileNameSuffix( G4String const& suffix )
+  { m_fileName += suffix; }
+
 	/*!
 	 *	\fn inline virtual void SetFileName( G4String const aName )
 	 *	\param aName name of the output file
@@ -310,7 +318,7 @@ public:
 			G4String m_collectionName; /*!< Name of the collection */
 			G4int m_fileCounter; /*!< Count of the file */
 			G4int	m_collectionID; /*!< Collection ID */
-			std::ofstream m_outputFile; /*!< Output file */
+			GateBufferedOutputFile m_outputFile; /*!< Output file */
 			static G4int m_outputFileSizeLimit; /*!< Output file size limit */
   } VOutputChannel;
 
@@ -397,7 +405,7 @@ protected:
 	std::vector< VOutputChannel* > m_outputChannelVector; /*!< Vector of output channel */
 
 	std::ofstream m_outFileRun; /*!< outfile for run */
-  std::ofstream m_outFileHits; /*!< outfile for hits */
+  GateBufferedOutputFile m_outFileHits; /*!< outfile for hits */
 };
 
 #endif
@@ -77,6 +77,7 @@ public:
   GateToRoot(const G4String& name, GateOutputMgr* outputMgr,DigiMode digiMode);
   virtual ~GateToRoot();
   const G4String& GiveNameOfFile();
+  void AddFileNameSuffix(const G4String& suffix) { m_fileName += suffix; }
 
   void RecordBeginOfAcquisition();
   void RecordEndOfAcquisition();
@@ -105,6 +105,12 @@ public:
   G4String GetSaveFilename() { return mSaveFilename; }
   virtual void SaveData();
   virtual void ResetData() = 0;
+  // Multi-process run (see GateApplicationMgr::StartDAQWorkers): merges the
+  // outputs saved by the workers. Called in the parent process, where the
+  // actor is not constructed. Actors with outputs that cannot be merged
+  // cannot be used with several workers.
+  virtual bool CanMergeWorkerOutputs() { return false; }
+  virtual void MergeWorkerOutputs(const std::vector<G4String> & workerFilenames);
   void EnableSaveEveryNEvents(int n) { mSaveEveryNEvents = n; }
   void EnableSaveEveryNSeconds(int n) { mSaveEveryNSeconds = n; }
   void SetOverWriteFilesFlag(bool b) { mOverWriteFilesFlag = b; }
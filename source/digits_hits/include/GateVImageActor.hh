@@ -22,6 +22,8 @@ See GATE/LICENSE.txt for further details
 #include "GateImageWithStatistic.hh"
 #include "Randomize.hh"
 
+#include <map>
+
 //-----------------------------------------------------------------------------
 /// \brief Base (virtual) class for sensor storing data in a 3D matrix
 /// (GateImage)
@@ -59,6 +61,9 @@ public :
   //void SetPosition(GateVVolume * v);
   /// Sets the type of the hit
   void SetStepHitType(G4String t);
+  /// Output of the GateImageWithStatistic images
+  void EnableBackgroundWriting(bool b) { mIsBackgroundWritingEnabled = b; }
+  void EnableCompressedOutput(bool b) { mIsCompressedOutputEnabled = b; }
   //-----------------------------------------------------------------------------
 
   double GetDoselVolume(){return mVoxelSize.x()*mVoxelSize.y()*mVoxelSize.z();}
@@ -71,6 +76,12 @@ public :
   virtual void UserSteppingAction(const GateVVolume * v, const G4Step*);
   //-----------------------------------------------------------------------------
 
+  //-----------------------------------------------------------------------------
+  /// Flushes the per-event values of the images (see
+  /// GateImageEventBuffer). Actors overloading this callback must call it.
+  virtual void EndOfEventAction(const G4Event*);
+  //-----------------------------------------------------------------------------
+
   //-----------------------------------------------------------------------------
   /// Callbacks called when a hits should be add to the image
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step) = 0;
@@ -80,6 +91,15 @@ public :
 
   virtual void ResetData();
 
+  //-----------------------------------------------------------------------------
+  /// Multi-process run: all the .mhd/.mha images saved by the workers are
+  /// merged (see GateVActor::MergeWorkerOutputs)
+  virtual bool CanMergeWorkerOutputs();
+  virtual void MergeWorkerOutputs(const std::vector<G4String> & workerFilenames);
+  /// Sums images saved without statistic, with their own voxel type
+  static void MergeWorkerImages(const std::vector<G4String> & inputs, const G4String & output);
+  //-----------------------------------------------------------------------------
+
 protected:
 
   //-----------------------------------------------------------------------------
@@ -99,10 +119,43 @@ protected:
   bool           mResolutionIsSet;
   bool           mHalfSizeIsSet;
   bool           mPositionIsSet;
+  bool           mIsBackgroundWritingEnabled;
+  bool           mIsCompressedOutputEnabled;
+  // per-event sparse buffer shared by all the GateImageWithStatistic of
+  // the actor (set by SetOriginTransformAndFlagToImage)
+  GateImageEventBuffer mEventBuffer;
 
   int GetIndexFromTrackPosition(const GateVVolume *, const G4Track * track);
   int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step);
 
+  //-----------------------------------------------------------------------------
+  // Per step results shared by all the image actors: the step positions
+  // in the frame of a volume, and the voxel index for a grid (size,
+  // position and hit type). Valid for one GateActorManager step stamp.
+  struct VolumeStepCache {
+    const GateVVolume * volume;
+    unsigned long stamp;
+    bool inside;
+    G4ThreeVector prePosition;
+    G4ThreeVector postPosition;
+    std::map<const G4LogicalVolume*, bool> isVolume; // touchable volume matches 'volume'
+  };
+  struct GridStepCache {
+    int volumeSlot;
+    G4ThreeVector resolution;
+    G4ThreeVector halfSize;
+    G4ThreeVector position;
+    StepHitType stepHitType;
+    unsigned long stamp;
+    int index;
+  };
+  static std::vector<VolumeStepCache> mVolumeStepCaches;
+  static std::vector<GridStepCache> mGridStepCaches;
+  int mVolumeStepCacheSlot;
+  int mGridStepCacheSlot;   // -1 until the first step
+  void ResolveStepCacheSlots(const GateVVolume *);
+  void ComputeVolumeStepPositions(VolumeStepCache & cache, const G4Step * step);
+
 }; // end class GateVImageActor
 
 //-----------------------------------------------------------------------------
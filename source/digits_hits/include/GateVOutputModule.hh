@@ -58,6 +58,13 @@ public:
 */
   virtual const G4String& GiveNameOfFile() = 0;
 
+/*
+ * Add a suffix to the output file name(s), used to get distinct files in
+ * the worker processes (see GateApplicationMgr). The default is to
+ * disable the module, with a warning, as its file cannot be renamed.
+*/
+  virtual void AddFileNameSuffix(const G4String& suffix);
+
   /*! \brief Virtual method to print-out a description of the module
 
     \param indent: the print-out indentation (cosmetic parameter)
@@ -13,6 +13,7 @@
 #include "GateActorManager.hh"
 #include "GateVActor.hh"
 #include "GateMultiSensitiveDetector.hh"
+#include "GateApplicationMgr.hh"
 
 //-----------------------------------------------------------------------------
 GateActorManager::GateActorManager()
@@ -22,6 +23,7 @@ GateActorManager::GateActorManager()
   pActorManagerMessenger = new GateActorManagerMessenger(this);
   IsInitialized =0;
   resetAfterSaving = false;
+  mStepStamp = 1;
   GateDebugMessageDec("Actor",4,"GateActormanager() -- end\n");
 }
 //-----------------------------------------------------------------------------
@@ -92,6 +94,14 @@ void GateActorManager::CreateListsOfEnabledActors()
   //  return;
   // }
 
+  // Multi-process run: the actors are constructed in each worker, once
+  // their output file names are known (see GateApplicationMgr::RunWorker)
+  GateApplicationMgr * appMgr = GateApplicationMgr::GetInstance();
+  if (appMgr->GetNumberOfWorkers() > 1 && appMgr->GetWorkerID() < 0) {
+    GateMessage("Actor", 1, "Construction of the actors deferred to the workers\n");
+    return;
+  }
+
   std::vector<GateVActor*>::iterator sit;
   for(sit= theListOfActors.begin(); sit!=theListOfActors.end(); ++sit)
     {
@@ -172,6 +182,10 @@ void GateActorManager::BeginOfRunAction(const G4Run* run)
   std::vector<GateVActor*>::iterator sit;
 
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is starting.\n");
+  // Resolve the filters, identical filters of different actors share their evaluation
+  for(sit = theListOfActors.begin(); sit!=theListOfActors.end(); ++sit)
+    if((*sit)->GetNumberOfFilters()!=0) (*sit)->GetFilterManager()->Initialize();
+
   for(sit = theListOfActorsEnabledForBeginOfRun.begin(); sit!=theListOfActorsEnabledForBeginOfRun.end(); ++sit)
     (*sit)->BeginOfRunAction(run);
 
@@ -240,6 +254,10 @@ void GateActorManager::UserSteppingAction(const G4Step* step)
 {
   std::vector<GateVActor*>::iterator sit;
   // GateDebugMessage("Actor", 1, "list = " << theListOfActorsEnabledForUserSteppingAction.size() << Gateendl);
+  // The actors attached to a volume are called by its sensitive detector,
+  // before this callback: the results shared there, and those of the
+  // actors below, need a new step stamp each.
+  mStepStamp++;
   for(sit = theListOfActorsEnabledForUserSteppingAction.begin(); sit!=theListOfActorsEnabledForUserSteppingAction.end(); ++sit)
     {
       // GateDebugMessage("Actor", 1, "Step for " << (*sit)->GetObjectName());
@@ -248,6 +266,7 @@ void GateActorManager::UserSteppingAction(const G4Step* step)
       }
       (*sit)->UserSteppingAction(0, step);
     }
+  mStepStamp++;
 }
 //-----------------------------------------------------------------------------
 
@@ -0,0 +1,142 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateBackgroundImageWriter.hh"
+#include "GateMessageManager.hh"
+#include <algorithm>
+
+GateBackgroundImageWriter * GateBackgroundImageWriter::pInstance = 0;
+
+//-----------------------------------------------------------------------------
+GateBackgroundImageWriter::GateBackgroundImageWriter()
+{
+  pthread_mutex_init(&mMutex, NULL);
+  pthread_cond_init(&mJobSubmitted, NULL);
+  pthread_cond_init(&mJobDone, NULL);
+  pRunningJob = 0;
+  mIsThreadStarted = false;
+  mStop = false;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBackgroundImageWriter::~GateBackgroundImageWriter()
+{
+  if (mIsThreadStarted) {
+    WaitAll();
+    pthread_mutex_lock(&mMutex);
+    mStop = true;
+    pthread_cond_signal(&mJobSubmitted);
+    pthread_mutex_unlock(&mMutex);
+    pthread_join(mThread, NULL);
+  }
+  pthread_cond_destroy(&mJobDone);
+  pthread_cond_destroy(&mJobSubmitted);
+  pthread_mutex_destroy(&mMutex);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBackgroundImageWriter::Submit(GateVBackgroundImageJob * job)
+{
+  if (!mIsThreadStarted) {
+    if (pthread_create(&mThread, NULL, ThreadMain, this) != 0) {
+      // no thread: write now
+      GateWarning("Cannot start the image writer thread, images are written synchronously.");
+      job->Run();
+      for(unsigned int i=0; i<job->mMessages.size(); i++) GateMessage("Actor", 2, job->mMessages[i] << Gateendl);
+      job->mMessages.clear();
+      return;
+    }
+    mIsThreadStarted = true;
+  }
+  pthread_mutex_lock(&mMutex);
+  mJobs.push_back(job);
+  pthread_cond_signal(&mJobSubmitted);
+  pthread_mutex_unlock(&mMutex);
+  PrintMessages();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateBackgroundImageWriter::IsInProgress(GateVBackgroundImageJob * job) const
+{
+  return (pRunningJob == job || std::find(mJobs.begin(), mJobs.end(), job) != mJobs.end());
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBackgroundImageWriter::Wait(GateVBackgroundImageJob * job)
+{
+  if (!mIsThreadStarted) return;
+  pthread_mutex_lock(&mMutex);
+  while (IsInProgress(job)) pthread_cond_wait(&mJobDone, &mMutex);
+  pthread_mutex_unlock(&mMutex);
+  PrintMessages();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBackgroundImageWriter::WaitAll()
+{
+  if (!mIsThreadStarted) return;
+  pthread_mutex_lock(&mMutex);
+  while (pRunningJob || !mJobs.empty()) pthread_cond_wait(&mJobDone, &mMutex);
+  pthread_mutex_unlock(&mMutex);
+  PrintMessages();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBackgroundImageWriter::PrintMessages()
+{
+  std::vector<std::string> messages;
+  pthread_mutex_lock(&mMutex);
+  messages.swap(mMessages);
+  pthread_mutex_unlock(&mMutex);
+  for(unsigned int i=0; i<messages.size(); i++) GateMessage("Actor", 2, messages[i] << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void * GateBackgroundImageWriter::ThreadMain(void * writer)
+{
+  static_cast<GateBackgroundImageWriter*>(writer)->Loop();
+  return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBackgroundImageWriter::Loop()
+{
+  pthread_mutex_lock(&mMutex);
+  while (true) {
+    while (mJobs.empty() && !mStop) pthread_cond_wait(&mJobSubmitted, &mMutex);
+    if (mJobs.empty()) break; // stop requested
+    GateVBackgroundImageJob * job = mJobs.front();
+    mJobs.pop_front();
+    pRunningJob = job;
+    pthread_mutex_unlock(&mMutex);
+    job->Run();
+    pthread_mutex_lock(&mMutex);
+    mMessages.insert(mMessages.end(), job->mMessages.begin(), job->mMessages.end());
+    job->mMessages.clear();
+    pRunningJob = 0;
+    pthread_cond_broadcast(&mJobDone);
+  }
+  pthread_mutex_unlock(&mMutex);
+}
+//-----------------------------------------------------------------------------
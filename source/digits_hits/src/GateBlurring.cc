@@ -34,12 +34,18 @@ GateBlurring::~GateBlurring()
 
 void GateBlurring::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
 {
-	G4double currentEnergy = inputPulse->GetEnergy();
 	GatePulse* outputPulse = new GatePulse(*inputPulse);
-	outputPulse->SetEnergy(G4RandGauss::shoot(currentEnergy,(m_blurringLaw->ComputeResolution(currentEnergy)*currentEnergy)/GateConstants::fwhm_to_sigma));
+	ProcessOnePulseInPlace(outputPulse);
 	outputPulseList.push_back(outputPulse);
 }
 
+G4bool GateBlurring::ProcessOnePulseInPlace(GatePulse* pulse)
+{
+	G4double currentEnergy = pulse->GetEnergy();
+	pulse->SetEnergy(G4RandGauss::shoot(currentEnergy,(m_blurringLaw->ComputeResolution(currentEnergy)*currentEnergy)/GateConstants::fwhm_to_sigma));
+	return true;
+}
+
 void GateBlurring::DescribeMyself(size_t indent)
 {
  G4cout << GateTools::Indent(indent) << "Blurring law:\t" << m_blurringLaw->GetObjectName() << Gateendl;
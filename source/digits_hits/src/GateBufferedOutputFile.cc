@@ -0,0 +1,170 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+#include "GateBufferedOutputFile.hh"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+GateBufferedOutputFile::GateBufferedOutputFile(size_t blockSize)
+  : m_blockSize(blockSize), m_current(0), m_size(0), m_bytes(0), m_file(0),
+    m_threadStarted(false), m_pending(false), m_pendingBlock(0), m_pendingSize(0),
+    m_stop(false)
+{
+  m_blocks[0].resize(m_blockSize);
+  m_blocks[1].resize(m_blockSize);
+  pthread_mutex_init(&m_mutex, NULL);
+  pthread_cond_init(&m_condition, NULL);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBufferedOutputFile::~GateBufferedOutputFile()
+{
+  Close();
+  pthread_cond_destroy(&m_condition);
+  pthread_mutex_destroy(&m_mutex);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateBufferedOutputFile::Open(const G4String& fileName)
+{
+  Close();
+  m_file = fopen(fileName.c_str(), "wb");
+  if (!m_file) return false;
+
+  m_current = 0;
+  m_size = 0;
+  m_bytes = 0;
+  m_pending = false;
+  m_stop = false;
+  // without thread, the blocks are written by Flush
+  m_threadStarted = (pthread_create(&m_thread, NULL, WriteBlocks, this) == 0);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedOutputFile::Close()
+{
+  if (!m_file) return;
+  if (m_size > 0) Flush();
+  if (m_threadStarted) {
+    pthread_mutex_lock(&m_mutex);
+    m_stop = true;
+    pthread_cond_broadcast(&m_condition);
+    pthread_mutex_unlock(&m_mutex);
+    pthread_join(m_thread, NULL);
+    m_threadStarted = false;
+  }
+  fclose(m_file);
+  m_file = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedOutputFile::Flush()
+{
+  if (!m_file) {
+    m_size = 0;
+    return;
+  }
+  m_bytes += m_size;
+  if (!m_threadStarted) {
+    fwrite(&m_blocks[m_current][0], 1, m_size, m_file);
+    m_size = 0;
+    return;
+  }
+
+  // wait for the previous block, then swap
+  pthread_mutex_lock(&m_mutex);
+  while (m_pending) pthread_cond_wait(&m_condition, &m_mutex);
+  m_pending = true;
+  m_pendingBlock = m_current;
+  m_pendingSize = m_size;
+  pthread_cond_broadcast(&m_condition);
+  pthread_mutex_unlock(&m_mutex);
+  m_current = 1 - m_current;
+  m_size = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void* GateBufferedOutputFile::WriteBlocks(void* arg)
+{
+  GateBufferedOutputFile* file = (GateBufferedOutputFile*)arg;
+  pthread_mutex_lock(&file->m_mutex);
+  while (true) {
+    while (!file->m_pending && !file->m_stop)
+      pthread_cond_wait(&file->m_condition, &file->m_mutex);
+    if (!file->m_pending) break;
+    const char* data = &file->m_blocks[file->m_pendingBlock][0];
+    size_t size = file->m_pendingSize;
+    pthread_mutex_unlock(&file->m_mutex);
+    fwrite(data, 1, size, file->m_file);
+    pthread_mutex_lock(&file->m_mutex);
+    file->m_pending = false;
+    pthread_cond_broadcast(&file->m_condition);
+  }
+  pthread_mutex_unlock(&file->m_mutex);
+  return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedOutputFile::WriteLarge(const void* data, size_t size)
+{
+  const char* p = (const char*)data;
+  while (size > 0) {
+    if (m_size == m_blockSize) Flush();
+    size_t n = std::min(size, m_blockSize - m_size);
+    memcpy(&m_blocks[m_current][m_size], p, n);
+    m_size += n;
+    p += n;
+    size -= n;
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedOutputFile::PutInt(long value, int width)
+{
+  // digits from the end of a small buffer
+  char buffer[32];
+  char* p = buffer + sizeof(buffer);
+  unsigned long u = (value < 0 ? 0UL - (unsigned long)value : (unsigned long)value);
+  do {
+    *--p = '0' + (char)(u % 10);
+    u /= 10;
+  } while (u);
+  if (value < 0) *--p = '-';
+  int n = buffer + sizeof(buffer) - p;
+  for (int i = n; i < width; i++) Put(' ');
+  Write(p, n);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedOutputFile::PutScientific(double value, int width, int precision)
+{
+  // printf conversions are those of the iostreams, without the stream state
+  char buffer[512];
+  int n = snprintf(buffer, sizeof(buffer), "%*.*e", width, precision, value);
+  if (n > (int)sizeof(buffer) - 1) n = sizeof(buffer) - 1;
+  Write(buffer, n);
+}
+//-----------------------------------------------------------------------------
@@ -24,6 +24,8 @@ See GATE/LICENSE.txt for further details
 #include "GateVSystem.hh"
 #include "GateCoincidenceDigiMaker.hh"
 
+#include <algorithm>
+
 //#include <map>
 
 //------------------------------------------------------------------------------------------------------
@@ -46,6 +48,8 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
     m_multiplesPolicy(kKeepIfAllAreGoods),
     m_allPulseOpenCoincGate(false),
     m_depth(1),
+    m_presortOrder(0),
+    m_presortMethod(kPresortList),
     m_presortBufferSize(256),
     m_presortWarning(false)
 {
@@ -68,6 +72,12 @@ GateCoincidenceSorter::~GateCoincidenceSorter()
     m_presortBuffer.pop_back();
   }
 
+  while(m_presortHeap.size() > 0)
+  {
+    delete m_presortHeap.back().pulse;
+    m_presortHeap.pop_back();
+  }
+
   while(m_coincidencePulses.size() > 0)
   {
     delete m_coincidencePulses.back();
@@ -91,6 +101,7 @@ void GateCoincidenceSorter::Describe(size_t indent)
   G4cout << GateTools::Indent(indent) << "Coincidence offset jitter: " << G4BestUnit(m_offsetJitter,"Time") << Gateendl;
   G4cout << GateTools::Indent(indent) << "Min sector diff.:    " << m_minSectorDifference << Gateendl;
   G4cout << GateTools::Indent(indent) << "Presort buffer size: " << m_presortBufferSize << Gateendl;
+  G4cout << GateTools::Indent(indent) << "Presort method:      " << (m_presortMethod==kPresortHeap ? "heap" : "list") << Gateendl;
   G4cout << GateTools::Indent(indent) << "Input:              '" << m_inputName << "'" << Gateendl;
   G4cout << GateTools::Indent(indent) << "Output:             '" << m_outputName << "'" << Gateendl;
 }
@@ -127,10 +138,109 @@ void GateCoincidenceSorter::SetMultiplesPolicy(const G4String& policy)
 //------------------------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------------------------
+void GateCoincidenceSorter::SetPresortMethod(const G4String& method)
+{
+  presort_method_t newMethod;
+  if (method=="heap")
+    newMethod=kPresortHeap;
+  else {
+    if (method!="list")
+      G4cout<<"WARNING : presort method not recognized, using default : list\n";
+    newMethod=kPresortList;
+  }
+  if (newMethod==m_presortMethod)
+    return;
+
+  // move the buffered pulses, earliest first
+  std::vector<GatePulse*> pulses;
+  while (GetPresortedPulseNumber() > 0)
+    pulses.push_back(PopEarliestPresortedPulse());
+  m_presortMethod=newMethod;
+  for (size_t i=0; i<pulses.size(); i++)
+    PresortPulse(pulses[i]);
+}
+//------------------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------------------
+// put the pulse into the presort buffer
+void GateCoincidenceSorter::PresortPulse(GatePulse* pulse)
+{
+  if(m_presortMethod==kPresortHeap)
+  {
+    // check that even isn't earlier than the earliest event in the buffer
+    if(!m_presortHeap.empty() && pulse->GetTime() < m_presortHeap.front().time)
+    {
+      if(!m_presortWarning)
+        GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
+      m_presortWarning = true;
+    }
+    PresortEntry entry;
+    entry.time = pulse->GetTime();
+    entry.order = m_presortOrder++;
+    entry.pulse = pulse;
+    m_presortHeap.push_back(entry);
+    std::push_heap(m_presortHeap.begin(), m_presortHeap.end());
+    return;
+  }
+
+  std::list<GatePulse*>::iterator buf_iter;                // presort buffer iterator
+
+  if(m_presortBuffer.empty())
+    m_presortBuffer.push_back(pulse);
+  else if(pulse->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
+  {
+    if(!m_presortWarning)
+      GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
+    m_presortWarning = true;
+    m_presortBuffer.push_back(pulse); // this will probably not cause a problem, but coincidences may be missed
+  }
+  else // put the event into the presort buffer in the right place
+  {
+    buf_iter = m_presortBuffer.begin();
+    while(pulse->GetTime() < (*buf_iter)->GetTime())
+      buf_iter++;
+    m_presortBuffer.insert(buf_iter, pulse);
+  }
+}
+//------------------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------------------
+G4int GateCoincidenceSorter::GetPresortedPulseNumber() const
+{
+  if(m_presortMethod==kPresortHeap)
+    return m_presortHeap.size();
+  return m_presortBuffer.size();
+}
+//------------------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------------------
+// remove and return the earliest pulse of the presort buffer
+GatePulse* GateCoincidenceSorter::PopEarliestPresortedPulse()
+{
+  GatePulse* pulse;
+  if(m_presortMethod==kPresortHeap)
+  {
+    std::pop_heap(m_presortHeap.begin(), m_presortHeap.end());
+    pulse = m_presortHeap.back().pulse;
+    m_presortHeap.pop_back();
+  }
+  else
+  {
+    pulse = m_presortBuffer.back();
+    m_presortBuffer.pop_back();
+  }
+  return pulse;
+}
+//------------------------------------------------------------------------------------------------------
+
+
 void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
 {
   GatePulse* pulse;
-  std::list<GatePulse*>::iterator buf_iter;                // presort buffer iterator
   std::deque<GateCoincidencePulse*>::iterator coince_iter; // coincidence list iterator
 
   G4bool inCoincidence;
@@ -153,31 +263,13 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
   {
     // make a copy of the pulse
     pulse = new GatePulse(**gpl_iter);
-
-    if(m_presortBuffer.empty())
-      m_presortBuffer.push_back(pulse);
-    else if(pulse->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
-    {
-      if(!m_presortWarning)
-        GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
-      m_presortWarning = true;
-      m_presortBuffer.push_back(pulse); // this will probably not cause a problem, but coincidences may be missed
-    }
-    else // put the event into the presort buffer in the right place
-    {
-      buf_iter = m_presortBuffer.begin();
-      while(pulse->GetTime() < (*buf_iter)->GetTime())
-        buf_iter++;
-      m_presortBuffer.insert(buf_iter, pulse);
-    }
-
+    PresortPulse(pulse);
   }
 
   //  once buffer reaches the specified size look for coincidences
-  for(G4int i = m_presortBuffer.size();i > m_presortBufferSize;i--)
+  for(G4int i = GetPresortedPulseNumber();i > m_presortBufferSize;i--)
   {
-    pulse = m_presortBuffer.back();
-    m_presortBuffer.pop_back();
+    pulse = PopEarliestPresortedPulse();
 
     // process completed coincidence pulse window at front of list
     while(!m_coincidencePulses.empty() && m_coincidencePulses.front()->IsAfterWindow(pulse))
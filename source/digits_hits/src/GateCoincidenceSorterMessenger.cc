@@ -62,6 +62,13 @@ GateCoincidenceSorterMessenger::GateCoincidenceSorterMessenger(GateCoincidenceSo
   setPresortBufferSizeCmd->SetParameterName("size",false);
   setPresortBufferSizeCmd->SetRange("size>=32");
 
+  cmdName = GetDirectoryName()+"setPresortMethod";
+  setPresortMethodCmd = new G4UIcmdWithAString(cmdName.c_str(),this);
+  setPresortMethodCmd->SetGuidance("Set the presort buffer implementation: 'list' (default) or 'heap'.");
+  setPresortMethodCmd->SetGuidance("Both give the same coincidences; 'heap' is faster for large buffers.");
+  setPresortMethodCmd->SetParameterName("method",false);
+  setPresortMethodCmd->SetCandidates("list heap");
+
   cmdName = GetDirectoryName()+"setInputName";
   SetInputNameCmd = new G4UIcmdWithAString(cmdName,this);
   SetInputNameCmd->SetGuidance("Set the name of the input pulse channel");
@@ -89,6 +96,7 @@ GateCoincidenceSorterMessenger::~GateCoincidenceSorterMessenger()
   delete SetInputNameCmd;
   delete MultiplePolicyCmd;
   delete setPresortBufferSizeCmd;
+  delete setPresortMethodCmd;
   delete AllPulseOpenCoincGateCmd;
 }
 
@@ -109,6 +117,8 @@ void GateCoincidenceSorterMessenger::SetNewValue(G4UIcommand* aCommand, G4String
     { GetCoincidenceSorter()->SetDepth(setDepthCmd->GetNewIntValue(newValue)); }
   else if( aCommand == setPresortBufferSizeCmd )
     { GetCoincidenceSorter()->SetPresortBufferSize(setPresortBufferSizeCmd->GetNewIntValue(newValue)); }
+  else if( aCommand == setPresortMethodCmd )
+    { GetCoincidenceSorter()->SetPresortMethod(newValue); }
   else if (aCommand == SetInputNameCmd)
     {
      GetCoincidenceSorter()->SetInputName(newValue);
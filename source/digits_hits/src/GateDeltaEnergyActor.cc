@@ -25,7 +25,6 @@ GateStoppingPowerActor::GateStoppingPowerActor(G4String name, G4int depth):
   mIsStopPowerImageEnabled = true;
   mIsRelStopPowerImageEnabled = true;
 
-  mIsLastHitEventImageEnabled = false;
   mIsNumberOfHitsImageEnabled = true;
 
   mIsStopPowerSquaredImageEnabled = false;
@@ -70,7 +69,6 @@ void GateStoppingPowerActor::Construct() {
   SetOriginTransformAndFlagToImage(mStopPowerImage);
   SetOriginTransformAndFlagToImage(mRelStopPowerImage);
   SetOriginTransformAndFlagToImage(mNumberOfHitsImage);
-  SetOriginTransformAndFlagToImage(mLastHitEventImage);
 
   // Output Filename
   mStopPowerFilename = G4String(removeExtension(mSaveFilename))+"-StopPower."+G4String(getExtension(mSaveFilename));
@@ -78,12 +76,6 @@ void GateStoppingPowerActor::Construct() {
   mNbOfHitsFilename = G4String(removeExtension(mSaveFilename))+"-NbOfHits."+G4String(getExtension(mSaveFilename));
 
   // Resize and allocate images
-  if (mIsStopPowerSquaredImageEnabled || mIsStopPowerUncertaintyImageEnabled ||
-      mIsRelStopPowerSquaredImageEnabled || mIsRelStopPowerUncertaintyImageEnabled) {
-    mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-    mLastHitEventImage.Allocate();
-    mIsLastHitEventImageEnabled = true;
-  }
   if (mIsStopPowerImageEnabled) {
     //  mStopPowerImage.SetLastHitEventImage(&mLastHitEventImage);
     mStopPowerImage.EnableSquaredImage(mIsStopPowerSquaredImageEnabled);
@@ -119,7 +111,6 @@ void GateStoppingPowerActor::Construct() {
               "\tStopPower squared      = " << mIsStopPowerSquaredImageEnabled << Gateendl <<
               "\tStopPower uncertainty  = " << mIsStopPowerUncertaintyImageEnabled << Gateendl <<
               "\tNumber of hit     = " << mIsNumberOfHitsImageEnabled << Gateendl <<
-              "\t     (last hit)   = " << mIsLastHitEventImageEnabled << Gateendl <<
               "\tNb Hits filename  = " << mNbOfHitsFilename << Gateendl);
 
   ResetData();
@@ -137,10 +128,6 @@ void GateStoppingPowerActor::SaveData() {
 
   if (mIsRelStopPowerImageEnabled) mRelStopPowerImage.SaveData(mCurrentEvent+1, false);
 
-  if (mIsLastHitEventImageEnabled) {
-    mLastHitEventImage.Fill(-1); // reset
-  }
-
   if (mIsNumberOfHitsImageEnabled) {
     G4String a = GetSaveCurrentFilename(mNbOfHitsFilename);
     mNumberOfHitsImage.Write(a);
@@ -150,7 +137,6 @@ void GateStoppingPowerActor::SaveData() {
 
 //-----------------------------------------------------------------------------
 void GateStoppingPowerActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   if (mIsStopPowerImageEnabled) mStopPowerImage.Reset();
   if (mIsRelStopPowerImageEnabled) mRelStopPowerImage.Reset();
   if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.Fill(0);
@@ -199,28 +185,17 @@ void GateStoppingPowerActor::UserSteppingActionInVoxel(const int index, const G4
     return;
   }
 
-  bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
-    GateDebugMessage("Actor", 2,  "GateStoppingPowerActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-    if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-      sameEvent = false;
-      mLastHitEventImage.SetValue(index, mCurrentEvent);
-    }
-  }
-
   if (mIsRelStopPowerImageEnabled) {
 
     if (mIsRelStopPowerUncertaintyImageEnabled || mIsRelStopPowerSquaredImageEnabled) {
-      if (sameEvent) mRelStopPowerImage.AddTempValue(index, relativeStopPower);
-      else mRelStopPowerImage.AddValueAndUpdate(index, relativeStopPower);
+      mRelStopPowerImage.AddTempValue(index, relativeStopPower);
     }
     else mRelStopPowerImage.AddValue(index, relativeStopPower);
   }
 
   if (mIsStopPowerImageEnabled) {
     if (mIsStopPowerUncertaintyImageEnabled || mIsStopPowerSquaredImageEnabled) {
-      if (sameEvent) mStopPowerImage.AddTempValue(index, stoppingPower);
-      else mStopPowerImage.AddValueAndUpdate(index, stoppingPower);
+      mStopPowerImage.AddTempValue(index, stoppingPower);
     }
     else mStopPowerImage.AddValue(index, stoppingPower);
   }
@@ -14,6 +14,8 @@
 // gate
 #include "GateDoseActor.hh"
 #include "GateMiscFunctions.hh"
+#include "GateVImageVolume.hh"
+#include "GateApplicationMgr.hh"
 
 // g4
 #include <G4EmCalculator.hh>
@@ -28,7 +30,6 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
 
   mCurrentEvent=-1;
   mIsEdepImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mIsEdepSquaredImageEnabled = false;
   mIsEdepUncertaintyImageEnabled = false;
   mIsDoseImageEnabled = true;
@@ -40,6 +41,8 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mIsNumberOfHitsImageEnabled = false;
   mIsDoseNormalisationEnabled = false;
   mIsDoseToWaterNormalisationEnabled = false;
+  mIsDoseToWaterTableCheckEnabled = false;
+  mDoseToWaterTableNumberOfBinsPerDecade = 50;
   mDoseAlgorithmType = "VolumeWeighting";
   mImportMassImage = "";
   mExportMassImage = "";
@@ -116,18 +119,10 @@ void GateDoseActor::Construct() {
   SetOriginTransformAndFlagToImage(mEdepImage);
   SetOriginTransformAndFlagToImage(mDoseImage);
   SetOriginTransformAndFlagToImage(mNumberOfHitsImage);
-  SetOriginTransformAndFlagToImage(mLastHitEventImage);
   SetOriginTransformAndFlagToImage(mDoseToWaterImage);
   SetOriginTransformAndFlagToImage(mMassImage);
 
   // Resize and allocate images
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
-      mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled) {
-    mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-    mLastHitEventImage.Allocate();
-    mIsLastHitEventImageEnabled = true;
-  }
   if (mIsEdepImageEnabled) {
     //  mEdepImage.SetLastHitEventImage(&mLastHitEventImage);
     mEdepImage.EnableSquaredImage(mIsEdepSquaredImageEnabled);
@@ -170,7 +165,8 @@ void GateDoseActor::Construct() {
     mMassImage.Allocate();
     mVoxelizedMass.Initialize(mVolumeName,mMassImage,mImportMassImage);
     mMassImage=mVoxelizedMass.UpdateImage(mMassImage);
-    if (mExportMassImage!="")
+    // the same in all the workers of a multi-process run: written once
+    if (mExportMassImage!="" && GateApplicationMgr::GetInstance()->GetWorkerID() <= 0)
       mMassImage.Write(mExportMassImage);
   }
 
@@ -194,11 +190,11 @@ void GateDoseActor::Construct() {
               "\tDose to water image        = " << mIsDoseToWaterImageEnabled << Gateendl <<
               "\tDose to water squared      = " << mIsDoseToWaterSquaredImageEnabled << Gateendl <<
               "\tDose to water uncertainty  = " << mIsDoseToWaterUncertaintyImageEnabled << Gateendl <<
+              "\tDose to water table (bins/decade) = " << mDoseToWaterTableNumberOfBinsPerDecade << Gateendl <<
               "\tEdep image        = " << mIsEdepImageEnabled << Gateendl <<
               "\tEdep squared      = " << mIsEdepSquaredImageEnabled << Gateendl <<
               "\tEdep uncertainty  = " << mIsEdepUncertaintyImageEnabled << Gateendl <<
               "\tNumber of hit     = " << mIsNumberOfHitsImageEnabled << Gateendl <<
-              "\t     (last hit)   = " << mIsLastHitEventImageEnabled << Gateendl <<
               "\tDose algorithm    = " << mDoseAlgorithmType << Gateendl <<
               "\tMass image (import) = " << mImportMassImage << Gateendl <<
               "\tMass image (export) = " << mExportMassImage << Gateendl <<
@@ -232,10 +228,6 @@ void GateDoseActor::SaveData() {
       mDoseToWaterImage.SaveData(mCurrentEvent+1, false);
   }
 
-  if (mIsLastHitEventImageEnabled) {
-    mLastHitEventImage.Fill(-1); // reset
-  }
-
   if (mIsNumberOfHitsImageEnabled) {
     mNumberOfHitsImage.Write(mNbOfHitsFilename);
   }
@@ -245,7 +237,6 @@ void GateDoseActor::SaveData() {
 
 //-----------------------------------------------------------------------------
 void GateDoseActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   if (mIsEdepImageEnabled) mEdepImage.Reset();
   if (mIsDoseImageEnabled) mDoseImage.Reset();
   if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Reset();
@@ -260,6 +251,17 @@ void GateDoseActor::BeginOfRunAction(const G4Run * r) {
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Run\n");
   // ResetData(); // Do no reset here !! (when multiple run);
   //
+
+  // Stopping power ratios for dose to water are tabulated once per run
+  // for all the materials of the attached volume (0 bins per decade
+  // means exact computation at each step).
+  if (mIsDoseToWaterImageEnabled && mDoseToWaterTableNumberOfBinsPerDecade > 0) {
+    std::vector<G4Material*> materials;
+    BuildListOfMaterials(materials);
+    mStoppingPowerRatioTable.SetNumberOfBinsPerDecade(mDoseToWaterTableNumberOfBinsPerDecade);
+    mStoppingPowerRatioTable.Build(materials, emcalc);
+    if (mIsDoseToWaterTableCheckEnabled) mStoppingPowerRatioTable.CheckDeviation();
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -303,17 +305,6 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     return;
   }
 
-  // compute sameEvent
-  // sameEvent is false the first time some energy is deposited for each primary particle
-  bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
-    GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-    if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-      sameEvent = false;
-      mLastHitEventImage.SetValue(index, mCurrentEvent);
-    }
-  }
-
   //---------------------------------------------------------------------------------
   // Volume weighting
   double density = step->GetPreStepPoint()->GetMaterial()->GetDensity();
@@ -346,30 +337,39 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     // G4HadronicProcessStore* store = G4HadronicProcessStore::Instance();
     // store->GetInelasticCrossSectionPerAtom(particle,e,elm);
 
-    double cut = DBL_MAX;
-    cut=1;
-    G4String material = step->GetPreStepPoint()->GetMaterial()->GetName();
-    double Energy = step->GetPreStepPoint()->GetKineticEnergy();
-    G4String PartName = step->GetTrack()->GetDefinition()->GetParticleName();
-    double DEDX=0, DEDX_Water=0;
-
     // Dose to water: it could be possible to make this process more
     // generic by choosing any material in place of water
     double Volume = mDoseToWaterImage.GetVoxelVolume();
 
-    // Other particles should be taken into account (Helium etc), but bug ? FIXME
-    if (PartName== "proton" || PartName== "e-" || PartName== "e+" || PartName== "deuteron") {
-      //if (PartName != "O16[0.0]" && PartName != "alpha" && PartName != "Be7[0.0]" && PartName != "C12[0.0]"){
-
-      DEDX = emcalc->ComputeTotalDEDX(Energy, PartName, material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(Energy, PartName, "G4_WATER", cut);
-
-      doseToWater=edep/density/Volume/gray*(DEDX_Water/1.)/(DEDX/(density*e_SI));
+    if (mDoseToWaterTableNumberOfBinsPerDecade > 0) {
+      // Tabulated DEDX_Water/DEDX (see GateStoppingPowerRatioTable)
+      double ratio = mStoppingPowerRatioTable.GetRatio(step->GetPreStepPoint()->GetMaterial(),
+                                                       step->GetTrack()->GetDefinition(),
+                                                       step->GetPreStepPoint()->GetKineticEnergy());
+      doseToWater=edep/density/Volume/gray*ratio*(density*e_SI);
     }
     else {
-      DEDX = emcalc->ComputeTotalDEDX(100, "proton", material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(100, "proton", "G4_WATER", cut);
-      doseToWater=edep/density/Volume/gray*(DEDX_Water/1.)/(DEDX/(density*e_SI));
+      double cut = DBL_MAX;
+      cut=1;
+      G4String material = step->GetPreStepPoint()->GetMaterial()->GetName();
+      double Energy = step->GetPreStepPoint()->GetKineticEnergy();
+      G4String PartName = step->GetTrack()->GetDefinition()->GetParticleName();
+      double DEDX=0, DEDX_Water=0;
+
+      // Other particles should be taken into account (Helium etc), but bug ? FIXME
+      if (PartName== "proton" || PartName== "e-" || PartName== "e+" || PartName== "deuteron") {
+        //if (PartName != "O16[0.0]" && PartName != "alpha" && PartName != "Be7[0.0]" && PartName != "C12[0.0]"){
+
+        DEDX = emcalc->ComputeTotalDEDX(Energy, PartName, material, cut);
+        DEDX_Water = emcalc->ComputeTotalDEDX(Energy, PartName, "G4_WATER", cut);
+
+        doseToWater=edep/density/Volume/gray*(DEDX_Water/1.)/(DEDX/(density*e_SI));
+      }
+      else {
+        DEDX = emcalc->ComputeTotalDEDX(100, "proton", material, cut);
+        DEDX_Water = emcalc->ComputeTotalDEDX(100, "proton", "G4_WATER", cut);
+        doseToWater=edep/density/Volume/gray*(DEDX_Water/1.)/(DEDX/(density*e_SI));
+      }
     }
 
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel:\tdose to water = "
@@ -385,30 +385,21 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   if (mIsDoseImageEnabled)
   {
     if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled)
-    {
-      if (sameEvent) mDoseImage.AddTempValue(index, dose);
-      else mDoseImage.AddValueAndUpdate(index, dose);
-    }
+      mDoseImage.AddTempValue(index, dose);
     else mDoseImage.AddValue(index, dose);
   }
 
   if (mIsDoseToWaterImageEnabled)
   {
     if (mIsDoseToWaterUncertaintyImageEnabled || mIsDoseToWaterSquaredImageEnabled)
-    {
-      if (sameEvent) mDoseToWaterImage.AddTempValue(index, doseToWater);
-      else mDoseToWaterImage.AddValueAndUpdate(index, doseToWater);
-    }
+      mDoseToWaterImage.AddTempValue(index, doseToWater);
     else mDoseToWaterImage.AddValue(index, doseToWater);
   }
 
   if (mIsEdepImageEnabled)
   {
     if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled)
-    {
-      if (sameEvent) mEdepImage.AddTempValue(index, edep);
-      else mEdepImage.AddValueAndUpdate(index, edep);
-    }
+      mEdepImage.AddTempValue(index, edep);
     else mEdepImage.AddValue(index, edep);
   }
 
@@ -417,3 +408,24 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   GateDebugMessageDec("Actor", 4, "GateDoseActor -- UserSteppingActionInVoxel -- end\n");
 }
 //-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseActor::BuildListOfMaterials(std::vector<G4Material*> & materials)
+{
+  // Materials of the image (labels) if the actor is attached to an
+  // image volume, plus the materials of the logical volume hierarchy.
+  materials.clear();
+  GateVImageVolume * imageVolume = dynamic_cast<GateVImageVolume*>(mVolume);
+  if (imageVolume) imageVolume->BuildLabelToG4MaterialVector(materials);
+
+  std::vector<G4LogicalVolume*> stack;
+  stack.push_back(mVolume->GetLogicalVolume());
+  while (!stack.empty()) {
+    G4LogicalVolume * lv = stack.back();
+    stack.pop_back();
+    if (lv->GetMaterial()) materials.push_back(lv->GetMaterial());
+    for(int i=0; i<lv->GetNoDaughters(); i++) stack.push_back(lv->GetDaughter(i)->GetLogicalVolume());
+  }
+}
+//-----------------------------------------------------------------------------
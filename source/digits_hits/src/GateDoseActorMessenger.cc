@@ -35,6 +35,8 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pSetDoseAlgorithmCmd= 0;
   pImportMassImageCmd= 0;
   pExportMassImageCmd= 0;
+  pSetDoseToWaterTableBinsCmd= 0;
+  pEnableDoseToWaterTableCheckCmd= 0;
 
   BuildCommands(baseName+sensor->GetObjectName());
 }
@@ -60,6 +62,8 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
   if(pSetDoseAlgorithmCmd) delete pSetDoseAlgorithmCmd;
   if(pImportMassImageCmd) delete pImportMassImageCmd;
   if(pExportMassImageCmd) delete pExportMassImageCmd;
+  if(pSetDoseToWaterTableBinsCmd) delete pSetDoseToWaterTableBinsCmd;
+  if(pEnableDoseToWaterTableCheckCmd) delete pEnableDoseToWaterTableCheckCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -150,6 +154,17 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   guid = G4String("Export mass image");
   pExportMassImageCmd->SetGuidance(guid);
   pExportMassImageCmd->SetParameterName("Export mass image",false);
+
+  n = base+"/setDoseToWaterTableBinsPerDecade";
+  pSetDoseToWaterTableBinsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of log-energy bins per decade of the stopping power ratio table used for dose to water (0 = exact computation at each step, default 50)");
+  pSetDoseToWaterTableBinsCmd->SetGuidance(guid);
+  pSetDoseToWaterTableBinsCmd->SetParameterName("Bins per decade",false);
+
+  n = base+"/checkDoseToWaterTable";
+  pEnableDoseToWaterTableCheckCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Report the maximum deviation between the stopping power ratio table and the exact computation");
+  pEnableDoseToWaterTableCheckCmd->SetGuidance(guid);
 }
 //-----------------------------------------------------------------------------
 
@@ -175,6 +190,8 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pSetDoseAlgorithmCmd) pDoseActor->SetDoseAlgorithmType(newValue);
   if (cmd == pImportMassImageCmd) pDoseActor->ImportMassImage(newValue);
   if (cmd == pExportMassImageCmd) pDoseActor->ExportMassImage(newValue);
+  if (cmd == pSetDoseToWaterTableBinsCmd) pDoseActor->SetDoseToWaterTableNumberOfBinsPerDecade(pSetDoseToWaterTableBinsCmd->GetNewIntValue(newValue));
+  if (cmd == pEnableDoseToWaterTableCheckCmd) pDoseActor->EnableDoseToWaterTableCheck(pEnableDoseToWaterTableCheckCmd->GetNewBoolValue(newValue));
 
   GateImageActorMessenger::SetNewValue( cmd, newValue);
 }
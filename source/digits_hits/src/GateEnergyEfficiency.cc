@@ -40,22 +40,36 @@ GateEnergyEfficiency::~GateEnergyEfficiency()
 
 void GateEnergyEfficiency::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
 {
-   if (!m_efficiency){ // default efficiency is 1
+   if (IsPulseDetected(inputPulse))
       outputPulseList.push_back(new GatePulse(*inputPulse));
-      return;
+}
+
+
+
+G4bool GateEnergyEfficiency::ProcessOnePulseInPlace(GatePulse* pulse)
+{
+   return IsPulseDetected(pulse);
+}
+
+
+
+G4bool GateEnergyEfficiency::IsPulseDetected(const GatePulse* pulse)
+{
+   if (!m_efficiency){ // default efficiency is 1
+      return true;
    }
    GateVSystem* system = GateSystemListManager::GetInstance()->GetSystem(0);
    if (!system){
       G4cerr<<"[GateEnergyEfficiency::ProcessOnePulse] Problem : no system defined\n";
-      return ;
+      return false;
    }
-   G4double eff = m_efficiency->Value(inputPulse->GetEnergy());
-//   G4cout<<inputPulse->GetEnergy()<<"   "<<eff<< Gateendl;
-   if (G4UniformRand() < eff)
-      outputPulseList.push_back(new GatePulse(*inputPulse));
-
+   G4double eff = m_efficiency->Value(pulse->GetEnergy());
+//   G4cout<<pulse->GetEnergy()<<"   "<<eff<< Gateendl;
+   return (G4UniformRand() < eff);
 }
 
+
+
 void GateEnergyEfficiency::DescribeMyself(size_t indent)
 {
   G4cout << GateTools::Indent(indent) << "Tabular Efficiency "<< Gateendl;
@@ -11,6 +11,9 @@
 
 #include "GateEnergySpectrumActorMessenger.hh"
 #include "GateMiscFunctions.hh"
+#include "GateActorMerger.hh"
+
+#include <cstdlib>
 
 //-----------------------------------------------------------------------------
 /// Constructors (Prototype)
@@ -115,6 +118,57 @@ void GateEnergySpectrumActor::SaveData()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// The discrete spectra are not saved in the .root file
+bool GateEnergySpectrumActor::CanMergeWorkerOutputs()
+{
+  return (getExtension(mSaveFilename) == "root" && !mSaveAsDiscreteSpectrumTextFlag);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// The histograms are summed by the merger of gjm. The text outputs are
+// written again from the summed histograms, with the number of events of
+// all the workers (read in their own text outputs).
+void GateEnergySpectrumActor::MergeWorkerOutputs(const std::vector<G4String> & workerFilenames)
+{
+  std::vector<std::string> inputs(workerFilenames.begin(), workerFilenames.end());
+  GateActorMerger merger(0, true, "");
+  if (!merger.MergeHistograms(inputs, mSaveFilename))
+    GateError("Cannot merge the outputs of actor " << GetObjectName() << " (" << workerFilenames[0] << ", ...)");
+  GateMessage("Actor", 1, "Merged " << inputs.size() << " worker histograms into " << mSaveFilename << Gateendl);
+  if (!mSaveAsTextFlag) return;
+
+  const std::string eventsLine = "# Number of events: ";
+  nEvent = 0;
+  for(unsigned int w=0; w<workerFilenames.size(); w++) {
+    G4String filename = G4String(removeExtension(workerFilenames[w]))+"_energySpectrum.txt";
+    std::ifstream is(filename.c_str());
+    std::string line;
+    int n = -1;
+    while (std::getline(is, line))
+      if (line.compare(0, eventsLine.length(), eventsLine) == 0) {
+        n = atoi(line.substr(eventsLine.length()).c_str());
+        break;
+      }
+    if (n < 0) GateError("Cannot read the number of events of a worker in " << filename);
+    nEvent += n;
+  }
+
+  TFile * file = TFile::Open(mSaveFilename, "READ");
+  if (!file) GateError("Cannot read " << mSaveFilename);
+  const char * names[4] = { "energySpectrum", "edepHisto", "edepTrackHisto", "eLossHisto" };
+  for(int i=0; i<4; i++) {
+    TH1D * histo = dynamic_cast<TH1D*>(file->Get(names[i]));
+    if (histo) SaveAsText(histo, mSaveFilename);
+  }
+  file->Close();
+  delete file;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateEnergySpectrumActor::ResetData()
 {
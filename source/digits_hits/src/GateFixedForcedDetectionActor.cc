@@ -47,7 +47,8 @@ GateFixedForcedDetectionActor::GateFixedForcedDetectionActor(G4String name, G4in
   mIsSecondaryUncertaintyImageEnabled(false),
   mNoisePrimary(0),
   mInputRTKGeometryFilename(""),
-  mEnergyResolvedBinSize(0)
+  mEnergyResolvedBinSize(0),
+  mBatchSize(64)
 {
   GateDebugMessageInc("Actor",4,"GateFixedForcedDetectionActor() -- begin"<<G4endl);
   pActorMessenger = new GateFixedForcedDetectionActorMessenger(this);
@@ -208,6 +209,7 @@ void GateFixedForcedDetectionActor::BeginOfRunAction(const G4Run*r)
     mProcessImage[pt] = CreateVoidProjectionImage();
     mSquaredImage[pt] = CreateVoidProjectionImage();
     mPerOrderImages[pt].clear();
+    mQueuedInteractions[pt].clear();
   }
   mSecondarySquaredImage = CreateVoidProjectionImage();
 
@@ -381,6 +383,9 @@ void GateFixedForcedDetectionActor::BeginOfEventAction(const G4Event *e)
 void GateFixedForcedDetectionActor::EndOfEventAction(const G4Event *e)
 {
   if(mIsSecondarySquaredImageEnabled || mIsSecondaryUncertaintyImageEnabled) {
+    // The squared images need the contribution of each event separately
+    ForceDetectionOfQueuedInteractions();
+
     typedef itk::AddImageFilter <OutputImageType, OutputImageType, OutputImageType> AddImageFilterType;
     AddImageFilterType::Pointer addFilter = AddImageFilterType::New();
     typedef itk::MultiplyImageFilter<OutputImageType, OutputImageType, OutputImageType> MultiplyImageFilterType;
@@ -557,75 +562,158 @@ void GateFixedForcedDetectionActor::ForceDetectionOfInteraction(G4int runID,
                 << processName << ".\n");
     return;
   }
-  else {
-    mInteractionOrder++;
-
-    switch(mMapProcessNameWithType[processName]) {
-    case COMPTON:
-      this->ForceDetectionOfInteraction<COMPTON>(mComptonProjector.GetPointer(),
-                                                 mProcessImage[COMPTON]);
-      break;
-    case RAYLEIGH:
-      mInteractionWeight = mEnergyResponseDetector(mInteractionEnergy)*mInteractionWeight;
-      this->ForceDetectionOfInteraction<RAYLEIGH>(mRayleighProjector.GetPointer(),
-                                                  mProcessImage[RAYLEIGH]);
-      break;
-    case PHOTOELECTRIC:
-      mInteractionWeight = mEnergyResponseDetector(mInteractionEnergy)*mInteractionWeight;
-      this->ForceDetectionOfInteraction<PHOTOELECTRIC>(mFluorescenceProjector.GetPointer(),
-                                                       mProcessImage[PHOTOELECTRIC]);
-      break;
-    default:
-      GateError("Implementation problem, unexpected process type reached.");
-    }
+
+  mInteractionOrder++;
+  const ProcessType pt = mMapProcessNameWithType[processName];
+  if(pt == RAYLEIGH || pt == PHOTOELECTRIC)
+    mInteractionWeight = mEnergyResponseDetector(mInteractionEnergy)*mInteractionWeight;
+
+  if(!mDoFFDForThisProcess[pt]) {
+    mInteractionTotalContribution = 0.;
+    if(mPhaseSpaceFile) mPhaseSpace->Fill();
+    return;
   }
-  if(mPhaseSpaceFile) mPhaseSpace->Fill();
+
+  QueuedInteraction interaction;
+  interaction.position = mInteractionPosition;
+  interaction.direction = mInteractionDirection;
+  interaction.energy = mInteractionEnergy;
+  interaction.weight = mInteractionWeight;
+  interaction.Z = mInteractionZ;
+  interaction.eventID = mInteractionEventId;
+  interaction.order = mInteractionOrder;
+  interaction.processName = processName;
+  mQueuedInteractions[pt].push_back(interaction);
+  if((G4int)mQueuedInteractions[pt].size() >= mBatchSize)
+    ForceDetectionOfQueuedInteractions(pt);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateFixedForcedDetectionActor::ForceDetectionOfQueuedInteractions()
+{
+  for(unsigned int i=0; i<PRIMARY; i++)
+    ForceDetectionOfQueuedInteractions(ProcessType(i));
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
+void GateFixedForcedDetectionActor::ForceDetectionOfQueuedInteractions(ProcessType pt)
+{
+  switch(pt) {
+  case COMPTON:
+    this->ForceDetectionOfQueuedInteractions<COMPTON>(mComptonProjector.GetPointer());
+    break;
+  case RAYLEIGH:
+    this->ForceDetectionOfQueuedInteractions<RAYLEIGH>(mRayleighProjector.GetPointer());
+    break;
+  case PHOTOELECTRIC:
+    this->ForceDetectionOfQueuedInteractions<PHOTOELECTRIC>(mFluorescenceProjector.GetPointer());
+    break;
+  default:
+    GateError("Implementation problem, unexpected process type reached.");
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// All queued interactions of one process are projected with a single
+// projector update: each interaction is the source of one projection of the
+// geometry and the projections are then summed in the process image.
 template <ProcessType VProcess, class TProjectorType>
-void GateFixedForcedDetectionActor::ForceDetectionOfInteraction(TProjectorType *projector,
-                                                                 InputImageType::Pointer &input)
+void GateFixedForcedDetectionActor::ForceDetectionOfQueuedInteractions(TProjectorType *projector)
 {
-  if(!mDoFFDForThisProcess[VProcess])
+  std::vector<QueuedInteraction> &queue = mQueuedInteractions[VProcess];
+  if(queue.empty())
     return;
+  const unsigned int nInteractions = queue.size();
 
-  // d and p are in World coordinates and they must be in CT coordinates
-  G4ThreeVector p = m_WorldToCT.TransformPoint(mInteractionPosition);
-  G4ThreeVector d = m_WorldToCT.TransformAxis(mInteractionDirection);
-
-  // Convert to ITK
-  VectorType direction;
-  for(unsigned int i=0; i<3; i++) {
-    mInteractionITKPosition[i] = p[i];
-    direction[i] = d[i];
-  }
+  mProcessTimeProbe[VProcess].Start();
 
-  // Create interaction geometry
-  GeometryType::Pointer oneProjGeometry = GeometryType::New();
-  oneProjGeometry->AddReg23Projection(mInteractionITKPosition,
+  // Create interactions geometry, positions and directions must be converted
+  // from World to CT coordinates
+  GeometryType::Pointer batchGeometry = GeometryType::New();
+  projector->GetProjectedValueAccumulation().ClearInteractions();
+  for(unsigned int k=0; k<nInteractions; k++) {
+    G4ThreeVector p = m_WorldToCT.TransformPoint(queue[k].position);
+    G4ThreeVector d = m_WorldToCT.TransformAxis(queue[k].direction);
+    PointType position;
+    VectorType direction;
+    for(unsigned int i=0; i<3; i++) {
+      position[i] = p[i];
+      direction[i] = d[i];
+    }
+    batchGeometry->AddReg23Projection(position,
                                       mDetectorPosition,
                                       mDetectorRowVector,
                                       mDetectorColVector);
+    projector->GetProjectedValueAccumulation().AddInteraction(queue[k].energy,
+                                                              queue[k].Z,
+                                                              queue[k].weight,
+                                                              direction);
+  }
 
-  mProcessTimeProbe[VProcess].Start();
-  projector->SetInput(FirstSliceProjection(input));
-  projector->SetGeometry( oneProjGeometry.GetPointer() );
-  projector->GetProjectedValueAccumulation().SetEnergyZAndWeight( mInteractionEnergy, mInteractionZ, mInteractionWeight );
-  projector->GetProjectedValueAccumulation().SetDirection( direction );
+  // Batch image with one slice per interaction (and per energy bin, see
+  // SetBatchParameters). Only the first nInteractions slices are projected.
+  InputImageType::Pointer &output = mProcessImage[VProcess];
+  InputImageType::RegionType region = output->GetLargestPossibleRegion();
+  const unsigned int nPixOneSlice = region.GetSize(0) * region.GetSize(1);
+  const unsigned int nBins = region.GetSize(2);
+  mBatchBuffer.assign(nInteractions * nBins * nPixOneSlice, 0.f);
+  region.SetSize(2, nInteractions);
+  rtk::ImportImageFilter<InputImageType>::Pointer batchFilter = rtk::ImportImageFilter<InputImageType>::New();
+  batchFilter->SetRegion(region);
+  batchFilter->SetImportPointer(&(mBatchBuffer[0]), region.GetNumberOfPixels(), false);
+  batchFilter->SetSpacing( output->GetSpacing() );
+  batchFilter->SetOrigin( output->GetOrigin() );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(batchFilter->Update());
+
+  projector->SetInput(batchFilter->GetOutput());
+  projector->SetGeometry( batchGeometry.GetPointer() );
+  projector->GetProjectedValueAccumulation().SetBatchParameters(&(mBatchBuffer[0]), nPixOneSlice, nInteractions);
   TRY_AND_EXIT_ON_ITK_EXCEPTION(projector->Update());
+  projector->GetProjectedValueAccumulation().GetIntegralOverDetectorAndReset();
+
+  // Sum the projections in the process image and, if required, in the image
+  // of the scatter order of each interaction
+  const bool perOrder = (mPerOrderImagesBaseName != "");
+  for(unsigned int k=0; k<nInteractions; k++) {
+    if(perOrder)
+      while(queue[k].order>(int)mPerOrderImages[VProcess].size())
+        mPerOrderImages[VProcess].push_back( CreateVoidProjectionImage() );
+    for(unsigned int b=0; b<nBins; b++) {
+      const float *in = &(mBatchBuffer[0]) + (k + b*nInteractions) * nPixOneSlice;
+      float *out = output->GetBufferPointer() + b * nPixOneSlice;
+      for(unsigned int i=0; i<nPixOneSlice; i++)
+        out[i] += in[i];
+      if(perOrder) {
+        out = mPerOrderImages[VProcess][queue[k].order-1]->GetBufferPointer() + b * nPixOneSlice;
+        for(unsigned int i=0; i<nPixOneSlice; i++)
+          out[i] += in[i];
+      }
+    }
+  }
+  output->Modified();
   mProcessTimeProbe[VProcess].Stop();
-  mInteractionTotalContribution = projector->GetProjectedValueAccumulation().GetIntegralOverDetectorAndReset();
-
-  // Scatter order
-  if(mPerOrderImagesBaseName != "")
-  {
-    while(mInteractionOrder>(int)mPerOrderImages[VProcess].size())
-      mPerOrderImages[VProcess].push_back( CreateVoidProjectionImage() );
-    projector->SetInput(FirstSliceProjection(mPerOrderImages[VProcess][mInteractionOrder-1]));
-    TRY_AND_EXIT_ON_ITK_EXCEPTION(projector->Update());
+
+  // Phase space: the branched variables are set from the queue
+  if(mPhaseSpaceFile) {
+    const int order = mInteractionOrder;
+    for(unsigned int k=0; k<nInteractions; k++) {
+      mInteractionPosition = queue[k].position;
+      mInteractionDirection = queue[k].direction;
+      mInteractionEnergy = queue[k].energy;
+      mInteractionWeight = queue[k].weight;
+      mInteractionZ = queue[k].Z;
+      mInteractionEventId = queue[k].eventID;
+      mInteractionOrder = queue[k].order;
+      strcpy(mInteractionProductionProcessStep, queue[k].processName.c_str());
+      mInteractionTotalContribution = projector->GetProjectedValueAccumulation().GetInteractionIntegral(k);
+      mPhaseSpace->Fill();
+    }
+    mInteractionOrder = order;
   }
+  queue.clear();
 }
 //-----------------------------------------------------------------------------
 
@@ -643,6 +731,7 @@ void GateFixedForcedDetectionActor::SaveData(const G4String prefix)
                                          GateFixedForcedDetectionFunctor::Chetty<InputImageType::PixelType> > ChettyType;
 
   GateVActor::SaveData();
+  ForceDetectionOfQueuedInteractions();
 
   // Geometry
   if(mGeometryFilename != "") {
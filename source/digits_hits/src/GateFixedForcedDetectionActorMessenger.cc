@@ -140,6 +140,13 @@ void GateFixedForcedDetectionActorMessenger::BuildCommands(G4String base)
   pEnergyResolvedBinSizeCmd = new G4UIcmdWithADoubleAndUnit(bb, this);
   guidance = "Set energy bin size for having an energy resolved output. Default is 0, i.e., off.";
   pEnergyResolvedBinSizeCmd->SetGuidance(guidance);
+
+  bb = base+"/interactionBatchSize";
+  pSetBatchSizeCmd = new G4UIcmdWithAnInteger(bb,this);
+  guidance = "Set the number of interactions projected together for each process. Default is 64. The memory of a batch is the size of the detector image times the batch size.";
+  pSetBatchSizeCmd->SetGuidance(guidance);
+  pSetBatchSizeCmd->SetParameterName("Size", false);
+  pSetBatchSizeCmd->SetRange("Size>0");
 }
 //-----------------------------------------------------------------------------
 
@@ -166,6 +173,7 @@ void GateFixedForcedDetectionActorMessenger::SetNewValue(G4UIcommand* command, G
   if(command == pSetInputRTKGeometryFilenameCmd) pActor->SetInputRTKGeometryFilename(param);
   if(command == pSetNoisePrimaryCmd) pActor->SetNoisePrimary(pSetNoisePrimaryCmd->GetNewIntValue(param));
   if(command == pEnergyResolvedBinSizeCmd) pActor->SetEnergyResolvedBinSize(pEnergyResolvedBinSizeCmd->GetNewDoubleValue(param));
+  if(command == pSetBatchSizeCmd) pActor->SetBatchSize(pSetBatchSizeCmd->GetNewIntValue(param));
 
   GateActorMessenger::SetNewValue(command ,param );
 }
@@ -25,7 +25,6 @@ GateFluenceActor::GateFluenceActor(G4String name, G4int depth):
   mCurrentEvent=-1;
   mIsSquaredImageEnabled = false;
   mIsUncertaintyImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mIsNormalisationEnabled = false;
   mIsNumberOfHitsImageEnabled = false;
 
@@ -71,19 +70,13 @@ void GateFluenceActor::Construct()
 
   mImage.SetOrigin(mOrigin);
   mImageProcess.SetOrigin(mOrigin);
-  mLastHitEventImage.SetOrigin(mOrigin);
   mNumberOfHitsImage.SetOrigin(mOrigin);
 
   mImage.SetOverWriteFilesFlag(mOverWriteFilesFlag);
   mImageProcess.SetOverWriteFilesFlag(mOverWriteFilesFlag);
 
-  if( mIsSquaredImageEnabled || mIsUncertaintyImageEnabled)
-    {
-      mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mLastHitEventImage.Allocate();
-      mIsLastHitEventImageEnabled = true;
-    }
-
+  // mImage is not set by SetOriginTransformAndFlagToImage
+  mImage.SetEventBuffer(&mEventBuffer);
   mImage.EnableSquaredImage(mIsSquaredImageEnabled);
   mImage.EnableUncertaintyImage(mIsUncertaintyImageEnabled);
   // Force the computation of squared image if uncertainty is enabled
@@ -149,10 +142,7 @@ void GateFluenceActor::SaveData()
           mImageProcess.SetFilename(fn);
           if( mIsNormalisationEnabled) mImageProcess.SaveData(mCurrentEvent+1, true);
           else mImageProcess.SaveData(mCurrentEvent+1, false);
-
-          if( mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
 	}
-      if( mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1); // reset
     }
 
 
@@ -189,7 +179,6 @@ void GateFluenceActor::SaveData()
 //-----------------------------------------------------------------------------
 void GateFluenceActor::ResetData()
 {
-  if( mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   mImage.Reset();
   mImageProcess.Reset();
   mImage.Fill(0);
@@ -242,22 +231,8 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
     {
       double energy = (step->GetPreStepPoint()->GetKineticEnergy());
       double respValue = mEnergyResponse(energy);
-      bool sameEvent=true;
-      if( mIsLastHitEventImageEnabled)
-	{
-	  GateDebugMessage( "Actor", 2,  "GateFluenceActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-	  if( mCurrentEvent != mLastHitEventImage.GetValue( index))
-	    {
-	      sameEvent = false;
-	      mLastHitEventImage.SetValue(index, mCurrentEvent);
-	    }
-	}
-
       if( mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
-	{
-          if( sameEvent) mImage.AddTempValue( index, respValue);
-	  else mImage.AddValueAndUpdate( index, respValue);
-	}
+        mImage.AddTempValue(index, respValue);
       else mImage.AddValue( index, respValue);
 
       if( mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.AddValue( index, weight);
@@ -300,10 +275,7 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
           {
 
             if( mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
-              {
-                if( sameEvent) mImageProcess.AddTempValue( index, respValue);
-                else mImageProcess.AddValueAndUpdate( index, respValue);
-              }
+              mImageProcess.AddTempValue(index, respValue);
             else mImageProcess.AddValue( index, respValue);
 
             if( process != G4String("") )
@@ -317,10 +289,7 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
         if(step->GetTrack()->GetTrackID() && step->GetTrack()->GetParentID()>0 )
           {
             if( mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
-              {
-                if( sameEvent) mImageProcess.AddTempValue( index, respValue);
-                else mImageProcess.AddValueAndUpdate( index, respValue);
-              }
+              mImageProcess.AddTempValue(index, respValue);
             else mImageProcess.AddValue( index, respValue);
 
             // Scatter order image
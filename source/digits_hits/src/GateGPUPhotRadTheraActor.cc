@@ -26,6 +26,11 @@ GateGPUPhotRadTheraActor::GateGPUPhotRadTheraActor(G4String name, G4int depth):
   GateVActor(name,depth) {
   GateDebugMessageInc("Actor",4,"GateGPUPhotRadTheraActor() -- begin\n");
   mGPUDeviceID = 0;
+#ifdef GATE_USE_GPU
+  mCPUEnabled = false;
+#else
+  mCPUEnabled = true;
+#endif
   gpu_input = 0;
   max_buffer_size = 5;
   pMessenger = new GateGPUPhotRadTheraActorMessenger(this);
@@ -83,6 +88,24 @@ void GateGPUPhotRadTheraActor::SetGPUBufferSize(int n) {
 }
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+void GateGPUPhotRadTheraActor::EnableCPU(bool b) {
+#ifndef GATE_USE_GPU
+  if (!b) GateWarning("Gate is compiled without GPU support, the tracking stays on the CPU.");
+  b = true;
+#endif
+  mCPUEnabled = b;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateGPUPhotRadTheraActor::SetNumberOfCPUThreads(int n) {
+  GateCPUSetNumberOfThreads(n);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateGPUPhotRadTheraActor::ResetData() {
   DD("ResetData");
@@ -151,13 +174,18 @@ void GateGPUPhotRadTheraActor::BeginOfRunAction(const G4Run *)
     half_phan_size_y = gpu_input->phantom_size_y * gpu_input->phantom_spacing_y * 0.5f;
     half_phan_size_z = gpu_input->phantom_size_z * gpu_input->phantom_spacing_z * 0.5f;
 
-#ifdef GATE_USE_GPU
     // Init GPU' stuff
-    GPU_GatePhotRadThera_init(gpu_input, gpu_dosemap, gpu_materials, gpu_phantom,
-                              gpu_photons, gpu_electrons, 
-                              cpu_photons, max_buffer_size, seed);
-    DD(max_buffer_size);
+    if (mCPUEnabled)
+      CPU_GatePhotRadThera_init(gpu_input, gpu_dosemap, gpu_materials, gpu_phantom,
+                                gpu_photons, gpu_electrons,
+                                cpu_photons, max_buffer_size, seed);
+#ifdef GATE_USE_GPU
+    else
+      GPU_GatePhotRadThera_init(gpu_input, gpu_dosemap, gpu_materials, gpu_phantom,
+                                gpu_photons, gpu_electrons, 
+                                cpu_photons, max_buffer_size, seed);
 #endif    
+    DD(max_buffer_size);
 }
 //-----------------------------------------------------------------------------
 
@@ -166,16 +194,24 @@ void GateGPUPhotRadTheraActor::EndOfRunAction(const G4Run *)
 {
     // Remaining particles?
     if (ct_photons != 0) {
+        if (mCPUEnabled)
+          CPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
+                               gpu_photons, gpu_electrons, cpu_photons, ct_photons);
 #ifdef GATE_USE_GPU
-        GPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
-                             gpu_photons, gpu_electrons, cpu_photons, ct_photons);
+        else
+          GPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
+                               gpu_photons, gpu_electrons, cpu_photons, ct_photons);
 #endif    
     }
 
     // Export dosemap & shutdown the GPU
+    if (mCPUEnabled)
+      CPU_GatePhotRadThera_end(gpu_dosemap, gpu_materials, gpu_phantom, gpu_photons, gpu_electrons,
+                               cpu_photons);
 #ifdef GATE_USE_GPU
-    GPU_GatePhotRadThera_end(gpu_dosemap, gpu_materials, gpu_phantom, gpu_photons, gpu_electrons,
-                             cpu_photons);
+    else
+      GPU_GatePhotRadThera_end(gpu_dosemap, gpu_materials, gpu_phantom, gpu_photons, gpu_electrons,
+                               cpu_photons);
 #endif
 
 }
@@ -244,9 +280,13 @@ void GateGPUPhotRadTheraActor::UserSteppingAction(const GateVVolume * /*v*/,
     // if enough particles in the buffer, start the gpu tracking
     ct_photons++;
     if (ct_photons == max_buffer_size) {
+        if (mCPUEnabled)
+          CPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
+                               gpu_photons, gpu_electrons, cpu_photons, ct_photons);
 #ifdef GATE_USE_GPU
-        GPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
-                             gpu_photons, gpu_electrons, cpu_photons, ct_photons);
+        else
+          GPU_GatePhotRadThera(gpu_dosemap, gpu_materials, gpu_phantom,
+                               gpu_photons, gpu_electrons, cpu_photons, ct_photons);
 #endif    
         ct_photons = 0;
 
@@ -35,6 +35,11 @@ GateGPUSPECTActor::GateGPUSPECTActor(G4String name, G4int depth):
   GateDebugMessageInc("Actor",4,"GateGPUSPECTActor() -- begin\n");
   gpu_input = 0;
   mGPUDeviceID = 0;
+#ifdef GATE_USE_GPU
+  mCPUEnabled = false;
+#else
+  mCPUEnabled = true;
+#endif
   max_buffer_size = 5;
   mHoleHexaHeight = 0.0;
   mHoleHexaRadius = 0.0;
@@ -104,6 +109,24 @@ void GateGPUSPECTActor::SetGPUBufferSize(G4int n) {
 }
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+void GateGPUSPECTActor::EnableCPU(bool b) {
+#ifndef GATE_USE_GPU
+  if (!b) GateWarning("Gate is compiled without GPU support, the tracking stays on the CPU.");
+  b = true;
+#endif
+  mCPUEnabled = b;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateGPUSPECTActor::SetNumberOfCPUThreads(G4int n) {
+  GateCPUSetNumberOfThreads(n);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateGPUSPECTActor::SetHoleHexaHeight(G4double d) {
   mHoleHexaHeight = d;
@@ -254,18 +277,22 @@ void GateGPUSPECTActor::BeginOfRunAction(const G4Run *)
   //DD(seed);
   srand(seed);
 
-#ifdef GATE_USE_GPU
   int size_center = (mCubArrayRepNumY * mCubArrayRepNumZ) + ((mCubArrayRepNumY - 1) * (mCubArrayRepNumZ - 1));
 
   // Init GPU' stuff
   //GPU_GateTransTomo_init(gpu_input, gpu_materials, gpu_phantom,
   //                       gpu_photons, cpu_photons, max_buffer_size, seed);
 
-  GPU_GateSPECT_init(gpu_input, gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons,
-                     gpu_photons, cpu_photons, gpu_materials, max_buffer_size, size_center, seed);
+  if (mCPUEnabled)
+    CPU_GateSPECT_init(gpu_input, gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons,
+                       gpu_photons, cpu_photons, gpu_materials, max_buffer_size, size_center, seed);
+#ifdef GATE_USE_GPU
+  else
+    GPU_GateSPECT_init(gpu_input, gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons,
+                       gpu_photons, cpu_photons, gpu_materials, max_buffer_size, size_center, seed);
+#endif
 
   //DD(max_buffer_size);
-#endif
 
 }
 //-----------------------------------------------------------------------------
@@ -276,9 +303,13 @@ void GateGPUSPECTActor::EndOfRunAction(const G4Run *)
     // Remaining particles?
     if (ct_photons != 0) {
 
+        if (mCPUEnabled)
+          CPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
+                        cpu_photons, gpu_materials, ct_photons);
 #ifdef GATE_USE_GPU
-        GPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
-        			   cpu_photons, gpu_materials, ct_photons);
+        else
+          GPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
+          			   cpu_photons, gpu_materials, ct_photons);
 #endif
 
         // G4
@@ -317,9 +348,12 @@ void GateGPUSPECTActor::EndOfRunAction(const G4Run *)
     }
 
     // Shutdown the GPU
-#ifdef GATE_USE_GPU
     //GPU_GateTransTomo_end(gpu_materials, gpu_phantom, gpu_photons, cpu_photons);
-    GPU_GateSPECT_end(gpu_centerOfHexagons, gpu_photons, cpu_photons, gpu_materials);
+    if (mCPUEnabled)
+      CPU_GateSPECT_end(gpu_centerOfHexagons, gpu_photons, cpu_photons, gpu_materials);
+#ifdef GATE_USE_GPU
+    else
+      GPU_GateSPECT_end(gpu_centerOfHexagons, gpu_photons, cpu_photons, gpu_materials);
 #endif
 
 }
@@ -405,11 +439,13 @@ void GateGPUSPECTActor::UserSteppingAction(const GateVVolume * /*v*/,
   // if enough particles in the buffer, start the gpu tracking
   if (ct_photons == max_buffer_size) {
 
+    if (mCPUEnabled)
+      CPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
+                    cpu_photons, gpu_materials, ct_photons);
 #ifdef GATE_USE_GPU
-
-    GPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
-    				cpu_photons, gpu_materials, ct_photons);
-
+    else
+      GPU_GateSPECT(gpu_collim, cpu_centerOfHexagons, gpu_centerOfHexagons, gpu_photons,
+      				cpu_photons, gpu_materials, ct_photons);
 #endif
 
     // G4
@@ -14,6 +14,7 @@ See GATE/LICENSE.txt for further details
 #include "GateGPUSPECTActor.hh"
 
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
@@ -36,6 +37,8 @@ GateGPUSPECTActorMessenger::~GateGPUSPECTActorMessenger()
 {
   delete pSetGPUDeviceIDCmd;
   delete pSetGPUBufferCmd;
+  delete pEnableCPUCmd;
+  delete pSetCPUThreadsCmd;
   delete pSetHoleHexaHeightCmd;
   delete pSetHoleHexaRadiusCmd;
   delete pSetHoleHexaRotAxisCmd;
@@ -66,6 +69,18 @@ void GateGPUSPECTActorMessenger::BuildCommands(G4String base)
   pSetGPUBufferCmd->SetGuidance(guid);
   pSetGPUBufferCmd->SetParameterName("Size", false);
 
+  n = base+"/enableCPU";
+  pEnableCPUCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Track the particles with the CPU version of the gpu code");
+  pEnableCPUCmd->SetGuidance(guid);
+
+  n = base+"/setNumberOfCPUThreads";
+  pSetCPUThreadsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of threads of the CPU version (default: number of cores)");
+  pSetCPUThreadsCmd->SetGuidance(guid);
+  pSetCPUThreadsCmd->SetParameterName("Threads", false);
+  pSetCPUThreadsCmd->SetRange("Threads>0");
+
   n = base+"/setHoleHexaHeight"; 
   pSetHoleHexaHeightCmd = new G4UIcmdWithADoubleAndUnit(n, this); 
   guid = G4String("Set the height of an hexagonal hole");
@@ -147,6 +162,10 @@ void GateGPUSPECTActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue
     pSPECTActor->SetGPUDeviceID(pSetGPUDeviceIDCmd->GetNewIntValue(newValue));
   if (cmd == pSetGPUBufferCmd) 
     pSPECTActor->SetGPUBufferSize(pSetGPUBufferCmd->GetNewIntValue(newValue));
+  if (cmd == pEnableCPUCmd)
+    pSPECTActor->EnableCPU(pEnableCPUCmd->GetNewBoolValue(newValue));
+  if (cmd == pSetCPUThreadsCmd)
+    pSPECTActor->SetNumberOfCPUThreads(pSetCPUThreadsCmd->GetNewIntValue(newValue));
   if (cmd == pSetHoleHexaHeightCmd) 
     pSPECTActor->SetHoleHexaHeight(pSetHoleHexaHeightCmd->GetNewDoubleValue(newValue));
   if (cmd == pSetHoleHexaRadiusCmd) 
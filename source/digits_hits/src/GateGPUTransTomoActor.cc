@@ -27,6 +27,11 @@ GateGPUTransTomoActor::GateGPUTransTomoActor(G4String name, G4int depth):
   GateDebugMessageInc("Actor",4,"GateGPUTransTomoActor() -- begin\n");
   gpu_input = 0;
   mGPUDeviceID = 0;
+#ifdef GATE_USE_GPU
+  mCPUEnabled = false;
+#else
+  mCPUEnabled = true;
+#endif
   max_buffer_size = 5;
   pMessenger = new GateGPUTransTomoActorMessenger(this);
   GateDebugMessageDec("Actor",4,"GateGPUTransTomoActor() -- end\n");
@@ -82,6 +87,24 @@ void GateGPUTransTomoActor::SetGPUBufferSize(int n) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateGPUTransTomoActor::EnableCPU(bool b) {
+#ifndef GATE_USE_GPU
+  if (!b) GateWarning("Gate is compiled without GPU support, the tracking stays on the CPU.");
+  b = true;
+#endif
+  mCPUEnabled = b;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateGPUTransTomoActor::SetNumberOfCPUThreads(int n) {
+  GateCPUSetNumberOfThreads(n);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateGPUTransTomoActor::ResetData() {
   DD("ResetData");
@@ -149,12 +172,16 @@ void GateGPUTransTomoActor::BeginOfRunAction(const G4Run *)
   half_phan_size_y = gpu_input->phantom_size_y * gpu_input->phantom_spacing_y * 0.5f;
   half_phan_size_z = gpu_input->phantom_size_z * gpu_input->phantom_spacing_z * 0.5f;
 
-#ifdef GATE_USE_GPU
   // Init GPU' stuff
-  GPU_GateTransTomo_init(gpu_input, gpu_materials, gpu_phantom,
-                         gpu_photons, cpu_photons, max_buffer_size, seed);
-  DD(max_buffer_size);
+  if (mCPUEnabled)
+    CPU_GateTransTomo_init(gpu_input, gpu_materials, gpu_phantom,
+                           gpu_photons, cpu_photons, max_buffer_size, seed);
+#ifdef GATE_USE_GPU
+  else
+    GPU_GateTransTomo_init(gpu_input, gpu_materials, gpu_phantom,
+                           gpu_photons, cpu_photons, max_buffer_size, seed);
 #endif
+  DD(max_buffer_size);
 
 }
 //-----------------------------------------------------------------------------
@@ -164,9 +191,13 @@ void GateGPUTransTomoActor::EndOfRunAction(const G4Run *)
 {
   // Remaining particles?
   if (ct_photons != 0) {
+    if (mCPUEnabled)
+      CPU_GateTransTomo(gpu_materials, gpu_phantom,
+                        gpu_photons, cpu_photons, ct_photons);
 #ifdef GATE_USE_GPU
-    GPU_GateTransTomo(gpu_materials, gpu_phantom,
-                      gpu_photons, cpu_photons, ct_photons);
+    else
+      GPU_GateTransTomo(gpu_materials, gpu_phantom,
+                        gpu_photons, cpu_photons, ct_photons);
 #endif
     // G4
     static G4EventManager * em = G4EventManager::GetEventManager();
@@ -204,8 +235,11 @@ void GateGPUTransTomoActor::EndOfRunAction(const G4Run *)
   }
 
   // Shutdown the GPU
+  if (mCPUEnabled)
+    CPU_GateTransTomo_end(gpu_materials, gpu_phantom, gpu_photons, cpu_photons);
 #ifdef GATE_USE_GPU
-  GPU_GateTransTomo_end(gpu_materials, gpu_phantom, gpu_photons, cpu_photons);
+  else
+    GPU_GateTransTomo_end(gpu_materials, gpu_phantom, gpu_photons, cpu_photons);
 #endif
 
 }
@@ -276,9 +310,13 @@ void GateGPUTransTomoActor::UserSteppingAction(const GateVVolume * /*v*/,
 
   // if enough particles in the buffer, start the gpu tracking
   if (ct_photons == max_buffer_size) {
+    if (mCPUEnabled)
+      CPU_GateTransTomo(gpu_materials, gpu_phantom,
+                        gpu_photons, cpu_photons, ct_photons);
 #ifdef GATE_USE_GPU
-    GPU_GateTransTomo(gpu_materials, gpu_phantom,
-                      gpu_photons, cpu_photons, ct_photons);
+    else
+      GPU_GateTransTomo(gpu_materials, gpu_phantom,
+                        gpu_photons, cpu_photons, ct_photons);
 #endif
     // G4
     static G4EventManager * em = G4EventManager::GetEventManager();
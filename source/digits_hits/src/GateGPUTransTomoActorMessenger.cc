@@ -20,6 +20,8 @@ GateGPUTransTomoActorMessenger::GateGPUTransTomoActorMessenger(GateGPUTransTomoA
 {
   pSetGPUDeviceIDCmd = 0;
   pSetGPUBufferCmd = 0;
+  pEnableCPUCmd = 0;
+  pSetCPUThreadsCmd = 0;
   BuildCommands(baseName+sensor->GetObjectName());
 }
 //-----------------------------------------------------------------------------
@@ -30,6 +32,8 @@ GateGPUTransTomoActorMessenger::~GateGPUTransTomoActorMessenger()
 {
   if (pSetGPUDeviceIDCmd) delete pSetGPUDeviceIDCmd;
   if (pSetGPUBufferCmd) delete pSetGPUBufferCmd;
+  if (pEnableCPUCmd) delete pEnableCPUCmd;
+  if (pSetCPUThreadsCmd) delete pSetCPUThreadsCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -46,6 +50,18 @@ void GateGPUTransTomoActorMessenger::BuildCommands(G4String base)
   pSetGPUBufferCmd = new G4UIcmdWithAnInteger(n, this); 
   guid = G4String("Set the buffer size for the gpu (nb of particles)");
   pSetGPUBufferCmd->SetGuidance(guid);
+
+  n = base+"/enableCPU";
+  pEnableCPUCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Track the particles with the CPU version of the gpu code");
+  pEnableCPUCmd->SetGuidance(guid);
+
+  n = base+"/setNumberOfCPUThreads";
+  pSetCPUThreadsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of threads of the CPU version (default: number of cores)");
+  pSetCPUThreadsCmd->SetGuidance(guid);
+  pSetCPUThreadsCmd->SetParameterName("Threads", false);
+  pSetCPUThreadsCmd->SetRange("Threads>0");
 }
 //-----------------------------------------------------------------------------
 
@@ -57,6 +73,10 @@ void GateGPUTransTomoActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newV
     pTransTomoActor->SetGPUDeviceID(pSetGPUDeviceIDCmd->GetNewIntValue(newValue));
   if (cmd == pSetGPUBufferCmd) 
     pTransTomoActor->SetGPUBufferSize(pSetGPUBufferCmd->GetNewIntValue(newValue));
+  if (cmd == pEnableCPUCmd)
+    pTransTomoActor->EnableCPU(pEnableCPUCmd->GetNewBoolValue(newValue));
+  if (cmd == pSetCPUThreadsCmd)
+    pTransTomoActor->SetNumberOfCPUThreads(pSetCPUThreadsCmd->GetNewIntValue(newValue));
   GateActorMessenger::SetNewValue( cmd, newValue);
 }
 //-----------------------------------------------------------------------------
@@ -13,8 +13,6 @@ See GATE/LICENSE.txt for further details
 #include "GateImageActorMessenger.hh"
 #include "GateVImageActor.hh"
 
-//#include "G4UIcmdWithABool.hh"
-
 //-----------------------------------------------------------------------------
 GateImageActorMessenger::GateImageActorMessenger(GateVImageActor * v)
 : GateActorMessenger(v),
@@ -35,6 +33,8 @@ GateImageActorMessenger::~GateImageActorMessenger()
   delete pHalfSizeCmd;
   delete pSizeCmd;
   delete pPositionCmd;
+  delete pSaveInBackgroundCmd;
+  delete pEnableCompressionCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -83,6 +83,16 @@ void GateImageActorMessenger::BuildCommands(G4String base)
   guidance = G4String("Sets  hit type ('pre', 'post', 'random' or 'middle'). Default is 'middle'.");
   pStepHitTypeCmd->SetGuidance(guidance);
 
+  bb = base+"/saveInBackground";
+  pSaveInBackgroundCmd = new G4UIcmdWithABool(bb,this);
+  guidance = G4String("Images are copied at each save and written by a background thread (default is false)");
+  pSaveInBackgroundCmd->SetGuidance(guidance);
+
+  bb = base+"/enableCompressedOutput";
+  pEnableCompressionCmd = new G4UIcmdWithABool(bb,this);
+  guidance = G4String("Compress (zlib) the images saved with the .mha extension (default is false)");
+  pEnableCompressionCmd->SetGuidance(guidance);
+
 }
 //-----------------------------------------------------------------------------
 
@@ -94,6 +104,8 @@ void GateImageActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue) {
   if (cmd == pSizeCmd)        pImageActor->SetSize(pSizeCmd->GetNew3VectorValue(newValue));
   if (cmd == pPositionCmd)    pImageActor->SetPosition(pPositionCmd->GetNew3VectorValue(newValue));
   if (cmd == pStepHitTypeCmd) pImageActor->SetStepHitType(newValue);
+  if (cmd == pSaveInBackgroundCmd)  pImageActor->EnableBackgroundWriting(pSaveInBackgroundCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableCompressionCmd) pImageActor->EnableCompressedOutput(pEnableCompressionCmd->GetNewBoolValue(newValue));
   GateActorMessenger::SetNewValue(cmd,newValue);
 }
 //-----------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+#include "GateImageEventBuffer.hh"
+#include "GateImageWithStatistic.hh"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+GateImageEventBuffer::GateImageEventBuffer()
+{
+  mKeys.resize(1024, -1);
+  mSlots.resize(1024, 0);
+  mMask = mKeys.size()-1;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageEventBuffer::AddImage(GateImageWithStatistic * image)
+{
+  if (std::find(mImages.begin(), mImages.end(), image) == mImages.end())
+    mImages.push_back(image);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageEventBuffer::RemoveImage(GateImageWithStatistic * image)
+{
+  std::vector<GateImageWithStatistic*>::iterator it = std::find(mImages.begin(), mImages.end(), image);
+  if (it != mImages.end()) mImages.erase(it);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageEventBuffer::EndOfEvent()
+{
+  if (mTouched.empty()) return;
+  for(unsigned int i=0; i<mImages.size(); i++) mImages[i]->FlushEventValues(mTouched);
+  Clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageEventBuffer::Clear()
+{
+  // Only the used entries are reset
+  for(unsigned int i=0; i<mPositions.size(); i++) mKeys[mPositions[i]] = -1;
+  mTouched.clear();
+  mPositions.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageEventBuffer::Grow()
+{
+  mKeys.assign(2*mKeys.size(), -1);
+  mSlots.resize(mKeys.size());
+  mMask = mKeys.size()-1;
+  for(unsigned int slot=0; slot<mTouched.size(); slot++) {
+    unsigned int h = Hash(mTouched[slot]);
+    while (mKeys[h] != -1) h = (h+1) & mMask;
+    mKeys[h] = mTouched[slot];
+    mSlots[h] = slot;
+    mPositions[slot] = h;
+  }
+}
+//-----------------------------------------------------------------------------
@@ -14,6 +14,8 @@
 #include "GateImageWithStatistic.hh"
 #include "GateMessageManager.hh"
 #include "GateMiscFunctions.hh"
+#include <algorithm>
+#include <fstream>
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -24,6 +26,10 @@ GateImageWithStatistic::GateImageWithStatistic()  {
   mOverWriteFilesFlag = true;
   mNormalizedToMax = false;
   mNormalizedToIntegral = false;
+  mIsBackgroundWritingEnabled = false;
+  pSnapshot = 0;
+  pEventBuffer = &mOwnEventBuffer;
+  pEventBuffer->AddImage(this);
 }
 //-----------------------------------------------------------------------------
 
@@ -31,6 +37,11 @@ GateImageWithStatistic::GateImageWithStatistic()  {
 //-----------------------------------------------------------------------------
 /// Destructor
 GateImageWithStatistic::~GateImageWithStatistic()  {
+  pEventBuffer->RemoveImage(this);
+  if (pSnapshot) {
+    GateBackgroundImageWriter::GetInstance()->Wait(pSnapshot);
+    delete pSnapshot;
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -39,7 +50,6 @@ GateImageWithStatistic::~GateImageWithStatistic()  {
 void GateImageWithStatistic::SetOrigin(G4ThreeVector o) {
   mValueImage.SetOrigin(o);
   mSquaredImage.SetOrigin(o);
-  mTempImage.SetOrigin(o);
   mUncertaintyImage.SetOrigin(o);
   mScaledValueImage.SetOrigin(o);
   mScaledSquaredImage.SetOrigin(o);
@@ -51,7 +61,6 @@ void GateImageWithStatistic::SetOrigin(G4ThreeVector o) {
 void GateImageWithStatistic::SetTransformMatrix(const G4RotationMatrix & m) {
   mValueImage.SetTransformMatrix(m);
   mSquaredImage.SetTransformMatrix(m);
-  mTempImage.SetTransformMatrix(m);
   mUncertaintyImage.SetTransformMatrix(m);
   mScaledValueImage.SetTransformMatrix(m);
   mScaledSquaredImage.SetTransformMatrix(m);
@@ -59,6 +68,17 @@ void GateImageWithStatistic::SetTransformMatrix(const G4RotationMatrix & m) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::SetCompression(bool b) {
+  mValueImage.SetCompression(b);
+  mSquaredImage.SetCompression(b);
+  mUncertaintyImage.SetCompression(b);
+  mScaledValueImage.SetCompression(b);
+  mScaledSquaredImage.SetCompression(b);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetScaleFactor(double s) {
   mScaleFactor = s;
@@ -77,13 +97,11 @@ void GateImageWithStatistic::SetResolutionAndHalfSize(const G4ThreeVector & reso
     mUncertaintyImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
-      mTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
       mScaledSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
-    mTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     mScaledSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
   }
 
@@ -108,13 +126,11 @@ void GateImageWithStatistic::Allocate() {
     mUncertaintyImage.Allocate();
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.Allocate();
-      mTempImage.Allocate();
       if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.Allocate();
-    mTempImage.Allocate();
     if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
   }
   if (mIsValuesMustBeScaled) mScaledValueImage.Allocate();
@@ -129,16 +145,16 @@ void GateImageWithStatistic::Reset(double val) {
     mUncertaintyImage.Fill(0.0);
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.Fill(val*val);
-      mTempImage.Fill(0.0);
       if (mIsValuesMustBeScaled) mScaledSquaredImage.Fill(0.0);
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.Fill(val*val);
-    mTempImage.Fill(0.0);
     if (mIsValuesMustBeScaled) mScaledSquaredImage.Fill(0.0);
   }
   if (mIsValuesMustBeScaled) mScaledValueImage.Fill(0.0);
+  // discard the values of the current event
+  std::fill(mEventValues.begin(), mEventValues.end(), 0.0);
 }
 //-----------------------------------------------------------------------------
 
@@ -175,20 +191,45 @@ void GateImageWithStatistic::AddValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddTempValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddTempValue index=" << index << " value=" << value << Gateendl);
-  mTempImage.AddValue(index, value);
+  unsigned int slot = pEventBuffer->GetSlot(index);
+  if (slot >= mEventValues.size()) mEventValues.resize(slot+1, 0.0);
+  mEventValues[slot] += value;
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
+  AddTempValue(index, value);
+}
+//-----------------------------------------------------------------------------
 
-  GateDebugMessageInc("Actor", 2, "AddValue and update -- start: "<<mTempImage.GetSize() << Gateendl);
-  double tmp = mTempImage.GetValue(index);
-  mValueImage.AddValue(index, tmp);
-  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) mSquaredImage.AddValue(index, tmp*tmp);
-  mTempImage.SetValue(index, value);
-  GateDebugMessageDec("Actor", 2, "AddValue and update -- end"<< Gateendl);
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::SetEventBuffer(GateImageEventBuffer * buffer) {
+  if (buffer == pEventBuffer) return;
+  pEventBuffer->EndOfEvent();
+  pEventBuffer->RemoveImage(this);
+  pEventBuffer = buffer;
+  pEventBuffer->AddImage(this);
+  mEventValues.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::FlushEventValues(const std::vector<int> & touchedVoxels) {
+  // Values of voxels touched only by the other images of the buffer are
+  // beyond mEventValues or null
+  unsigned int n = std::min(touchedVoxels.size(), mEventValues.size());
+  bool squared = (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled);
+  for(unsigned int i=0; i<n; i++) {
+    double v = mEventValues[i];
+    if (v == 0.0) continue;
+    mValueImage.AddValue(touchedVoxels[i], v);
+    if (squared) mSquaredImage.AddValue(touchedVoxels[i], v*v);
+    mEventValues[i] = 0.0;
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -206,6 +247,33 @@ void GateImageWithStatistic::SetFilename(G4String f) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Recorded in the .mhd header for the merge of split jobs (gjm) or of
+// workers: the squared image is scaled by the square of the factor of the
+// values. Normalised: 0 (no), 1 (to the max) or 2 (to the integral).
+static void SetStatisticHeaderFields(GateImageDouble & image, double scale, int normalisation, int numberOfEvents) {
+  image.SetHeaderField("ScaleFactor", scale);
+  image.SetHeaderField("Normalised", normalisation);
+  image.SetHeaderField("NumberOfEvents", numberOfEvents);
+}
+
+static int GetNormalisation(bool normalise, bool toMax, bool toIntegral) {
+  if (!normalise) return 0;
+  if (toMax) return 1;
+  if (toIntegral) return 2;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateImageWithStatistic::IsWrittenInBackground(const G4String & filename) {
+  std::string extension = getExtension(filename);
+  return (extension == "mhd" || extension == "mha");
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
 
@@ -216,6 +284,13 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     mUncertaintyFilename = GetSaveCurrentFilename(mUncertaintyInitialFilename);
   }
 
+  // Only the MetaImage formats are written by the background thread: the
+  // other writers (ROOT in particular) are not thread-safe
+  if (mIsBackgroundWritingEnabled && IsWrittenInBackground(mFilename)) {
+    SaveDataInBackground(numberOfEvents, normalise);
+    return;
+  }
+
   static double factor=1.0;
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {UpdateImage();}
 
@@ -242,6 +317,13 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
   GateMessage("Actor", 2, "Save " << mFilename << " with scaling = "
 	      << mScaleFactor << "(" << mIsValuesMustBeScaled << ")\n");
 
+  double scale = (mIsValuesMustBeScaled ? mScaleFactor : 1.0);
+  int normalisation = GetNormalisation(normalise, mNormalizedToMax, mNormalizedToIntegral);
+  SetStatisticHeaderFields(mValueImage, scale, normalisation, numberOfEvents);
+  SetStatisticHeaderFields(mScaledValueImage, scale, normalisation, numberOfEvents);
+  SetStatisticHeaderFields(mSquaredImage, scale, normalisation, numberOfEvents);
+  SetStatisticHeaderFields(mScaledSquaredImage, scale, normalisation, numberOfEvents);
+
   if (!mIsValuesMustBeScaled) mValueImage.Write(mFilename);
   else {
     GateImageDouble::iterator po = mScaledValueImage.begin();
@@ -253,9 +335,10 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
       ++po;
     }
     mScaledValueImage.Write(mFilename);
-    SetScaleFactor(factor);
   }
 
+  // the squared values are scaled by the square of the (normalised) factor
+  // of the values, so that the uncertainty does not depend on the scaling
   if (mIsSquaredImageEnabled) {
     UpdateSquaredImage();
     if (!mIsUncertaintyImageEnabled) { // only write if square enable and no uncertainty
@@ -267,42 +350,147 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     if (!mIsSquaredImageEnabled) UpdateSquaredImage();
     UpdateUncertaintyImage(numberOfEvents);
     mUncertaintyImage.Write(mUncertaintyFilename);
-    mSquaredImage.Write(mSquaredFilename); // force output of squared dose for grid
+    // force output of squared dose for grid
+    if(!mIsValuesMustBeScaled) mSquaredImage.Write(mSquaredFilename);
+    else mScaledSquaredImage.Write(mSquaredFilename);
   }
 
+  if (mIsValuesMustBeScaled) SetScaleFactor(factor);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
-void GateImageWithStatistic::UpdateImage() {
-  GateImageDouble::iterator pi = mValueImage.begin();
-  GateImageDouble::iterator pt = mTempImage.begin();
-  GateImageDouble::const_iterator pe = mValueImage.end();
-  while (pi != pe) {
-    *pi += (*pt);
-    ++pt;
-    ++pi;
+void GateImageWithStatistic::SaveDataInBackground(int numberOfEvents, bool normalise) {
+  // flush the pending event
+  UpdateImage();
+
+  // the previous snapshot of this image must be written before reuse
+  GateBackgroundImageWriter * writer = GateBackgroundImageWriter::GetInstance();
+  if (!pSnapshot) pSnapshot = new GateImageWithStatisticSnapshot;
+  else writer->Wait(pSnapshot);
+
+  pSnapshot->mValueImage = mValueImage;
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) pSnapshot->mSquaredImage = mSquaredImage;
+  pSnapshot->mIsSquaredImageEnabled = mIsSquaredImageEnabled;
+  pSnapshot->mIsUncertaintyImageEnabled = mIsUncertaintyImageEnabled;
+  pSnapshot->mIsValuesMustBeScaled = mIsValuesMustBeScaled;
+  pSnapshot->mScaleFactor = (mIsValuesMustBeScaled ? mScaleFactor : 1.0);
+  pSnapshot->mNormalise = normalise;
+  pSnapshot->mNormalizedToMax = mNormalizedToMax;
+  pSnapshot->mNormalizedToIntegral = mNormalizedToIntegral;
+  pSnapshot->mNumberOfEvents = numberOfEvents;
+  pSnapshot->mFilename = mFilename;
+  pSnapshot->mSquaredFilename = mSquaredFilename;
+  pSnapshot->mUncertaintyFilename = mUncertaintyFilename;
+
+  // same state as after a synchronous save
+  if (normalise) {
+    if (!mIsValuesMustBeScaled) mScaleFactor = 1.0;
+    mIsValuesMustBeScaled = true;
+  }
+
+  GateMessage("Actor", 2, "Save " << mFilename << " in background" << Gateendl);
+  writer->Submit(pSnapshot);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Written with GateMHDImage, not GateImageT::Write, which prints messages
+void GateImageWithStatisticSnapshot::Write(GateImageDouble & image, const G4String & filename) {
+  GateMHDImage mhd;
+  mhd.SetCompression(image.IsCompressionEnabled());
+  mhd.WriteData<double>(filename, &image);
+  mMessages.push_back("Saved " + filename + " (background)");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Same output as GateImageWithStatistic::SaveData, run by the background writer
+void GateImageWithStatisticSnapshot::Run() {
+  double scale = mScaleFactor;
+  bool scaled = mIsValuesMustBeScaled;
+  if (mNormalise) {
+    scaled = true;
+    double sum = 0.0;
+    double max = 0.0;
+    GateImageDouble::const_iterator pi = mValueImage.begin();
+    GateImageDouble::const_iterator pe = mValueImage.end();
+    while (pi != pe) {
+      if (*pi > max) max = *pi;
+      sum += *pi*mScaleFactor;
+      ++pi;
+    }
+    if (mNormalizedToMax) scale = mScaleFactor/max;
+    if (mNormalizedToIntegral) scale = mScaleFactor/sum;
+  }
+
+  int normalisation = GetNormalisation(mNormalise, mNormalizedToMax, mNormalizedToIntegral);
+  SetStatisticHeaderFields(mValueImage, scale, normalisation, mNumberOfEvents);
+  SetStatisticHeaderFields(mScaledValueImage, scale, normalisation, mNumberOfEvents);
+  SetStatisticHeaderFields(mSquaredImage, scale, normalisation, mNumberOfEvents);
+  SetStatisticHeaderFields(mScaledSquaredImage, scale, normalisation, mNumberOfEvents);
+
+  if (!scaled) Write(mValueImage, mFilename);
+  else {
+    mScaledValueImage = mValueImage;
+    GateImageDouble::iterator po = mScaledValueImage.begin();
+    GateImageDouble::const_iterator pe = mScaledValueImage.end();
+    while (po != pe) { *po *= scale; ++po; }
+    Write(mScaledValueImage, mFilename);
+  }
+
+  if (!mIsSquaredImageEnabled && !mIsUncertaintyImageEnabled) return;
+  if (scaled) {
+    mScaledSquaredImage = mSquaredImage;
+    GateImageDouble::iterator po = mScaledSquaredImage.begin();
+    GateImageDouble::const_iterator pe = mScaledSquaredImage.end();
+    double fact = scale*scale;
+    while (po != pe) { *po *= fact; ++po; }
   }
+  if (mIsSquaredImageEnabled && !mIsUncertaintyImageEnabled) {
+    if (!scaled) Write(mSquaredImage, mSquaredFilename);
+    else Write(mScaledSquaredImage, mSquaredFilename);
+  }
+  if (mIsUncertaintyImageEnabled) {
+    mUncertaintyImage = mValueImage;
+    if (scaled)
+      GateImageWithStatistic::ComputeUncertainty(mScaledValueImage, mScaledSquaredImage, mUncertaintyImage, mNumberOfEvents);
+    else
+      GateImageWithStatistic::ComputeUncertainty(mValueImage, mSquaredImage, mUncertaintyImage, mNumberOfEvents);
+    Write(mUncertaintyImage, mUncertaintyFilename);
+    // force output of squared dose for grid
+    if (!scaled) Write(mSquaredImage, mSquaredFilename);
+    else Write(mScaledSquaredImage, mSquaredFilename);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::UpdateImage() {
+  // flush the pending event (all the images sharing the buffer)
+  pEventBuffer->EndOfEvent();
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateSquaredImage() {
+  // the squared values of the pending event are added by the flush
+  pEventBuffer->EndOfEvent();
+  if (!mIsValuesMustBeScaled) return;
+
   GateImageDouble::iterator pi = mSquaredImage.begin();
-  GateImageDouble::iterator pt = mTempImage.begin();
   GateImageDouble::const_iterator pe = mSquaredImage.end();
-  GateImageDouble::iterator po;
-
-  if(mIsValuesMustBeScaled) po = mScaledSquaredImage.begin();
+  GateImageDouble::iterator po = mScaledSquaredImage.begin();
 
   double fact = mScaleFactor*mScaleFactor;
   while (pi != pe) {
-    *pi += (*pt)*(*pt);
-    if(mIsValuesMustBeScaled)  {  *po = (*pi)*fact;++po;}
-    *pt = 0;
-    ++pt;
+    *po = (*pi)*fact;
+    ++po;
     ++pi;
   }
 }
@@ -312,20 +500,24 @@ void GateImageWithStatistic::UpdateSquaredImage() {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 {
+  if(mIsValuesMustBeScaled)
+    ComputeUncertainty(mScaledValueImage, mScaledSquaredImage, mUncertaintyImage, numberOfEvents);
+  else
+    ComputeUncertainty(mValueImage, mSquaredImage, mUncertaintyImage, numberOfEvents);
+}
+//-----------------------------------------------------------------------------
 
-  GateImageDouble::iterator po = mUncertaintyImage.begin();
-  GateImageDouble::iterator pi;
-  GateImageDouble::iterator pii;
-  GateImageDouble::const_iterator pe;
-
-  if(mIsValuesMustBeScaled)  pi = mScaledValueImage.begin();
-  else pi = mValueImage.begin();
-
-  if(mIsValuesMustBeScaled) pii = mScaledSquaredImage.begin();
-  else pii = mSquaredImage.begin();
 
-  if(mIsValuesMustBeScaled)  pe = mScaledValueImage.end();
-  else pe = mValueImage.end();
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::ComputeUncertainty(const GateImageDouble & value,
+                                                const GateImageDouble & squaredValue,
+                                                GateImageDouble & uncertainty,
+                                                int numberOfEvents)
+{
+  GateImageDouble::iterator po = uncertainty.begin();
+  GateImageDouble::const_iterator pi = value.begin();
+  GateImageDouble::const_iterator pii = squaredValue.begin();
+  GateImageDouble::const_iterator pe = value.end();
 
   int N = numberOfEvents;
 
@@ -369,4 +561,148 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 }
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+// Fields written by SetStatisticHeaderFields, false if not found
+bool GateImageWithStatistic::ReadHeaderFields(const G4String & filename, double & scale,
+                                              int & normalisation, int & numberOfEvents)
+{
+  MetaImage m_MetaImage;
+  m_MetaImage.AddUserField("ScaleFactor", MET_DOUBLE_ARRAY, 1, false);
+  m_MetaImage.AddUserField("Normalised", MET_DOUBLE_ARRAY, 1, false);
+  m_MetaImage.AddUserField("NumberOfEvents", MET_DOUBLE_ARRAY, 1, false);
+  if (!m_MetaImage.Read(filename.c_str(), false)) return false;
+
+  const char * names[3] = { "ScaleFactor", "Normalised", "NumberOfEvents" };
+  double values[3];
+  for(int i=0; i<3; i++) {
+    void * r = m_MetaImage.GetUserField(names[i]);
+    if (r == 0) return false;
+    values[i] = *static_cast<double*>(r);
+    delete [] static_cast<char*>(r);
+  }
+  scale = values[0];
+  normalisation = (int)values[1];
+  numberOfEvents = (int)values[2];
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+static bool FileExists(const G4String & filename)
+{
+  std::ifstream is(filename.c_str());
+  return is.good();
+}
+
+static void AddImage(GateImageDouble & sum, const G4String & filename, bool first, double weight)
+{
+  if (first) {
+    sum.Read(filename);
+    if (weight != 1.0)
+      for(GateImageDouble::iterator po = sum.begin(); po != sum.end(); ++po) *po *= weight;
+    return;
+  }
+  GateImageDouble image;
+  image.Read(filename);
+  if (image.GetNumberOfValues() != sum.GetNumberOfValues())
+    GateError("The image " << filename << " has not the size of the image of the first worker.\n");
+  GateImageDouble::iterator po = sum.begin();
+  GateImageDouble::const_iterator pi = image.begin();
+  GateImageDouble::const_iterator pe = image.end();
+  while (pi != pe) { *po += (*pi)*weight; ++po; ++pi; }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// The values are summed as saved (scaled): all workers must have the same
+// scale factor. The normalised values of each worker are unscaled with its
+// own factor before the sum, which is normalised as in SaveData: its max is
+// the max of the images of the workers (the scale factor before the
+// normalisation), or its integral is 1.
+bool GateImageWithStatistic::MergeWorkerFiles(const std::vector<G4String> & inputs, const G4String & output)
+{
+  std::string extension = getExtension(output);
+  if (extension != "mhd" && extension != "mha") {
+    GateWarning("Only .mhd/.mha images of the workers are merged, not " << output);
+    return false;
+  }
+  G4String squaredInput = G4String(removeExtension(inputs[0]))+"-Squared."+extension;
+  G4String uncertaintyInput = G4String(removeExtension(inputs[0]))+"-Uncertainty."+extension;
+  bool squaredSaved = FileExists(squaredInput);
+  bool uncertaintySaved = FileExists(uncertaintyInput);
+
+  std::vector<double> scales(inputs.size());
+  int normalisation = 0;
+  int numberOfEvents = 0;
+  for(unsigned int i=0; i<inputs.size(); i++) {
+    int norm;
+    int n;
+    if (!FileExists(inputs[i]) || !ReadHeaderFields(inputs[i], scales[i], norm, n)) {
+      GateWarning("Cannot merge the image " << inputs[i] << " of the workers into " << output);
+      return false;
+    }
+    if (i > 0 && norm != normalisation) {
+      GateWarning("The images " << inputs[0] << ", ... are not normalised the same way, they are not merged");
+      return false;
+    }
+    if (i > 0 && norm == 0 && scales[i] != scales[0]) {
+      GateWarning("The images " << inputs[0] << ", ... have different scale factors, they are not merged");
+      return false;
+    }
+    if (norm != 0 && scales[i] == 0) {
+      GateWarning("The image " << inputs[i] << " is normalised with a null factor, it cannot be merged");
+      return false;
+    }
+    normalisation = norm;
+    numberOfEvents += n;
+  }
+
+  GateImageDouble value;
+  GateImageDouble squared;
+  double maxOfWorkers = 0.0;
+  for(unsigned int i=0; i<inputs.size(); i++) {
+    double weight = (normalisation == 0 ? 1.0 : 1.0/scales[i]);
+    AddImage(value, inputs[i], i == 0, weight);
+    if (i == 0 && normalisation == 1)
+      for(GateImageDouble::const_iterator pi = value.begin(); pi != value.end(); ++pi)
+        maxOfWorkers = std::max(maxOfWorkers, (*pi)*scales[0]);
+    if (squaredSaved) AddImage(squared, G4String(removeExtension(inputs[i]))+"-Squared."+extension, i == 0, weight*weight);
+  }
+
+  double scale = scales[0];
+  if (normalisation != 0) {
+    double max = 0.0;
+    double sum = 0.0;
+    for(GateImageDouble::const_iterator pi = value.begin(); pi != value.end(); ++pi) {
+      max = std::max(max, *pi);
+      sum += *pi;
+    }
+    if (normalisation == 1) scale = (max > 0 ? maxOfWorkers/max : 1.0);
+    else scale = (sum != 0 ? 1.0/sum : 1.0);
+    for(GateImageDouble::iterator po = value.begin(); po != value.end(); ++po) *po *= scale;
+    if (squaredSaved)
+      for(GateImageDouble::iterator po = squared.begin(); po != squared.end(); ++po) *po *= scale*scale;
+  }
+
+  SetStatisticHeaderFields(value, scale, normalisation, numberOfEvents);
+  value.Write(output);
+  if (squaredSaved) {
+    SetStatisticHeaderFields(squared, scale, normalisation, numberOfEvents);
+    squared.Write(G4String(removeExtension(output))+"-Squared."+extension);
+  }
+  if (uncertaintySaved && squaredSaved) {
+    GateImageDouble uncertainty = value;
+    ComputeUncertainty(value, squared, uncertainty, numberOfEvents);
+    uncertainty.Write(G4String(removeExtension(output))+"-Uncertainty."+extension);
+  }
+  GateMessage("Actor", 1, "Merged " << inputs.size() << " worker images ("
+              << numberOfEvents << " events) into " << output << Gateendl);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
 #endif /* end #define GATEIMAGEWITHSTATISTIC_CC */
@@ -27,7 +27,6 @@ GateKermaActor::GateKermaActor(G4String name, G4int depth):
   GateDebugMessageInc("Actor",4,"GateKermaActor() -- begin\n");
   mCurrentEvent=-1;
   mIsEdepImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mIsEdepSquaredImageEnabled = false;
   mIsEdepUncertaintyImageEnabled = false;
   mIsDoseImageEnabled = true;
@@ -114,16 +113,8 @@ void GateKermaActor::Construct() {
   SetOriginTransformAndFlagToImage(mDoseImage);
   SetOriginTransformAndFlagToImage(mDoseToWaterImage);
   SetOriginTransformAndFlagToImage(mNumberOfHitsImage);
-  SetOriginTransformAndFlagToImage(mLastHitEventImage);
 
   // Resize and allocate images
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
-      mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled) {
-    mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-    mLastHitEventImage.Allocate();
-    mIsLastHitEventImageEnabled = true;
-  }
   if (mIsEdepImageEnabled) {
     //  mEdepImage.SetLastHitEventImage(&mLastHitEventImage);
     mEdepImage.EnableSquaredImage(mIsEdepSquaredImageEnabled);
@@ -174,7 +165,6 @@ void GateKermaActor::Construct() {
               "\tEdep squared      = " << mIsEdepSquaredImageEnabled << Gateendl <<
               "\tEdep uncertainty  = " << mIsEdepUncertaintyImageEnabled << Gateendl <<
               "\tNumber of hit     = " << mIsNumberOfHitsImageEnabled << Gateendl <<
-              "\t     (last hit)   = " << mIsLastHitEventImageEnabled << Gateendl <<
               "\tedepFilename      = " << mEdepFilename << Gateendl <<
               "\tdoseFilename      = " << mDoseFilename << Gateendl <<
               "\tNb Hits filename  = " << mNbOfHitsFilename << Gateendl);
@@ -205,10 +195,6 @@ void GateKermaActor::SaveData() {
       mDoseToWaterImage.SaveData(mCurrentEvent+1, false);
   }
 
-  if (mIsLastHitEventImageEnabled) {
-    mLastHitEventImage.Fill(-1); // reset
-  }
-
   if (mIsNumberOfHitsImageEnabled) {
     mNumberOfHitsImage.Write(mNbOfHitsFilename);
   }
@@ -217,7 +203,6 @@ void GateKermaActor::SaveData() {
 
 //-----------------------------------------------------------------------------
 void GateKermaActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   if (mIsEdepImageEnabled) mEdepImage.Reset();
   if (mIsDoseImageEnabled) mDoseImage.Reset();
   if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Reset();
@@ -276,17 +261,6 @@ void GateKermaActor::UserSteppingActionInVoxel(const int index, const G4Step* st
     return;
   }
 
-  // compute sameEvent
-  // sameEvent is false the first time some energy is deposited for each primary particle
-  bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
-    GateDebugMessage("Actor", 2,  "GateKermaActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-    if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-      sameEvent = false;
-      mLastHitEventImage.SetValue(index, mCurrentEvent);
-    }
-  }
-
   double dose=0.;
 
   if (mIsDoseImageEnabled) {
@@ -364,8 +338,7 @@ void GateKermaActor::UserSteppingActionInVoxel(const int index, const G4Step* st
   if (mIsDoseImageEnabled) {
 
     if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled) {
-      if (sameEvent) mDoseImage.AddTempValue(index, dose);
-      else mDoseImage.AddValueAndUpdate(index, dose);
+      mDoseImage.AddTempValue(index, dose);
     }
     else mDoseImage.AddValue(index, dose);
   }
@@ -373,16 +346,14 @@ void GateKermaActor::UserSteppingActionInVoxel(const int index, const G4Step* st
   if (mIsDoseToWaterImageEnabled) {
 
     if (mIsDoseToWaterUncertaintyImageEnabled || mIsDoseToWaterSquaredImageEnabled) {
-      if (sameEvent) mDoseToWaterImage.AddTempValue(index, doseToWater);
-      else mDoseToWaterImage.AddValueAndUpdate(index, doseToWater);
+      mDoseToWaterImage.AddTempValue(index, doseToWater);
     }
     else mDoseToWaterImage.AddValue(index, doseToWater);
   }
 
   if (mIsEdepImageEnabled) {
     if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled) {
-      if (sameEvent) mEdepImage.AddTempValue(index, edep);
-      else mEdepImage.AddValueAndUpdate(index, edep);
+      mEdepImage.AddTempValue(index, edep);
     }
     else mEdepImage.AddValue(index, edep);
   }
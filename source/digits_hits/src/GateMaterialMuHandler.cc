@@ -31,9 +31,6 @@ GateMaterialMuHandler::GateMaterialMuHandler()
   mEnergyNumber = 40;
   mAtomicShellEnergyMin = 1. * keV;
   mPrecision = 0.01;
-
-  mLastCouple = 0;
-  mLastMuTable = 0;
 }
 //-----------------------------------------------------------------------------
 
@@ -45,62 +42,58 @@ GateMaterialMuHandler::~GateMaterialMuHandler()
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-void GateMaterialMuHandler::CheckLastCall(const G4MaterialCutsCouple* couple)
+GateMuTable *GateMaterialMuHandler::AddCoupleIndex(const G4MaterialCutsCouple* couple)
 {
-  if(!mIsInitialized) { Initialize(); }
-
-  if(couple != mLastCouple) {
-    mLastCouple = couple;
-    mLastMuTable = mCoupleTable[mLastCouple];
+  GateMuTable *table = mCoupleTable[couple];
+  int index = couple->GetIndex();
+  if(index >= 0)
+  {
+    if(index >= (int)mCoupleIndexTable.size()) { mCoupleIndexTable.resize(index+1, 0); }
+    mCoupleIndexTable[index] = table;
   }
+  return table;
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::GetDensity(const G4MaterialCutsCouple* couple)
 {
-  CheckLastCall(couple);
-  return mLastMuTable->GetDensity();
+  return FindMuTable(couple)->GetDensity();
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::GetMuEnOverRho(const G4MaterialCutsCouple* couple, double energy)
 {
-  CheckLastCall(couple);
-  return mLastMuTable->GetMuEnOverRho(energy);
+  return FindMuTable(couple)->GetMuEnOverRho(energy);
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::GetMuEn(const G4MaterialCutsCouple* couple, double energy)
 {
-  CheckLastCall(couple);
-  return mLastMuTable->GetMuEn(energy);
+  return FindMuTable(couple)->GetMuEn(energy);
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::GetMuOverRho(const G4MaterialCutsCouple* couple, double energy)
 {
-  CheckLastCall(couple);
-  return mLastMuTable->GetMuOverRho(energy);
+  return FindMuTable(couple)->GetMuOverRho(energy);
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::GetMu(const G4MaterialCutsCouple* couple, double energy)
 {
-  CheckLastCall(couple);
-  return mLastMuTable->GetMu(energy);
+  return FindMuTable(couple)->GetMu(energy);
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 GateMuTable *GateMaterialMuHandler::GetMuTable(const G4MaterialCutsCouple *couple)
 {
-  CheckLastCall(couple);
-  return mLastMuTable;
+  return FindMuTable(couple);
 }
 //-----------------------------------------------------------------------------
 
@@ -14,6 +14,9 @@ GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size)
   lastMuen = -1.0;
   lastEnergyMu = -1.0;
   lastEnergyMuen = -1.0;
+  mIndexGridIsValid = false;
+  mGridMin = 0.;
+  mGridInverseStep = 0.;
 
   mCouple = couple;
   mDensity = -1;
@@ -40,15 +43,69 @@ void GateMuTable::PutValue(int index, double energy, double mu, double mu_en)
   mEnergy[index] = energy;
   mMu[index] = mu;
   mMu_en[index] = mu_en;
+  mIndexGridIsValid = false;
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-inline double interpol(double x1, double x, double x2,
-		       double y1, double y2)
+void GateMuTable::BuildIndexGrid()
 {
-  return ( y1 + ( (y2-y1) * (x-x1) / (x2-x1) ) );  // if log storage
-//   return exp( log(y1) + log(y2/y1) / log(x2/x1)* log(x/x1) ); // if no log storage
+  mIndexGridIsValid = true;
+  mMuSlope.assign(mSize, 0.);
+  mMuEnSlope.assign(mSize, 0.);
+  for(int i = 0; i < mSize-1; i++)
+  {
+    double de = mEnergy[i+1] - mEnergy[i];
+    if(de > 0.)
+    {
+      mMuSlope[i] = (mMu[i+1] - mMu[i]) / de;
+      mMuEnSlope[i] = (mMu_en[i+1] - mMu_en[i]) / de;
+    }
+  }
+
+  // a few table points per bin at most
+  int nbOfBins = 4*mSize;
+  mGridMin = mEnergy[0];
+  double range = mEnergy[mSize-1] - mEnergy[0];
+  mGridInverseStep = (range > 0. ? nbOfBins / range : 0.);
+  mGridIndex.resize(nbOfBins);
+  int index = 0;
+  for(int b = 0; b < nbOfBins; b++)
+  {
+    double x = (mGridInverseStep > 0. ? mGridMin + b / mGridInverseStep : mGridMin);
+    while(index < mSize-2 && mEnergy[index+1] <= x) index++;
+    mGridIndex[b] = index;
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+inline int GateMuTable::FindIndex(double x)
+{
+  if(mSize < 2) { return 0; }
+  if(!mIndexGridIsValid) { BuildIndexGrid(); }
+
+  double bin = (x - mGridMin) * mGridInverseStep;
+  int index = 0;
+  if(bin >= (double)mGridIndex.size()) { index = mGridIndex.back(); }
+  else if(bin > 0.) { index = mGridIndex[(int)bin]; }
+  // rounding of the bin position
+  while(index < mSize-2 && mEnergy[index+1] <= x) { index++; }
+  while(index > 0 && mEnergy[index] > x) { index--; }
+  return index;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+inline double GateMuTable::Interpolate(const double *values, const std::vector<double> & slopes,
+                                       int index, double x)
+{
+  // log storage; the last value is kept out of the table
+  if(mSize > 1 && x > mEnergy[index] && x < mEnergy[index+1])
+  {
+    return exp(values[index] + slopes[index] * (x - mEnergy[index]));
+  }
+  return exp(values[index]);
 }
 //-----------------------------------------------------------------------------
 
@@ -58,22 +115,8 @@ double GateMuTable::GetMuEnOverRho(double energy)
   if (energy != lastEnergyMuen)
   {
     lastEnergyMuen = energy;
-
-    energy = log(energy);
-
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
-    double e_inf = mEnergy[inf];
-    double e_sup = mEnergy[sup];
-
-    if( energy > e_inf && energy < e_sup) { lastMuen = exp(interpol(e_inf, energy, e_sup, mMu_en[inf], mMu_en[sup])); }
-    else { lastMuen = exp(mMu_en[inf]); }
+    double x = log(energy);
+    lastMuen = Interpolate(mMu_en, mMuEnSlope, FindIndex(x), x);
   }
 
   return lastMuen;
@@ -93,22 +136,8 @@ double GateMuTable::GetMuOverRho(double energy)
   if (energy != lastEnergyMu)
   {
     lastEnergyMu = energy;
-
-    energy = log(energy);
-
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
-    double e_inf = mEnergy[inf];
-    double e_sup = mEnergy[sup];
-
-    if( energy > e_inf && energy < e_sup) { lastMu = exp(interpol(e_inf, energy, e_sup, mMu[inf], mMu[sup])); }
-    else { lastMu = exp(mMu[inf]); }
+    double x = log(energy);
+    lastMu = Interpolate(mMu, mMuSlope, FindIndex(x), x);
   }
 
   return lastMu;
@@ -122,4 +151,21 @@ double GateMuTable::GetMu(double energy)
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateMuTable::GetMuAndMuEnOverRho(double energy, double & muOverRho, double & muenOverRho)
+{
+  if (energy != lastEnergyMu || energy != lastEnergyMuen)
+  {
+    lastEnergyMu = energy;
+    lastEnergyMuen = energy;
+    double x = log(energy);
+    int index = FindIndex(x);
+    lastMu = Interpolate(mMu, mMuSlope, index, x);
+    lastMuen = Interpolate(mMu_en, mMuEnSlope, index, x);
+  }
+  muOverRho = lastMu;
+  muenOverRho = lastMuen;
+}
+//-----------------------------------------------------------------------------
+
 #endif
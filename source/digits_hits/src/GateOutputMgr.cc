@@ -409,6 +409,20 @@ GateVOutputModule* GateOutputMgr::GetModule(G4String aName)
 }
 //----------------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------------
+void GateOutputMgr::AddFileNameSuffixForAllOutput(const G4String& suffix)
+{
+  std::vector<GateVOutputModule*>::iterator aIt;
+  for ( aIt = m_outputModules.begin(); aIt != m_outputModules.end(); aIt++)
+    {
+      // modules without file name are checked by CheckFileNameForAllOutput
+      if ( (*aIt)->IsEnabled() && (*aIt)->GiveNameOfFile()!=" " && (*aIt)->GiveNameOfFile()!="  ")
+        (*aIt)->AddFileNameSuffix(suffix);
+    }
+}
+//----------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------
 void GateOutputMgr::CheckFileNameForAllOutput()
 {
@@ -27,6 +27,7 @@
 #include "GateIAEARecord.h"
 #include "GateIAEAUtilities.h"
 #include "GateSourceMgr.hh"
+#include "GateActorMerger.hh"
 
 #include "G4ParticleTable.hh"
 
@@ -72,6 +73,7 @@ GatePhaseSpaceActor::GatePhaseSpaceActor(G4String name, G4int depth):
   mNevent = 0;
   pIAEARecordType = 0;
   pIAEAheader = 0;
+  pBinaryWriter = 0;
   mFileSize = 0;
   GateDebugMessageDec("Actor", 4, "GatePhaseSpaceActor() -- end\n");
 }
@@ -88,6 +90,7 @@ GatePhaseSpaceActor::~GatePhaseSpaceActor() {
   free(pIAEARecordType);
   pIAEAheader = 0;
   pIAEARecordType = 0;
+  delete pBinaryWriter;
   delete pMessenger;
   GateDebugMessageDec("Actor", 4, "~GatePhaseSpaceActor() -- end\n");
 }
@@ -111,8 +114,9 @@ void GatePhaseSpaceActor::Construct() {
 
   if (extension == "root") mFileType = "rootFile";
   else if (extension == "IAEAphsp" || extension == "IAEAheader" ) mFileType = "IAEAFile";
+  else if (extension == "gphsp") mFileType = "binaryFile";
   else GateError( "Unknow phase space file extension. Knowns extensions are : "
-                    << Gateendl << ".IAEAphsp (or IAEAheader), .root\n");
+                    << Gateendl << ".IAEAphsp (or IAEAheader), .root, .gphsp\n");
 
   if (mFileType == "rootFile") {
 
@@ -175,6 +179,14 @@ void GatePhaseSpaceActor::Construct() {
       GateWarning("'Mass' is not available in IAEA phase space.");
     }
     if ( pIAEAheader->set_record_contents(pIAEARecordType) == FAIL) GateError("Record contents not setted.");
+  } else if (mFileType == "binaryFile") {
+    // fixed records: energy, position, direction, weight, time and PDG code
+    // are always stored, other variables are not available
+    if (EnableProdVol || EnableProdProcess || EnableMass || bEnablePrimaryEnergy || bEnableEmissionPoint || bEnableSpotID) {
+      GateMessage("Actor", 1, "Only energy, position, direction, weight, time and particle type are stored in .gphsp phase space.\n");
+    }
+    pBinaryWriter = new GateBinaryPhaseSpaceWriter;
+    pBinaryWriter->Open(mSaveFilename);
   }
 }
 // --------------------------------------------------------------------
@@ -446,6 +458,19 @@ void GatePhaseSpaceActor::UserSteppingAction(const GateVVolume *, const G4Step *
 
     pIAEAheader->update_counters(pIAEARecordType);
 
+  } else if (mFileType == "binaryFile") {
+    GateBinaryPhaseSpaceRecord record;
+    record.energy = e;
+    record.x = x;
+    record.y = y;
+    record.z = z;
+    record.dx = dx;
+    record.dy = dy;
+    record.dz = dz;
+    record.weight = (EnableWeight ? w : 1.0);
+    record.time = (EnableTime || EnableLocalTime ? t : 0.0);
+    record.pdgCode = bPDGCode;
+    pBinaryWriter->Write(record);
   }
   mIsFistStep = false;
 }
@@ -477,6 +502,8 @@ void GatePhaseSpaceActor::SaveData() {
 
     fclose(pIAEAheader->fheader);
     fclose(pIAEARecordType->p_file);
+  } else if (mFileType == "binaryFile") {
+    pBinaryWriter->Flush();
   }
 }
 
@@ -485,10 +512,52 @@ void GatePhaseSpaceActor::ResetData() {
     pListeVar->Reset();
     return;
   }
+  if (mFileType == "binaryFile") {
+    pBinaryWriter->Reset();
+    return;
+  }
 
   GateError("Can't reset phase space");
 }
 // --------------------------------------------------------------------
 
 
+// --------------------------------------------------------------------
+// The particles of an IAEA phase space are counted in its header, they
+// are not merged
+bool GatePhaseSpaceActor::CanMergeWorkerOutputs() {
+  G4String extension = getExtension(mSaveFilename);
+  return (extension == "root" || extension == "gphsp");
+}
+
+// The particles of the workers are concatenated: the trees of the .root
+// files by the merger of gjm, the records of the .gphsp files here
+void GatePhaseSpaceActor::MergeWorkerOutputs(const std::vector<G4String> & workerFilenames) {
+  if (getExtension(mSaveFilename) == "root") {
+    std::vector<std::string> inputs(workerFilenames.begin(), workerFilenames.end());
+    GateActorMerger merger(0, true, "");
+    if (!merger.MergeTrees(inputs, mSaveFilename))
+      GateError("Cannot merge the phase spaces " << workerFilenames[0] << ", ... of actor " << GetObjectName());
+  }
+  else {
+    GateBinaryPhaseSpaceWriter writer;
+    writer.Open(mSaveFilename);
+    std::vector<GateBinaryPhaseSpaceRecord> block(4096);
+    for(unsigned int w=0; w<workerFilenames.size(); w++) {
+      GateBinaryPhaseSpaceReader reader;
+      reader.Open(workerFilenames[w]);
+      uint64_t first = 0;
+      uint64_t n;
+      while ((n = reader.ReadRecords(first, block.size(), &block[0])) > 0) {
+        for(uint64_t i=0; i<n; i++) writer.Write(block[i]);
+        first += n;
+      }
+    }
+    writer.Close();
+  }
+  GateMessage("Actor", 1, "Merged " << workerFilenames.size() << " worker phase spaces into " << mSaveFilename << Gateendl);
+}
+// --------------------------------------------------------------------
+
+
 #endif /* end #define G4ANALYSIS_USE_ROOT */
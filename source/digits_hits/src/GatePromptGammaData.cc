@@ -427,6 +427,20 @@ TH1D * GatePromptGammaData::GetGammaEnergySpectrum(const int & materialIndex,
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+TH1D * GatePromptGammaData::GetGammaEnergySpectrumOfBin(const int & materialIndex,
+                                                        const int & protonBin)
+{
+  if (!DataForMaterialExist(materialIndex)) {
+    GateError("Error in GatePromptGammaData for TLE, the material " <<
+              (*G4Material::GetMaterialTable())[materialIndex]->GetName()
+              << " is not in the DB. materialIndex: " << materialIndex);
+  }
+  return mGammaEnergyHistoByMaterialByProtonEnergy[materialIndex][protonBin];
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 TH2D* GatePromptGammaData::GetNgammaM(const int & materialIndex)
 {
@@ -17,6 +17,9 @@
 #include <G4Proton.hh>
 #include <G4VProcess.hh>
 
+#include <unistd.h>
+#include <pthread.h>
+
 //-----------------------------------------------------------------------------
 GatePromptGammaTLEActor::GatePromptGammaTLEActor(G4String name, G4int depth):
   GateVImageActor(name, depth)
@@ -27,6 +30,9 @@ GatePromptGammaTLEActor::GatePromptGammaTLEActor(G4String name, G4int depth):
   mCurrentEvent = -1;
   mIsDebugOutputEnabled = false;
   mIsOutputMatchEnabled = false;
+  mIsDeferredSpectrumEnabled = false;
+  mIsSparseOutputEnabled = false;
+  mDeferredTrackl = NULL;
   alreadyHere = false;
 }
 //-----------------------------------------------------------------------------
@@ -77,6 +83,10 @@ void GatePromptGammaTLEActor::Construct()
     SetTrackIoH(trackl);
     SetTrackIoH(tracklsq);
   }
+  if (mIsDeferredSpectrumEnabled) {
+    SetTrackIoH(mDeferredTrackl);
+    mDeferredMaterial.assign(mDeferredTrackl->GetNumberOfValues(), -1);
+  }
 
   // Force hit type to random
   if (mStepHitType != RandomStepHitType) {
@@ -98,6 +108,10 @@ void GatePromptGammaTLEActor::ResetData()
   trackl->Reset();
   tracklsq->Reset();
   mLastHitEventImage.Fill(-1);
+  if (mIsDeferredSpectrumEnabled) {
+    mDeferredTrackl->Reset();
+    mDeferredMaterial.assign(mDeferredMaterial.size(), -1);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -112,6 +126,8 @@ void GatePromptGammaTLEActor::SaveData()
 
   //GateVImageActor::SaveData();  //What does this do?
 
+  if (mIsDeferredSpectrumEnabled) BuildDeferredSpectrum();
+
   // Number of primaries for normalisation, so that we have the number per proton, which is easier to use.
   mImageGamma->Scale(1./(GateActorManager::GetInstance()->GetCurrentEventId() + 1));// +1 because start at zero
   mImageGamma->Write(mSaveFilename);
@@ -209,6 +225,20 @@ void GatePromptGammaTLEActor::UserSteppingActionInVoxel(int index, const G4Step
     material = GateDetectorConstruction::GetGateDetectorConstruction()->mMaterialDatabase.GetMaterial(materialname);
   }
 
+  // Deferred spectrum: only the track length is stored when the voxel
+  // material is the one of its first step, see BuildDeferredSpectrum
+  if (mIsDeferredSpectrumEnabled) {
+    int materialIndex = material->GetIndex();
+    int &voxelMaterial = mDeferredMaterial[index];
+    if (voxelMaterial < 0) voxelMaterial = materialIndex;
+    if (voxelMaterial == materialIndex) {
+      int protbin = data.GetHEp()->FindFixBin(particle_energy/MeV);
+      if (protbin >= 1 && protbin <= data.GetProtonNbBins())
+        mDeferredTrackl->AddValueDouble(index, protbin-1, distance * material->GetDensity() / (g / cm3));
+      return;
+    }
+  }
+
   // Get value from histogram. We do not check the material index, and
   // assume everything exist (has been computed by InitializeMaterial)
   TH1D *h = data.GetGammaEnergySpectrum(material->GetIndex(), particle_energy);
@@ -315,6 +345,92 @@ void GatePromptGammaTLEActor::BuildVarianceOutput() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Part of the voxels converted by one thread of BuildDeferredSpectrum
+struct GatePromptGammaSpectrumTask {
+  const double * trackl;                 //voxel x E_proton
+  const int * material;                  //material index per voxel
+  const std::vector<double> * spectra;   //per material: E_proton x E_gamma
+  double * const * gamma;                //E_gamma histogram per voxel
+  int protonNbBins;
+  int gammaNbBins;
+  long firstVoxel;
+  long lastVoxel;
+};
+
+static void * ExpandDeferredSpectrum(void * arg)
+{
+  GatePromptGammaSpectrumTask * task = (GatePromptGammaSpectrumTask*)arg;
+  for(long v=task->firstVoxel; v<task->lastVoxel; v++) {
+    if (task->material[v] < 0) continue;
+    const double * spectrum = &task->spectra[task->material[v]][0];
+    const double * trackl = task->trackl + v*task->protonNbBins;
+    double * gamma = task->gamma[v];
+    for(int pi=0; pi<task->protonNbBins; pi++) {
+      double l = trackl[pi];
+      if (l == 0.) continue;
+      const double * s = spectrum + (long)pi*task->gammaNbBins;
+      for(int gi=0; gi<task->gammaNbBins; gi++) gamma[gi] += l * s[gi];
+    }
+  }
+  return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePromptGammaTLEActor::BuildDeferredSpectrum() {
+  int protonNbBins = data.GetProtonNbBins();
+  int gammaNbBins = data.GetGammaNbBins();
+  long nbOfVoxels = mDeferredTrackl->GetNumberOfValues();
+
+  // Copy the spectra of the materials used into plain arrays (ROOT
+  // histograms are only read here, not by the threads)
+  std::vector<std::vector<double> > spectra(G4Material::GetNumberOfMaterials());
+  for(long v=0; v<nbOfVoxels; v++) {
+    int m = mDeferredMaterial[v];
+    if (m < 0 || !spectra[m].empty()) continue;
+    spectra[m].resize((long)protonNbBins*gammaNbBins);
+    for(int pi=0; pi<protonNbBins; pi++) {
+      TH1D * h = data.GetGammaEnergySpectrumOfBin(m, pi+1);
+      for(int gi=0; gi<gammaNbBins; gi++)
+        spectra[m][(long)pi*gammaNbBins+gi] = h->GetBinContent(gi+1);
+    }
+  }
+
+  // Output histograms of the voxels, allocated here if the output is sparse
+  std::vector<double*> gamma(nbOfVoxels, (double*)NULL);
+  for(long v=0; v<nbOfVoxels; v++)
+    if (mDeferredMaterial[v] >= 0) gamma[v] = mImageGamma->GetHistoDoublePointer(v);
+
+  // Sum over E_proton, voxels are split between the threads
+  int nbOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (nbOfThreads < 1) nbOfThreads = 1;
+  if (nbOfThreads > nbOfVoxels) nbOfThreads = (nbOfVoxels > 0 ? nbOfVoxels : 1);
+  std::vector<GatePromptGammaSpectrumTask> tasks(nbOfThreads);
+  std::vector<pthread_t> threads(nbOfThreads);
+  for(int t=0; t<nbOfThreads; t++) {
+    tasks[t].trackl = mDeferredTrackl->GetDataDoublePointer();
+    tasks[t].material = &mDeferredMaterial[0];
+    tasks[t].spectra = &spectra[0];
+    tasks[t].gamma = &gamma[0];
+    tasks[t].protonNbBins = protonNbBins;
+    tasks[t].gammaNbBins = gammaNbBins;
+    tasks[t].firstVoxel = nbOfVoxels*t/nbOfThreads;
+    tasks[t].lastVoxel = nbOfVoxels*(t+1)/nbOfThreads;
+  }
+  // the last part is converted by this thread
+  int nbOfStartedThreads = 0;
+  for(int t=0; t<nbOfThreads-1; t++) {
+    if (pthread_create(&threads[t], NULL, ExpandDeferredSpectrum, &tasks[t]) != 0) break;
+    nbOfStartedThreads++;
+  }
+  for(int t=nbOfStartedThreads; t<nbOfThreads; t++) ExpandDeferredSpectrum(&tasks[t]);
+  for(int t=0; t<nbOfStartedThreads; t++) pthread_join(threads[t], NULL);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 GateVImageVolume* GatePromptGammaTLEActor::GetPhantom() {
   // Search for voxelized volume. If more than one, crash (yet).
@@ -344,6 +460,7 @@ void GatePromptGammaTLEActor::SetTLEIoH(GateImageOfHistograms*& ioh) {
   ioh->SetOrigin(mOrigin);
   ioh->SetTransformMatrix(mImage.GetTransformMatrix());
   ioh->SetHistoInfo(data.GetGammaNbBins(), data.GetGammaEMin(), data.GetGammaEMax());
+  ioh->SetSparse(mIsSparseOutputEnabled);
   ioh->Allocate();
   ioh->PrintInfo();
 }
@@ -28,6 +28,9 @@ GatePromptGammaTLEActorMessenger::~GatePromptGammaTLEActorMessenger()
   DD("GatePromptGammaTLEActorMessenger destructor");
   delete pSetInputDataFileCmd;
   delete pEnableDebugOutputCmd;
+  delete pEnableOutputMatchCmd;
+  delete pEnableDeferredSpectrumCmd;
+  delete pEnableSparseOutputCmd;
   //delete pEnableSysVarianceCmd;
   //delete pEnableIntermediaryUncertaintyOutputCmd;
 }
@@ -52,6 +55,16 @@ void GatePromptGammaTLEActorMessenger::BuildCommands(G4String base)
   guidance = G4String("Enable this too make sure the regular TLE output and debug output match. In corner cases where voxels of the image and TLE actor don't match, DebugOutput will take the material at the voxel center, while regular TLE will take the material at the interaction point. Enabling this will force regular TLE to also look at the voxel center.");
   pEnableOutputMatchCmd->SetGuidance(guidance);
 
+  bb = base+"/enableDeferredSpectrum";
+  pEnableDeferredSpectrumCmd = new G4UIcmdWithABool(bb, this);
+  guidance = G4String("Enable this to store only the track length per voxel per E_proton during the simulation, and to convert it into gamma spectra once, when the output is saved. Same output, faster stepping, but needs an image of E_proton bins in memory.");
+  pEnableDeferredSpectrumCmd->SetGuidance(guidance);
+
+  bb = base+"/enableSparseOutput";
+  pEnableSparseOutputCmd = new G4UIcmdWithABool(bb, this);
+  guidance = G4String("Enable this to allocate the output gamma spectra only in the voxels reached by protons. Same output file, less memory when most of the image is not irradiated.");
+  pEnableSparseOutputCmd->SetGuidance(guidance);
+
 }
 //-----------------------------------------------------------------------------
 
@@ -62,6 +75,8 @@ void GatePromptGammaTLEActorMessenger::SetNewValue(G4UIcommand* cmd, G4String ne
   if (cmd == pSetInputDataFileCmd) pTLEActor->SetInputDataFilename(newValue);
   if (cmd == pEnableDebugOutputCmd) pTLEActor->EnableDebugOutput(pEnableDebugOutputCmd->GetNewBoolValue(newValue));
   if (cmd == pEnableOutputMatchCmd) pTLEActor->EnableOutputMatch(pEnableOutputMatchCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableDeferredSpectrumCmd) pTLEActor->EnableDeferredSpectrum(pEnableDeferredSpectrumCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableSparseOutputCmd) pTLEActor->EnableSparseOutput(pEnableSparseOutputCmd->GetNewBoolValue(newValue));
   //if (cmd == pEnableSysVarianceCmd) pTLEActor->EnableSysVarianceImage(pEnableSysVarianceCmd->GetNewBoolValue(newValue));
   //if (cmd == pEnableIntermediaryUncertaintyOutputCmd) pTLEActor->EnableIntermediaryUncertaintyOutput(pEnableIntermediaryUncertaintyOutputCmd->GetNewBoolValue(newValue));
   GateImageActorMessenger::SetNewValue(cmd,newValue);
@@ -12,6 +12,9 @@ See GATE/LICENSE.txt for further details
 
 #include "G4UnitsTable.hh"
 
+G4Allocator<GatePulse> GatePulseAllocator;
+G4Allocator<GatePulseList> GatePulseListAllocator;
+
 GatePulse::GatePulse(const void* itsMother)
   : m_runID(-1),
     m_eventID(-1),
@@ -199,6 +202,7 @@ GatePulseList::GatePulseList(const GatePulseList& src):
 std::vector<GatePulse*>()
 {
     m_name=src.m_name;
+    reserve(src.size());
     for (GatePulseConstIterator it=src.begin();it != src.end() ;++it)
     	push_back(new GatePulse( **it ));
 }
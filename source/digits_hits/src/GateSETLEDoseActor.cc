@@ -32,6 +32,15 @@
 #include "G4PhysicalConstants.hh"
 
 #include <typeinfo>
+#include <map>
+#include <algorithm>
+#include <cmath>
+
+// The rays are cast by packets of the width of the vector registers when
+// the compiler targets AVX2 or AVX-512 (e.g. -march=native), else one by one
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 //-----------------------------------------------------------------------------
 GateSETLEDoseActor::GateSETLEDoseActor(G4String name, G4int depth) :
   GateVImageActor(name,depth) {
@@ -47,9 +56,6 @@ GateSETLEDoseActor::GateSETLEDoseActor(G4String name, G4int depth) :
   mIsSecondaryDoseImageEnabled = false;
   mIsSecondaryDoseUncertaintyImageEnabled = false;
 
-  mIsLastHitEventImageEnabled = false;
-  mIsPrimaryLastHitEventImageEnabled = false;
-  mIsSecondaryLastHitEventImageEnabled = false;
 
   mIsHybridinoEnabled = false;
   mIsMuTableInitialized = false;
@@ -101,6 +107,7 @@ void GateSETLEDoseActor::Construct() {
   // Enable callbacks
   EnableBeginOfRunAction(true);
   EnableBeginOfEventAction(true);
+  EnableEndOfEventAction(true);
   EnableUserSteppingAction(true);
 
 //   GateMessage("Actor", 0, " halfSize " << mHalfSize << " resolution " << mResolution << " placement " << mPosition << Gateendl);
@@ -117,13 +124,11 @@ void GateSETLEDoseActor::Construct() {
     mDoseImage.EnableSquaredImage(false);
     mDoseImage.EnableUncertaintyImage(mIsDoseUncertaintyImageEnabled);
     mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseImage.SetEventBuffer(&mEventBuffer);
     // Force the computation of squared image if uncertainty is enabled
     if(mIsDoseUncertaintyImageEnabled)
     {
       mDoseImage.EnableSquaredImage(true);
-      mIsLastHitEventImageEnabled = true;
-      mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mLastHitEventImage.Allocate();
     }
     mDoseImage.Allocate();
     mDoseImage.SetFilename(mDoseFilename);
@@ -136,13 +141,11 @@ void GateSETLEDoseActor::Construct() {
     mPrimaryDoseImage.EnableSquaredImage(false);
     mPrimaryDoseImage.EnableUncertaintyImage(mIsPrimaryDoseUncertaintyImageEnabled);
     mPrimaryDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mPrimaryDoseImage.SetEventBuffer(&mEventBuffer);
     // Force the computation of squared image if uncertainty is enabled
     if(mIsPrimaryDoseUncertaintyImageEnabled)
     {
       mPrimaryDoseImage.EnableSquaredImage(true);
-      mIsPrimaryLastHitEventImageEnabled = true;
-      mPrimaryLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mPrimaryLastHitEventImage.Allocate();
     }
     mPrimaryDoseImage.Allocate();
     mPrimaryDoseImage.SetFilename(mPrimaryDoseFilename);
@@ -155,13 +158,11 @@ void GateSETLEDoseActor::Construct() {
     mSecondaryDoseImage.EnableSquaredImage(false);
     mSecondaryDoseImage.EnableUncertaintyImage(mIsSecondaryDoseUncertaintyImageEnabled);
     mSecondaryDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mSecondaryDoseImage.SetEventBuffer(&mEventBuffer);
     // Force the computation of squared image if uncertainty is enabled
     if(mIsSecondaryDoseUncertaintyImageEnabled)
     {
       mSecondaryDoseImage.EnableSquaredImage(true);
-      mIsSecondaryLastHitEventImageEnabled = true;
-      mSecondaryLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mSecondaryLastHitEventImage.Allocate();
     }
     mSecondaryDoseImage.Allocate();
     mSecondaryDoseImage.SetFilename(mSecondaryDoseFilename);
@@ -192,7 +193,9 @@ void GateSETLEDoseActor::InitializeMaterialAndMuTable()
     int planeSize = (int)lrint(mResolution.x()*mResolution.y());
     int voxelIndex = -1;
 
-    mListOfMuTable.resize(mResolution.x()*mResolution.y()*mResolution.z());
+    mVoxelMaterials.resize(mResolution.x()*mResolution.y()*mResolution.z());
+    mListOfMuTable.clear();
+    std::map<GateMuTable *, int> materialIndices;
 
     GateVImageVolume* volume = dynamic_cast<GateVImageVolume*>(GetVolume());
     G4Region *region = G4RegionStore::GetInstance()->GetRegion(volume->GetObjectName());
@@ -205,11 +208,23 @@ void GateSETLEDoseActor::InitializeMaterialAndMuTable()
 	{
 	  voxelIndex = x+y*lineSize+z*planeSize;
 	  G4Material *material = detectorConstruction->mMaterialDatabase.GetMaterial(volume->GetMaterialNameFromLabel(volume->GetImage()->GetValue(x,y,z)));
-	  mListOfMuTable[voxelIndex] = mMaterialHandler->GetMuTable(region->FindCouple(material));
+	  GateMuTable *muTable = mMaterialHandler->GetMuTable(region->FindCouple(material));
+	  std::map<GateMuTable *, int>::iterator it = materialIndices.find(muTable);
+	  if(it == materialIndices.end())
+	  {
+	    it = materialIndices.insert(std::make_pair(muTable, (int)mListOfMuTable.size())).first;
+	    mListOfMuTable.push_back(muTable);
+	  }
+	  mVoxelMaterials[voxelIndex] = it->second;
 	}
       }
     }
 
+    // -1: no energy computed yet
+    mMaterialEnergy.assign(mListOfMuTable.size(), -1.0);
+    mMaterialMu.assign(mListOfMuTable.size(), 0.0);
+    mMaterialDoseFactor.assign(mListOfMuTable.size(), 0.0);
+
     mIsMuTableInitialized = true;
   }
 
@@ -222,6 +237,19 @@ void GateSETLEDoseActor::InitializeMaterialAndMuTable()
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateSETLEDoseActor::UpdateMaterialCoefficients(int material, double energy)
+{
+  double muOverRho, muenOverRho;
+  mListOfMuTable[material]->GetMuAndMuEnOverRho(energy, muOverRho, muenOverRho);
+  double mu = muOverRho * mListOfMuTable[material]->GetDensity();
+  mMaterialEnergy[material] = energy;
+  // mu is in cm-1, lengths in mm
+  mMaterialMu[material] = mu/10.;
+  mMaterialDoseFactor[material] = ConversionFactor*energy*muenOverRho/mu/VoxelVolume;
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 /// Save data
 void GateSETLEDoseActor::SaveData()
@@ -230,18 +258,12 @@ void GateSETLEDoseActor::SaveData()
   if(mIsPrimaryDoseImageEnabled) { mPrimaryDoseImage.SaveData(mCurrentEvent+1, false); }
   if(mIsSecondaryDoseImageEnabled) { mSecondaryDoseImage.SaveData(mCurrentEvent+1, false); }
 
-  if(mIsLastHitEventImageEnabled) { mLastHitEventImage.Fill(-1); /* reset */ }
-  if(mIsPrimaryLastHitEventImageEnabled) { mPrimaryLastHitEventImage.Fill(-1); /* reset */ }
-  if(mIsSecondaryLastHitEventImageEnabled) { mSecondaryLastHitEventImage.Fill(-1); /* reset */ }
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 void GateSETLEDoseActor::ResetData()
 {
-  if(mIsLastHitEventImageEnabled) { mLastHitEventImage.Fill(-1); }
-  if(mIsPrimaryLastHitEventImageEnabled) { mPrimaryLastHitEventImage.Fill(-1); }
-  if(mIsSecondaryLastHitEventImageEnabled) { mSecondaryLastHitEventImage.Fill(-1); }
 
   if(mIsDoseImageEnabled) { mDoseImage.Reset(); }
   if(mIsPrimaryDoseImageEnabled) { mPrimaryDoseImage.Reset(); }
@@ -291,6 +313,15 @@ void GateSETLEDoseActor::BeginOfEventAction(const G4Event *) {
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateSETLEDoseActor::EndOfEventAction(const G4Event * event)
+{
+  // the dose of the rays goes in the event buffer flushed below
+  CastPendingRays();
+  GateVImageActor::EndOfEventAction(event);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateSETLEDoseActor::PreUserTrackingAction(const GateVVolume *, const G4Track *) {}
 //-----------------------------------------------------------------------------
@@ -330,7 +361,13 @@ void GateSETLEDoseActor::UserSteppingAction(const GateVVolume *v, const G4Step*
 	  mNearestDistance = 0.0;
 	}
 
-	weight = RayCast(isPrimary, energy, weight, position, momentum);
+	// cast with the other rays of the event (see CastPendingRays)
+	VoxelRay ray;
+	ray.isPrimary = isPrimary;
+	ray.energy = energy;
+	ray.weight = weight;
+	InitializeRay(ray, position, momentum);
+	mPendingRays.push_back(ray);
       }
     }
 
@@ -385,20 +422,17 @@ static inline int getIncrement(double value)
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-double GateSETLEDoseActor::RayCast(bool isPrimary, double energy, double weight, G4ThreeVector position, G4ThreeVector momentum)
+void GateSETLEDoseActor::InitializeRay(VoxelRay & ray, G4ThreeVector position, G4ThreeVector momentum)
 {
-//   GateMessage("Actor", 0, "  \n";);
-//   GateMessage("Actor", 0, " halfSize " << mHalfSize << " resolution " << mResolution << " voxelSize " << mVoxSize << Gateendl);
-
   int xincr = getIncrement(momentum.x());
   int yincr = getIncrement(momentum.y());
   int zincr = getIncrement(momentum.z());
 
   //Momentum norm have to be 1
   //double norm = momentum.mag();
-  double Lx = xincr * mVoxelSize.x() / momentum.x(); //*norm
-  double Ly = yincr * mVoxelSize.y() / momentum.y(); //*norm
-  double Lz = zincr * mVoxelSize.z() / momentum.z(); //*norm
+  ray.voxelLength[0] = xincr * mVoxelSize.x() / momentum.x(); //*norm
+  ray.voxelLength[1] = yincr * mVoxelSize.y() / momentum.y(); //*norm
+  ray.voxelLength[2] = zincr * mVoxelSize.z() / momentum.z(); //*norm
   //Coordinates
   int x, y, z;
   //Because GateImage is shit
@@ -425,20 +459,18 @@ double GateSETLEDoseActor::RayCast(bool isPrimary, double energy, double weight,
   double Ry = 1.0e15;
   double Rz = 1.0e15;
 
-  mTotalLength = 2.0*mHalfSize.x()*mHalfSize.y()*mHalfSize.z();
-  double Ltmp = mTotalLength;
-
-//   GateMessage("Actor", 0, "increment " << xincr << " " << yincr << " " << zincr << Gateendl);
+  double totalLength = 2.0*mHalfSize.x()*mHalfSize.y()*mHalfSize.z();
+  double Ltmp = totalLength;
 
   if(xincr > 0){
     Rx = xincr * (-mHalfSize.x() + (x+1)*mVoxelSize.x() - position.x())/momentum.x();
-    mTotalLength = (mHalfSize.x() - position.x())/momentum.x();
+    totalLength = (mHalfSize.x() - position.x())/momentum.x();
   }
   else if (momentum.x() < 0){
     Rx = xincr * (position.x() - (-mHalfSize.x() + x*mVoxelSize.x()))/momentum.x();
-    mTotalLength = (-mHalfSize.x() - position.x())/momentum.x();
+    totalLength = (-mHalfSize.x() - position.x())/momentum.x();
   }
-  else {Rx = 2*mTotalLength;}
+  else {Rx = 2*totalLength;}
 
   if(yincr > 0){
       Ry = yincr * (-mHalfSize.y() + (y+1)*mVoxelSize.y() - position.y())/momentum.y();
@@ -448,8 +480,8 @@ double GateSETLEDoseActor::RayCast(bool isPrimary, double energy, double weight,
     Ry = yincr * (position.y() - (-mHalfSize.y() + y*mVoxelSize.y()))/momentum.y();
     Ltmp = (-mHalfSize.y() - position.y())/momentum.y();
   }
-  else {Ry = 2*mTotalLength;}
-  if (Ltmp < mTotalLength) {mTotalLength = Ltmp;}
+  else {Ry = 2*totalLength;}
+  if (Ltmp < totalLength) {totalLength = Ltmp;}
 
   if(zincr > 0){
     Rz = zincr * (-mHalfSize.z() + (z+1)*mVoxelSize.z() - position.z())/momentum.z();
@@ -459,134 +491,413 @@ double GateSETLEDoseActor::RayCast(bool isPrimary, double energy, double weight,
       Rz = zincr * (position.z() - (-mHalfSize.z() + z*mVoxelSize.z()))/momentum.z();
       Ltmp = (-mHalfSize.z() - position.z())/momentum.z();
   }
-  else {Rz = 2*mTotalLength;}
-
-  if (Ltmp < mTotalLength) {mTotalLength = Ltmp;}
-
-//   GateMessage("Actor", 0, "Lx : " << Lx << " Ly " << Ly << " Lz " << Lz << Gateendl);
-//   GateMessage("Actor", 0, "Rx : " << Rx << " Ry " << Ry << " Rz " << Rz << Gateendl);
-//   GateMessage("Actor", 0, "entry index " << x << " " << y << " " << z << Gateendl);
-//   GateMessage("Actor", 0, "LTot" << mTotalLength << Gateendl);
-
-  int index = 0;
-  double dose = 0.0;
-  double L = 0.0;
-
-  double delta_in  = weight;
-  double delta_out(0.0);
-  double mu(0.0);
-  double muenOverRho(0.0);
+  else {Rz = 2*totalLength;}
+
+  if (Ltmp < totalLength) {totalLength = Ltmp;}
+
+  ray.index = x+y*mLineSize+z*mPlaneSize;
+  ray.step[0] = xincr;
+  ray.step[1] = yincr*mLineSize;
+  ray.step[2] = zincr*mPlaneSize;
+  ray.remaining[0] = Rx;
+  ray.remaining[1] = Ry;
+  ray.remaining[2] = Rz;
+  ray.length = totalLength;
+}
+//-----------------------------------------------------------------------------
 
-  // test on dose contribution: primary or secondary ?
-  GateImageWithStatistic *currentDoseImage = 0;
-  GateImage *currentLastHitImage = 0;
-  bool isCurrentLastHitImageEnabled = false;
-  bool isCurrentDoseUncertaintyEnabled = false;
+//-----------------------------------------------------------------------------
+int GateSETLEDoseActor::GetDoseImages(bool isPrimary, GateImageWithStatistic ** images, bool * isUncertaintyEnabled)
+{
+  // total, and primary or secondary
+  int nbOfDoseImages = 0;
+  if(mIsDoseImageEnabled)
+  {
+    images[nbOfDoseImages] = &mDoseImage;
+    isUncertaintyEnabled[nbOfDoseImages++] = mIsDoseUncertaintyImageEnabled;
+  }
   if(isPrimary)
   {
     if(mIsPrimaryDoseImageEnabled)
     {
-      currentDoseImage = &mPrimaryDoseImage;
-      isCurrentLastHitImageEnabled = mIsPrimaryLastHitEventImageEnabled;
-      isCurrentDoseUncertaintyEnabled = mIsPrimaryDoseUncertaintyImageEnabled;
-      currentLastHitImage = &mPrimaryLastHitEventImage;
+      images[nbOfDoseImages] = &mPrimaryDoseImage;
+      isUncertaintyEnabled[nbOfDoseImages++] = mIsPrimaryDoseUncertaintyImageEnabled;
     }
   }
   else if(mIsSecondaryDoseImageEnabled)
   {
-    currentDoseImage = &mSecondaryDoseImage;
-    isCurrentLastHitImageEnabled = mIsSecondaryLastHitEventImageEnabled;
-    isCurrentDoseUncertaintyEnabled = mIsSecondaryDoseUncertaintyImageEnabled;
-    currentLastHitImage = &mSecondaryLastHitEventImage;
+    images[nbOfDoseImages] = &mSecondaryDoseImage;
+    isUncertaintyEnabled[nbOfDoseImages++] = mIsSecondaryDoseUncertaintyImageEnabled;
   }
+  return nbOfDoseImages;
+}
+//-----------------------------------------------------------------------------
 
-  while(L < mTotalLength-0.00001)
-  {
-//     GateMessage("Actor", 0, " index " << x << " " << y << " " << z << " | Rest " << Rx << " " << Ry << " " << Rz << " | L " << L << " mTotalLength " << mTotalLength << Gateendl);
-//     GateMessage("Actor", 0, " Rest  " << Rx << " " << Ry << " " << Rz << Gateendl);
-//     GateMessage("Actor", 0, "L " << L << " mTotalLength " << mTotalLength << Gateendl);
-//     GateMessage("Actor", 0, "Volume = " << GetVolume()->GetLogicalVolumeName() << Gateendl);
-//     GateMessage("Actor", 0, "material 1 : " << volume->GetMaterialNameFromLabel(volume->GetImage()->GetValue(x,y,z)) << Gateendl);
-//     GateMessage("Actor", 0, "label : " << volume->GetImage()->GetValue(0,0,0) << " " << volume->GetMaterialNameFromLabel(volume->GetImage()->GetValue(0,0,0)) << Gateendl);
+//-----------------------------------------------------------------------------
+double GateSETLEDoseActor::RayCast(bool isPrimary, double energy, double weight, G4ThreeVector position, G4ThreeVector momentum)
+{
+  VoxelRay ray;
+  InitializeRay(ray, position, momentum);
+  mTotalLength = ray.length;
+
+  int index = ray.index;
+  double Rx = ray.remaining[0];
+  double Ry = ray.remaining[1];
+  double Rz = ray.remaining[2];
+  double Lx = ray.voxelLength[0];
+  double Ly = ray.voxelLength[1];
+  double Lz = ray.voxelLength[2];
+
+  int material = 0;
+  double dose = 0.0;
+  double L = 0.0;
 
-    index = x+y*mLineSize+z*mPlaneSize;
+  double delta_in  = weight;
+  double delta_out(0.0);
+  double mu(0.0);
 
-    bool sameEvent = true;
-    if(mIsLastHitEventImageEnabled)
-    {
-      GateDebugMessage("Actor", 2,  "GateSETLEDoseActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-      if(mCurrentEvent != mLastHitEventImage.GetValue(index))
-      {
-	sameEvent = false;
-	mLastHitEventImage.SetValue(index, mCurrentEvent);
-      }
-    }
+  GateImageWithStatistic *doseImages[2];
+  bool isDoseUncertaintyEnabled[2];
+  int nbOfDoseImages = GetDoseImages(isPrimary, doseImages, isDoseUncertaintyEnabled);
 
-    bool currentContributionSameEvent = true;
-    if(isCurrentLastHitImageEnabled)
-    {
-      GateDebugMessage("Actor", 2,  "GateSETLEDoseActor -- UserSteppingActionInVoxel: Last event in index = " << currentLastHitImage->GetValue(index) << Gateendl);
-      if(mCurrentEvent != currentLastHitImage->GetValue(index))
-      {
-	currentContributionSameEvent = false;
-	currentLastHitImage->SetValue(index, mCurrentEvent);
-      }
-    }
-
-    mu = mListOfMuTable[index]->GetMu(energy);
-    muenOverRho = mListOfMuTable[index]->GetMuEnOverRho(energy);
+  while(L < mTotalLength-0.00001)
+  {
+    int voxel = index;
+    material = mVoxelMaterials[voxel];
+    if(mMaterialEnergy[material] != energy) { UpdateMaterialCoefficients(material, energy); }
+    mu = mMaterialMu[material];
 
     if(Rx < Ry && Rx < Rz){
-      delta_out = delta_in*exp(-mu*Rx/10.);
+      delta_out = delta_in*exp(-mu*Rx);
       L+=Rx;
       Ry-=Rx;
       Rz-=Rx;
       Rx=Lx;
-      x+=xincr;
+      index+=ray.step[0];
     }
     else if (Ry < Rz){
-      delta_out = delta_in*exp(-mu*Ry/10.);
+      delta_out = delta_in*exp(-mu*Ry);
       L+=Ry;
       Rx-=Ry;
       Rz-=Ry;
       Ry=Ly;
-      y+=yincr;
+      index+=ray.step[1];
     }
     else{
-      delta_out = delta_in*exp(-mu*Rz/10.);
+      delta_out = delta_in*exp(-mu*Rz);
       L+=Rz;
       Rx-=Rz;
       Ry-=Rz;
       Rz=Lz;
-      z+=zincr;
+      index+=ray.step[2];
     }
 
-    dose = ConversionFactor*energy*muenOverRho*(delta_in-delta_out)/mu/VoxelVolume;
+    dose = mMaterialDoseFactor[material]*(delta_in-delta_out);
 
-    if(mIsDoseImageEnabled)
+    for(int i=0; i<nbOfDoseImages; i++)
     {
-      if(mIsDoseUncertaintyImageEnabled)
+      if(isDoseUncertaintyEnabled[i]) { doseImages[i]->AddTempValue(voxel, dose); }
+      else { doseImages[i]->AddValue(voxel, dose); }
+    }
+
+    delta_in = delta_out;
+  }
+
+  return delta_out;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Packets of rays: the operations on the lanes of the vector registers.
+// The rays of a packet have the same energy, so that the coefficients of
+// a material are those of mMaterialMu and mMaterialDoseFactor.
+namespace {
+
+const int MaxPacketWidth = 8;
+
+// Lanes of a packet (structure of arrays); the unused lanes have a null
+// length and are never active
+struct VoxelRayPacket {
+  double index[MaxPacketWidth];
+  double step[3][MaxPacketWidth];
+  double remaining[3][MaxPacketWidth];
+  double voxelLength[3][MaxPacketWidth];
+  double length[MaxPacketWidth];
+  double weight[MaxPacketWidth];
+};
+
+struct VoxelRayPacketContext {
+  GateSETLEDoseActor * actor;
+  double energy;
+  const int * voxelMaterials;
+  const double * materialEnergy;
+  const double * materialMu;
+  const double * materialDoseFactor;
+  GateImageWithStatistic * doseImages[2];
+  bool isUncertaintyEnabled[2];
+  int nbOfDoseImages;
+};
+
+// exp(x) = 2^n exp(r), r = x - n ln2 with |r| <= ln2/2: Taylor series to
+// the 13th order (relative error below 1e-17), within a few ulp of exp.
+// Underflows to 0 below -708 (no denormals).
+template<class Ops>
+inline typename Ops::D PacketExp(typename Ops::D x)
+{
+  static const double inverseFactorials[14] = {
+    1., 1., 1./2., 1./6., 1./24., 1./120., 1./720., 1./5040., 1./40320., 1./362880.,
+    1./3628800., 1./39916800., 1./479001600., 1./6227020800. };
+  typename Ops::M underflow = Ops::Lt(x, Ops::Set(-708.));
+  x = Ops::Max(Ops::Min(x, Ops::Set(709.)), Ops::Set(-708.));
+  typename Ops::D n = Ops::Round(Ops::Mul(x, Ops::Set(1.4426950408889634)));
+  typename Ops::D r = Ops::Sub(Ops::Sub(x, Ops::Mul(n, Ops::Set(6.93147180369123816490e-01))),
+                               Ops::Mul(n, Ops::Set(1.90821492927058770002e-10)));
+  typename Ops::D p = Ops::Set(inverseFactorials[13]);
+  for(int k=12; k>=0; k--) { p = Ops::Add(Ops::Mul(p, r), Ops::Set(inverseFactorials[k])); }
+  return Ops::Select(underflow, Ops::Set(0.), Ops::Mul(p, Ops::Pow2(n)));
+}
+
+#if defined(__AVX512F__)
+struct PacketOps
+{
+  enum { W = 8 };
+  typedef __m512d D;
+  typedef __mmask8 M;
+  typedef __m256i I;
+  static inline D Load(const double * p) { return _mm512_loadu_pd(p); }
+  static inline void Store(double * p, D a) { _mm512_storeu_pd(p, a); }
+  static inline D Set(double a) { return _mm512_set1_pd(a); }
+  static inline D Add(D a, D b) { return _mm512_add_pd(a, b); }
+  static inline D Sub(D a, D b) { return _mm512_sub_pd(a, b); }
+  static inline D Mul(D a, D b) { return _mm512_mul_pd(a, b); }
+  static inline D Min(D a, D b) { return _mm512_min_pd(a, b); }
+  static inline D Max(D a, D b) { return _mm512_max_pd(a, b); }
+  static inline D Round(D a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static inline D Pow2(D n) {
+    // integer n in the low bits of the mantissa of n + 1.5*2^52
+    const D magic = _mm512_set1_pd(6755399441055744.0);
+    __m512i i = _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(n, magic)), _mm512_castpd_si512(magic));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(i, _mm512_set1_epi64(1023)), 52));
+  }
+  static inline D Exp(D a) { return PacketExp<PacketOps>(a); }
+  static inline M Lt(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+  static inline M Neq(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ); }
+  static inline M And(M a, M b) { return (M)(a & b); }
+  static inline M Or(M a, M b) { return (M)(a | b); }
+  static inline M AndNot(M a, M b) { return (M)(~a & b); }
+  static inline D Select(M m, D a, D b) { return _mm512_mask_blend_pd(m, b, a); }
+  static inline int Bits(M m) { return m; }
+  static inline I ToInt(D a) { return _mm512_cvttpd_epi32(a); }
+  static inline void StoreInt(int * p, I a) { _mm256_storeu_si256((__m256i*)p, a); }
+  static inline I GatherInt(const int * base, I index) { return _mm256_i32gather_epi32(base, index, 4); }
+  static inline D Gather(const double * base, I index) { return _mm512_i32gather_pd(index, base, 8); }
+};
+#elif defined(__AVX2__)
+struct PacketOps
+{
+  enum { W = 4 };
+  typedef __m256d D;
+  typedef __m256d M;
+  typedef __m128i I;
+  static inline D Load(const double * p) { return _mm256_loadu_pd(p); }
+  static inline void Store(double * p, D a) { _mm256_storeu_pd(p, a); }
+  static inline D Set(double a) { return _mm256_set1_pd(a); }
+  static inline D Add(D a, D b) { return _mm256_add_pd(a, b); }
+  static inline D Sub(D a, D b) { return _mm256_sub_pd(a, b); }
+  static inline D Mul(D a, D b) { return _mm256_mul_pd(a, b); }
+  static inline D Min(D a, D b) { return _mm256_min_pd(a, b); }
+  static inline D Max(D a, D b) { return _mm256_max_pd(a, b); }
+  static inline D Round(D a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static inline D Pow2(D n) {
+    // integer n in the low bits of the mantissa of n + 1.5*2^52
+    const D magic = _mm256_set1_pd(6755399441055744.0);
+    __m256i i = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(n, magic)), _mm256_castpd_si256(magic));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(i, _mm256_set1_epi64x(1023)), 52));
+  }
+  static inline D Exp(D a) { return PacketExp<PacketOps>(a); }
+  static inline M Lt(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+  static inline M Neq(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ); }
+  static inline M And(M a, M b) { return _mm256_and_pd(a, b); }
+  static inline M Or(M a, M b) { return _mm256_or_pd(a, b); }
+  static inline M AndNot(M a, M b) { return _mm256_andnot_pd(a, b); }
+  static inline D Select(M m, D a, D b) { return _mm256_blendv_pd(b, a, m); }
+  static inline int Bits(M m) { return _mm256_movemask_pd(m); }
+  static inline I ToInt(D a) { return _mm256_cvttpd_epi32(a); }
+  static inline void StoreInt(int * p, I a) { _mm_storeu_si128((__m128i*)p, a); }
+  static inline I GatherInt(const int * base, I index) { return _mm_i32gather_epi32(base, index, 4); }
+  static inline D Gather(const double * base, I index) { return _mm256_i32gather_pd(base, index, 8); }
+};
+#else
+// Scalar fallback: one ray at a time, same operations as RayCast
+struct PacketOps
+{
+  enum { W = 1 };
+  typedef double D;
+  typedef bool M;
+  typedef int I;
+  static inline D Load(const double * p) { return *p; }
+  static inline void Store(double * p, D a) { *p = a; }
+  static inline D Set(double a) { return a; }
+  static inline D Add(D a, D b) { return a + b; }
+  static inline D Sub(D a, D b) { return a - b; }
+  static inline D Mul(D a, D b) { return a * b; }
+  static inline D Exp(D a) { return exp(a); }
+  static inline M Lt(D a, D b) { return a < b; }
+  static inline M Neq(D a, D b) { return a != b; }
+  static inline M And(M a, M b) { return a && b; }
+  static inline M Or(M a, M b) { return a || b; }
+  static inline M AndNot(M a, M b) { return !a && b; }
+  static inline D Select(M m, D a, D b) { return m ? a : b; }
+  static inline int Bits(M m) { return m ? 1 : 0; }
+  static inline I ToInt(D a) { return (int)a; }
+  static inline void StoreInt(int * p, I a) { *p = a; }
+  static inline I GatherInt(const int * base, I index) { return base[index]; }
+  static inline D Gather(const double * base, I index) { return base[index]; }
+};
+#endif
+
+// Traversal of the voxels by the rays of the packet, as in RayCast. The
+// doses of the lanes are added one lane after the other: the rays of a
+// packet often cross the same voxel at the same step (same origin).
+template<class Ops>
+void CastVoxelRayPacket(const VoxelRayPacket & packet, VoxelRayPacketContext & c)
+{
+  typedef typename Ops::D D;
+  typedef typename Ops::M M;
+  typedef typename Ops::I I;
+
+  D index = Ops::Load(packet.index);
+  D stepX = Ops::Load(packet.step[0]);
+  D stepY = Ops::Load(packet.step[1]);
+  D stepZ = Ops::Load(packet.step[2]);
+  D Rx = Ops::Load(packet.remaining[0]);
+  D Ry = Ops::Load(packet.remaining[1]);
+  D Rz = Ops::Load(packet.remaining[2]);
+  D Lx = Ops::Load(packet.voxelLength[0]);
+  D Ly = Ops::Load(packet.voxelLength[1]);
+  D Lz = Ops::Load(packet.voxelLength[2]);
+  D end = Ops::Sub(Ops::Load(packet.length), Ops::Set(0.00001));
+  D delta_in = Ops::Load(packet.weight);
+  D energy = Ops::Set(c.energy);
+  D zero = Ops::Set(0.0);
+  D L = zero;
+  M active = Ops::Lt(L, end);
+
+  int voxels[MaxPacketWidth];
+  int materials[MaxPacketWidth];
+  double doses[MaxPacketWidth];
+  while(Ops::Bits(active))
+  {
+    // the finished lanes read the first voxel
+    I voxel = Ops::ToInt(Ops::Select(active, index, zero));
+    I material = Ops::GatherInt(c.voxelMaterials, voxel);
+    int stale = Ops::Bits(Ops::And(active, Ops::Neq(Ops::Gather(c.materialEnergy, material), energy)));
+    if(stale)
+    {
+      Ops::StoreInt(materials, material);
+      for(int l=0; l<Ops::W; l++)
       {
-	if(sameEvent) { mDoseImage.AddTempValue(index, dose); }
-	else { mDoseImage.AddValueAndUpdate(index, dose); }
+        if(((stale >> l) & 1) && c.materialEnergy[materials[l]] != c.energy)
+          c.actor->UpdateMaterialCoefficients(materials[l], c.energy);
       }
-      else { mDoseImage.AddValue(index, dose); }
     }
-
-    if(currentDoseImage)
+    D mu = Ops::Gather(c.materialMu, material);
+    D factor = Ops::Gather(c.materialDoseFactor, material);
+
+    M crossX = Ops::And(Ops::Lt(Rx, Ry), Ops::Lt(Rx, Rz));
+    M crossY = Ops::AndNot(crossX, Ops::Lt(Ry, Rz));
+    M crossXorY = Ops::Or(crossX, crossY);
+    D R = Ops::Select(crossX, Rx, Ops::Select(crossY, Ry, Rz));
+    D delta_out = Ops::Mul(delta_in, Ops::Exp(Ops::Sub(zero, Ops::Mul(mu, R))));
+    D dose = Ops::Mul(factor, Ops::Sub(delta_in, delta_out));
+
+    int lanes = Ops::Bits(active);
+    Ops::StoreInt(voxels, voxel);
+    Ops::Store(doses, dose);
+    for(int l=0; l<Ops::W; l++)
     {
-      if(isCurrentDoseUncertaintyEnabled)
+      if(!((lanes >> l) & 1)) { continue; }
+      for(int i=0; i<c.nbOfDoseImages; i++)
       {
-	if(currentContributionSameEvent) { currentDoseImage->AddTempValue(index, dose); }
-	else { currentDoseImage->AddValueAndUpdate(index, dose); }
+        if(c.isUncertaintyEnabled[i]) { c.doseImages[i]->AddTempValue(voxels[l], doses[l]); }
+        else { c.doseImages[i]->AddValue(voxels[l], doses[l]); }
       }
-      else { currentDoseImage->AddValue(index, dose); }
     }
 
-    delta_in = delta_out;
+    L = Ops::Select(active, Ops::Add(L, R), L);
+    Rx = Ops::Select(active, Ops::Select(crossX, Lx, Ops::Sub(Rx, R)), Rx);
+    Ry = Ops::Select(active, Ops::Select(crossY, Ly, Ops::Sub(Ry, R)), Ry);
+    Rz = Ops::Select(active, Ops::Select(crossXorY, Ops::Sub(Rz, R), Lz), Rz);
+    index = Ops::Select(active, Ops::Add(index, Ops::Select(crossX, stepX, Ops::Select(crossY, stepY, stepZ))), index);
+    delta_in = Ops::Select(active, delta_out, delta_in);
+    active = Ops::And(active, Ops::Lt(L, end));
   }
+}
 
-  return delta_out;
+bool IsCastBefore(const GateSETLEDoseActor::VoxelRay & a, const GateSETLEDoseActor::VoxelRay & b)
+{
+  if(a.isPrimary != b.isPrimary) { return a.isPrimary; }
+  return a.energy < b.energy;
+}
+
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateSETLEDoseActor::CastPendingRays()
+{
+  if(mPendingRays.empty()) { return; }
+
+  // rays of the same kind and energy together: the primary rays of an
+  // interaction have the energy of the photon
+  std::stable_sort(mPendingRays.begin(), mPendingRays.end(), IsCastBefore);
+
+  VoxelRayPacketContext context;
+  context.actor = this;
+  context.voxelMaterials = &mVoxelMaterials[0];
+  context.materialEnergy = &mMaterialEnergy[0];
+  context.materialMu = &mMaterialMu[0];
+  context.materialDoseFactor = &mMaterialDoseFactor[0];
+
+  VoxelRayPacket packet;
+  size_t first = 0;
+  while(first < mPendingRays.size())
+  {
+    const VoxelRay & ray = mPendingRays[first];
+    context.energy = ray.energy;
+    context.nbOfDoseImages = GetDoseImages(ray.isPrimary, context.doseImages, context.isUncertaintyEnabled);
+    size_t last = first+1;
+    while(last < mPendingRays.size() && mPendingRays[last].isPrimary == ray.isPrimary &&
+          mPendingRays[last].energy == ray.energy) { last++; }
+
+    for(size_t p=first; p<last; p+=PacketOps::W)
+    {
+      for(int l=0; l<PacketOps::W; l++)
+      {
+        if(p+l >= last)
+        {
+          packet.index[l] = 0;
+          packet.length[l] = 0;
+          packet.weight[l] = 0;
+          for(int d=0; d<3; d++) { packet.step[d][l] = packet.remaining[d][l] = packet.voxelLength[d][l] = 0; }
+          continue;
+        }
+        const VoxelRay & r = mPendingRays[p+l];
+        packet.index[l] = r.index;
+        packet.length[l] = r.length;
+        packet.weight[l] = r.weight;
+        for(int d=0; d<3; d++)
+        {
+          packet.step[d][l] = r.step[d];
+          packet.remaining[d][l] = r.remaining[d];
+          packet.voxelLength[d][l] = r.voxelLength[d];
+        }
+      }
+      CastVoxelRayPacket<PacketOps>(packet, context);
+    }
+    first = last;
+  }
+  mPendingRays.clear();
 }
 //-----------------------------------------------------------------------------
 
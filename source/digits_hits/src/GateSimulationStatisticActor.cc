@@ -19,6 +19,10 @@
 #include "GateMiscFunctions.hh"
 #include "GateApplicationMgr.hh"
 #include "G4Event.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 double get_elapsed_time(const timeval &start, const timeval &end) {
   double elapsed = 0;
@@ -172,6 +176,59 @@ void GateSimulationStatisticActor::SaveData()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// The counts of the workers are summed; they run at the same time, so the
+// elapsed times are the longest ones
+void GateSimulationStatisticActor::MergeWorkerOutputs(const std::vector<G4String> & workerFilenames)
+{
+  const char * keys[8] = { "NumberOfRun", "NumberOfEvents", "NumberOfTracks", "NumberOfSteps",
+                           "NumberOfGeometricalSteps", "NumberOfPhysicalSteps",
+                           "ElapsedTime", "ElapsedTimeWoInit" };
+  double values[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  for(unsigned int w=0; w<workerFilenames.size(); w++) {
+    std::ifstream is(workerFilenames[w].c_str());
+    if (!is) {
+      GateWarning("Cannot merge the statistics " << workerFilenames[w] << " of the workers");
+      return;
+    }
+    std::string line;
+    while (std::getline(is, line)) {
+      std::string::size_type eq = line.find('=');
+      if (line.length() < 2 || line[0] != '#' || eq == std::string::npos) continue;
+      std::istringstream key(line.substr(1, eq-1));
+      std::string k;
+      key >> k;
+      double v = atof(line.substr(eq+1).c_str());
+      for(int i=0; i<8; i++) {
+        if (k != keys[i]) continue;
+        if (i < 6) values[i] += v;
+        else values[i] = std::max(values[i], v);
+      }
+    }
+  }
+
+  std::ofstream os;
+  OpenFileOutput(mSaveFilename, os);
+  os << "# NumberOfRun    = " << values[0] << Gateendl
+     << "# NumberOfEvents = " << values[1] << Gateendl
+     << "# NumberOfTracks = " << values[2] << Gateendl
+     << "# NumberOfSteps  = " << values[3] << Gateendl
+     << "# NumberOfGeometricalSteps  = " << values[4] << Gateendl
+     << "# NumberOfPhysicalSteps     = " << values[5] << Gateendl
+     << "# ElapsedTime           = " << values[6] << Gateendl
+     << "# ElapsedTimeWoInit     = " << values[7] << Gateendl
+     << "# NumberOfWorkers       = " << workerFilenames.size() << Gateendl
+     << "# PPS (Primary per sec)      = " << values[1]/values[7] << Gateendl
+     << "# TPS (Track per sec)        = " << values[2]/values[7] << Gateendl
+     << "# SPS (Step per sec)         = " << values[3]/values[7] << Gateendl;
+  if (!os) {
+    GateMessage("Output",1,"Error Writing file: " <<mSaveFilename << Gateendl);
+  }
+  os.close();
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateSimulationStatisticActor::ResetData()
 {
@@ -0,0 +1,154 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+#include "GateStoppingPowerRatioTable.hh"
+#include "GateMessageManager.hh"
+
+#include <G4EmCalculator.hh>
+#include <G4NistManager.hh>
+#include <G4ParticleTable.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4UnitsTable.hh>
+
+//-----------------------------------------------------------------------------
+GateStoppingPowerRatioTable::GateStoppingPowerRatioTable()
+{
+  mEmCalculator = 0;
+  mWater = 0;
+  mNumberOfBinsPerDecade = 50;
+  mNumberOfBins = 0;
+  mEnergyMin = 1*keV;
+  mEnergyMax = 10*GeV;
+  mLogEnergyMin = 0;
+  mInvLogBinWidth = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::Build(const std::vector<G4Material*> & materials,
+                                        G4EmCalculator * calc)
+{
+  if (mNumberOfBinsPerDecade < 1) {
+    GateError("GateStoppingPowerRatioTable: the number of bins per decade must be >= 1, but is "
+              << mNumberOfBinsPerDecade);
+  }
+  if (mEnergyMin <= 0 || mEnergyMax <= mEnergyMin) {
+    GateError("GateStoppingPowerRatioTable: wrong energy range " << mEnergyMin << " " << mEnergyMax);
+  }
+
+  mEmCalculator = calc;
+  mWater = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
+
+  // Particles for which the ratio depends on the energy (see GetRatio)
+  G4ParticleTable * table = G4ParticleTable::GetParticleTable();
+  const char * names[4] = { "proton", "e-", "e+", "deuteron" };
+  mParticles.clear();
+  for(int i=0; i<4; i++) {
+    G4ParticleDefinition * p = table->FindParticle(names[i]);
+    if (p) mParticles.push_back(p);
+  }
+  if (mParticles.empty() || mParticles[0]->GetParticleName() != "proton") {
+    GateError("GateStoppingPowerRatioTable: proton not found in the particle table");
+  }
+
+  double decades = std::log10(mEnergyMax/mEnergyMin);
+  mNumberOfBins = (int)std::ceil(decades*mNumberOfBinsPerDecade)+1;
+  mLogEnergyMin = std::log(mEnergyMin);
+  mInvLogBinWidth = (mNumberOfBins-1)/(std::log(mEnergyMax)-mLogEnergyMin);
+
+  mMaterials.clear();
+  mMaterialIndexToRow.clear();
+  mRatios.clear();
+  mDefaultRatios.clear();
+  for(unsigned int i=0; i<materials.size(); i++) {
+    int index = materials[i]->GetIndex();
+    if (index < (int)mMaterialIndexToRow.size() && mMaterialIndexToRow[index] >= 0) continue;
+    AddMaterial(materials[i]);
+  }
+
+  GateMessage("Actor", 1, "Stopping power ratio table: " << mMaterials.size() << " materials, "
+              << mParticles.size() << " particles, " << mNumberOfBins << " energy bins from "
+              << G4BestUnit(mEnergyMin, "Energy") << " to " << G4BestUnit(mEnergyMax, "Energy") << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::AddMaterial(const G4Material * m)
+{
+  if (!mEmCalculator) {
+    GateError("GateStoppingPowerRatioTable: table used before Build");
+  }
+  int index = m->GetIndex();
+  if (index >= (int)mMaterialIndexToRow.size()) mMaterialIndexToRow.resize(index+1, -1);
+  int row = mMaterials.size();
+  mMaterialIndexToRow[index] = row;
+  mMaterials.push_back(m);
+
+  mRatios.resize((row+1)*mParticles.size()*mNumberOfBins);
+  for(unsigned int p=0; p<mParticles.size(); p++) {
+    double * v = &mRatios[(row*mParticles.size() + p)*mNumberOfBins];
+    for(int i=0; i<mNumberOfBins; i++) {
+      double e = std::exp(mLogEnergyMin + i/mInvLogBinWidth);
+      v[i] = ComputeRatio(m, mParticles[p], e);
+    }
+  }
+  mDefaultRatios.push_back(ComputeRatio(m, 0, 0));
+  GateMessage("Actor", 3, "Stopping power ratio table: add material " << m->GetName() << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateStoppingPowerRatioTable::ComputeRatio(const G4Material * m,
+                                                 const G4ParticleDefinition * p,
+                                                 double energy)
+{
+  double cut = 1;
+  if (GetParticleSlot(p) < 0) {
+    // Other particles should be taken into account (Helium etc) FIXME
+    p = mParticles[0];
+    energy = 100;
+  }
+  double dedx = mEmCalculator->ComputeTotalDEDX(energy, p, m, cut);
+  double dedxWater = mEmCalculator->ComputeTotalDEDX(energy, p, mWater, cut);
+  if (dedx <= 0) return 0.0;
+  return dedxWater/dedx;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateStoppingPowerRatioTable::CheckDeviation()
+{
+  double maxDeviation = 0.0;
+  for(unsigned int row=0; row<mMaterials.size(); row++) {
+    for(unsigned int p=0; p<mParticles.size(); p++) {
+      double rowMax = 0.0;
+      double rowMaxEnergy = 0.0;
+      for(int i=0; i<mNumberOfBins-1; i++) {
+        double e = std::exp(mLogEnergyMin + (i+0.5)/mInvLogBinWidth);
+        double exact = ComputeRatio(mMaterials[row], mParticles[p], e);
+        double interp = GetRatio(mMaterials[row], mParticles[p], e);
+        if (exact == 0) continue;
+        double d = std::fabs(interp-exact)/exact;
+        if (d > rowMax) { rowMax = d; rowMaxEnergy = e; }
+      }
+      GateMessage("Actor", 0, "Stopping power ratio table check: " << mMaterials[row]->GetName()
+                  << " " << mParticles[p]->GetParticleName()
+                  << " max relative deviation = " << rowMax
+                  << " at " << G4BestUnit(rowMaxEnergy, "Energy") << Gateendl);
+      if (rowMax > maxDeviation) maxDeviation = rowMax;
+    }
+  }
+  GateMessage("Actor", 0, "Stopping power ratio table check: max relative deviation = "
+              << maxDeviation << Gateendl);
+  return maxDeviation;
+}
+//-----------------------------------------------------------------------------
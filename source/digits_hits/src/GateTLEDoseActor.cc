@@ -28,7 +28,6 @@ GateTLEDoseActor::GateTLEDoseActor(G4String name, G4int depth):
   mMaterialHandler = GateMaterialMuHandler::GetInstance();
   mIsEdepImageEnabled = false;
   mIsDoseUncertaintyImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mIsEdepSquaredImageEnabled = false;
   mIsEdepUncertaintyImageEnabled = false;
   mIsDoseSquaredImageEnabled = false;
@@ -68,15 +67,6 @@ void GateTLEDoseActor::Construct() {
 
   SetOriginTransformAndFlagToImage(mDoseImage);
   SetOriginTransformAndFlagToImage(mEdepImage);
-  SetOriginTransformAndFlagToImage(mLastHitEventImage);
-
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled) {
-    mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-    mLastHitEventImage.Allocate();
-    mIsLastHitEventImageEnabled = true;
-    mLastHitEventImage.SetOrigin(mOrigin);
-  }
 
   if (mIsEdepImageEnabled) {
     mEdepImage.EnableSquaredImage(mIsEdepSquaredImageEnabled);
@@ -111,13 +101,11 @@ void GateTLEDoseActor::SaveData() {
   GateVActor::SaveData();
   if (mIsDoseImageEnabled) mDoseImage.SaveData(mCurrentEvent + 1, false);
   if (mIsEdepImageEnabled) mEdepImage.SaveData(mCurrentEvent + 1, false);
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
 }
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 void GateTLEDoseActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   if (mIsEdepImageEnabled) mEdepImage.Reset();
   if (mIsDoseImageEnabled) mDoseImage.Reset();
 }
@@ -159,14 +147,6 @@ void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *
     double muenOverRho = mMaterialHandler->GetMuEnOverRho(PreStep->GetMaterialCutsCouple(), energy);
     G4double dose = ConversionFactor * energy * muenOverRho * distance / VoxelVolume;
     G4double edep = 0.1 * energy * muenOverRho * distance * PreStep->GetMaterial()->GetDensity() / (g / cm3);
-    bool sameEvent = true;
-
-    if (mIsLastHitEventImageEnabled) {
-      if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-        sameEvent = false;
-        mLastHitEventImage.SetValue(index, mCurrentEvent);
-      }
-    }
 
     if (energy <= .001) {
       edep = energy;
@@ -175,16 +155,14 @@ void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *
 
     if (mIsDoseImageEnabled) {
       if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled) {
-        if (sameEvent) mDoseImage.AddTempValue(index, dose);
-        else mDoseImage.AddValueAndUpdate(index, dose);
+        mDoseImage.AddTempValue(index, dose);
       }
       else
         mDoseImage.AddValue(index, dose);
     }
     if (mIsEdepImageEnabled) {
       if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled) {
-        if (sameEvent) mEdepImage.AddTempValue(index, edep);
-        else mEdepImage.AddValueAndUpdate(index, edep);
+        mEdepImage.AddTempValue(index, edep);
       }
       else
         mEdepImage.AddValue(index, edep);
@@ -40,13 +40,8 @@ void GateThresholder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&
       	G4cout << "[GateThresholder::ProcessOnePulse]: input pulse was null -> nothing to do\n\n";
     return;
   }
-  if (inputPulse->GetEnergy()==0) {
-    if (nVerboseLevel>1)
-      	G4cout << "[GateThresholder::ProcessOneHit]: energy is null for " << inputPulse << " -> pulse ignored\n\n";
-    return;
-  }
 
-  if ( inputPulse->GetEnergy() >= m_threshold )
+  if ( IsAboveThreshold(inputPulse) )
   {
     GatePulse* outputPulse = new GatePulse(*inputPulse);
     outputPulseList.push_back(outputPulse);
@@ -54,11 +49,32 @@ void GateThresholder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&
       	G4cout << "Copied pulse to output:\n"
       	       << *outputPulse << Gateendl << Gateendl ;
   }
-  else {
-      if (nVerboseLevel>1)
-      	G4cout << "Ignored pulse with energy below threshold:\n"
-      	       << *inputPulse << Gateendl << Gateendl ;
+}
+
+
+
+G4bool GateThresholder::ProcessOnePulseInPlace(GatePulse* pulse)
+{
+  return IsAboveThreshold(pulse);
+}
+
+
+
+G4bool GateThresholder::IsAboveThreshold(const GatePulse* pulse)
+{
+  if (pulse->GetEnergy()==0) {
+    if (nVerboseLevel>1)
+      	G4cout << "[GateThresholder::ProcessOneHit]: energy is null for " << pulse << " -> pulse ignored\n\n";
+    return false;
   }
+
+  if ( pulse->GetEnergy() >= m_threshold )
+    return true;
+
+  if (nVerboseLevel>1)
+      G4cout << "Ignored pulse with energy below threshold:\n"
+      	     << *pulse << Gateendl << Gateendl ;
+  return false;
 }
 
 
@@ -42,6 +42,93 @@
 #include <iostream>
 #include <sstream>
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// The records are formatted directly in the output blocks, with the same
+// layout as the operator<< of GateCrystalHit, GateSingleDigi and
+// GateCoincidenceDigi on std::ofstream
+static void WriteVolumeID(GateBufferedOutputFile& file, const GateOutputVolumeID& volumeID, int width)
+{
+  for (size_t i=0; i<volumeID.size(); ++i) {
+    file.PutInt(volumeID[i], width);
+    file.Put(' ');
+  }
+}
+
+static void WriteHit(GateBufferedOutputFile& file, const GateCrystalHit* hit)
+{
+  file.Put(' '); file.PutInt(hit->GetRunID(), 7);
+  file.Put(' '); file.PutInt(hit->GetEventID(), 7);
+  file.Put(' '); file.PutInt(hit->GetPrimaryID(), 3);
+  file.Put(' '); file.PutInt(hit->GetSourceID(), 3);
+  file.Put(' '); WriteVolumeID(file, hit->GetOutputVolumeID(), 5);
+  file.Put(' '); file.PutScientific(hit->GetTime()/s, 30, 23);
+  file.Put(' '); file.PutScientific(hit->GetEdep()/MeV, 10, 3);
+  file.Put(' '); file.PutScientific(hit->GetStepLength()/mm, 10, 3);
+  file.Put(' '); file.PutScientific(hit->GetGlobalPos().x()/mm, 10, 3);
+  file.Put(' '); file.PutScientific(hit->GetGlobalPos().y()/mm, 10, 3);
+  file.Put(' '); file.PutScientific(hit->GetGlobalPos().z()/mm, 10, 3);
+  file.Put(' '); file.PutInt(hit->GetPDGEncoding(), 7);
+  file.Put(' '); file.PutInt(hit->GetTrackID(), 5);
+  file.Put(' '); file.PutInt(hit->GetParentID(), 5);
+  file.Put(' '); file.PutInt(hit->GetPhotonID(), 3);
+  file.Put(' '); file.PutInt(hit->GetNPhantomCompton(), 4);
+  file.Put(' '); file.PutInt(hit->GetNPhantomRayleigh(), 4);
+  file.Put(' '); file.PutString(hit->GetProcess());
+  file.Put(' '); file.PutString(hit->GetComptonVolumeName());
+  file.Put(' '); file.PutString(hit->GetRayleighVolumeName());
+  file.Put('\n');
+}
+
+static void WriteSingle(GateBufferedOutputFile& file, const GateSingleDigi* digi)
+{
+  if ( GateSingleDigi::GetSingleASCIIMask(0) ) { file.Put(' '); file.PutInt(digi->GetRunID(), 7); }
+  if ( GateSingleDigi::GetSingleASCIIMask(1) ) { file.Put(' '); file.PutInt(digi->GetEventID(), 7); }
+  if ( GateSingleDigi::GetSingleASCIIMask(2) ) { file.Put(' '); file.PutInt(digi->GetSourceID(), 5); }
+  if ( GateSingleDigi::GetSingleASCIIMask(3) ) { file.Put(' '); file.PutScientific(digi->GetSourcePosition().x()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(4) ) { file.Put(' '); file.PutScientific(digi->GetSourcePosition().y()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(5) ) { file.Put(' '); file.PutScientific(digi->GetSourcePosition().z()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(6) ) { file.Put(' '); WriteVolumeID(file, digi->GetOutputVolumeID(), 5); }
+  if ( GateSingleDigi::GetSingleASCIIMask(7) ) { file.Put(' '); file.PutScientific(digi->GetTime()/s, 30, 23); }
+  if ( GateSingleDigi::GetSingleASCIIMask(8) ) { file.Put(' '); file.PutScientific(digi->GetEnergy()/MeV, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(9) ) { file.Put(' '); file.PutScientific(digi->GetGlobalPos().x()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(10) ) { file.Put(' '); file.PutScientific(digi->GetGlobalPos().y()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(11) ) { file.Put(' '); file.PutScientific(digi->GetGlobalPos().z()/mm, 10, 3); }
+  if ( GateSingleDigi::GetSingleASCIIMask(12) ) { file.Put(' '); file.PutInt(digi->GetNPhantomCompton(), 4); }
+  if ( GateSingleDigi::GetSingleASCIIMask(13) ) { file.Put(' '); file.PutInt(digi->GetNCrystalCompton(), 4); }
+  if ( GateSingleDigi::GetSingleASCIIMask(14) ) { file.Put(' '); file.PutInt(digi->GetNPhantomRayleigh(), 4); }
+  if ( GateSingleDigi::GetSingleASCIIMask(15) ) { file.Put(' '); file.PutInt(digi->GetNCrystalRayleigh(), 4); }
+  if ( GateSingleDigi::GetSingleASCIIMask(16) ) { file.Put(' '); file.PutString(digi->GetComptonVolumeName()); }
+  if ( GateSingleDigi::GetSingleASCIIMask(17) ) { file.Put(' '); file.PutString(digi->GetRayleighVolumeName()); }
+  file.Put('\n');
+}
+
+static void WriteCoincidence(GateBufferedOutputFile& file, GateCoincidenceDigi* digi)
+{
+  for (G4int iP=0; iP<2; iP++) {
+    const GatePulse& pulse = digi->GetPulse(iP);
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(0) ) { file.Put(' '); file.PutInt(pulse.GetRunID(), 7); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(1) ) { file.Put(' '); file.PutInt(pulse.GetEventID(), 7); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(2) ) { file.Put(' '); file.PutInt(pulse.GetSourceID(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(3) ) { file.Put(' '); file.PutScientific(pulse.GetSourcePosition().x()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(4) ) { file.Put(' '); file.PutScientific(pulse.GetSourcePosition().y()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(5) ) { file.Put(' '); file.PutScientific(pulse.GetSourcePosition().z()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(6) ) { file.Put(' '); file.PutScientific(pulse.GetTime()/s, 0, 23); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(7) ) { file.Put(' '); file.PutScientific(pulse.GetEnergy()/MeV, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(8) ) { file.Put(' '); file.PutScientific(pulse.GetGlobalPos().x()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(9) ) { file.Put(' '); file.PutScientific(pulse.GetGlobalPos().y()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(10) ) { file.Put(' '); file.PutScientific(pulse.GetGlobalPos().z()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(11) ) { file.Put(' '); WriteVolumeID(file, pulse.GetOutputVolumeID(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(12) ) { file.Put(' '); file.PutInt(pulse.GetNPhantomCompton(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(13) ) { file.Put(' '); file.PutInt(pulse.GetNCrystalCompton(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(14) ) { file.Put(' '); file.PutInt(pulse.GetNPhantomRayleigh(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(15) ) { file.Put(' '); file.PutInt(pulse.GetNCrystalRayleigh(), 5); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(16) ) { file.Put(' '); file.PutScientific(pulse.GetScannerPos().z()/mm, 0, 3); }
+    if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(17) ) { file.Put(' '); file.PutScientific(pulse.GetScannerRotAngle()/deg, 0, 3); }
+  }
+  file.Put('\n');
+}
+
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
@@ -99,8 +186,10 @@ void GateToASCII::RecordBeginOfAcquisition()
   if (nVerboseLevel > 0) G4cout << "Opening the ASCII output files...";
   if (m_outFileRunsFlag)
     m_outFileRun.open((m_fileName+"Run.dat").c_str(),std::ios::out);
-  if (m_outFileHitsFlag)
-    m_outFileHits.open((m_fileName+"Hits.dat").c_str(),std::ios::out);
+  if (m_outFileHitsFlag && !m_outFileHits.Open(m_fileName+"Hits.dat")) {
+    G4String msg = "Could not open the hits file '" + m_fileName + "Hits.dat'";
+    G4Exception( "GateToASCII::RecordBeginOfAcquisition", "RecordBeginOfAcquisition", FatalException, msg);
+  }
 
   for (size_t i=0; i<m_outputChannelList.size() ; ++i )
     m_outputChannelList[i]->Open(m_fileName);
@@ -122,7 +211,7 @@ void GateToASCII::RecordEndOfAcquisition()
   if (m_outFileRunsFlag)
     m_outFileRun.close();
   if (m_outFileHitsFlag)
-    m_outFileHits.close();
+    m_outFileHits.Close();
 
   for (size_t i=0; i<m_outputChannelList.size() ; ++i )
        m_outputChannelList[i]->Close();
@@ -190,7 +279,7 @@ void GateToASCII::RecordEndOfEvent(const G4Event* event)
 	  << "GateToASCII::RecordEndOfEvent : CrystalHitsCollection: processName : <" << processName
 	  << ">    Particls PDG code : " << PDGEncoding << Gateendl;
 	if ((*CHC)[iHit]->GoodForAnalysis()) {
-	  if (m_outFileHitsFlag) m_outFileHits << (*CHC)[iHit];
+	  if (m_outFileHitsFlag) WriteHit(m_outFileHits, (*CHC)[iHit]);
 	}
       }
 
@@ -330,13 +419,9 @@ void GateToASCII::VOutputChannel::Open(const G4String& aFileBaseName)
     fileCounterSuffix = G4String("");
   }
   G4String fileName = aFileBaseName + m_collectionName + fileCounterSuffix + ".dat";
-  if (m_outputFlag) {
-    m_outputFile.open(fileName,std::ios::out);
-	//LF
-    //m_outputFile.seekp (0, ios::beg);
-	 m_outputFile.seekp (0, std::ios::beg);
-	//LF
-    m_outputFileBegin = m_outputFile.tellp();
+  if (m_outputFlag && !m_outputFile.Open(fileName)) {
+    G4String msg = "Could not open the output file '" + fileName + "'";
+    G4Exception( "GateToASCII::VOutputChannel::Open", "Open", FatalException, msg);
   }
   m_fileBaseName = aFileBaseName;
   m_fileCounter++;
@@ -346,19 +431,12 @@ void GateToASCII::VOutputChannel::Open(const G4String& aFileBaseName)
 void GateToASCII::VOutputChannel::Close()
 {
   if (m_outputFlag)
-    m_outputFile.close();
+    m_outputFile.Close();
 }
 
 G4bool GateToASCII::VOutputChannel::ExceedsSize()
 {
-  // from http://www.cplusplus.com/doc/tutorial/tut6-1.html
-  long outputFileEnd;
-  //LF
-  //m_outputFile.seekp (0, ios::end);
-  m_outputFile.seekp (0, std::ios::end);
-  //LF
-  outputFileEnd = m_outputFile.tellp();
-  long size = outputFileEnd - m_outputFileBegin; // in bytes
+  long size = m_outputFile.Tellp(); // in bytes
 //   G4cout << "[GateToASCII::VOutputChannel::ExceedsSize]"
 // 	 << " collectionID: " << m_collectionID
 // 	 << " file limit: " << m_outputFileSizeLimit
@@ -398,7 +476,7 @@ void GateToASCII::SingleOutputChannel::RecordDigitizer()
 	    Open(m_fileBaseName);
 	  }
 	}
-        m_outputFile << (*SDC)[iDigi];
+        WriteSingle(m_outputFile, (*SDC)[iDigi]);
       }
     }
 
@@ -438,7 +516,7 @@ void GateToASCII::CoincidenceOutputChannel::RecordDigitizer()
 	    Open(m_fileBaseName);
 	  }
 	}
-	m_outputFile << (*CDC)[iDigi];
+	WriteCoincidence(m_outputFile, (*CDC)[iDigi]);
       }
     }
   }
@@ -80,8 +80,11 @@ void GateToBinary::RecordBeginOfAcquisition()
 
 	if( m_outFileHitsFlag )
 	{
-		m_outFileHits.open( ( m_fileName + "Hits.bin" ).c_str(),
-			std::ios::out | std::ios::binary );
+		if( !m_outFileHits.Open( m_fileName + "Hits.bin" ) )
+		{
+			G4String msg = "Could not open the hits file '" + m_fileName + "Hits.bin'";
+			G4Exception( "GateToBinary::RecordBeginOfAcquisition", "RecordBeginOfAcquisition", FatalException, msg );
+		}
 	}
 
 	for( size_t i = 0; i < m_outputChannelVector.size(); ++i )
@@ -110,7 +113,7 @@ void GateToBinary::RecordEndOfAcquisition()
 
 	if( m_outFileHitsFlag )
 	{
-		m_outFileHits.close();
+		m_outFileHits.Close();
 	}
 
 	for( size_t i = 0; i < m_outputChannelVector.size(); ++i )
@@ -226,47 +229,45 @@ void GateToBinary::RecordEndOfEvent( G4Event const* event )
 						G4String rayVolName = (*CHC)[ iHit ]->GetRayleighVolumeName();
 
 						// Writing data
-						m_outFileHits.write( reinterpret_cast< char* >( &runID ),
+						m_outFileHits.Write( &runID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &eventID ),
+						m_outFileHits.Write( &eventID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &primaryID ),
+						m_outFileHits.Write( &primaryID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &sourceID ),
+						m_outFileHits.Write( &sourceID,
 							sizeof( G4int ) );
-						m_outFileHits.write(
-							reinterpret_cast< char* >( &volumeID[ 0 ] ),
+						m_outFileHits.Write( &volumeID[ 0 ],
 							( (*CHC)[ iHit ]->GetOutputVolumeID() ).size() * sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &timeID ),
+						m_outFileHits.Write( &timeID,
 							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &eDepID ),
+						m_outFileHits.Write( &eDepID,
 							sizeof( G4double ) );
-						m_outFileHits.write(
-							reinterpret_cast< char* >( &stepLengthID ),
+						m_outFileHits.Write( &stepLengthID,
 							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posX ),
+						m_outFileHits.Write( &posX,
 							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posY ),
+						m_outFileHits.Write( &posY,
 							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posZ ),
+						m_outFileHits.Write( &posZ,
 							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &PDGEncoding ),
+						m_outFileHits.Write( &PDGEncoding,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &trackID ),
+						m_outFileHits.Write( &trackID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &parentID ),
+						m_outFileHits.Write( &parentID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &photonID ),
+						m_outFileHits.Write( &photonID,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &phCompton ),
+						m_outFileHits.Write( &phCompton,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &phRayleigh ),
+						m_outFileHits.Write( &phRayleigh,
 							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &processName ),
+						m_outFileHits.Write( &processName,
 							sizeof( G4String ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &compVolName ),
+						m_outFileHits.Write( &compVolName,
 							sizeof( G4String ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &rayVolName ),
+						m_outFileHits.Write( &rayVolName,
 							sizeof( G4String ) );
 					}
 				}
@@ -418,8 +419,11 @@ void GateToBinary::VOutputChannel::OpenFile(
 		+ ".dat";
 	if( m_outputFlag )
 	{
-		m_outputFile.open( fileName.c_str(), std::ios::out |
-			std::ios::binary );
+		if( !m_outputFile.Open( fileName ) )
+		{
+			G4String msg = "Could not open the output file '" + fileName + "'";
+			G4Exception( "GateToBinary::VOutputChannel::OpenFile", "OpenFile", FatalException, msg );
+		}
 	}
 	m_fileBaseName = aFileBaseName;
 	++m_fileCounter;
@@ -430,13 +434,13 @@ void GateToBinary::VOutputChannel::CloseFile()
 {
   if( m_outputFlag )
 	{
-		m_outputFile.close();
+		m_outputFile.Close();
 	}
 }
 
 G4bool GateToBinary::VOutputChannel::ExceedsSize()
 {
-	G4int size = m_outputFile.tellp();
+	long size = m_outputFile.Tellp();
 	//std::cout << "size: " << size << " B\n";
   return size > m_outputFileSizeLimit;
 }
@@ -500,21 +504,21 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 0 ) )
 					{
 						runID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetRunID();
-						m_outputFile.write( reinterpret_cast< char* >( &runID ),
+						m_outputFile.Write( &runID,
 						sizeof( G4int ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 1 ) )
 					{
 						eventID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetEventID();
-						m_outputFile.write( reinterpret_cast< char* >( &eventID ),
+						m_outputFile.Write( &eventID,
 						sizeof( G4int ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 2 ) )
 					{
 						sourceID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetSourceID();
-						m_outputFile.write( reinterpret_cast< char* >( &sourceID ),
+						m_outputFile.Write( &sourceID,
 						sizeof( G4int ) );
 					}
 
@@ -522,7 +526,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosX = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().x()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosX ),
+						m_outputFile.Write( &sourcePosX,
 						sizeof( G4double ) );
 					}
 
@@ -530,7 +534,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosY = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().y()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosY ),
+						m_outputFile.Write( &sourcePosY,
 						sizeof( G4double ) );
 					}
 
@@ -538,42 +542,42 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosZ = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosZ ),
+						m_outputFile.Write( &sourcePosZ,
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 6 ) )
 					{
 						time = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetTime()/s;
-						m_outputFile.write( reinterpret_cast< char* >( &time ),
+						m_outputFile.Write( &time,
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 7 ) )
 					{
 						energy = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetEnergy()/MeV;
-						m_outputFile.write( reinterpret_cast< char* >( &energy ),
+						m_outputFile.Write( &energy,
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 8 ) )
 					{
 						posX = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().x()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posX ),
+						m_outputFile.Write( &posX,
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 9 ) )
 					{
 						posY = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().y()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posY ),
+						m_outputFile.Write( &posY,
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 10 ) )
 					{
 						posZ = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posZ ),
+						m_outputFile.Write( &posZ,
 						sizeof( G4double ) );
 					}
 
@@ -588,8 +592,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 								( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 								GetOutputVolumeID()[ lvl ];
 						}
-						m_outputFile.write(
-							reinterpret_cast< char* >( &volumeID[ 0 ] ),
+						m_outputFile.Write( &volumeID[ 0 ],
 							( ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetOutputVolumeID() ).size() * sizeof( G4int ) );
 					}
 
@@ -597,7 +600,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nPhantCompt = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNPhantomCompton();
-						m_outputFile.write( reinterpret_cast< char* >( &nPhantCompt ),
+						m_outputFile.Write( &nPhantCompt,
 						sizeof( G4int ) );
 					}
 
@@ -605,7 +608,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nCrysCompt = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNCrystalCompton();
-						m_outputFile.write( reinterpret_cast< char* >( &nCrysCompt ),
+						m_outputFile.Write( &nCrysCompt,
 						sizeof( G4int ) );
 					}
 
@@ -613,7 +616,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nPhantRay = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNPhantomRayleigh();
-						m_outputFile.write( reinterpret_cast< char* >( &nPhantRay ),
+						m_outputFile.Write( &nPhantRay,
 						sizeof( G4int ) );
 					}
 
@@ -621,7 +624,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nCrysRay = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNCrystalRayleigh();
-						m_outputFile.write( reinterpret_cast< char* >( &nCrysRay ),
+						m_outputFile.Write( &nCrysRay,
 						sizeof( G4int ) );
 					}
 
@@ -629,7 +632,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						scannerPosZ = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetScannerPos().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &scannerPosZ ),
+						m_outputFile.Write( &scannerPosZ,
 						sizeof( G4double ) );
 					}
 
@@ -637,7 +640,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						scannerRotAng = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetScannerRotAngle()/deg;
-						m_outputFile.write( reinterpret_cast< char* >( &scannerRotAng ),
+						m_outputFile.Write( &scannerRotAng,
 						sizeof( G4double ) );
 					}
 				}
@@ -702,42 +705,42 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 				if ( GateSingleDigi::GetSingleASCIIMask( 0 ) )
 				{
 					runID = (*SDC)[ iDigi ]->GetRunID();
-					m_outputFile.write( reinterpret_cast< char* >( &runID ),
+					m_outputFile.Write( &runID,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 1 ) )
 				{
 					eventID = (*SDC)[ iDigi ]->GetEventID();
-					m_outputFile.write( reinterpret_cast< char* >( &eventID ),
+					m_outputFile.Write( &eventID,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 2 ) )
 				{
 					sourceID = (*SDC)[ iDigi ]->GetSourceID();
-					m_outputFile.write( reinterpret_cast< char* >( &sourceID ),
+					m_outputFile.Write( &sourceID,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 3 ) )
 				{
 					sourcePosX = (*SDC)[ iDigi ]->GetSourcePosition().x()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosX ),
+					m_outputFile.Write( &sourcePosX,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 4 ) )
 				{
 					sourcePosY = (*SDC)[ iDigi ]->GetSourcePosition().y()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosY ),
+					m_outputFile.Write( &sourcePosY,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 5 ) )
 				{
 					sourcePosZ = (*SDC)[ iDigi ]->GetSourcePosition().z()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosZ ),
+					m_outputFile.Write( &sourcePosZ,
 					sizeof( G4double ) );
 				}
 
@@ -751,85 +754,84 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 						*( volumeID + lvl ) = (*SDC)[ iDigi ]->
 							GetOutputVolumeID()[ lvl ];
 					}
-					m_outputFile.write(
-						reinterpret_cast< char* >( &volumeID[ 0 ] ),
+					m_outputFile.Write( &volumeID[ 0 ],
 						( (*SDC)[ iDigi ]->GetOutputVolumeID() ).size() * sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 7 ) )
 				{
 					time = (*SDC)[ iDigi ]->GetTime()/s;
-					m_outputFile.write( reinterpret_cast< char* >( &time ),
+					m_outputFile.Write( &time,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 8 ) )
 				{
 					energy = (*SDC)[ iDigi ]->GetEnergy()/MeV;
-					m_outputFile.write( reinterpret_cast< char* >( &energy ),
+					m_outputFile.Write( &energy,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 9 ) )
 				{
 					posX = (*SDC)[ iDigi ]->GetGlobalPos().x()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posX ),
+					m_outputFile.Write( &posX,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 10 ) )
 				{
 					posY = (*SDC)[ iDigi ]->GetGlobalPos().y()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posY ),
+					m_outputFile.Write( &posY,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 11 ) )
 				{
 					posZ = (*SDC)[ iDigi ]->GetGlobalPos().z()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posZ ),
+					m_outputFile.Write( &posZ,
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 12 ) )
 				{
 					nPhantCompt = (*SDC)[ iDigi ]->GetNPhantomCompton();
-					m_outputFile.write( reinterpret_cast< char* >( &nPhantCompt ),
+					m_outputFile.Write( &nPhantCompt,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 13 ) )
 				{
 					nCrysCompt = (*SDC)[ iDigi ]->GetNCrystalCompton();
-					m_outputFile.write( reinterpret_cast< char* >( &nCrysCompt ),
+					m_outputFile.Write( &nCrysCompt,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 14 ) )
 				{
 					nPhantRay = (*SDC)[ iDigi ]->GetNPhantomRayleigh();
-					m_outputFile.write( reinterpret_cast< char* >( &nPhantRay ),
+					m_outputFile.Write( &nPhantRay,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 15 ) )
 				{
 					nCrysRay = (*SDC)[ iDigi ]->GetNCrystalRayleigh();
-					m_outputFile.write( reinterpret_cast< char* >( &nCrysRay ),
+					m_outputFile.Write( &nCrysRay,
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 16 ) )
 				{
 					compVolName = (*SDC)[ iDigi ]->GetComptonVolumeName();
-					m_outputFile.write( reinterpret_cast< char* >( &compVolName ),
+					m_outputFile.Write( &compVolName,
 					sizeof( G4String ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 17 ) )
 				{
 					rayVolName = (*SDC)[ iDigi ]->GetRayleighVolumeName();
-					m_outputFile.write( reinterpret_cast< char* >( &rayVolName ),
+					m_outputFile.Write( &rayVolName,
 					sizeof( G4String ) );
 				}
 			}
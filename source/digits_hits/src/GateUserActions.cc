@@ -12,6 +12,7 @@ See GATE/LICENSE.txt for further details
 
 #include "GateUserActions.hh"
 #include "GateActions.hh"
+#include "GateBackgroundImageWriter.hh"
 
 #include "G4UImanager.hh"
 #include "G4VVisManager.hh"
@@ -106,6 +107,8 @@ void GateUserActions::BeginOfRunAction(const G4Run* run)
 void GateUserActions::EndOfRunAction(const G4Run* run)
 {
   GateActorManager::GetInstance()->EndOfRunAction(run);
+  // images saved in background must be complete at the end of the run
+  GateBackgroundImageWriter::GetInstance()->WaitAll();
 
   if(mIsTimeStudyActivated){
      GateSteppingVerbose * steppingVerbose = (GateSteppingVerbose*)(G4VSteppingVerbose::GetInstance());
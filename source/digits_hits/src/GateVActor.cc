@@ -132,3 +132,15 @@ void GateVActor::SaveData()
   }
 }
 //-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Only the actors without output have nothing to merge by default (see
+// CanMergeWorkerOutputs, checked before the workers are started)
+void GateVActor::MergeWorkerOutputs(const std::vector<G4String> & workerFilenames)
+{
+  if (mSaveFilename == "FilnameNotGivenForThisActor") return;
+  GateError("The outputs of actor " << GetObjectName() << " cannot be merged ("
+            << workerFilenames[0] << ", ...)");
+}
+//-----------------------------------------------------------------------------
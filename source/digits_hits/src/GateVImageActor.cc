@@ -20,6 +20,13 @@
 #include <G4TouchableHistory.hh>
 #include <G4VoxelLimits.hh>
 
+#include <algorithm>
+#include <fstream>
+#include <glob.h>
+
+std::vector<GateVImageActor::VolumeStepCache> GateVImageActor::mVolumeStepCaches;
+std::vector<GateVImageActor::GridStepCache> GateVImageActor::mGridStepCaches;
+
 //-----------------------------------------------------------------------------
 /// Constructor
 GateVImageActor::GateVImageActor(G4String name, G4int depth):
@@ -33,7 +40,11 @@ GateVImageActor::GateVImageActor(G4String name, G4int depth):
   mVoxelSizeIsSet(false),
   mResolutionIsSet(false),
   mHalfSizeIsSet(false),
-  mPositionIsSet(false)
+  mPositionIsSet(false),
+  mIsBackgroundWritingEnabled(false),
+  mIsCompressedOutputEnabled(false),
+  mVolumeStepCacheSlot(-1),
+  mGridStepCacheSlot(-1)
 {
   GateMessageInc("Actor",4, "GateVImageActor() - begin\n");
   //pMessenger = new GateImageActorMessenger(this);
@@ -60,6 +71,139 @@ void GateVImageActor::ResetData()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVImageActor::EndOfEventAction(const G4Event * e)
+{
+  // flush before a possible save every n events/seconds
+  mEventBuffer.EndOfEvent();
+  GateVActor::EndOfEventAction(e);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// The images are merged from their MetaImage files
+bool GateVImageActor::CanMergeWorkerOutputs()
+{
+  std::string extension = getExtension(mSaveFilename);
+  return (extension == "mhd" || extension == "mha");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+static std::string GetElementType(const G4String & filename)
+{
+  std::ifstream is(filename.c_str());
+  std::string line;
+  while (std::getline(is, line)) {
+    size_t eq = line.find('=');
+    if (eq == std::string::npos) continue;
+    std::string key = line.substr(0, eq);
+    key.erase(key.find_last_not_of(" \t") + 1);
+    std::string value = line.substr(eq + 1);
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t\r") + 1);
+    if (key == "ElementType") return value;
+    if (key == "ElementDataFile") break;
+  }
+  return "";
+}
+
+template<class ImageType>
+static void SumWorkerImages(const std::vector<G4String> & inputs, const G4String & output)
+{
+  ImageType sum;
+  sum.Read(inputs[0]);
+  for(unsigned int i=1; i<inputs.size(); i++) {
+    ImageType image;
+    image.Read(inputs[i]);
+    if (image.GetNumberOfValues() != sum.GetNumberOfValues())
+      GateError("The image " << inputs[i] << " has not the size of the image of the first worker.\n");
+    typename ImageType::iterator po = sum.begin();
+    typename ImageType::const_iterator pi = image.begin();
+    typename ImageType::const_iterator pe = image.end();
+    while (pi != pe) { *po += *pi; ++po; ++pi; }
+  }
+  sum.Write(output);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Images saved without statistic (number of hits, productions, ...) are
+// summed with their own voxel type
+void GateVImageActor::MergeWorkerImages(const std::vector<G4String> & inputs, const G4String & output)
+{
+  for(unsigned int i=0; i<inputs.size(); i++) {
+    std::ifstream is(inputs[i].c_str());
+    if (!is) GateError("Cannot merge the image " << inputs[i] << " of the workers into " << output);
+  }
+  std::string type = GetElementType(inputs[0]);
+  if (type == "MET_INT") SumWorkerImages<GateImageInt>(inputs, output);
+  else if (type == "MET_FLOAT") SumWorkerImages<GateImageFloat>(inputs, output);
+  else if (type == "MET_DOUBLE") SumWorkerImages<GateImageDouble>(inputs, output);
+  else GateError("Cannot merge the images " << inputs[0] << ", ... of the workers (voxel type " << type << ")");
+  GateMessage("Actor", 1, "Merged " << inputs.size() << " worker images into " << output << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// An actor saved as base.ext writes base.ext and/or files named
+// base-xxx.ext (dose-Edep.mhd, dose-Edep-Squared.mhd, ...), found in the
+// output of the first worker (as gjm does for split jobs). The images of
+// GateImageWithStatistic are merged with their squared and uncertainty
+// images, the other images are summed.
+void GateVImageActor::MergeWorkerOutputs(const std::vector<G4String> & workerFilenames)
+{
+  if (mSaveFilename == "FilnameNotGivenForThisActor") return;
+  std::string extension = "." + getExtension(mSaveFilename);
+  std::vector<std::string> bases;
+  for(unsigned int w=0; w<workerFilenames.size(); w++) bases.push_back(removeExtension(workerFilenames[w]));
+  std::string base = removeExtension(mSaveFilename);
+
+  std::vector<std::string> suffixes;
+  glob_t files;
+  std::string patterns[2] = { bases[0]+extension, bases[0]+"-*"+extension };
+  for(int p=0; p<2; p++) {
+    if (glob(patterns[p].c_str(), 0, NULL, &files) == 0)
+      for(size_t k=0; k<files.gl_pathc; k++) suffixes.push_back(std::string(files.gl_pathv[k]).substr(bases[0].length()));
+    globfree(&files);
+  }
+  if (suffixes.empty()) {
+    GateWarning("No output of actor " << GetObjectName() << " found (" << workerFilenames[0] << ")");
+    return;
+  }
+
+  const std::string statisticSuffixes[2] = { "-Squared"+extension, "-Uncertainty"+extension };
+  for(unsigned int k=0; k<suffixes.size(); k++) {
+    // merged with the values
+    bool merged = false;
+    for(int s=0; s<2; s++) {
+      const std::string & end = statisticSuffixes[s];
+      if (suffixes[k].length() < end.length() ||
+          suffixes[k].compare(suffixes[k].length()-end.length(), end.length(), end) != 0) continue;
+      std::string valueSuffix = suffixes[k].substr(0, suffixes[k].length()-end.length())+extension;
+      if (std::find(suffixes.begin(), suffixes.end(), valueSuffix) != suffixes.end()) merged = true;
+    }
+    if (merged) continue;
+
+    std::vector<G4String> inputs;
+    for(unsigned int w=0; w<bases.size(); w++) inputs.push_back(bases[w]+suffixes[k]);
+    G4String output = base+suffixes[k];
+    double scale;
+    int normalisation, numberOfEvents;
+    if (GateImageWithStatistic::ReadHeaderFields(inputs[0], scale, normalisation, numberOfEvents)) {
+      if (!GateImageWithStatistic::MergeWorkerFiles(inputs, output))
+        GateError("Cannot merge the images " << inputs[0] << ", ... of actor " << GetObjectName());
+    }
+    else MergeWorkerImages(inputs, output);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateVImageActor::SetResolution(G4ThreeVector v)
 {
@@ -134,6 +278,7 @@ void GateVImageActor::Construct()
 {
   GateDebugMessageInc("Actor", 4, "GateVImageActor -- Construct: begin\n");
   GateVActor::Construct();
+  mGridStepCacheSlot = -1;
 
   if (!mHalfSizeIsSet){
 	  if (mResolutionIsSet && mVoxelSizeIsSet){
@@ -233,6 +378,13 @@ void GateVImageActor::SetOriginTransformAndFlagToImage(GateImageWithStatistic &
 
   // Set Overwrite flag
   image.SetOverWriteFilesFlag(mOverWriteFilesFlag);
+
+  // Output options
+  image.EnableBackgroundWriting(mIsBackgroundWritingEnabled);
+  image.SetCompression(mIsCompressedOutputEnabled);
+
+  // Share the per-event buffer of the actor
+  image.SetEventBuffer(&mEventBuffer);
 }
 //-----------------------------------------------------------------------------
 
@@ -255,6 +407,7 @@ void GateVImageActor::SetOriginTransformAndFlagToImage(GateVImage & image)
 void GateVImageActor::SetStepHitType(G4String t)
 {
   mStepHitTypeName = t;
+  mGridStepCacheSlot = -1;
   if (t == "pre")    { mStepHitType = PreStepHitType; return; }
   if (t == "post")   { mStepHitType = PostStepHitType; return; }
   if (t == "middle") { mStepHitType = MiddleStepHitType; return; }
@@ -350,10 +503,51 @@ int GateVImageActor::GetIndexFromTrackPosition(const GateVVolume * v , const G4T
 
 
 //-----------------------------------------------------------------------------
-int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step)
+void GateVImageActor::ResolveStepCacheSlots(const GateVVolume * v)
 {
-  if(v==0) return -1;
+  mVolumeStepCacheSlot = -1;
+  for(unsigned int i=0; i<mVolumeStepCaches.size(); i++)
+    if (mVolumeStepCaches[i].volume == v) mVolumeStepCacheSlot = i;
+  if (mVolumeStepCacheSlot < 0) {
+    VolumeStepCache c;
+    c.volume = v;
+    c.stamp = 0;
+    c.inside = false;
+    mVolumeStepCacheSlot = mVolumeStepCaches.size();
+    mVolumeStepCaches.push_back(c);
+  }
+
+  // The prePosition/postPosition are only translated when the position is set
+  G4ThreeVector position = (mPositionIsSet ? mPosition : G4ThreeVector(0.0, 0.0, 0.0));
+  mGridStepCacheSlot = -1;
+  for(unsigned int i=0; i<mGridStepCaches.size(); i++) {
+    const GridStepCache & g = mGridStepCaches[i];
+    if (g.volumeSlot == mVolumeStepCacheSlot && g.stepHitType == mStepHitType &&
+        g.resolution == mImage.GetResolution() && g.halfSize == mImage.GetHalfSize() &&
+        g.position == position) mGridStepCacheSlot = i;
+  }
+  if (mGridStepCacheSlot < 0) {
+    GridStepCache g;
+    g.volumeSlot = mVolumeStepCacheSlot;
+    g.resolution = mImage.GetResolution();
+    g.halfSize = mImage.GetHalfSize();
+    g.position = position;
+    g.stepHitType = mStepHitType;
+    g.stamp = 0;
+    g.index = -1;
+    mGridStepCacheSlot = mGridStepCaches.size();
+    mGridStepCaches.push_back(g);
+  }
+  GateMessage("Actor", 3, "GateVImageActor -- " << GetObjectName() << " shares the voxel index of grid "
+              << mGridStepCacheSlot << " (volume " << v->GetObjectName() << ")" << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
 
+//-----------------------------------------------------------------------------
+void GateVImageActor::ComputeVolumeStepPositions(VolumeStepCache & cache, const G4Step * step)
+{
+  const GateVVolume * v = cache.volume;
   const G4ThreeVector & worldPos = step->GetPostStepPoint()->GetPosition();
   const G4ThreeVector & worldPre =  step->GetPreStepPoint()->GetPosition() ;
 
@@ -368,21 +562,54 @@ int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Ste
   int depth = 0;
   int transDepth = maxDepth;
 
-  while((depth<maxDepth) &&
-        (currentVol->GetName() != v->GetLogicalVolume()->GetName()))
-    //(currentVol != v->GetLogicalVolume())) //depth<=maxDepth or depth<maxDepth ? OK < only
+  // The logical volumes are compared by name, once per logical volume
+  std::map<const G4LogicalVolume*, bool>::iterator it;
+  while(depth<maxDepth) //depth<=maxDepth or depth<maxDepth ? OK < only
     {
+      it = cache.isVolume.find(currentVol);
+      if (it == cache.isVolume.end())
+        it = cache.isVolume.insert(std::make_pair(currentVol, currentVol->GetName() == v->GetLogicalVolume()->GetName())).first;
+      if (it->second) break;
       depth++;
       transDepth--;
       currentVol = theTouchable->GetVolume(depth)->GetLogicalVolume();
     }
 
-  if(depth>=maxDepth) return -1;
+  cache.inside = (depth<maxDepth);
+  if (!cache.inside) return;
 
   GateDebugMessage("Step",3,"GateVImageActor -- GetIndexFromStepPosition: Logical volume "<<currentVol->GetName() <<" found! - Depth = "<<depth << Gateendl );
 
-  G4ThreeVector postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
-  G4ThreeVector prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
+  const G4AffineTransform & transform = theTouchable->GetHistory()->GetTransform(transDepth);
+  cache.postPosition = transform.TransformPoint(worldPos);
+  cache.prePosition = transform.TransformPoint(worldPre);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step)
+{
+  if(v==0) return -1;
+
+  // Actors with the same volume and grid share the index of the step
+  unsigned long stamp = GateActorManager::GetInstance()->GetStepStamp();
+  if (mGridStepCacheSlot < 0 || mVolumeStepCaches[mVolumeStepCacheSlot].volume != v)
+    ResolveStepCacheSlots(v);
+  GridStepCache & grid = mGridStepCaches[mGridStepCacheSlot];
+  if (grid.stamp == stamp) return grid.index;
+  grid.stamp = stamp;
+  grid.index = -1;
+
+  VolumeStepCache & volume = mVolumeStepCaches[mVolumeStepCacheSlot];
+  if (volume.stamp != stamp) {
+    ComputeVolumeStepPositions(volume, step);
+    volume.stamp = stamp;
+  }
+  if (!volume.inside) return -1;
+
+  G4ThreeVector postPosition = volume.postPosition;
+  G4ThreeVector prePosition = volume.prePosition;
 
   if (mPositionIsSet) {
     GateDebugMessage("Step", 3, "GateVImageActor -- GetIndexFromStepPosition: Step postPosition (vol reference) = " << postPosition << Gateendl);
@@ -428,6 +655,7 @@ int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Ste
   }
 
   GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tVoxel index = " << index << Gateendl);
+  grid.index = index;
   return index;
 }
 //-----------------------------------------------------------------------------
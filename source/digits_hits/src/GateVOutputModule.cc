@@ -10,6 +10,7 @@ See GATE/LICENSE.txt for further details
 #include "GateVOutputModule.hh"
 //#include "GateOutputModuleMessenger.hh"
 #include "GateTools.hh"
+#include "GateMessageManager.hh"
 
 GateVOutputModule::GateVOutputModule(const G4String& name, GateOutputMgr* outputMgr,DigiMode digiMode)
   : m_outputMgr(outputMgr),
@@ -37,3 +38,10 @@ void GateVOutputModule::Describe(size_t indent)
 {
   G4cout << Gateendl << GateTools::Indent(indent) << "Output module: '" << m_name << "'\n";
 }
+
+void GateVOutputModule::AddFileNameSuffix(const G4String& suffix)
+{
+  GateWarning("Output module '" << m_name << "' cannot add the suffix '" << suffix
+              << "' to its file name. Output module is so DISABLED !!");
+  Enable(false);
+}
@@ -121,7 +121,8 @@ void GateWashOutActor::BeginOfEventAction(const G4Event * event)
       // Set the total activity of the source (with the washout decay)
 
     if ( !(mSourceNow->GetIfSourceVoxelized()) ) {    // Non-voxelized source
-        mSourceNow->SetActivity( ActivityNew ); }
+        mSourceNow->SetActivity( ActivityNew );
+        (GateSourceMgr::GetInstance())->RescheduleSource( mSourceNow ); }
     else {
         GateSourceVoxellized * SourceVoxlNow = (GateSourceVoxellized *) mSourceNow;
         mSVReader = SourceVoxlNow->GetReader();
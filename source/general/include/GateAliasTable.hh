@@ -0,0 +1,69 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateAliasTable
+  \brief  Walker/Vose alias table: O(1) sampling of a discrete
+          distribution given by a vector of (unnormalised) weights.
+*/
+
+#ifndef GATEALIASTABLE_HH
+#define GATEALIASTABLE_HH
+
+#include <vector>
+#include "globals.hh"
+
+//-----------------------------------------------------------------------------
+class GateAliasTable
+{
+public:
+  GateAliasTable();
+  ~GateAliasTable() {}
+
+  // Build (or rebuild in place) the table from the given weights.
+  // Negative weights are considered as zero. Internal buffers are
+  // kept between successive builds to avoid reallocation.
+  void Build(const std::vector<G4double> & weights);
+
+  // Return an index in [0, size) with probability weight[i]/total,
+  // or -1 if the table is empty. u must be uniform in [0,1).
+  inline G4int Sample(G4double u) const;
+
+  // Same as above, using G4UniformRand
+  G4int Sample() const;
+
+  void Clear();
+  G4bool IsEmpty() const { return mProbability.empty(); }
+  G4int GetSize() const { return mProbability.size(); }
+  G4double GetTotalWeight() const { return mTotalWeight; }
+
+protected:
+  std::vector<G4double> mProbability;
+  std::vector<G4int> mAlias;
+  std::vector<G4double> mScaled;
+  std::vector<G4int> mSmall;
+  std::vector<G4int> mLarge;
+  G4double mTotalWeight;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+inline G4int GateAliasTable::Sample(G4double u) const
+{
+  G4int n = mProbability.size();
+  if (n == 0) return -1;
+  G4double x = u * n;
+  G4int i = static_cast<G4int>(x);
+  if (i >= n) i = n-1;
+  return ((x - i) < mProbability[i]) ? i : mAlias[i];
+}
+//-----------------------------------------------------------------------------
+
+#endif
@@ -69,6 +69,16 @@ public:
   G4double GetTimeStepInTotalAmountOfPrimariesMode(){return mTimeStepInTotalAmountOfPrimariesMode;}
   G4double GetWeight(){return m_weight;}
 
+  //! Number of worker processes used by StartDAQ (1: no worker)
+  void SetNumberOfWorkers(G4int n);
+  G4int GetNumberOfWorkers() const { return mNumberOfWorkers; }
+  //! Number of the current worker process, -1 if not in a worker
+  G4int GetWorkerID() const { return mWorkerID; }
+  //! Insert the suffix of a worker before the file extension (unchanged if workerID < 0)
+  G4String GetWorkerFileName(const G4String& filename, G4int workerID) const;
+  //! "-worker<i>" for worker i, empty if workerID < 0
+  G4String GetWorkerSuffix(G4int workerID) const;
+
   void EnableTimeStudy(G4String filename);
   void EnableTimeStudyForSteps(G4String filename);
   long GetRequestedAmountOfPrimariesPerRun() { return mRequestedAmountOfPrimariesPerRun; }
@@ -102,6 +112,12 @@ protected:
 
   void InitializeTimeSlices();
 
+  G4int mNumberOfWorkers;
+  G4int mWorkerID;
+  void StartDAQWorkers();
+  void RunWorker(G4int workerID, G4double virtualStart, G4double virtualStop);
+  void MergeWorkerOutputs();
+
   GateApplicationMgrMessenger* m_appMgrMessenger;
 
 };
@@ -60,6 +60,7 @@ private:
   G4UIcmdWithADouble *      SetTotalNumberOfPrimariesCmd;
   G4UIcmdWithADouble *      SetNumberOfPrimariesPerRunCmd;
   G4UIcmdWithADouble *      SetNumberOfPrimariesPerRunCmd2;
+  G4UIcmdWithAnInteger *    SetNumberOfWorkersCmd;
 };
 
 #endif
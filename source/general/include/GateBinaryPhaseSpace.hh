@@ -0,0 +1,131 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+
+/*!
+  \file   GateBinaryPhaseSpace.hh
+  \brief  Compact phase space file format (extension .gphsp): a 64
+          bytes header followed by fixed size records. Written by
+          GatePhaseSpaceActor, read by GateSourcePhaseSpace.
+
+  The file is memory-mapped by the reader, so that any record can be
+  accessed without reading the previous ones (disjoint slices for split
+  jobs), and records are decoded by blocks, the next block being
+  prefetched by the kernel while the current one is simulated.
+  Values are stored in the native byte order of the machine that wrote
+  the file (checked at opening).
+*/
+
+#ifndef GATEBINARYPHASESPACE_HH
+#define GATEBINARYPHASESPACE_HH
+
+#include "globals.hh"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// One particle. Units are the Geant4 internal units (mm, MeV, ns).
+struct GateBinaryPhaseSpaceRecord
+{
+  float   energy;
+  float   x, y, z;
+  float   dx, dy, dz;
+  float   weight;
+  float   time;     // 0 if not stored
+  int32_t pdgCode;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+struct GateBinaryPhaseSpaceHeader
+{
+  char     magic[8];      // "GATEPHSP"
+  uint32_t version;
+  uint32_t recordSize;    // sizeof(GateBinaryPhaseSpaceRecord)
+  uint64_t nbOfRecords;
+  uint32_t byteOrderMark; // 0x01020304 in the native byte order
+  char     unused[36];
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GateBinaryPhaseSpaceWriter
+{
+public:
+  GateBinaryPhaseSpaceWriter();
+  ~GateBinaryPhaseSpaceWriter();
+
+  void Open(const G4String & filename);
+  inline void Write(const GateBinaryPhaseSpaceRecord & record);
+
+  // Write the buffered records and update the header, the file is then
+  // readable even if the simulation does not terminate normally
+  void Flush();
+  // Remove all the records written so far
+  void Reset();
+  void Close();
+
+  uint64_t GetNumberOfRecords() const { return mNbOfRecords; }
+
+protected:
+  void WriteHeader();
+
+  G4String mFilename;
+  FILE * pFile;
+  std::vector<GateBinaryPhaseSpaceRecord> mBuffer;
+  uint64_t mNbOfRecords;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GateBinaryPhaseSpaceReader
+{
+public:
+  GateBinaryPhaseSpaceReader();
+  ~GateBinaryPhaseSpaceReader();
+
+  void Open(const G4String & filename);
+  void Close();
+
+  uint64_t GetNumberOfRecords() const { return mNbOfRecords; }
+  const G4String & GetFilename() const { return mFilename; }
+
+  // Direct access to the mapped records
+  const GateBinaryPhaseSpaceRecord & GetRecord(uint64_t i) const { return pRecords[i]; }
+
+  // Copy n records from the given index (n is reduced at the end of
+  // the file) and ask the kernel to prefetch the following block.
+  // Return the number of copied records.
+  uint64_t ReadRecords(uint64_t first, uint64_t n, GateBinaryPhaseSpaceRecord * out);
+
+protected:
+  void Prefetch(uint64_t first, uint64_t n);
+
+  G4String mFilename;
+  int mFileDescriptor;
+  void * pMapping;
+  size_t mMappingSize;
+  const GateBinaryPhaseSpaceRecord * pRecords;
+  uint64_t mNbOfRecords;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+inline void GateBinaryPhaseSpaceWriter::Write(const GateBinaryPhaseSpaceRecord & record)
+{
+  mBuffer.push_back(record);
+  if (mBuffer.size() == mBuffer.capacity()) Flush();
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEBINARYPHASESPACE_HH */
@@ -19,6 +19,9 @@
 #include "GateCreatorProcessFilterMessenger.hh"
 
 #include <list>
+#include <map>
+
+class G4VProcess;
 
 class  GateCreatorProcessFilter : 
   public GateVFilter
@@ -30,6 +33,8 @@ class  GateCreatorProcessFilter :
     FCT_FOR_AUTO_CREATOR_FILTER(GateCreatorProcessFilter)
 
     virtual G4bool Accept(const G4Track*);
+    virtual void Initialize();
+    virtual G4String GetFilterKey();
 
     void AddCreatorProcess(const G4String& processName);
 
@@ -40,6 +45,9 @@ class  GateCreatorProcessFilter :
     typedef std::list<G4String> CreatorProcesses;
     CreatorProcesses creatorProcesses;
 
+    // creatorProcesses resolved for each process met
+    std::map<const G4VProcess*, G4bool> mIsAcceptedProcess;
+
     GateCreatorProcessFilterMessenger * pMessenger;
 
 };
@@ -24,6 +24,7 @@ See GATE/LICENSE.txt for further details
 #include "globals.hh"
 #include "G4String.hh"
 #include <vector>
+#include <map>
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -39,14 +40,29 @@ public:
   virtual G4bool Accept(const G4Step*) const;
   virtual G4bool Accept(const G4Track*) const;
 
-  void AddFilter(GateVFilter* filter){theFilters.push_back(filter);}
+  void AddFilter(GateVFilter* filter){theFilters.push_back(filter); mSharedSlots.clear();}
   G4int GetNumberOfFilters(){return theFilters.size();}
   void show();
 
+  // Initializes the filters and enables the per step evaluation shared
+  // by the filters with the same key (see GateVFilter::GetFilterKey)
+  // in all the initialized managers. The steps are identified by
+  // GateActorManager::GetStepStamp.
+  void Initialize();
+
 protected:
   G4String mFilterName;
   std::vector<GateVFilter*> theFilters;
 
+  // Shared result of a filter key: valid for the step stamp
+  struct SharedResult {
+    unsigned long stamp;
+    G4bool result;
+  };
+  std::vector<int> mSharedSlots;  // per filter, -1 if not shared
+  static std::vector<SharedResult> mSharedResults;
+  static std::map<G4String, int> mSharedSlotOfKey;
+
 private:
   
 };
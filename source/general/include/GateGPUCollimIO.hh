@@ -247,6 +247,22 @@ void GPU_GateSPECT(Colli &colli_d, CoordHex2 &centerOfHexagons_h, CoordHex2 &cen
 void GPU_GateSPECT_end(CoordHex2 &centerOfHexagons_d, StackParticle &photons_d, StackParticle &photons_h,
 						Materials &materials_d);					
 
+// Same calculation on the CPU (source/gpu/src/GateCPUManager.cc)
+void CPU_GateSPECT_init(const GateGPUCollimIO_Input *input, Colli &colli_d, 
+						CoordHex2 &centerOfHexagons_h, CoordHex2 &centerOfHexagons_d, 
+						StackParticle &photons_d, StackParticle &photons_h, Materials &materials_d,
+						unsigned int nb_of_particles, unsigned int nb_of_hexagons, unsigned int seed);
+
+void CPU_GateSPECT(Colli &colli_d, CoordHex2 &centerOfHexagons_h, CoordHex2 &centerOfHexagons_d, 
+					StackParticle &photons_d, StackParticle &photons_h, Materials &materials_d, 
+					unsigned int nb_of_particles);
+
+void CPU_GateSPECT_end(CoordHex2 &centerOfHexagons_d, StackParticle &photons_d, StackParticle &photons_h,
+						Materials &materials_d);
+
+// Number of threads used by the CPU calculations (default: number of cores)
+void GateCPUSetNumberOfThreads(int n);
+
 /*void GPU_GateTransTomo_init(const GateGPUCollimIO_Input *input,
                             Materials &materials_d, Volume &phantom_d,
                             StackParticle &photons_d, StackParticle &photon_h,
@@ -284,4 +284,62 @@ void GateOpticalBiolum_GPU(const GateGPUIO_Input * input,
                            GateGPUIO_Output * output);
 //----------------------------------------------------------
 
+
+//----------------------------------------------------------
+// Same calculations on the CPU (source/gpu/src/GateCPUManager.cc)
+void CPU_GateTransTomo_init(const GateGPUIO_Input *input,
+                            Materials &materials_d, Volume &phantom_d,
+                            StackParticle &photons_d, StackParticle &photon_h,
+                            unsigned int nb_of_particles, unsigned int seed);
+
+void CPU_GateTransTomo(Materials &materials_d, Volume &phantom_d,
+                       StackParticle &photons_d, StackParticle &photons_h,
+                       unsigned int nb_of_particles);
+
+void CPU_GateTransTomo_end(Materials &materials_d, Volume &phantom_d,
+                           StackParticle &photons_d, StackParticle &photons_h);
+
+void CPU_GateEmisTomo_init(const GateGPUIO_Input *input,
+                           Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                           StackParticle &gamma1_d, StackParticle &gamma2_d,
+                           StackParticle &gamma1_h, StackParticle &gamma2_h,
+                           unsigned int nb_of_particles, unsigned int seed);
+
+void CPU_GateEmisTomo(Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                      StackParticle &gamma1_d, StackParticle &gamma2_d,
+                      StackParticle &gamma1_h, StackParticle &gamma2_h,
+                      unsigned int nb_of_particles);
+
+void CPU_GateEmisTomo_end(Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                          StackParticle &gamma1_d, StackParticle &gamma2_d,
+                          StackParticle &gamma1_h, StackParticle &gamma2_h);
+
+void CPU_GatePhotRadThera_init(const GateGPUIO_Input *input, 
+                               Dosimetry &dose_d,
+                               Materials &materials_d,
+                               Volume &phantom_d,
+                               StackParticle &photons_d, StackParticle &electrons_d,
+                               StackParticle &photons_h, 
+                               unsigned int nb_of_particles, unsigned int seed);
+
+void CPU_GatePhotRadThera(Dosimetry &dosemap_d,
+                          Materials &materials_d,
+                          Volume &phantom_d,
+                          StackParticle &photons_d, StackParticle &electrons_d,
+                          StackParticle &photons_h,
+                          unsigned int nb_of_particles);
+
+void CPU_GatePhotRadThera_end(Dosimetry &dosemap_d, 
+                              Materials &materials_d, 
+                              Volume &phantom_d,
+                              StackParticle &photons_d, StackParticle &electrons_d,
+                              StackParticle &photons_h);
+
+void GateOpticalBiolum_CPU(const GateGPUIO_Input * input, 
+                           GateGPUIO_Output * output);
+
+// Number of threads used by the CPU calculations (default: number of cores)
+void GateCPUSetNumberOfThreads(int n);
+//----------------------------------------------------------
+
 #endif
@@ -52,12 +52,21 @@ public:
   void MapLabelToMaterial(LabelToMaterialNameType & m);
   double GetHMeanFromLabel(int l);
   LabelType GetLabelFromH(double h);
+  // Precomputes the label of every integer H of the table range, done
+  // by the first GetLabelFromH. Must be called before concurrent calls.
+  void BuildLabelLookupTable();
   
   GateMaterialsVector GetMaterials() { return mMaterialsVector; }
   inline mMaterials & operator[](int index){ return mMaterialsVector[index];}
 
 protected:
+  LabelType SearchLabelFromH(double h);
+
   GateMaterialsVector mMaterialsVector;
+  std::vector<double> mH1MaxVector;
+  std::vector<LabelType> mLabelLookupTable;
+  int mLabelLookupTableMinH;
+  bool mLabelLookupTableIsValid;
 
 };
 #endif
@@ -31,8 +31,12 @@
   initial 'data' member will result in a seg fault. Use
   GetDataDoublePointer.
 
-  FIXME:
-  - manage a sparse version (not an histo at every pixel)
+  Sparse storage (SetSparse(true) before Allocate, double only): the
+  histograms are stored by blocks of consecutive pixels, a block being
+  allocated the first time one of its pixels is modified. Pixels of
+  unallocated blocks are zero. GetDataDoublePointer cannot be used, use
+  GetHistoDoublePointer (one pixel) instead. Write streams the mhd raw
+  data one bin at a time, without building the full XYZH image.
 
  */
 
@@ -46,6 +50,8 @@ public:
 
   void SetHistoInfo(int n, double min, double max);
   virtual void Allocate();
+  void SetSparse(bool b) { mIsSparse = b; }
+  bool IsSparse() { return mIsSparse; }
   void Reset();
   void AddValueFloat(const int & index, TH1D * h, const double scale);
   void AddValueDouble(const int & index, TH1D * h, const double scale);
@@ -61,7 +67,9 @@ public:
   unsigned long GetDoubleSize() { return dataDouble.size(); }
   unsigned long GetFloatSize() { return dataFloat.size(); }
   unsigned long GetIntSize() { return dataInt.size(); }
-  double * GetDataDoublePointer() { return &dataDouble[0]; }
+  double * GetDataDoublePointer();
+  // Histogram of a pixel (nbOfBins values), allocated if sparse. Not thread safe.
+  double * GetHistoDoublePointer(const int & index);
   float * GetDataFloatPointer() { return &dataFloat[0]; }
   unsigned int * GetDataIntPointer() { return &dataInt[0]; }
   long GetIndexFromPixelIndex(int i, int j, int k);
@@ -86,6 +94,13 @@ protected:
   std::vector<float> dataFloat;
   std::vector<unsigned int> dataInt;
 
+  // Sparse storage: blocks of mSparseBlockSize pixels x nbOfBins, empty
+  // vector when not allocated.
+  bool mIsSparse;
+  std::vector<std::vector<double> > mSparseBlocks;
+  static const long mSparseBlockSize = 64;
+  void WriteSparseRawData(std::string rawName);
+
   // Store a copy of G4ThreeVector resolution in int for integer
   // computation of index
   long sizeX;
@@ -24,6 +24,7 @@
 // std
 #include <fstream>
 #include <iomanip>
+#include <map>
 
 // gate
 #include "GateVImage.hh"
@@ -103,6 +104,12 @@ public:
   // IO
   /// Writes the image to a file with comment (the format is detected automatically)
   virtual void Write(G4String filename, const G4String & comment = "");
+  // Write .mha files with zlib compressed data
+  void SetCompression(bool b) { mIsCompressionEnabled = b; }
+  bool IsCompressionEnabled() const { return mIsCompressionEnabled; }
+  // Additional "name = value" lines of the .mhd/.mha header
+  void SetHeaderField(const std::string & name, double value) { mHeaderFields[name] = value; }
+  const std::map<std::string, double> & GetHeaderFields() const { return mHeaderFields; }
 
   /// Reads the image from a file (the format is detected automatically)
   virtual void Read(G4String filename);
@@ -116,6 +123,8 @@ public:
 protected:
   std::vector<PixelType> data;
   PixelType mOutsideValue;
+  bool mIsCompressionEnabled;
+  std::map<std::string, double> mHeaderFields;
 
   void ReadAscii(G4String filename);
   void ReadAnalyze(G4String filename);
@@ -14,6 +14,7 @@
 #include "G4ThreeVector.hh"
 
 // std
+#include <map>
 #include <vector>
 
 // gate
@@ -48,6 +49,9 @@ public:
     template<class PixelType>
     void WriteData(std::string filename, GateImageT<PixelType> * image);
 
+    // zlib compression of the data, for .mha files only
+    void SetCompression(bool b) { mIsCompressionEnabled = b; }
+
     std::vector<double> size;
     std::vector<double> spacing;
     std::vector<double> origin;
@@ -56,6 +60,7 @@ public:
 protected:
     std::vector<std::string> tags;
     std::vector<std::string> values;
+    bool mIsCompressionEnabled;
 
     void Print();
     void Read_3_values(std::string tag, double * v);
@@ -17,6 +17,8 @@ See GATE/LICENSE.txt for further details
 #include "GateActorManager.hh"
 #include "GateMaterialFilterMessenger.hh"
 
+#include "G4Material.hh"
+
 class  GateMaterialFilter : 
   public GateVFilter
 {
@@ -28,14 +30,22 @@ public:
 
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
+  virtual void Initialize();
+  virtual G4String GetFilterKey();
   void Add(const G4String& materialName);
   virtual void show();
 
 private:
  std::vector<G4String> theMdef;
  GateMaterialFilterMessenger * pMatMessenger;
- 
- int nFilteredParticles;
+
+ // theMdef resolved for each material of the material table, by index
+ std::vector<G4bool> mIsAcceptedMaterial;
+ void ResolveMaterials();
+ inline G4bool IsAcceptedMaterial(const G4Material * m) {
+   if (m->GetIndex() >= mIsAcceptedMaterial.size()) ResolveMaterials();
+   return mIsAcceptedMaterial[m->GetIndex()];
+ }
 };
 
 MAKE_AUTO_CREATOR_FILTER(materialFilter,GateMaterialFilter)
@@ -27,6 +27,8 @@ See GATE/LICENSE.txt for further details
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 
+#include <map>
+
 class  GateParticleFilter :
   public GateVFilter
 {
@@ -37,6 +39,8 @@ public:
   FCT_FOR_AUTO_CREATOR_FILTER(GateParticleFilter)
 
   virtual G4bool Accept(const G4Track *);
+  virtual void Initialize();
+  virtual G4String GetFilterKey();
 
   void Add(const G4String &particleName);
   void AddParent(const G4String &particleName);
@@ -51,7 +55,9 @@ private:
   std::vector<G4String> theDirectParentPdef;
   GateParticleFilterMessenger *pPartMessenger;
 
-  int nFilteredParticles;
+  // thePdef resolved for each particle definition met
+  std::map<const G4ParticleDefinition*, G4bool> mIsAcceptedParticle;
+  G4bool IsAcceptedParticle(const G4ParticleDefinition *);
 };
 
 MAKE_AUTO_CREATOR_FILTER(particleFilter, GateParticleFilter)
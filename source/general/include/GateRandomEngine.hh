@@ -33,6 +33,8 @@ public:
   void SetRandomEngine(const G4String& aName);
   void SetEngineSeed(const G4String& value);
   void resetEngineFrom(const G4String& file); //TC
+  //! Offset added to the seed in Initialize(), to get distinct sequences in worker processes
+  inline void SetSeedOffset(long offset) {theSeedOffset=offset;}
   void ShowStatus();
   void Initialize();
 
@@ -45,6 +47,7 @@ private:
   GateRandomEngineMessenger* theMessenger;
   G4String theSeed;
   G4String theSeedFile; //TC
+  long theSeedOffset;
 };
 
 #endif
@@ -62,6 +62,7 @@ public:
   static GateRunManager* GetRunManager()
   {	return dynamic_cast<GateRunManager*>(G4RunManager::GetRunManager()); }
 
+  bool IsGateInitializationCalled() const { return mIsGateInitializationCalled; }
   bool GetGlobalOutputFlag() { return mGlobalOutputFlag; }
   void EnableGlobalOutput(bool b) { mGlobalOutputFlag = b; }
   void SetUserPhysicList(G4VUserPhysicsList * m) { mUserPhysicList = m; }
@@ -37,10 +37,21 @@ public:
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
 
- 
+  // Called at the beginning of each run, before the first Accept:
+  // names (particles, materials...) may be resolved here.
+  virtual void Initialize() {}
+
+  // Filters with the same non empty key accept exactly the same steps,
+  // so that the filter managers evaluate them only once per step.
+  virtual G4String GetFilterKey() { return ""; }
+
+  // Counts a step accepted by another filter with the same key
+  void AddFilteredParticle() { nFilteredParticles++; }
+
   virtual void show();
 
- 
+protected:
+  int nFilteredParticles;
 
 private:
 
@@ -0,0 +1,85 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+#include "GateAliasTable.hh"
+#include "Randomize.hh"
+
+//-----------------------------------------------------------------------------
+GateAliasTable::GateAliasTable()
+{
+  mTotalWeight = 0.0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateAliasTable::Clear()
+{
+  mProbability.clear();
+  mAlias.clear();
+  mTotalWeight = 0.0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateAliasTable::Build(const std::vector<G4double> & weights)
+{
+  G4int n = weights.size();
+  mTotalWeight = 0.0;
+  for(G4int i=0; i<n; i++) if (weights[i] > 0) mTotalWeight += weights[i];
+
+  if (n == 0 || mTotalWeight <= 0) {
+    Clear();
+    return;
+  }
+
+  mProbability.resize(n);
+  mAlias.resize(n);
+  mScaled.resize(n);
+  mSmall.clear();
+  mLarge.clear();
+
+  // Vose's algorithm: scale the weights so that the mean is 1, then
+  // pair each 'small' column with a 'large' one.
+  G4double f = n / mTotalWeight;
+  for(G4int i=0; i<n; i++) {
+    mScaled[i] = (weights[i] > 0 ? weights[i]*f : 0.0);
+    if (mScaled[i] < 1.0) mSmall.push_back(i);
+    else mLarge.push_back(i);
+  }
+
+  while (!mSmall.empty() && !mLarge.empty()) {
+    G4int s = mSmall.back(); mSmall.pop_back();
+    G4int l = mLarge.back(); mLarge.pop_back();
+    mProbability[s] = mScaled[s];
+    mAlias[s] = l;
+    mScaled[l] = (mScaled[l] + mScaled[s]) - 1.0;
+    if (mScaled[l] < 1.0) mSmall.push_back(l);
+    else mLarge.push_back(l);
+  }
+
+  // Remaining columns are full (up to rounding errors)
+  for(unsigned int i=0; i<mLarge.size(); i++) {
+    mProbability[mLarge[i]] = 1.0;
+    mAlias[mLarge[i]] = mLarge[i];
+  }
+  for(unsigned int i=0; i<mSmall.size(); i++) {
+    mProbability[mSmall[i]] = 1.0;
+    mAlias[mSmall[i]] = mSmall[i];
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4int GateAliasTable::Sample() const
+{
+  return Sample(G4UniformRand());
+}
+//-----------------------------------------------------------------------------
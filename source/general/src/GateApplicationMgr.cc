@@ -21,14 +21,24 @@ See GATE/LICENSE.txt for further details
 #include "GateVSource.hh"
 #include "GateSourceMgr.hh"
 #include "GateOutputMgr.hh"
+#include "GateActorManager.hh"
+#include "GateVActor.hh"
+#ifdef G4ANALYSIS_USE_ROOT
+#include "TROOT.h"
+#endif
 #include <algorithm> /* min and max */
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/wait.h>
 
 GateApplicationMgr* GateApplicationMgr::instance = 0; 
 //------------------------------------------------------------------------------------------
 GateApplicationMgr::GateApplicationMgr(): 
   nVerboseLevel(0), m_time(0),
   mOutputMode(true),  mTimeSliceIsSetUsingAddSlice(false), mTimeSliceIsSetUsingReadSliceInFile(false),
-  mTimeStepInTotalAmountOfPrimariesMode(0.0)
+  mTimeStepInTotalAmountOfPrimariesMode(0.0),
+  mNumberOfWorkers(1), mWorkerID(-1)
 {
   if(instance != 0) // this function is only ever called if instance==0. This will never be true...
     G4Exception( "GateApplicationMgr::GateApplicationMgr", "GateApplicationMgr", FatalException, "GateApplicationMgr constructed twice.");
@@ -290,6 +300,10 @@ void GateApplicationMgr::StartDAQComplete(G4ThreeVector param)
 //------------------------------------------------------------------------------------------
 void GateApplicationMgr::StartDAQ() 
 {
+  if (mNumberOfWorkers > 1 && mWorkerID < 0) {
+    StartDAQWorkers();
+    return;
+  }
 
   // With this method we check for all output module enabled but with no
   // filename given. In this case we disable the output module and send a warning.
@@ -484,6 +498,177 @@ void GateApplicationMgr::StartDAQCluster(G4ThreeVector param)
 //------------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------------
+void GateApplicationMgr::SetNumberOfWorkers(G4int n)
+{
+  if (n < 1) GateError("The number of workers must be >= 1, but is " << n);
+  // the actors are constructed by /gate/run/initialize, and must then be
+  // constructed in the workers instead
+  if (GateRunManager::GetRunManager()->IsGateInitializationCalled())
+    GateError("/gate/application/setNumberOfWorkers must be given before /gate/run/initialize");
+  mNumberOfWorkers = n;
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+G4String GateApplicationMgr::GetWorkerSuffix(G4int workerID) const
+{
+  if (workerID < 0) return "";
+  std::ostringstream suffix;
+  suffix << "-worker" << workerID;
+  return suffix.str();
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+G4String GateApplicationMgr::GetWorkerFileName(const G4String& filename, G4int workerID) const
+{
+  if (workerID < 0) return filename;
+  std::string f = filename;
+  size_t dot = f.find_last_of('.');
+  size_t slash = f.find_last_of('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    return f + GetWorkerSuffix(workerID);
+  return f.substr(0, dot) + GetWorkerSuffix(workerID) + f.substr(dot);
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// Multi-process acquisition: each worker is a fork of the current process
+// and simulates a part of the acquisition time, as with startDAQCluster,
+// or a part of the primaries in total-primaries mode. The geometry, the
+// materials and the physics tables are built before the fork, and shared
+// (copy-on-write) by all the workers. The actors are constructed in the
+// workers, and their outputs merged at the end.
+void GateApplicationMgr::StartDAQWorkers()
+{
+  InitializeTimeSlices();
+  G4double timeStart = mTimeSlices.front();
+  G4double timeStop = mTimeSlices.back();
+
+  if (mATotalAmountOfPrimariesIsRequested) {
+    long int n = (mAnAmountOfPrimariesPerRunIsRequested ? mRequestedAmountOfPrimariesPerRun : mRequestedAmountOfPrimaries);
+    if (n < mNumberOfWorkers)
+      GateError("Cannot share " << n << " primaries between " << mNumberOfWorkers << " workers");
+  }
+
+  // All the outputs are merged at the end: refuse the actors that cannot
+  // be, before simulating anything
+  std::vector<GateVActor*> & actors = GateActorManager::GetInstance()->GetTheListOfActors();
+  for(unsigned int i=0; i<actors.size(); i++) {
+    if (actors[i]->GetSaveFilename() == "FilnameNotGivenForThisActor") continue;
+    if (!actors[i]->CanMergeWorkerOutputs())
+      GateError("The outputs of actor " << actors[i]->GetObjectName() << " (" << actors[i]->GetSaveFilename()
+                << ") cannot be merged: this actor cannot be used with several workers");
+  }
+
+  GateMessage("Acquisition", 0,"  \n");
+  GateMessage("Acquisition", 0, "============= Starting " << mNumberOfWorkers << " workers =============\n");
+
+  // Build the physics tables now (fake run, no event)
+  GateClock::GetInstance()->SetTime(timeStart);
+  GateRunManager::GetRunManager()->BeamOn(0);
+
+  // Do not duplicate the buffered output in the workers
+  G4cout << std::flush;
+  std::cout.flush();
+  std::cerr.flush();
+
+  std::vector<pid_t> workers;
+  G4double workerStart = timeStart;
+  for(G4int i=0; i<mNumberOfWorkers; i++) {
+    G4double workerStop = (i == mNumberOfWorkers-1) ? timeStop :
+      timeStart + (timeStop-timeStart)*(i+1)/mNumberOfWorkers;
+    pid_t pid = fork();
+    if (pid < 0) GateError("Cannot start worker " << i);
+    if (pid == 0) RunWorker(i, workerStart, workerStop); // does not return
+    if (mATotalAmountOfPrimariesIsRequested)
+      GateMessage("Acquisition", 1, "Worker " << i << " (pid " << pid << ")\n");
+    else
+      GateMessage("Acquisition", 1, "Worker " << i << " (pid " << pid << ") from "
+                  << workerStart/s << " to " << workerStop/s << " s\n");
+    workers.push_back(pid);
+    workerStart = workerStop;
+  }
+
+  G4int nbOfFailedWorkers = 0;
+  for(unsigned int i=0; i<workers.size(); i++) {
+    int status = 0;
+    if (waitpid(workers[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      GateWarning("Worker " << i << " (pid " << workers[i] << ") did not terminate correctly");
+      nbOfFailedWorkers++;
+    }
+  }
+  if (nbOfFailedWorkers > 0)
+    GateError(nbOfFailedWorkers << " worker(s) on " << mNumberOfWorkers << " failed");
+
+  GateMessage("Acquisition", 0, "============= " << mNumberOfWorkers << " workers done =============\n");
+  MergeWorkerOutputs();
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// Reduce step of StartDAQWorkers: the actors merge the files of the workers
+// into their own output files. The output modules (ROOT, ASCII, ...) are
+// not merged.
+void GateApplicationMgr::MergeWorkerOutputs()
+{
+  GateMessage("Acquisition", 0, "============= Merging the outputs of the workers =============\n");
+  std::vector<GateVActor*> & actors = GateActorManager::GetInstance()->GetTheListOfActors();
+  for(unsigned int i=0; i<actors.size(); i++) {
+    std::vector<G4String> filenames;
+    for(G4int w=0; w<mNumberOfWorkers; w++)
+      filenames.push_back(GetWorkerFileName(actors[i]->GetSaveFilename(), w));
+    actors[i]->MergeWorkerOutputs(filenames);
+  }
+  GateMessage("Acquisition", 0, "Outputs of the output modules of each worker are suffixed with '-worker<i>'\n");
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+void GateApplicationMgr::RunWorker(G4int workerID, G4double virtualStart, G4double virtualStop)
+{
+  mWorkerID = workerID;
+
+  // Distinct random sequence in each worker
+  GateRandomEngine::GetInstance()->SetSeedOffset(workerID);
+
+  // Distinct output files in each worker. The actors derive the names of
+  // their files (and open some of them) in Construct, done only now.
+  GateOutputMgr::GetInstance()->AddFileNameSuffixForAllOutput(GetWorkerSuffix(workerID));
+  std::vector<GateVActor*> & actors = GateActorManager::GetInstance()->GetTheListOfActors();
+  for(unsigned int i=0; i<actors.size(); i++)
+    actors[i]->SetSaveFilename(GetWorkerFileName(actors[i]->GetSaveFilename(), workerID));
+  GateActorManager::GetInstance()->CreateListsOfEnabledActors();
+
+  if (mATotalAmountOfPrimariesIsRequested) {
+    // Share of the primaries, generated over the whole acquisition time
+    long int & n = (mAnAmountOfPrimariesPerRunIsRequested ? mRequestedAmountOfPrimariesPerRun : mRequestedAmountOfPrimaries);
+    n = long(double(n)*(workerID+1)/mNumberOfWorkers) - long(double(n)*workerID/mNumberOfWorkers);
+    StartDAQ();
+  }
+  else StartDAQCluster(G4ThreeVector(virtualStart, virtualStop, 0));
+
+  // _exit, not exit: the atexit handlers and static destructors belong to
+  // the parent (open files, ROOT, Geant4 singletons). Only the files of the
+  // worker are closed, and its streams flushed.
+#ifdef G4ANALYSIS_USE_ROOT
+  gROOT->CloseFiles();
+#endif
+  G4cout << std::flush;
+  std::cout.flush();
+  std::cerr.flush();
+  fflush(NULL);
+  _exit(0);
+}
+//------------------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------------------
 void GateApplicationMgr::Describe() 
 {
@@ -491,6 +676,7 @@ void GateApplicationMgr::Describe()
 	 << "  time slice (s) : " << mTimeSliceDuration/s << Gateendl
 	 << "  time start (s) : " << mTimeSlices[0]/s << Gateendl
 	 << "  time stop  (s) : " << mTimeSlices[mTimeSlices.size()-1]/s  << Gateendl
+	 << "  workers        : " << mNumberOfWorkers << Gateendl
 	 << "------------------ \n"
 	 << Gateendl;
 }
@@ -114,6 +114,14 @@ GateApplicationMgrMessenger::GateApplicationMgrMessenger()
   SetNumberOfPrimariesPerRunCmd2 = new G4UIcmdWithADouble("/gate/application/SetNumberOfPrimariesPerRun", this);
   SetNumberOfPrimariesPerRunCmd2->SetGuidance("Set the number of primaries to generate per per run.");
 
+  SetNumberOfWorkersCmd = new G4UIcmdWithAnInteger("/gate/application/setNumberOfWorkers", this);
+  SetNumberOfWorkersCmd->SetGuidance("Run startDAQ in several worker processes, each one simulating a part of the acquisition time (or of the primaries).");
+  SetNumberOfWorkersCmd->SetGuidance("Geometry, materials and physics tables are built once and shared by the workers.");
+  SetNumberOfWorkersCmd->SetGuidance("Output files of worker i are suffixed with '-worker<i>'; the dose and statistics actors merge them at the end.");
+  SetNumberOfWorkersCmd->SetGuidance("Must be given before /gate/run/initialize.");
+  SetNumberOfWorkersCmd->SetParameterName("n",false);
+  SetNumberOfWorkersCmd->SetRange("n>=1");
+
   TimeStudyCmd = new G4UIcmdWithAString("/gate/application/enableTrackTimeStudy", this);
   TimeStudyCmd->SetGuidance("Activate the time measurement of tracks (Slow down the simulation).");
   TimeStudyCmd->SetParameterName("File name",false);
@@ -145,6 +153,7 @@ GateApplicationMgrMessenger::~GateApplicationMgrMessenger()
   //delete EnableSuccessiveSourceMode;
   delete ReadTimeSlicesInAFileCmd;
   delete SetTotalNumberOfPrimariesCmd;
+  delete SetNumberOfWorkersCmd;
   delete SetNumberOfPrimariesPerRunCmd;
   delete SetNumberOfPrimariesPerRunCmd2;
   delete AddSliceCmd;
@@ -218,6 +227,9 @@ void GateApplicationMgrMessenger::SetNewValue(G4UIcommand* command, G4String new
   else if (command == SetNumberOfPrimariesPerRunCmd2) {
     appMgr->SetNumberOfPrimariesPerRun(SetNumberOfPrimariesPerRunCmd2->GetNewDoubleValue(newValue));
   }
+  else if (command == SetNumberOfWorkersCmd) {
+    appMgr->SetNumberOfWorkers(SetNumberOfWorkersCmd->GetNewIntValue(newValue));
+  }
   else if (command == TimeStudyCmd) {
     appMgr->EnableTimeStudy(newValue);
   }
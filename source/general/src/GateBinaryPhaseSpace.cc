@@ -0,0 +1,208 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+#include "GateBinaryPhaseSpace.hh"
+#include "GateMessageManager.hh"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char     gBinaryPhaseSpaceMagic[8] = { 'G','A','T','E','P','H','S','P' };
+static const uint32_t gBinaryPhaseSpaceVersion = 1;
+static const uint32_t gBinaryPhaseSpaceByteOrderMark = 0x01020304;
+static const size_t   gBinaryPhaseSpaceBlockSize = 4096; // records
+
+//-----------------------------------------------------------------------------
+GateBinaryPhaseSpaceWriter::GateBinaryPhaseSpaceWriter()
+{
+  pFile = 0;
+  mNbOfRecords = 0;
+  mBuffer.reserve(gBinaryPhaseSpaceBlockSize);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBinaryPhaseSpaceWriter::~GateBinaryPhaseSpaceWriter()
+{
+  Close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceWriter::Open(const G4String & filename)
+{
+  Close();
+  mFilename = filename;
+  pFile = fopen(mFilename.c_str(), "wb");
+  if (!pFile) GateError("Cannot open the phase space file '" << mFilename << "' for writing.");
+  mNbOfRecords = 0;
+  mBuffer.clear();
+  WriteHeader();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceWriter::WriteHeader()
+{
+  GateBinaryPhaseSpaceHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, gBinaryPhaseSpaceMagic, sizeof(header.magic));
+  header.version = gBinaryPhaseSpaceVersion;
+  header.recordSize = sizeof(GateBinaryPhaseSpaceRecord);
+  header.nbOfRecords = mNbOfRecords;
+  header.byteOrderMark = gBinaryPhaseSpaceByteOrderMark;
+  fseek(pFile, 0, SEEK_SET);
+  if (fwrite(&header, sizeof(header), 1, pFile) != 1)
+    GateError("Cannot write the header of the phase space file '" << mFilename << "'.");
+  fseek(pFile, 0, SEEK_END);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceWriter::Flush()
+{
+  if (!pFile) return;
+  if (!mBuffer.empty()) {
+    if (fwrite(&mBuffer[0], sizeof(GateBinaryPhaseSpaceRecord), mBuffer.size(), pFile) != mBuffer.size())
+      GateError("Cannot write to the phase space file '" << mFilename << "'.");
+    mNbOfRecords += mBuffer.size();
+    mBuffer.clear();
+  }
+  WriteHeader();
+  fflush(pFile);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceWriter::Reset()
+{
+  if (!pFile) return;
+  Open(mFilename);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceWriter::Close()
+{
+  if (!pFile) return;
+  Flush();
+  fclose(pFile);
+  pFile = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBinaryPhaseSpaceReader::GateBinaryPhaseSpaceReader()
+{
+  mFileDescriptor = -1;
+  pMapping = 0;
+  mMappingSize = 0;
+  pRecords = 0;
+  mNbOfRecords = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBinaryPhaseSpaceReader::~GateBinaryPhaseSpaceReader()
+{
+  Close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceReader::Open(const G4String & filename)
+{
+  Close();
+  mFilename = filename;
+  mFileDescriptor = open(mFilename.c_str(), O_RDONLY);
+  if (mFileDescriptor < 0) GateError("Error file not found: " << mFilename);
+
+  struct stat info;
+  if (fstat(mFileDescriptor, &info) != 0 || info.st_size < (off_t)sizeof(GateBinaryPhaseSpaceHeader))
+    GateError("The phase space file '" << mFilename << "' is too small to be a .gphsp file.");
+  mMappingSize = info.st_size;
+
+  pMapping = mmap(0, mMappingSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+  if (pMapping == MAP_FAILED) {
+    pMapping = 0;
+    GateError("Cannot map the phase space file '" << mFilename << "' in memory.");
+  }
+  madvise(pMapping, mMappingSize, MADV_SEQUENTIAL);
+
+  const GateBinaryPhaseSpaceHeader * header = static_cast<const GateBinaryPhaseSpaceHeader*>(pMapping);
+  if (memcmp(header->magic, gBinaryPhaseSpaceMagic, sizeof(header->magic)) != 0)
+    GateError("The file '" << mFilename << "' is not a .gphsp phase space file.");
+  if (header->byteOrderMark != gBinaryPhaseSpaceByteOrderMark)
+    GateError("The phase space file '" << mFilename << "' was written with another byte order.");
+  if (header->version != gBinaryPhaseSpaceVersion || header->recordSize != sizeof(GateBinaryPhaseSpaceRecord))
+    GateError("The phase space file '" << mFilename << "' has an unknown version (" << header->version << ").");
+
+  pRecords = reinterpret_cast<const GateBinaryPhaseSpaceRecord*>(static_cast<const char*>(pMapping) + sizeof(GateBinaryPhaseSpaceHeader));
+  mNbOfRecords = header->nbOfRecords;
+  uint64_t nbOfRecordsInFile = (mMappingSize - sizeof(GateBinaryPhaseSpaceHeader)) / sizeof(GateBinaryPhaseSpaceRecord);
+  if (nbOfRecordsInFile < mNbOfRecords) {
+    GateWarning("The phase space file '" << mFilename << "' is truncated: only " << nbOfRecordsInFile
+                << " particles out of " << mNbOfRecords << " are used.");
+    mNbOfRecords = nbOfRecordsInFile;
+  }
+  Prefetch(0, gBinaryPhaseSpaceBlockSize);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceReader::Close()
+{
+  if (pMapping) munmap(pMapping, mMappingSize);
+  if (mFileDescriptor >= 0) close(mFileDescriptor);
+  mFileDescriptor = -1;
+  pMapping = 0;
+  mMappingSize = 0;
+  pRecords = 0;
+  mNbOfRecords = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+uint64_t GateBinaryPhaseSpaceReader::ReadRecords(uint64_t first, uint64_t n, GateBinaryPhaseSpaceRecord * out)
+{
+  if (first >= mNbOfRecords) return 0;
+  if (first + n > mNbOfRecords) n = mNbOfRecords - first;
+  memcpy(out, pRecords + first, n*sizeof(GateBinaryPhaseSpaceRecord));
+  Prefetch(first + n, n);
+  return n;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBinaryPhaseSpaceReader::Prefetch(uint64_t first, uint64_t n)
+{
+  if (first >= mNbOfRecords || n == 0) return;
+  if (first + n > mNbOfRecords) n = mNbOfRecords - first;
+  // madvise needs a page-aligned start address
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t begin = sizeof(GateBinaryPhaseSpaceHeader) + first*sizeof(GateBinaryPhaseSpaceRecord);
+  size_t end = begin + n*sizeof(GateBinaryPhaseSpaceRecord);
+  begin -= begin % pageSize;
+  madvise(static_cast<char*>(pMapping) + begin, end - begin, MADV_WILLNEED);
+}
+//-----------------------------------------------------------------------------
@@ -9,6 +9,9 @@
 #include "GateCreatorProcessFilter.hh"
 #include "G4VProcess.hh"
 
+#include <algorithm>
+#include <vector>
+
 
 //---------------------------------------------------------------------------
 GateCreatorProcessFilter::GateCreatorProcessFilter(G4String name) : GateVFilter(name)
@@ -33,18 +36,44 @@ G4bool GateCreatorProcessFilter::Accept(const G4Track* aTrack)
   const G4VProcess *creatorProcess = aTrack->GetCreatorProcess();
   if (!creatorProcess) return false;
 
-  G4String creatorProcessName = creatorProcess->GetProcessName();
+  // The names are compared once per process object
+  std::map<const G4VProcess*, G4bool>::const_iterator it = mIsAcceptedProcess.find(creatorProcess);
+  if (it != mIsAcceptedProcess.end()) return it->second;
+
+  G4bool accept = false;
+  const G4String & creatorProcessName = creatorProcess->GetProcessName();
   for (CreatorProcesses::const_iterator iter=creatorProcesses.begin(); iter!=creatorProcesses.end(); iter++)
-    if (*iter==creatorProcessName)
-      return true;
+    if (*iter==creatorProcessName) {
+      accept = true;
+      break;
+    }
+  mIsAcceptedProcess[creatorProcess] = accept;
+  return accept;
+}
+//---------------------------------------------------------------------------
 
-  return false;
+//---------------------------------------------------------------------------
+void GateCreatorProcessFilter::Initialize()
+{
+  mIsAcceptedProcess.clear();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4String GateCreatorProcessFilter::GetFilterKey()
+{
+  std::vector<G4String> p(creatorProcesses.begin(), creatorProcesses.end());
+  std::sort(p.begin(), p.end());
+  G4String key = "creatorProcessFilter";
+  for (size_t i=0; i<p.size(); i++) key += " " + p[i];
+  return key;
 }
 
 //---------------------------------------------------------------------------
 void GateCreatorProcessFilter::AddCreatorProcess(const G4String& processName)
 {
   creatorProcesses.push_back(processName);
+  mIsAcceptedProcess.clear();
 }
 //---------------------------------------------------------------------------
 
@@ -9,7 +9,10 @@ See GATE/LICENSE.txt for further details
 
 #include "GateFilterManager.hh"
 #include "GateMessageManager.hh"
+#include "GateActorManager.hh"
 
+std::vector<GateFilterManager::SharedResult> GateFilterManager::mSharedResults;
+std::map<G4String, int> GateFilterManager::mSharedSlotOfKey;
 
 //---------------------------------------------------------------------------
 GateFilterManager::GateFilterManager(G4String name)
@@ -39,15 +42,54 @@ GateFilterManager::~GateFilterManager()
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+void GateFilterManager::Initialize()
+{
+  mSharedSlots.resize(theFilters.size());
+  for(unsigned int i = 0;i<theFilters.size();i++) {
+    theFilters[i]->Initialize();
+    G4String key = theFilters[i]->GetFilterKey();
+    if (key == "") {
+      mSharedSlots[i] = -1;
+      continue;
+    }
+    std::map<G4String, int>::iterator it = mSharedSlotOfKey.find(key);
+    if (it == mSharedSlotOfKey.end()) {
+      SharedResult r = { 0, false };
+      it = mSharedSlotOfKey.insert(std::make_pair(key, (int)mSharedResults.size())).first;
+      mSharedResults.push_back(r);
+    }
+    mSharedSlots[i] = it->second;
+  }
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 G4bool GateFilterManager::Accept(const G4Step* aStep) const
 {
-//  std::vector<GateVFilter*>::iterator sit;
- // for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
-      //if(!(*sit)->Accept(aStep)) return false;
+  // Not initialized (or filter added since): no shared evaluation
+  if (mSharedSlots.size() != theFilters.size()) {
+    for(unsigned int i = 0;i<theFilters.size();i++)
+      if(!theFilters[i]->Accept(aStep)) return false;
+    return true;
+  }
 
-  for(unsigned int i = 0;i<theFilters.size();i++)
-     if(!theFilters[i]->Accept(aStep)) return false;
+  unsigned long stamp = GateActorManager::GetInstance()->GetStepStamp();
+  for(unsigned int i = 0;i<theFilters.size();i++) {
+    int slot = mSharedSlots[i];
+    if (slot < 0) {
+      if(!theFilters[i]->Accept(aStep)) return false;
+      continue;
+    }
+    SharedResult & r = mSharedResults[slot];
+    if (r.stamp != stamp) {
+      // first filter with this key for this step
+      r.result = theFilters[i]->Accept(aStep);
+      r.stamp = stamp;
+    }
+    else if (r.result) theFilters[i]->AddFilteredParticle();
+    if (!r.result) return false;
+  }
 
   return true;
 }
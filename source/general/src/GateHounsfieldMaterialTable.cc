@@ -18,9 +18,14 @@
 #include "GateMiscFunctions.hh"
 #include "G4UnitsTable.hh"
 
+#include <algorithm>
+#include <cmath>
+
 //-----------------------------------------------------------------------------
 GateHounsfieldMaterialTable::GateHounsfieldMaterialTable()
 {
+  mLabelLookupTableMinH = 0;
+  mLabelLookupTableIsValid = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -62,6 +67,7 @@ void GateHounsfieldMaterialTable::AddMaterial(double H1, double H2, double d,
 
   // Set material
   mMaterialsVector.push_back(mat);
+  mLabelLookupTableIsValid = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -119,6 +125,7 @@ void GateHounsfieldMaterialTable::AddMaterial(double H1, double H2, G4String nam
   mat.mMaterial = theMaterialDatabase.GetMaterial(name);
   mat.md1=mat.mMaterial->GetDensity();
   mMaterialsVector.push_back(mat);
+  mLabelLookupTableIsValid = false;
   GateMessage("Actor",3,H1 << " " << H2 << " " << name);
 }
 //-----------------------------------------------------------------------------
@@ -131,6 +138,7 @@ void GateHounsfieldMaterialTable::Reset()
     it = mMaterialsVector.erase(it);
   }
   mMaterialsVector.clear();
+  mLabelLookupTableIsValid = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -155,14 +163,51 @@ void GateHounsfieldMaterialTable::MapLabelToMaterial(LabelToMaterialNameType & m
 //-----------------------------------------------------------------------------
 GateHounsfieldMaterialTable::LabelType GateHounsfieldMaterialTable::GetLabelFromH(double h)
 {
-  int i=0;
-  while ((i<GetNumberOfMaterials() && h>=mMaterialsVector[i].mH1)) i++;
+  if (!mLabelLookupTableIsValid) BuildLabelLookupTable();
+  double i = h - mLabelLookupTableMinH;
+  if (i >= 0 && i < mLabelLookupTable.size() && h == floor(h)) return mLabelLookupTable[(int)i];
+  return SearchLabelFromH(h);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// The label is the material before the first one with h<H1, and the number
+// of materials above the last H2. The first H1 above h is also the first
+// running maximum of H1 above h, which is sorted: binary search.
+GateHounsfieldMaterialTable::LabelType GateHounsfieldMaterialTable::SearchLabelFromH(double h)
+{
+  int n = GetNumberOfMaterials();
+  if (n == 0) return -1;
+  int i = std::upper_bound(mH1MaxVector.begin(), mH1MaxVector.end(), h) - mH1MaxVector.begin();
   i--;
-  if ((i==GetNumberOfMaterials()-1) && h>mMaterialsVector[i].mH2) return i+1;
+  if ((i==n-1) && h>mMaterialsVector[i].mH2) return i+1;
   return i;
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateHounsfieldMaterialTable::BuildLabelLookupTable()
+{
+  int n = GetNumberOfMaterials();
+  mH1MaxVector.resize(n);
+  for(int i=0; i<n; i++)
+    mH1MaxVector[i] = (i==0 ? mMaterialsVector[i].mH1 : std::max(mH1MaxVector[i-1], (double)mMaterialsVector[i].mH1));
+  mLabelLookupTable.clear();
+  mLabelLookupTableIsValid = true;
+  if (n == 0) return;
+
+  // labels of the integer H from below the first H1 to above the last H2
+  // (CT images store integer H). A table with a huge range is not worth it.
+  double minH = mMaterialsVector[0].mH1 - 1;
+  double maxH = std::max(mH1MaxVector[n-1], (double)mMaterialsVector[n-1].mH2) + 1;
+  if (maxH - minH + 1 > 1 << 22) return;
+  mLabelLookupTableMinH = (int)minH;
+  mLabelLookupTable.resize((int)(maxH - minH) + 1);
+  for(unsigned int i=0; i<mLabelLookupTable.size(); i++)
+    mLabelLookupTable[i] = SearchLabelFromH(mLabelLookupTableMinH + (double)i);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 double GateHounsfieldMaterialTable::GetHMeanFromLabel(int l) {
   double h = (mMaterialsVector[l].mH1+mMaterialsVector[l].mH2)/2.0;
@@ -15,15 +15,21 @@
 // Root
 #include <TFile.h>
 
+#include <fstream>
+#include <algorithm>
+
 // From ITK
 #include "metaObject.h"
 #include "metaImage.h"
 
+const long GateImageOfHistograms::mSparseBlockSize;
+
 //-----------------------------------------------------------------------------
 GateImageOfHistograms::GateImageOfHistograms(std::string dataTypeName):GateImage()
 {
   SetHistoInfo(0,0,0);
   mDataTypeName = dataTypeName;
+  mIsSparse = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -52,6 +58,17 @@ void GateImageOfHistograms::Allocate()
   sizeY = resolution.y();
   sizeZ = resolution.z();
 
+  // Sparse: only the (empty) table of blocks
+  if (mIsSparse) {
+    if (mDataTypeName != "double") {
+      GateError("Sparse ImageOfHistogram is only available for double data, not " << mDataTypeName);
+    }
+    std::vector<double>().swap(dataDouble);
+    mSparseBlocks.clear();
+    mSparseBlocks.resize((nbOfValues + mSparseBlockSize - 1) / mSparseBlockSize);
+    return;
+  }
+
   // Allocate full vector
   try {
     if (mDataTypeName == "double")
@@ -115,7 +132,12 @@ void GateImageOfHistograms::UpdateSizesFromResolutionAndHalfSize() {
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::Reset()
 {
-  if (mDataTypeName == "double")
+  if (mIsSparse) {
+    // Release the blocks, they will be allocated again when needed
+    for(unsigned int b=0; b<mSparseBlocks.size(); b++)
+      std::vector<double>().swap(mSparseBlocks[b]);
+  }
+  else if (mDataTypeName == "double")
     fill(dataDouble.begin(), dataDouble.end(), 0.0);
   else if (mDataTypeName == "float")
     fill(dataFloat.begin(), dataFloat.end(), 0.0);
@@ -125,6 +147,28 @@ void GateImageOfHistograms::Reset()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+double * GateImageOfHistograms::GetDataDoublePointer()
+{
+  if (mIsSparse) {
+    GateError("GetDataDoublePointer cannot be used with a sparse ImageOfHistogram, use GetHistoDoublePointer.");
+  }
+  return &dataDouble[0];
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double * GateImageOfHistograms::GetHistoDoublePointer(const int & index)
+{
+  if (!mIsSparse) return &dataDouble[(long)index*nbOfBins];
+  std::vector<double> & block = mSparseBlocks[index / mSparseBlockSize];
+  if (block.empty()) block.resize(mSparseBlockSize * nbOfBins, 0.0);
+  return &block[(index % mSparseBlockSize) * nbOfBins];
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 long GateImageOfHistograms::GetIndexFromPixelIndex(int i, int j, int k)
 {
@@ -160,6 +204,17 @@ void GateImageOfHistograms::ComputeTotalOfCountsImageDataDouble(std::vector<doub
 {
   output.resize(nbOfValues);
   std::fill(output.begin(), output.end(), 0.0);
+  if (mIsSparse) {
+    for(unsigned int b=0; b<mSparseBlocks.size(); b++) {
+      if (mSparseBlocks[b].empty()) continue;
+      long first = b*mSparseBlockSize;
+      long n = std::min(mSparseBlockSize, nbOfValues - first);
+      for(long i=0; i<n; i++)
+        for(unsigned int l=0; l<nbOfBins; l++)
+          output[first+i] += mSparseBlocks[b][i*nbOfBins+l];
+    }
+    return;
+  }
   unsigned long index_image = 0;
   unsigned long index_data = 0;
   for(unsigned int k=0; k<sizeZ; k++) {
@@ -193,11 +248,10 @@ void GateImageOfHistograms::AddValueFloat(const int & index, TH1D * h, const dou
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::AddValueDouble(const int & index, TH1D * h, const double scale=1.0)
 {
-  int index_data = index*nbOfBins;
+  double * histo = GetHistoDoublePointer(index);
   for(unsigned int i=1; i<=nbOfBins; i++) {
     // +1 because TH1D start at 1, and end at index=size
-    dataDouble[index_data] += h->GetBinContent(i)*scale;
-    index_data++;
+    histo[i-1] += h->GetBinContent(i)*scale;
   }
 }
 //-----------------------------------------------------------------------------
@@ -206,6 +260,10 @@ void GateImageOfHistograms::AddValueDouble(const int & index, TH1D * h, const do
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::AddValueDouble(const int & index, const int &bin, const double value=1.0)
 {
+  if (mIsSparse) {
+    GetHistoDoublePointer(index)[bin] += value;
+    return;
+  }
   long index_data = index*nbOfBins+bin;
   dataDouble[index_data] += value;
 }
@@ -214,6 +272,12 @@ void GateImageOfHistograms::AddValueDouble(const int & index, const int &bin, co
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::SetValueDouble(const int & index, const int &bin, const double value=1.0)
 {
+  if (mIsSparse) {
+    // no need to allocate a block to store a zero
+    if (value == 0.0 && mSparseBlocks[index / mSparseBlockSize].empty()) return;
+    GetHistoDoublePointer(index)[bin] = value;
+    return;
+  }
   long index_data = index*nbOfBins+bin;
   dataDouble[index_data] = value;
 }
@@ -222,6 +286,11 @@ void GateImageOfHistograms::SetValueDouble(const int & index, const int &bin, co
 //-----------------------------------------------------------------------------
 double GateImageOfHistograms::GetValueDouble(const int & index, const int &bin)
 {
+  if (mIsSparse) {
+    const std::vector<double> & block = mSparseBlocks[index / mSparseBlockSize];
+    if (block.empty()) return 0.0;
+    return block[(index % mSparseBlockSize) * nbOfBins + bin];
+  }
   long index_data = index*nbOfBins+bin;
   return dataDouble[index_data];
 }
@@ -288,6 +357,10 @@ void GateImageOfHistograms::Read(G4String filename)
   origin -= transformMatrix*(voxelSize/2.0);
   UpdateSizesFromResolutionAndVoxelSize();
 
+  // Data are read in a full vector
+  mIsSparse = false;
+  mSparseBlocks.clear();
+
   // Set data in the correct order
   int len = resolution[0] * resolution[1] * resolution[2] * nbOfBins;
   std::vector<float> input;
@@ -377,6 +450,15 @@ void GateImageOfHistograms::Write(G4String filename, const G4String & )
   matrix[15] = 1.0;
   m_MetaImage.TransformMatrix(matrix);
 
+  // Sparse: header only, then raw data written bin by bin
+  if (mIsSparse) {
+    double total = ComputeSum();
+    m_MetaImage.AddUserField("TotalSum", MET_FLOAT_ARRAY, 1, &total);
+    m_MetaImage.Write(headerName.c_str(), rawName.c_str(), false);
+    WriteSparseRawData(rawName);
+    return;
+  }
+
   // Before writing convert from double to float
   double total = 0.0;
   if (mDataTypeName == "double") {
@@ -411,12 +493,48 @@ void GateImageOfHistograms::Write(G4String filename, const G4String & )
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageOfHistograms::WriteSparseRawData(std::string rawName)
+{
+  std::ofstream os(rawName.c_str(), std::ios::out | std::ios::binary);
+  if (!os) {
+    GateError("Cannot open " << rawName << " to write the ImageOfHistogram.");
+  }
+
+  // On disk, the order is XYZH: one 3D float image per bin, the
+  // unallocated blocks give zeros.
+  std::vector<float> image(nbOfValues);
+  for(unsigned int l=0; l<nbOfBins; l++) {
+    for(unsigned int b=0; b<mSparseBlocks.size(); b++) {
+      long first = b*mSparseBlockSize;
+      long n = std::min(mSparseBlockSize, nbOfValues - first);
+      const std::vector<double> & block = mSparseBlocks[b];
+      if (block.empty()) std::fill(image.begin()+first, image.begin()+first+n, 0.0f);
+      else {
+        for(long i=0; i<n; i++)
+          image[first+i] = (float)block[i*nbOfBins+l];
+      }
+    }
+    os.write((const char*)&image[0], image.size()*sizeof(float));
+  }
+  if (!os) {
+    GateError("Error while writing the ImageOfHistogram in " << rawName);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 // This scales the Image, and it converts an Int Image into a Float Image.
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::Scale(double f)
 {
-  if (mDataTypeName == "double") {
+  if (mIsSparse) {
+    for(unsigned int b=0; b<mSparseBlocks.size(); b++)
+      for(unsigned int i=0; i<mSparseBlocks[b].size(); i++)
+        mSparseBlocks[b][i] = f * mSparseBlocks[b][i];
+  }
+  else if (mDataTypeName == "double") {
     for(unsigned int i=0; i<dataDouble.size(); i++)
       dataDouble[i] = f * dataDouble[i];
   } else if (mDataTypeName == "int") { //cant scale and int
@@ -440,7 +558,12 @@ void GateImageOfHistograms::Scale(double f)
 double GateImageOfHistograms::ComputeSum()
 {
   double sum = 0.0;
-  if (mDataTypeName == "double") {
+  if (mIsSparse) {
+    for(unsigned int b=0; b<mSparseBlocks.size(); b++)
+      for(unsigned int i=0; i<mSparseBlocks[b].size(); i++)
+        sum += mSparseBlocks[b][i];
+  }
+  else if (mDataTypeName == "double") {
     for(unsigned int i=0; i<dataDouble.size(); i++)
       sum += dataDouble[i];
   }
@@ -32,6 +32,7 @@ GateMHDImage::GateMHDImage()
         size.resize(3);
         spacing.resize(3);
         origin.resize(3);
+        mIsCompressionEnabled = false;
     }
 //-----------------------------------------------------------------------------
 
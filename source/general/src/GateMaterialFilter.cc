@@ -15,6 +15,10 @@ See GATE/LICENSE.txt for further details
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include "G4Material.hh"
+
+#include <algorithm>
+
 
 //---------------------------------------------------------------------------
 GateMaterialFilter::GateMaterialFilter(G4String name)
@@ -22,7 +26,6 @@ GateMaterialFilter::GateMaterialFilter(G4String name)
 {
   theMdef.clear();
   pMatMessenger = new GateMaterialFilterMessenger(this);
-  nFilteredParticles = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -37,12 +40,10 @@ GateMaterialFilter::~GateMaterialFilter()
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Step* aStep) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){
-      if ( theMdef[i] == aStep->GetPreStepPoint()->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
+  if (IsAcceptedMaterial(aStep->GetPreStepPoint()->GetMaterial())) {
+    nFilteredParticles++;
+    return true;
+  }
   return false;
 }
 //---------------------------------------------------------------------------
@@ -50,12 +51,10 @@ G4bool GateMaterialFilter::Accept(const G4Step* aStep)
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Track* aTrack) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){ 	
-      if ( theMdef[i] == aTrack->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
+  if (IsAcceptedMaterial(aTrack->GetMaterial())) {
+    nFilteredParticles++;
+    return true;
+  }
   return false;
 }
 //---------------------------------------------------------------------------
@@ -67,6 +66,43 @@ void GateMaterialFilter::Add(const G4String& materialName)
     if ( theMdef[i] == materialName ) return;
   }
   theMdef.push_back(materialName);
+  mIsAcceptedMaterial.clear();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+void GateMaterialFilter::ResolveMaterials()
+{
+  // Names are compared once per material, materials created later
+  // extend the table at their first step.
+  const G4MaterialTable * table = G4Material::GetMaterialTable();
+  mIsAcceptedMaterial.assign(table->size(), false);
+  for ( size_t m = 0; m < table->size(); m++ ) {
+    for ( size_t i = 0; i < theMdef.size(); i++ ) {
+      if ( theMdef[i] == (*table)[m]->GetName() ) {
+        mIsAcceptedMaterial[m] = true;
+        break;
+      }
+    }
+  }
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+void GateMaterialFilter::Initialize()
+{
+  ResolveMaterials();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4String GateMaterialFilter::GetFilterKey()
+{
+  std::vector<G4String> m(theMdef);
+  std::sort(m.begin(), m.end());
+  G4String key = "materialFilter";
+  for ( size_t i = 0; i < m.size(); i++ ) key += " " + m[i];
+  return key;
 }
 //---------------------------------------------------------------------------
 
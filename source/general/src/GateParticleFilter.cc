@@ -12,13 +12,14 @@ See GATE/LICENSE.txt for further details
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include <algorithm>
+
 //---------------------------------------------------------------------------
 GateParticleFilter::GateParticleFilter(G4String name)
   : GateVFilter(name)
 {
   thePdef.clear();
   pPartMessenger = new GateParticleFilterMessenger(this);
-  nFilteredParticles = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -42,16 +43,9 @@ G4bool GateParticleFilter::Accept(const G4Track *aTrack)
 
   if (thePdef.empty()) {
     accept = true; //if no particles given, setting to true will disable filtering on particle
-  } else {
-    for ( size_t i = 0; i < thePdef.size(); i++) {
-      if ( thePdef[i] == aTrack->GetDefinition()->GetParticleName() ||
-           (aTrack->GetDefinition()->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") )
-      {
-        nFilteredParticles++;
-        accept = true;
-        break;
-      }
-    }
+  } else if (IsAcceptedParticle(aTrack->GetDefinition())) {
+    nFilteredParticles++;
+    accept = true;
   }
 
   if (theParentPdef.empty()) {
@@ -93,6 +87,54 @@ G4bool GateParticleFilter::Accept(const G4Track *aTrack)
   return accept && acceptparent && acceptdirectparent;
 }
 
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::IsAcceptedParticle(const G4ParticleDefinition *particle)
+{
+  // The names are compared once per particle definition (ions are
+  // created during the run, so they cannot be all resolved before).
+  std::map<const G4ParticleDefinition*, G4bool>::const_iterator it = mIsAcceptedParticle.find(particle);
+  if (it != mIsAcceptedParticle.end()) return it->second;
+
+  G4bool accept = false;
+  for ( size_t i = 0; i < thePdef.size(); i++) {
+    if ( thePdef[i] == particle->GetParticleName() ||
+         (particle->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") )
+    {
+      accept = true;
+      break;
+    }
+  }
+  mIsAcceptedParticle[particle] = accept;
+  return accept;
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+void GateParticleFilter::Initialize()
+{
+  mIsAcceptedParticle.clear();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4String GateParticleFilter::GetFilterKey()
+{
+  std::vector<G4String> p(thePdef);
+  std::vector<G4String> pp(theParentPdef);
+  std::vector<G4String> dp(theDirectParentPdef);
+  std::sort(p.begin(), p.end());
+  std::sort(pp.begin(), pp.end());
+  std::sort(dp.begin(), dp.end());
+  G4String key = "particleFilter";
+  for ( size_t i = 0; i < p.size(); i++) key += " " + p[i];
+  key += " /parent";
+  for ( size_t i = 0; i < pp.size(); i++) key += " " + pp[i];
+  key += " /directParent";
+  for ( size_t i = 0; i < dp.size(); i++) key += " " + dp[i];
+  return key;
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 void GateParticleFilter::Add(const G4String &particleName)
 {
@@ -100,6 +142,7 @@ void GateParticleFilter::Add(const G4String &particleName)
     if ( thePdef[i] == particleName ) return;
   }
   thePdef.push_back(particleName);
+  mIsAcceptedParticle.clear();
 }
 //---------------------------------------------------------------------------
 
@@ -36,6 +36,7 @@ GateRandomEngine::GateRandomEngine()
   theVerbosity = 0;
   theSeed="default";
   theSeedFile=" ";
+  theSeedOffset=0;
   // Create the messenger
   theMessenger = new GateRandomEngineMessenger(this);
 
@@ -137,6 +138,14 @@ void GateRandomEngine::Initialize() {
     isSeed=true;
   }
 
+  // worker processes (see GateApplicationMgr) must not share the same sequence
+  if (theSeedOffset!=0 && theSeed!="auto") {
+    if(theSeedFile !=" ") G4Exception( "GateRandomEngine::Initialize", "Initialize", FatalException, "ERROR !! => A status file cannot be used with several workers, please use a seed!");
+    if (!isSeed) seed = theRandomEngine->getSeed();
+    seed += theSeedOffset;
+    isSeed=true;
+  }
+
   if (isSeed) {
     if(theSeedFile !=" " && theSeed !="default") G4Exception( "GateRandomEngine::Initialize", "Initialize", FatalException, "ERROR !! => Please: choose between a status file and a seed (defined by a number) or auto computation of initial seed!");
 
@@ -14,7 +14,7 @@ See GATE/LICENSE.txt for further details
 GateVFilter::GateVFilter(G4String name)
   :GateNamedObject(name)
 {
- 
+  nFilteredParticles = 0;
 }
 //-------------------------------------------------------------
 
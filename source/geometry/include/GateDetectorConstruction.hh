@@ -60,6 +60,8 @@ public:
   // Material DB
   /// Mandatory : Adds a Material Database to use (filename, callback for Messenger)
   void AddFileToMaterialDatabase(const G4String& f);
+  /// Optional : Directory where the indexes of the Material Database files are cached
+  void SetMaterialDatabaseCacheDirectory(const G4String& dir);
 
   static GateDetectorConstruction* GetGateDetectorConstruction()
   {
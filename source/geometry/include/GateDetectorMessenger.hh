@@ -37,6 +37,7 @@ class GateDetectorMessenger: public G4UImessenger
     G4UIdirectory*             pGateGeometryDir;
     
     G4UIcmdWithAString*        pMaterialDatabaseFilenameCmd;
+    G4UIcmdWithAString*        pMaterialDatabaseCacheDirectoryCmd;
     G4UIcmdWith3VectorAndUnit* pMagFieldCmd;
     G4UIcmdWithoutParameter*   pListCreatorsCmd;
     G4UIcmdWithAString*        IoniCmd;
@@ -139,6 +139,8 @@ public:
   //====================================================================
   /// Sets the name of the distance map file
   void SetDistanceMapFilename(const G4String& name) { mDistanceMapFilename = name; }
+  /// Sets the directory of the distance maps computed when no file is given
+  void SetDistanceMapCacheDirectory(const G4String& name) { mDistanceMapCacheDirectory = name; }
   //====================================================================
 
 
@@ -207,6 +209,10 @@ private:
   //====================================================================
   /// The name of the distance map file
   G4String mDistanceMapFilename;
+  /// Where the computed distance maps are kept, named after a hash of
+  /// the label image
+  G4String mDistanceMapCacheDirectory;
+  G4String GetDistanceMapCacheFilename();
   //====================================================================
 };
 // EO class GateImageRegionalizedVolume
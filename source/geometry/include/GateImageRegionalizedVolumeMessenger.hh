@@ -36,6 +36,7 @@ public:
 private:
   GateImageRegionalizedVolume* pVolume;   
   G4UIcmdWithAString* pDistanceMapNameCmd;
+  G4UIcmdWithAString* pDistanceMapCacheDirectoryCmd;
 };
 //====================================================================
 
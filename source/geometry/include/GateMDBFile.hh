@@ -12,12 +12,12 @@ See GATE/LICENSE.txt for further details
 #define GateMDBFile_hh
 
 #include "globals.hh"
-#include <fstream>
 
 #include "G4Material.hh"
 
 #include "GateMDBCreators.hh"
 #include "GateMDBFieldReader.hh"
+#include "GateMDBIndex.hh"
 
 class GateMaterialDatabase;
 
@@ -49,17 +49,18 @@ protected:
   void     ReadMaterialOption(const G4String& materialName,const G4String& field,GateMaterialCreator* creator);
 
   void     FindSection(const G4String& name);
-  G4bool   LookForText(const G4String& text);
   G4String ReadItem(const G4String& sectionName,const G4String& itemName);
   G4int    ReadNonEmptyLine(G4String& lineBuffer);
-  G4int    ReadLine(G4String& lineBuffer);
 
 private:
   // Stores the database which instanciated this (used by creators)
   GateMaterialDatabase* mDatabase;
   G4String fileName;
   G4String filePath;
-  std::ifstream dbStream;
+  // Content of the file, shared with the other GateMDBFile reading it
+  const GateMDBIndex* mIndex;
+  // Next line to read
+  G4int mCursor;
 
 public:
   static char theStarterSeparator;
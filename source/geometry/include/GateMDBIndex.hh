@@ -0,0 +1,71 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+/*!
+  \class GateMDBIndex
+  \brief In-memory content of a material database file, used by GateMDBFile
+
+  The file is read once: the lines of its sections are kept (cleaned up,
+  without the empty lines) with the position of each section and of each
+  item of the sections, so that an item is found without reading the file
+  again. The index of a file is shared by all the GateMDBFile reading it,
+  and can be stored in a binary cache directory to be reused by the next
+  runs. Both are checked against the size, modification time (with the
+  nanoseconds) and inode of the file, so that the file itself is only
+  read when it has changed.
+*/
+
+#ifndef GateMDBIndex_hh
+#define GateMDBIndex_hh
+
+#include "globals.hh"
+#include <map>
+#include <vector>
+
+class GateMDBIndex
+{
+public:
+  /// Index of the file, read from the cache directory ("" = no cache),
+  /// from the memory if already read, or from the file itself
+  static const GateMDBIndex* GetIndex(const G4String& filePath, const G4String& cacheDirectory);
+
+  /// Line following the section header "[name]", -1 if no such section
+  G4int FindSection(const G4String& name) const;
+  /// Line of the item "itemName:" of a section, -1 if not found
+  G4int FindItem(const G4String& sectionName, const G4String& itemName) const;
+
+  G4int GetNumberOfLines() const { return mLines.size(); }
+  /// Line without leading/trailing blanks
+  const G4String& GetLine(G4int i) const { return mLines[i]; }
+
+protected:
+  /// What identifies a version of the file, from stat()
+  struct FileStatus {
+    long long size, time, timeNanoseconds, inode;
+    bool operator==(const FileStatus& s) const {
+      return size == s.size && time == s.time && timeNanoseconds == s.timeNanoseconds && inode == s.inode;
+    }
+  };
+  static bool GetFileStatus(const G4String& filePath, FileStatus& status);
+
+  GateMDBIndex() {}
+  void ReadDatabase(const std::string& content);
+  bool ReadCache(const G4String& cacheName);
+  void WriteCache(const G4String& cacheName) const;
+  static G4String GetCacheName(const G4String& filePath, const G4String& cacheDirectory);
+
+  typedef std::map<G4String, G4int> ItemMap;
+
+  FileStatus mFileStatus;
+  std::vector<G4String> mLines;           // non-empty lines of the sections
+  ItemMap mSections;                      // "[name]" -> line after the header
+  std::map<G4String, ItemMap> mItems;     // "[name]" -> item -> line
+};
+
+#endif
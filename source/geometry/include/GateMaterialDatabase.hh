@@ -35,6 +35,10 @@ public:
 
   void AddMDBFile(const G4String& filename);
 
+  //! Directory where the indexes of the database files are cached ("" = no cache)
+  void SetCacheDirectory(const G4String& dir) { mCacheDirectory = dir; }
+  const G4String& GetCacheDirectory() const { return mCacheDirectory; }
+
   G4Element*  GetElement(const G4String& name);
   G4Material* GetMaterial(const G4String& materialName);
 
@@ -50,6 +54,7 @@ protected:
 private:
   std::vector<GateMDBFile*> mMDBFile;
   G4MaterialPropertiesTable * water_MPT;
+  G4String mCacheDirectory;
 };
 
 #endif
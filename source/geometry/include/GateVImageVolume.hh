@@ -196,6 +196,9 @@ protected:
   //-----------------------------------------------------------------------------
   /// Build distance map
   void BuildDistanceTransfo();
+  /// Computes the distance (mm) of each voxel to the nearest voxel at the
+  /// interface between two labels (exact euclidean distance transform)
+  void ComputeDistanceMap(GateImage & dmap);
   G4String mDistanceTransfoOutput;
   bool mBuildDistanceTransfo;
   //-----------------------------------------------------------------------------
@@ -168,6 +168,13 @@ void GateDetectorConstruction::AddFileToMaterialDatabase(const G4String& f)
 }
 //---------------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------------
+void GateDetectorConstruction::SetMaterialDatabaseCacheDirectory(const G4String& dir)
+{
+  mMaterialDatabase.SetCacheDirectory(dir);
+}
+//---------------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------------
 void GateDetectorConstruction::SetMagField(G4ThreeVector fieldValue)
 {
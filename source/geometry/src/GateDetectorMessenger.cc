@@ -89,6 +89,11 @@ GateDetectorMessenger::GateDetectorMessenger(GateDetectorConstruction* GateDet)
   pMaterialDatabaseFilenameCmd = new G4UIcmdWithAString(cmd, this);
   pMaterialDatabaseFilenameCmd->SetGuidance("Sets the filename of the material database to use");
   pMaterialDatabaseFilenameCmd->SetParameterName("Material database filename", true);
+
+  cmd = "/gate/geometry/setMaterialDatabaseCacheDirectory";
+  pMaterialDatabaseCacheDirectoryCmd = new G4UIcmdWithAString(cmd, this);
+  pMaterialDatabaseCacheDirectoryCmd->SetGuidance("Sets the directory where the index of the material database files is cached, to be reused by the next runs (must be set before setMaterialDatabase)");
+  pMaterialDatabaseCacheDirectoryCmd->SetParameterName("Directory", false);
   
   pListCreatorsCmd = new G4UIcmdWithoutParameter("/gate/geometry/listVolumes",this);
   pListCreatorsCmd->SetGuidance("List all the volume creators in the GATE geometry");
@@ -109,6 +114,7 @@ GateDetectorMessenger::GateDetectorMessenger(GateDetectorConstruction* GateDet)
 GateDetectorMessenger::~GateDetectorMessenger()
 {
   delete pMaterialDatabaseFilenameCmd;
+  delete pMaterialDatabaseCacheDirectoryCmd;
   delete pMagFieldCmd;
   delete pListCreatorsCmd;
   delete IoniCmd;
@@ -126,6 +132,8 @@ void GateDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
   if (command == pMaterialDatabaseFilenameCmd ) {
       pDetectorConstruction->AddFileToMaterialDatabase(newValue);
   }
+  else if( command == pMaterialDatabaseCacheDirectoryCmd )
+    { pDetectorConstruction->SetMaterialDatabaseCacheDirectory(newValue); }
   else if( command == pMagFieldCmd )
     { pDetectorConstruction->SetMagField(pMagFieldCmd->GetNew3VectorValue(newValue));}
  
@@ -25,6 +25,11 @@
 #include "GatePhantomSD.hh"
 #include "GateDetectorConstruction.hh"
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
 //-----------------------------------------------------------------------------
 /// Constructor with :
 /// the path to the volume to create (for commands)
@@ -42,6 +47,7 @@ GateImageRegionalizedVolume::GateImageRegionalizedVolume(const G4String& name,
   // Retrieves surface tolerance from G4GeometryTolerance instance
   kCarTolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
   mDistanceMapFilename = "none";
+  mDistanceMapCacheDirectory = ".";
   pDistanceMap = 0;
   GateMessageDec("Volume",5,"GateImageRegionalizedVolume() - end\n");
 }
@@ -95,7 +101,10 @@ G4LogicalVolume* GateImageRegionalizedVolume::ConstructOwnSolidAndLogicalVolume(
   }
 
   // If needed, compute the distance map
-  if (mBuildDistanceTransfo) BuildDistanceTransfo();
+  if (mBuildDistanceTransfo) {
+    BuildDistanceTransfo();
+    if (mDistanceMapFilename == "none") mDistanceMapFilename = mDistanceTransfoOutput;
+  }
 
   //  EnableSmartVoxelOptimisation(false);
   G4String boxname = GetObjectName() + "_solid";
@@ -185,34 +194,70 @@ void GateImageRegionalizedVolume::LoadDistanceMap()
 {
   GateMessageInc("Volume",3,"GateImageRegionalizedVolume::LoadDistanceMap("<<mDistanceMapFilename<<") - begin\n");
 
-  if (mDistanceMapFilename == "none") {
-    GateError("ImageRegionalized Volume <" << GetObjectName()
-	      << "> : No distance map provided, the navigation could not be optimized."
-	      << Gateendl
-	      << "Please use /gate/" << GetObjectName() << "/geometry/buildAndDumpDistanceTransfo dmap.mhd"
-	      << Gateendl
-	      << "to generate the dmap and then, /gate/patient/geometry/distanceMap dmap.mhd to use it."
-	      << Gateendl);
-    pDistanceMap = new DistanceMapType;
-    pDistanceMap->SetResolutionAndHalfSize(GetImage()->GetResolution(), GetImage()->GetHalfSize());
-    pDistanceMap->Allocate();
-    pDistanceMap->Fill(0.0);
-    pDistanceMap->PrintInfo();
-    return;
-  }
+  // Without file, the map is kept in the cache directory
+  G4String filename = mDistanceMapFilename;
+  if (filename == "none") filename = GetDistanceMapCacheFilename();
+
   if (pDistanceMap) delete pDistanceMap;
   pDistanceMap = new DistanceMapType;
-  pDistanceMap->Read(mDistanceMapFilename);
-
-  // Check size
-  if (!pDistanceMap->HasSameResolutionThan(GetImage())) {
-    GateError("Error distance map image does not have the same size than the image.\n");
+  std::ifstream is(filename.c_str());
+  if (is) {
+    is.close();
+    pDistanceMap->Read(filename);
+
+    // Check size
+    if (!pDistanceMap->HasSameResolutionThan(GetImage())) {
+      GateError("Error distance map image does not have the same size than the image.\n");
+    }
+  }
+  else {
+    GateMessage("Geometry", 1, "Building the distance map of the image '" << mImageFilename
+                << "' in the file '" << filename << "'." << Gateendl);
+    ComputeDistanceMap(*pDistanceMap);
+    if (filename == mDistanceMapFilename) pDistanceMap->Write(filename);
+    else {
+      // The cache directory may be shared by concurrent jobs: the map is
+      // written under a name unique to this process, then renamed, so that
+      // another job never reads a partial file
+      std::ostringstream tmpName;
+      tmpName << filename << "." << getpid() << ".tmp.mha";
+      pDistanceMap->Write(tmpName.str());
+      if (rename(tmpName.str().c_str(), filename.c_str()) != 0) {
+        GateWarning("Could not store the distance map in the cache file '" << filename << "'\n");
+        remove(tmpName.str().c_str());
+      }
+    }
   }
 
   GateMessageDec("Volume",3,"GateImageRegionalizedVolume::LoadDistanceMap("<<mDistanceMapFilename<<") - end\n");
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+/// Name of the distance map of the current label image in the cache
+/// directory (FNV-1a hash of the labels and of the voxel size). It is a
+/// .mha file (header and data together) so that it is stored in one rename.
+/// The version in the name changes whenever the map values do (v2: the
+/// voxels on the image border are at distance 0)
+G4String GateImageRegionalizedVolume::GetDistanceMapCacheFilename()
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  const G4ThreeVector & voxelSize = GetImage()->GetVoxelSize();
+  const double header[6] = { GetImage()->GetResolution().x(), GetImage()->GetResolution().y(),
+                             GetImage()->GetResolution().z(), voxelSize.x(), voxelSize.y(), voxelSize.z() };
+  const unsigned char * p = (const unsigned char*)header;
+  for(unsigned int i=0; i<sizeof(header); i++) hash = (hash ^ p[i]) * 1099511628211ULL;
+  for(ImageType::const_iterator it = GetImage()->begin(); it != GetImage()->end(); ++it) {
+    float label = *it;
+    p = (const unsigned char*)&label;
+    for(unsigned int i=0; i<sizeof(label); i++) hash = (hash ^ p[i]) * 1099511628211ULL;
+  }
+  std::ostringstream name;
+  name << mDistanceMapCacheDirectory << "/dmap_v2_" << std::hex << hash << ".mha";
+  return name.str();
+}
+//-----------------------------------------------------------------------------
+
 //------------------------------------------------
 // Methods used by SubVolumeSolids
 //------------------------------------------------
@@ -26,7 +26,11 @@ GateImageRegionalizedVolumeMessenger::GateImageRegionalizedVolumeMessenger(GateI
 
   G4String n = GetDirectoryName() +"geometry/distanceMap";
   pDistanceMapNameCmd = new G4UIcmdWithAString(n,this);
-  pDistanceMapNameCmd->SetGuidance("Sets the name of the distance map file");
+  pDistanceMapNameCmd->SetGuidance("Sets the name of the distance map file (computed if it does not exist)");
+
+  n = GetDirectoryName() +"geometry/distanceMapCacheDirectory";
+  pDistanceMapCacheDirectoryCmd = new G4UIcmdWithAString(n,this);
+  pDistanceMapCacheDirectoryCmd->SetGuidance("Sets the directory where the distance maps are kept when no file is given (default: current directory)");
 }
 //====================================================================
 
@@ -36,6 +40,7 @@ GateImageRegionalizedVolumeMessenger::~GateImageRegionalizedVolumeMessenger()
 {
   GateMessage("Volume",5,"~GateImageRegionalizedVolumeMessenger()\n");
   delete  pDistanceMapNameCmd;
+  delete  pDistanceMapCacheDirectoryCmd;
 }
 //====================================================================
 
@@ -51,6 +56,9 @@ void GateImageRegionalizedVolumeMessenger::SetNewValue(G4UIcommand* command,
   if (command == pDistanceMapNameCmd) {
     pVolume->SetDistanceMapFilename(newValue);
   }
+  else if (command == pDistanceMapCacheDirectoryCmd) {
+    pVolume->SetDistanceMapCacheDirectory(newValue);
+  }
   else {
     GateVImageVolumeMessenger::SetNewValue(command,newValue);
   }
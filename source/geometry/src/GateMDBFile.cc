@@ -28,12 +28,11 @@ char GateMDBFile::theStarterSeparator = ':';
 char GateMDBFile::theFieldSeparator   = ';';
 G4String GateMDBFile::theReadItemErrorMsg = "Item not found";
 
-#define GATE_BUFFERSIZE 256
-
 //-----------------------------------------------------------------------------
 GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
   :mDatabase(db), 
-   fileName(itsFileName),filePath("")
+   fileName(itsFileName),filePath(""),
+   mIndex(0),mCursor(0)
 {
   GateMessage("Materials", 1, 
 	      "GateMDBFile: I start looking for the material database file <"
@@ -44,9 +43,9 @@ GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
 		G4String msg = "Could not find material database file '" + fileName + "'";
     G4Exception( "GateMDBFile::GateMDBFile", "GateMDBFile", FatalException, msg );
 	}
-  dbStream.open(filePath);
+  mIndex = GateMDBIndex::GetIndex(filePath,db->GetCacheDirectory());
 
-  if (dbStream) {
+  if (mIndex) {
     GateMessage("Materials", 2, 
 		"OK, I opened the material database <" 
 		<< filePath << ">\n");
@@ -63,7 +62,6 @@ GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
 //-----------------------------------------------------------------------------
 GateMDBFile::~GateMDBFile()
 {
-  dbStream.close();
 }
 //-----------------------------------------------------------------------------
 
@@ -402,50 +400,11 @@ void GateMDBFile::ReadMaterialOption(const G4String& materialName,const G4String
 
 
 //-----------------------------------------------------------------------------
-// Go through the whole file until we find a specific section
-// The section name we'll look for is "[name]"
+// Go to a specific section of the file (the line following "[name]")
 void GateMDBFile::FindSection(const G4String& name)
 {
-  if (LookForText("[" + name + "]")==false) {
-    /*   G4Exception("\n!!! GateMDBFile["+fileName+"]::FindSection:   \n"
-	 "\tI could not find any section [" + name + "] in the material database file. \n"
-	 "\tYou should check the database file.\n"
-	 "\tComputation aborted!!!\n");
-    */ }
-
-}
-//-----------------------------------------------------------------------------
-
-
-//-----------------------------------------------------------------------------
-// Go through the whole DB file from the start
-// until we find a specific text (at beginning of line)
-// Once the text is found, we're positioned just below the text's line
-G4bool GateMDBFile::LookForText(const G4String& text)
-{
-  G4int len = text.length() ;
-  G4String lineBuf;
-
-  if (dbStream.fail()) {
-    dbStream.close();
-    dbStream.clear();  
-    dbStream.open(fileName);
-    if (!dbStream) {
-      std::cerr << "ERROR Could not reopen " << fileName << Gateendl;
-      exit(0);
-    }
-  }
-
-  dbStream.seekg(0,std::ios::beg);  // Rewind!
-  
-
-  while (!dbStream.eof()) {
-    if (ReadLine(lineBuf)) return false; // Error or EOF
-   
-    if ( strncmp(text.c_str(),lineBuf.c_str(),len)==0 )
-      return true;// Line starts with the text we're looking for
-  }
-  return false;
+  G4int line = mIndex->FindSection(name);
+  mCursor = (line < 0 ? mIndex->GetNumberOfLines() : line);
 }
 //-----------------------------------------------------------------------------
 
@@ -454,40 +413,13 @@ G4bool GateMDBFile::LookForText(const G4String& text)
 //-----------------------------------------------------------------------------
 // Goes into a specific section of the DB file, then looks
 // for a specific item.
-// If the item is "Item", the routine will look through the
-// sectoin until it finds a line starting with "Item:"
+// If the item is "Item", the item is the first line of the section
+// starting with "Item:" (found in the index of the file)
 G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemName)
 {
-
-  
-  // Go in the relevant section of the DB file
-  FindSection(sectionName);
-  
-  // Prepare the lookup variables and buffer
-  G4bool flagElementFound=false;
-  G4String text = itemName + ":" ;
-  G4int len = text.length() ;
-  G4String lineBuf;
-  
-   
-  do {	// Read lines until we find the item or reach the OEF or the next section
-    if (ReadNonEmptyLine(lineBuf)) 
-      break;   // Reached EOF or read-error
-    if (lineBuf.at(0)=='[') 
-      break; // Reached next section
-    //if ( text.compare(lineBuf,0,len) == 0 ) {
-    if ( strncmp(text.c_str(),lineBuf.c_str(),len) == 0 ) {
-      // We found the item we were looking for  
-      flagElementFound = true;
-      break;
-    }
-  } while (1);
-
-  if (!flagElementFound) {  // We reached the EOF or the next section
-    // GateMessage("Materials", 3, "GateMDBFile<" << fileName
-    // 		<< ">::ReadItem: I could NOT find the item '"
-    // 		<< itemName << "' in section ["
-    // 		<< sectionName << "] of the material database. \n\n");
+  G4int line = mIndex->FindItem(sectionName,itemName);
+  if (line < 0) {
+    FindSection(sectionName);
     return theReadItemErrorMsg;
   }
 
@@ -496,8 +428,11 @@ G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemN
 	      << itemName << "' in section ["
 	      << sectionName << "] of the material database. \n\n");
 
+  // The next lines (components) are read from the item
+  mCursor = line + 1;
+
   // We found the item: we return the text after the colon
-  return lineBuf.substr(len);
+  return mIndex->GetLine(line).substr(itemName.length() + 1);
 }
 //-----------------------------------------------------------------------------
 
@@ -508,32 +443,11 @@ G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemN
 // Returns 0 if everything went OK, 1 if there was any failure (including EOF) 
 G4int GateMDBFile::ReadNonEmptyLine(G4String& lineBuffer)
 {
-  do {
-    if (ReadLine(lineBuffer))  
-      return 1;
-    GateTokenizer::CleanUpString(lineBuffer);
-  } while (lineBuffer=="");
-
-  return 0;
-}
-//-----------------------------------------------------------------------------
-
-
-
-//-----------------------------------------------------------------------------
-// Reads the next line from the DB file, and stores it
-// in the string
-// Returns 0 if everything went OK, 1 if there was any failure (including EOF) 
-G4int GateMDBFile::ReadLine(G4String& lineBuffer)
-{
-  static char buffer[GATE_BUFFERSIZE];
-
-  dbStream.getline(buffer,GATE_BUFFERSIZE);
-  if (dbStream.eof())  
-    return 1;
-  lineBuffer = G4String(buffer);
-  return 0;
+  G4int nLines = mIndex->GetNumberOfLines();
+  while (mCursor < nLines) {
+    lineBuffer = mIndex->GetLine(mCursor++);
+    if (lineBuffer != "") return 0;
+  }
+  return 1;
 }
 //-----------------------------------------------------------------------------
-
-
@@ -0,0 +1,287 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+
+/*!
+
+  \file GateMDBIndex.cc
+
+  \brief Class GateMDBIndex
+*/
+
+#include "GateMDBIndex.hh"
+
+#include "GateMessageManager.hh"
+#include "GateTokenizer.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------
+template<class T>
+static void WriteValue(std::ostream & os, const T & value)
+{
+  os.write((const char*)&value, sizeof(T));
+}
+
+template<class T>
+static bool ReadValue(std::istream & is, T & value)
+{
+  is.read((char*)&value, sizeof(T));
+  return is.good();
+}
+
+static void WriteString(std::ostream & os, const G4String & s)
+{
+  G4int n = s.length();
+  WriteValue(os, n);
+  os.write(s.data(), n);
+}
+
+static unsigned long long HashOf(const std::string & s)
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  for(unsigned int i=0; i<s.length(); i++)
+    hash = (hash ^ (unsigned char)s[i]) * 1099511628211ULL;
+  return hash;
+}
+
+static bool ReadString(std::istream & is, G4String & s)
+{
+  G4int n;
+  if (!ReadValue(is, n) || n < 0) return false;
+  std::vector<char> buffer(n+1);
+  is.read(&buffer[0], n);
+  s = G4String(&buffer[0], n);
+  return is.good();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateMDBIndex::GetFileStatus(const G4String& filePath, FileStatus& status)
+{
+  struct stat st;
+  if (stat(filePath.c_str(), &st) != 0) return false;
+  status.size = st.st_size;
+  status.time = st.st_mtime;
+#ifdef __APPLE__
+  status.timeNanoseconds = st.st_mtimespec.tv_nsec;
+#else
+  status.timeNanoseconds = st.st_mtim.tv_nsec;
+#endif
+  status.inode = st.st_ino;
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// The files already read, by path
+const GateMDBIndex* GateMDBIndex::GetIndex(const G4String& filePath, const G4String& cacheDirectory)
+{
+  static std::map<G4String, GateMDBIndex*> theIndexes;
+  static std::vector<GateMDBIndex*> theRetiredIndexes;
+
+  // The modification time is compared with its nanoseconds (a HU database
+  // regenerated within the same second is seen), and the inode changes
+  // when a file is replaced by a rename
+  FileStatus status;
+  if (!GetFileStatus(filePath, status)) return 0;
+
+  // Already read, and not modified since
+  GateMDBIndex* & index = theIndexes[filePath];
+  if (index && index->mFileStatus == status) return index;
+
+  // The index of the former version of the file is kept: the GateMDBFile
+  // created before still read their materials from it
+  if (index) theRetiredIndexes.push_back(index);
+  index = new GateMDBIndex;
+  index->mFileStatus = status;
+
+  G4String cacheName = (cacheDirectory == "" ? "" : GetCacheName(filePath, cacheDirectory));
+  if (cacheName != "" && index->ReadCache(cacheName)) {
+    GateMessage("Materials", 2, "GateMDBIndex: material database <" << filePath
+                << "> read from the cache <" << cacheName << ">\n");
+    return index;
+  }
+
+  std::ifstream is(filePath.c_str(), std::ios::in | std::ios::binary);
+  if (!is) {
+    delete index;
+    index = 0;
+    return 0;
+  }
+  std::ostringstream content;
+  content << is.rdbuf();
+  index->ReadDatabase(content.str());
+  GateMessage("Materials", 2, "GateMDBIndex: material database <" << filePath << "> read ("
+              << index->mLines.size() << " lines, " << index->mSections.size() << " sections)\n");
+  if (cacheName != "") index->WriteCache(cacheName);
+  return index;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4int GateMDBIndex::FindSection(const G4String& name) const
+{
+  ItemMap::const_iterator it = mSections.find("[" + name + "]");
+  if (it == mSections.end()) return -1;
+  return it->second;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4int GateMDBIndex::FindItem(const G4String& sectionName, const G4String& itemName) const
+{
+  std::map<G4String, ItemMap>::const_iterator section = mItems.find("[" + sectionName + "]");
+  if (section == mItems.end()) return -1;
+  ItemMap::const_iterator it = section->second.find(itemName);
+  if (it == section->second.end()) return -1;
+  return it->second;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Same lookup rules as the former sequential reading of the file:
+// - a section starts at the first line beginning with "[name]";
+// - its items are the non-empty lines "item:..." up to the next line
+//   starting with '[' (the first definition of an item is used).
+// Only the non-empty lines are read by GateMDBFile, from a section: the
+// empty lines and the lines before the first section are not kept.
+void GateMDBIndex::ReadDatabase(const std::string& content)
+{
+  std::istringstream is(content);
+  std::string line;
+  while (std::getline(is, line)) {
+    G4String cleaned(line);
+    GateTokenizer::CleanUpString(cleaned);
+    bool isSection = (line.length() && line[0] == '[' && line.find(']') != std::string::npos);
+    if (cleaned == "" || (mSections.empty() && !isSection)) continue;
+    G4int i = mLines.size();
+    mLines.push_back(cleaned);
+    if (isSection) {
+      G4String key = line.substr(0, line.find(']')+1);
+      if (mSections.find(key) == mSections.end()) mSections[key] = i+1;
+    }
+  }
+
+  G4int nLines = mLines.size();
+  for(ItemMap::const_iterator section = mSections.begin(); section != mSections.end(); ++section) {
+    ItemMap & items = mItems[section->first];
+    for(G4int i = section->second; i < nLines; i++) {
+      const G4String & l = mLines[i];
+      if (l[0] == '[') break; // next section
+      std::string::size_type colon = l.find(':');
+      if (colon == std::string::npos) continue;
+      G4String name = l.substr(0, colon);
+      if (items.find(name) == items.end()) items[name] = i;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// <cacheDirectory>/<file name>_<FNV-1a hash of the path>.mdbc
+G4String GateMDBIndex::GetCacheName(const G4String& filePath, const G4String& cacheDirectory)
+{
+  unsigned long long hash = HashOf(filePath);
+  std::string::size_type slash = filePath.rfind('/');
+  G4String baseName = filePath;
+  if (slash != std::string::npos) baseName = filePath.substr(slash+1);
+  std::ostringstream name;
+  name << cacheDirectory << "/" << baseName << "_" << std::hex << hash << ".mdbc";
+  return name.str();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateMDBIndex::ReadCache(const G4String& cacheName)
+{
+  std::ifstream is(cacheName.c_str(), std::ios::in | std::ios::binary);
+  if (!is) return false;
+
+  char magic[8];
+  is.read(magic, 8);
+  if (!is || G4String(magic, 8) != "GATEMDB3") return false;
+
+  // The cache is valid for the current version of the file only
+  FileStatus status;
+  if (!ReadValue(is, status) || !(status == mFileStatus)) return false;
+
+  G4int nLines;
+  if (!ReadValue(is, nLines) || nLines < 0) return false;
+  mLines.resize(nLines);
+  for(G4int i=0; i<nLines; i++)
+    if (!ReadString(is, mLines[i])) return false;
+
+  G4int nSections;
+  if (!ReadValue(is, nSections) || nSections < 0) return false;
+  for(G4int s=0; s<nSections; s++) {
+    G4String key;
+    G4int line, nItems;
+    if (!ReadString(is, key) || !ReadValue(is, line) || !ReadValue(is, nItems)) return false;
+    mSections[key] = line;
+    ItemMap & items = mItems[key];
+    for(G4int i=0; i<nItems; i++) {
+      G4String name;
+      if (!ReadString(is, name) || !ReadValue(is, line) || line < 0 || line >= nLines) return false;
+      items[name] = line;
+    }
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateMDBIndex::WriteCache(const G4String& cacheName) const
+{
+  // Written in a temporary file (one per process), so that a run reading
+  // the cache at the same time never gets a partial file
+  std::ostringstream tmp;
+  tmp << cacheName << "." << getpid() << ".tmp";
+  G4String tmpName = tmp.str();
+  std::ofstream os(tmpName.c_str(), std::ios::out | std::ios::binary);
+  if (!os) {
+    GateWarning("GateMDBIndex: cannot write the material database cache <" << cacheName << ">\n");
+    return;
+  }
+
+  os.write("GATEMDB3", 8);
+  WriteValue(os, mFileStatus);
+  WriteValue(os, (G4int)mLines.size());
+  for(unsigned int i=0; i<mLines.size(); i++) WriteString(os, mLines[i]);
+
+  WriteValue(os, (G4int)mSections.size());
+  for(ItemMap::const_iterator section = mSections.begin(); section != mSections.end(); ++section) {
+    const ItemMap & items = mItems.find(section->first)->second;
+    WriteString(os, section->first);
+    WriteValue(os, section->second);
+    WriteValue(os, (G4int)items.size());
+    for(ItemMap::const_iterator it = items.begin(); it != items.end(); ++it) {
+      WriteString(os, it->first);
+      WriteValue(os, it->second);
+    }
+  }
+  os.close();
+
+  if (!os || rename(tmpName.c_str(), cacheName.c_str()) != 0) {
+    GateWarning("GateMDBIndex: cannot write the material database cache <" << cacheName << ">\n");
+    remove(tmpName.c_str());
+  }
+}
+//-----------------------------------------------------------------------------
@@ -13,15 +13,15 @@
 
 
 #include <pthread.h>
+#include <unistd.h>
 #include <set>
+#include <limits>
+#include <algorithm>
 
 #include "GateVImageVolume.hh"
 #include "GateMiscFunctions.hh"
 #include "GateMessageManager.hh"
 #include "GateDetectorConstruction.hh"
-#include "GateDMapVol.h"
-#include "GateDMaplongvol.h"
-#include "GateDMapdt.h"
 #include "GateHounsfieldMaterialTable.hh"
 #include <G4TransportationManager.hh>
 #include "globals.hh"
@@ -317,6 +317,40 @@ void GateVImageVolume::SetDensityImageFilename(G4String filename) {
 }
 //--------------------------------------------------------------------
 
+//--------------------------------------------------------------------
+// Part of the image converted by one thread of
+// LoadImageMaterialsFromHounsfieldTable: H are replaced by labels, the
+// H range and the first H without material are kept for the checks.
+struct GateHounsfieldLabelTask {
+  GateHounsfieldMaterialTable * table;
+  GateImage::iterator begin;
+  GateImage::iterator end;
+  double minH;
+  double maxH;
+  bool hasLabelOutOfRange;
+  double labelOutOfRangeH;
+};
+
+static void * ConvertHounsfieldToLabel(void * arg)
+{
+  GateHounsfieldLabelTask * task = (GateHounsfieldLabelTask*)arg;
+  int n = task->table->GetNumberOfMaterials();
+  for(GateImage::iterator iter = task->begin; iter != task->end; ++iter) {
+    double h = *iter;
+    if (h < task->minH) task->minH = h;
+    if (h > task->maxH) task->maxH = h;
+    int label = task->table->GetLabelFromH(h);
+    if ((label<0 || label>=n) && !task->hasLabelOutOfRange) {
+      task->hasLabelOutOfRange = true;
+      task->labelOutOfRangeH = h;
+    }
+    (*iter) = label;
+  }
+  return NULL;
+}
+//--------------------------------------------------------------------
+
+
 //--------------------------------------------------------------------
 void GateVImageVolume::LoadImageMaterialsFromHounsfieldTable()
 {
@@ -354,14 +388,6 @@ void GateVImageVolume::LoadImageMaterialsFromHounsfieldTable()
     }
   }
 
-  // Bounds check
-  if(pImage->GetMinValue() < low || pImage->GetMaxValue() > high){
-      GateError("The image contains HU indices out of range of the HU range found in " <<
-            mHounsfieldToImageMaterialTableFilename <<
-            "\nmin, max:" << low << ", " << high <<
-            ".\nmin, max in image: " << pImage->GetMinValue() << ", " << pImage->GetMaxValue() <<
-            "\nAbort.\n");
-  }
   //  if (mHounsfieldMaterialTable.GetNumberOfMaterials() == 0) {
   if (mHounsfieldMaterialTable.GetNumberOfMaterials() == 1 ) {//there is a default mat = worldDefaultAir
     GateError("No Hounsfield material defined in the file "
@@ -371,25 +397,61 @@ void GateVImageVolume::LoadImageMaterialsFromHounsfieldTable()
   // Loop, create map H->label + verify
   mHounsfieldMaterialTable.MapLabelToMaterial(mLabelToMaterialName);
 
-  // Loop change image label
-  ImageType::iterator iter;
-  iter = pImage->begin();
-  while (iter != pImage->end()) {
-    double label = mHounsfieldMaterialTable.GetLabelFromH(*iter);
-    if (label<0) {
-      GateError(" I find H=" << *iter
+  // Change image label, in one pass with the H range of the bounds check
+  // (the image is not used if a check fails). The lookup table is built
+  // before the threads share it.
+  mHounsfieldMaterialTable.BuildLabelLookupTable();
+  int nbOfValues = pImage->GetNumberOfValues();
+  int nbOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (nbOfThreads > nbOfValues/65536 + 1) nbOfThreads = nbOfValues/65536 + 1;
+  if (nbOfThreads < 1) nbOfThreads = 1;
+  std::vector<GateHounsfieldLabelTask> tasks(nbOfThreads);
+  std::vector<pthread_t> threads(nbOfThreads);
+  for(int t=0; t<nbOfThreads; t++) {
+    tasks[t].table = &mHounsfieldMaterialTable;
+    tasks[t].begin = pImage->begin() + (long)nbOfValues*t/nbOfThreads;
+    tasks[t].end = pImage->begin() + (long)nbOfValues*(t+1)/nbOfThreads;
+    tasks[t].minH = std::numeric_limits<double>::max();
+    tasks[t].maxH = -std::numeric_limits<double>::max();
+    tasks[t].hasLabelOutOfRange = false;
+    tasks[t].labelOutOfRangeH = 0;
+  }
+  // the last part is converted by this thread
+  int nbOfStartedThreads = 0;
+  for(int t=0; t<nbOfThreads-1; t++) {
+    if (pthread_create(&threads[t], NULL, ConvertHounsfieldToLabel, &tasks[t]) != 0) break;
+    nbOfStartedThreads++;
+  }
+  for(int t=nbOfStartedThreads; t<nbOfThreads; t++) ConvertHounsfieldToLabel(&tasks[t]);
+  for(int t=0; t<nbOfStartedThreads; t++) pthread_join(threads[t], NULL);
+
+  double minH = std::numeric_limits<double>::max();
+  double maxH = -std::numeric_limits<double>::max();
+  for(int t=0; t<nbOfThreads; t++) {
+    minH = std::min(minH, tasks[t].minH);
+    maxH = std::max(maxH, tasks[t].maxH);
+  }
+
+  // Bounds check
+  if(minH < low || maxH > high){
+      GateError("The image contains HU indices out of range of the HU range found in " <<
+            mHounsfieldToImageMaterialTableFilename <<
+            "\nmin, max:" << low << ", " << high <<
+            ".\nmin, max in image: " << minH << ", " << maxH <<
+            "\nAbort.\n");
+  }
+  for(int t=0; t<nbOfThreads; t++) {
+    if (!tasks[t].hasLabelOutOfRange) continue;
+    double h = tasks[t].labelOutOfRangeH;
+    if (mHounsfieldMaterialTable.GetLabelFromH(h)<0) {
+      GateError(" I find H=" << h
 		<< " in the image, while Hounsfield range start at "
 		<< mHounsfieldMaterialTable[0].mH1 << Gateendl);
     }
-    if (label>=mHounsfieldMaterialTable.GetNumberOfMaterials()) {
-      GateError(" I find H=" << *iter
-		<< " in the image, while Hounsfield range stop at "
-		<< mHounsfieldMaterialTable[mHounsfieldMaterialTable.GetNumberOfMaterials()-1].mH2
-		<< Gateendl);
-    }
-    //GateMessage("Core", 0, " pix = " << (*iter) << " lab = " << label << Gateendl);
-    (*iter) = label;
-    ++iter;
+    GateError(" I find H=" << h
+              << " in the image, while Hounsfield range stop at "
+              << mHounsfieldMaterialTable[mHounsfieldMaterialTable.GetNumberOfMaterials()-1].mH2
+              << Gateendl);
   }
 
   // Debug
@@ -796,83 +858,145 @@ void GateVImageVolume::SetBuildDistanceTransfoFilename(G4String filename)
 void GateVImageVolume::BuildDistanceTransfo()
 {
   GateMessage("Geometry", 1, "Building distante map image (dmap) for the image '"
-	      << mImageFilename << "' (it could be long for large image)."
-	      << Gateendl);
-
-  // TEMPORARY : need isotrop !
-  if ((pImage->GetVoxelSize().x() !=
-       pImage->GetVoxelSize().y()) &&
-      (pImage->GetVoxelSize().x() !=
-       pImage->GetVoxelSize().z())) {
-    GateError("Error : image spacing should be isotropic for building dmap");
-    exit(0);
-  }
-
-  // Convert (copy) image into Vol structure
-  const G4ThreeVector & size = pImage->GetResolution();
-  GateMessage("Geometry", 1, "Image size is " << size << ".\n");
-  Vol v((int)lrint(size.x()),
-        (int)lrint(size.y()),
-        (int)lrint(size.z()), 0);
-  v.setVolumeCenter( v.sizeX()/2, v.sizeY()/2, v.sizeZ()/2 );
-  voxel * p = v.getDataPointer();
-  GateImage::const_iterator iter = pImage->begin();
-  while (iter != pImage->end()) {
-    /*
-      if ((*iter < 0) || (*iter > 255)) //FIXME
-      {
-      GateError("Error image value not uchar =" << *iter << Gateendl);
-      }
-    */
-    *p = static_cast<voxel>(lrint(*iter));
-    ++p;
-    ++iter;
-  }
+	      << mImageFilename << "'." << Gateendl);
 
-  //   GateDebugMessage("Geometry", 0, "im val = " << pImage->GetValue(22, 54, 34) << Gateendl);
-  //   GateDebugMessage("Geometry", 0, "vo val = " << (float)v.get(22, 54, 34) << Gateendl);
+  GateImage output;
+  ComputeDistanceMap(output);
 
-  if (!v.isOK()) {
-    fprintf( stderr, "Error construction vol ?");
-    exit(0);
-  }
+  // Dump final result ...
+  output.Write(mDistanceTransfoOutput);
+  GateMessage("Geometry", 1, "Distance map write to disk in the file '" << mDistanceTransfoOutput << "'.\n");
+  GateMessage("Geometry", 1, "You can now use it in the simulation. Use the macro 'distanceMap'. The macro 'buildAndDumpDistanceTransfo' is no more needed.\n");
+}
+//--------------------------------------------------------------------
 
-  // Creating the longvol tmpOutput structure
-  Longvol tmpOutput(v.sizeX(),v.sizeY(),v.sizeZ(),0);
-  if (!tmpOutput.isOK()) {
-    fprintf( stderr, "Couldn't init the longvol structure !\n" );
-    exit(0);
-  }
 
-  // Each volume center is (0,0,0)x(sizeX,sizeY,sizeZ)
-  tmpOutput.setVolumeCenter( tmpOutput.sizeX()/2, tmpOutput.sizeY()/2, tmpOutput.sizeZ()/2 );
+//--------------------------------------------------------------------
+// Lines of the distance map processed by one thread of
+// ComputeDistanceMap. The squared distances are computed in place, one
+// axis after the other; the first pass also finds the interface voxels.
+struct GateDistanceMapTask {
+  const GateImage * labels;
+  GateImage * dmap;
+  int axis;
+  int firstLine;
+  int lastLine;
+};
 
-  GateMessage("Geometry", 4, "Input Vol size: "<<
-	      tmpOutput.sizeX()<<"x"<<tmpOutput.sizeY()<<"x"<< tmpOutput.sizeZ()<< Gateendl);
+static void * ComputeDistanceMapLines(void * arg)
+{
+  GateDistanceMapTask * task = (GateDistanceMapTask*)arg;
+  const GateImage * labels = task->labels;
+  GateImage * dmap = task->dmap;
+  const int size[3] = { (int)lrint(dmap->GetResolution().x()),
+                        (int)lrint(dmap->GetResolution().y()),
+                        (int)lrint(dmap->GetResolution().z()) };
+  const int stride[3] = { 1, dmap->GetLineSize(), dmap->GetPlaneSize() };
+  const int a = task->axis;
+  const int n = size[a];
+  const double w = dmap->GetVoxelSize()[a];
+  const double inf = std::numeric_limits<double>::infinity();
+
+  std::vector<double> f(n), z(n+1);
+  std::vector<int> v(n);
+  for(int l=task->firstLine; l<task->lastLine; l++) {
+    // first voxel of the line
+    int start;
+    if (a == 0) start = l*size[0];
+    else if (a == 1) start = (l%size[0]) + (l/size[0])*stride[2];
+    else start = l;
+
+    if (a == 0) {
+      // 0 for the voxels on the image border or with a neighbour of
+      // another label
+      for(int q=0; q<n; q++) {
+        int index = start + q;
+        const int c[3] = { q, l%size[1], l/size[1] };
+        float label = labels->GetValue(index);
+        f[q] = inf;
+        for(int d=0; d<3 && f[q]!=0; d++) {
+          if (c[d] == 0 || c[d] == size[d]-1) f[q] = 0;
+          else if (labels->GetValue(index-stride[d]) != label ||
+                   labels->GetValue(index+stride[d]) != label) f[q] = 0;
+        }
+      }
+    }
+    else {
+      for(int q=0; q<n; q++) f[q] = dmap->GetValue(start + q*stride[a]);
+    }
 
-  // Go ?
-  GateMessage("Geometry", 4, "Start distance map computation ...\n");
-  bool b = computeSEDT(v, tmpOutput, true, false, 1);
-  GateMessage("Geometry", 4, "End ! b = " << b << Gateendl);
+    // lower envelope of the parabolas (Felzenszwalb & Huttenlocher)
+    int k = -1;
+    for(int q=0; q<n; q++) {
+      if (f[q] == inf) continue;
+      if (k < 0) {
+        k = 0; v[0] = q; z[0] = -inf; z[1] = inf;
+        continue;
+      }
+      double s;
+      while (true) {
+        double xv = v[k]*w, xq = q*w;
+        s = ((f[q]+xq*xq) - (f[v[k]]+xv*xv)) / (2*(xq-xv));
+        if (s > z[k]) break;
+        k--; // z[0] = -inf, k stays >= 0
+      }
+      k++; v[k] = q; z[k] = s; z[k+1] = inf;
+    }
+    if (k < 0) {
+      for(int q=0; q<n; q++) dmap->SetValue(start + q*stride[a], inf);
+      continue;
+    }
+    k = 0;
+    for(int q=0; q<n; q++) {
+      while (z[k+1] < q*w) k++;
+      double dx = (q - v[k])*w;
+      dmap->SetValue(start + q*stride[a], dx*dx + f[v[k]]);
+    }
+  }
+  return NULL;
+}
+//--------------------------------------------------------------------
 
-  // Convert (copy) image from Vol structure into GateImage
-  GateDebugMessage("Geometry", 4, "Convert and output\n");
-  GateImage output;
-  output.SetResolutionAndHalfSize(pImage->GetResolution(), pImage->GetHalfSize());
-  output.SetOrigin(pImage->GetOrigin());
-  output.Allocate();
-  double spacingFactor = pImage->GetVoxelSize().x();
-  GateImage::iterator it = output.begin();
-  lvoxel * pp = tmpOutput.getDataPointer();
-  while (it < output.end()) {
-    *it = (float)sqrt(*pp * spacingFactor);
-    ++pp;
-    ++it;
+
+//--------------------------------------------------------------------
+void GateVImageVolume::ComputeDistanceMap(GateImage & dmap)
+{
+  dmap.SetResolutionAndHalfSize(pImage->GetResolution(), pImage->GetHalfSize());
+  dmap.SetOrigin(pImage->GetOrigin());
+  dmap.Allocate();
+
+  const G4ThreeVector & resolution = pImage->GetResolution();
+  const int size[3] = { (int)lrint(resolution.x()), (int)lrint(resolution.y()), (int)lrint(resolution.z()) };
+  int nbOfCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+  if (nbOfCPUs < 1) nbOfCPUs = 1;
+  GateMessage("Geometry", 4, "Start distance map computation (" << nbOfCPUs << " threads) ...\n");
+
+  // Separable exact EDT: x, y then z
+  for(int axis=0; axis<3; axis++) {
+    int nbOfLines = pImage->GetNumberOfValues() / size[axis];
+    int nbOfThreads = std::min(nbOfCPUs, nbOfLines);
+    std::vector<GateDistanceMapTask> tasks(nbOfThreads);
+    std::vector<pthread_t> threads(nbOfThreads);
+    for(int t=0; t<nbOfThreads; t++) {
+      tasks[t].labels = pImage;
+      tasks[t].dmap = &dmap;
+      tasks[t].axis = axis;
+      tasks[t].firstLine = (long)nbOfLines*t/nbOfThreads;
+      tasks[t].lastLine = (long)nbOfLines*(t+1)/nbOfThreads;
+    }
+    int nbOfStartedThreads = 0;
+    for(int t=0; t<nbOfThreads-1; t++) {
+      if (pthread_create(&threads[t], NULL, ComputeDistanceMapLines, &tasks[t]) != 0) break;
+      nbOfStartedThreads++;
+    }
+    for(int t=nbOfStartedThreads; t<nbOfThreads; t++) ComputeDistanceMapLines(&tasks[t]);
+    for(int t=0; t<nbOfStartedThreads; t++) pthread_join(threads[t], NULL);
   }
 
-  // Dump final result ...
-  output.Write(mDistanceTransfoOutput);
-  GateMessage("Geometry", 1, "Distance map write to disk in the file '" << mDistanceTransfoOutput << "'.\n");
-  GateMessage("Geometry", 1, "You can now use it in the simulation. Use the macro 'distanceMap'. The macro 'buildAndDumpDistanceTransfo' is no more needed.\n");
+  // Squared distances to distances (the border voxels are 0, so every
+  // distance is finite)
+  for(GateImage::iterator it = dmap.begin(); it != dmap.end(); ++it)
+    *it = sqrt(*it);
+  GateMessage("Geometry", 4, "End of distance map computation.\n");
 }
 //--------------------------------------------------------------------
@@ -0,0 +1,222 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+
+/*
+ * \file  GateGPUEmulation.hh
+ * \brief Minimal host implementation of the CUDA language and runtime
+ * subset used by the .cu files of source/gpu/src, so that the same kernels
+ * can be compiled by the C++ compiler (see GateCPUManager.cc).
+ * - kernels are run block by block by a pool of threads, the threads of
+ *   a block being run one after the other;
+ * - device memory is host memory, atomicAdd is a real atomic operation.
+ */
+
+#ifndef GATEGPUEMULATION_HH
+#define GATEGPUEMULATION_HH
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#ifdef __CUDACC__
+#error "GateGPUEmulation.hh must not be compiled by nvcc"
+#endif
+
+//----------------------------------------------------------
+// Qualifiers
+#define __global__
+#define __device__
+#define __host__
+#define __constant__
+
+//----------------------------------------------------------
+// Vector types (same layout as in GateGPUIO.hh)
+#ifndef FLOAT3
+#define FLOAT3
+struct float3 {
+  float x, y, z;
+};
+#endif
+
+#ifndef INT3
+#define INT3
+struct int3 {
+  int x, y, z;
+};
+#endif
+
+struct float2 { float x, y; };
+struct int4 { int x, y, z, w; };
+struct uint3 { unsigned int x, y, z; };
+
+struct dim3 {
+  dim3(unsigned int vx=1, unsigned int vy=1, unsigned int vz=1):x(vx), y(vy), z(vz) {}
+  unsigned int x, y, z;
+};
+
+inline float2 make_float2(float x, float y) { float2 v = { x, y }; return v; }
+inline float3 make_float3(float x, float y, float z) { float3 v = { x, y, z }; return v; }
+inline int3 make_int3(int x, int y, int z) { int3 v = { x, y, z }; return v; }
+inline int4 make_int4(int x, int y, int z, int w) { int4 v = { x, y, z, w }; return v; }
+
+//----------------------------------------------------------
+// Built-in variables, set by the worker threads before each call
+extern __thread uint3 threadIdx;
+extern __thread uint3 blockIdx;
+extern __thread uint3 blockDim;
+extern __thread uint3 gridDim;
+
+//----------------------------------------------------------
+// Intrinsics
+inline float __fdividef(float x, float y) { return x/y; }
+inline float __logf(float x) { return logf(x); }
+inline float __log10f(float x) { return log10f(x); }
+inline float __expf(float x) { return expf(x); }
+inline float __sinf(float x) { return sinf(x); }
+inline float __cosf(float x) { return cosf(x); }
+inline float __powf(float x, float y) { return powf(x, y); }
+inline unsigned int __umul24(unsigned int x, unsigned int y) { return x*y; }
+
+inline int atomicAdd(int * address, int val) { return __sync_fetch_and_add(address, val); }
+inline unsigned int atomicAdd(unsigned int * address, unsigned int val) { return __sync_fetch_and_add(address, val); }
+inline float atomicAdd(float * address, float val) {
+  // no atomic floating point addition: compare and swap on the bits
+  union { float f; int i; } oldValue, newValue;
+  do {
+    oldValue.f = *(volatile float*)address;
+    newValue.f = oldValue.f + val;
+  } while (!__sync_bool_compare_and_swap((int*)address, oldValue.i, newValue.i));
+  return oldValue.f;
+}
+
+//----------------------------------------------------------
+// Runtime: there is only one "device", the host
+enum cudaError_t { cudaSuccess = 0, cudaErrorMemoryAllocation = 2 };
+enum cudaMemcpyKind { cudaMemcpyHostToHost = 0, cudaMemcpyHostToDevice = 1,
+                      cudaMemcpyDeviceToHost = 2, cudaMemcpyDeviceToDevice = 3 };
+
+template<class T>
+inline cudaError_t cudaMalloc(T ** p, size_t size) {
+  *p = (T*)malloc(size);
+  return (*p || !size) ? cudaSuccess : cudaErrorMemoryAllocation;
+}
+inline cudaError_t cudaMemcpy(void * dst, const void * src, size_t size, cudaMemcpyKind) {
+  memcpy(dst, src, size);
+  return cudaSuccess;
+}
+inline cudaError_t cudaFree(void * p) { free(p); return cudaSuccess; }
+inline cudaError_t cudaSetDevice(int) { return cudaSuccess; }
+inline cudaError_t cudaThreadExit() { return cudaSuccess; }
+inline cudaError_t cudaThreadSynchronize() { return cudaSuccess; }
+inline cudaError_t cudaDeviceSynchronize() { return cudaSuccess; }
+
+//----------------------------------------------------------
+// Kernel launch: GATE_KERNEL_LAUNCH(kernel, grid, threads)(args) stores
+// the arguments and runs kernel(args) for every thread of the grid.
+// It returns when all the blocks are done (launches are synchronous).
+class GateVCPUKernel {
+public:
+  virtual ~GateVCPUKernel() {}
+  virtual void Run() const = 0;
+};
+
+void GateCPURunKernel(const dim3 & grid, const dim3 & block, const GateVCPUKernel & kernel);
+void GateCPUSetNumberOfThreads(int n);
+int GateCPUGetNumberOfThreads();
+
+template<class TKernel>
+class GateCPUKernelLaunch {
+public:
+  GateCPUKernelLaunch(TKernel k, const dim3 & g, const dim3 & b):mKernel(k), mGrid(g), mBlock(b) {}
+
+  template<class A1>
+  void operator()(A1 a1) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1):k(k), a1(v1) {}
+      void Run() const { k(a1); }
+      TKernel k; A1 a1;
+    } call(mKernel, a1);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2>
+  void operator()(A1 a1, A2 a2) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2):k(k), a1(v1), a2(v2) {}
+      void Run() const { k(a1, a2); }
+      TKernel k; A1 a1; A2 a2;
+    } call(mKernel, a1, a2);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2, class A3>
+  void operator()(A1 a1, A2 a2, A3 a3) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2, A3 v3):k(k), a1(v1), a2(v2), a3(v3) {}
+      void Run() const { k(a1, a2, a3); }
+      TKernel k; A1 a1; A2 a2; A3 a3;
+    } call(mKernel, a1, a2, a3);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2, class A3, class A4>
+  void operator()(A1 a1, A2 a2, A3 a3, A4 a4) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2, A3 v3, A4 v4):k(k), a1(v1), a2(v2), a3(v3), a4(v4) {}
+      void Run() const { k(a1, a2, a3, a4); }
+      TKernel k; A1 a1; A2 a2; A3 a3; A4 a4;
+    } call(mKernel, a1, a2, a3, a4);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2, class A3, class A4, class A5>
+  void operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2, A3 v3, A4 v4, A5 v5):k(k), a1(v1), a2(v2), a3(v3), a4(v4), a5(v5) {}
+      void Run() const { k(a1, a2, a3, a4, a5); }
+      TKernel k; A1 a1; A2 a2; A3 a3; A4 a4; A5 a5;
+    } call(mKernel, a1, a2, a3, a4, a5);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2, class A3, class A4, class A5, class A6>
+  void operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2, A3 v3, A4 v4, A5 v5, A6 v6):k(k), a1(v1), a2(v2), a3(v3), a4(v4), a5(v5), a6(v6) {}
+      void Run() const { k(a1, a2, a3, a4, a5, a6); }
+      TKernel k; A1 a1; A2 a2; A3 a3; A4 a4; A5 a5; A6 a6;
+    } call(mKernel, a1, a2, a3, a4, a5, a6);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+  template<class A1, class A2, class A3, class A4, class A5, class A6, class A7>
+  void operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) const {
+    struct Call : public GateVCPUKernel {
+      Call(TKernel k, A1 v1, A2 v2, A3 v3, A4 v4, A5 v5, A6 v6, A7 v7):k(k), a1(v1), a2(v2), a3(v3), a4(v4), a5(v5), a6(v6), a7(v7) {}
+      void Run() const { k(a1, a2, a3, a4, a5, a6, a7); }
+      TKernel k; A1 a1; A2 a2; A3 a3; A4 a4; A5 a5; A6 a6; A7 a7;
+    } call(mKernel, a1, a2, a3, a4, a5, a6, a7);
+    GateCPURunKernel(mGrid, mBlock, call);
+  }
+
+protected:
+  TKernel mKernel;
+  dim3 mGrid;
+  dim3 mBlock;
+};
+
+template<class TKernel>
+inline GateCPUKernelLaunch<TKernel> GateCPUMakeLaunch(TKernel k, const dim3 & g, const dim3 & b) {
+  return GateCPUKernelLaunch<TKernel>(k, g, b);
+}
+
+#define GATE_KERNEL_LAUNCH(kernel, grid, threads) GateCPUMakeLaunch(kernel, grid, threads)
+//----------------------------------------------------------
+
+#endif
@@ -0,0 +1,409 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See GATE/LICENSE.txt for further details
+  ----------------------*/
+
+
+/*
+ * \file  GateCPUManager.cc
+ * \brief CPU build of the GPU tracking code (GateGPUManager.cu). The .cu
+ * files are compiled as C++ with GateGPUEmulation.hh, inside the
+ * GateCPUBackend namespace to avoid clashes with the CUDA build, and
+ * the CPU_xxx functions declared in GateGPUIO.hh and GateGPUCollimIO.hh
+ * forward to them.
+ * The kernels keep their GPU organisation: one call per particle of the
+ * stacks (structure of arrays), the blocks of 512 particles being shared
+ * between the threads of the pool.
+ */
+
+// Headers of the .cu files, included here outside of the namespace
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <math.h>
+#include <float.h>
+#include <vector>
+
+#include <TROOT.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TBranch.h>
+#include <TSystem.h>
+#include <TPluginManager.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "GateMessageManager.hh"
+#include "GateGPUIO.hh"
+#include "GateGPUCollimIO.hh"
+#include "GateGPUEmulation.hh"
+
+//----------------------------------------------------------
+namespace GateCPUBackend {
+#include "GateCommon_cst.cu"
+#include "GateCommon_fun.cu"
+
+#include "GateEmisTomo.cu"
+#include "GateTransTomo.cu"
+#include "GatePhotRadThera.cu"
+#include "GateSPECT.cu"
+
+#include "GateOptical_cst.cu"
+#include "GateOptical_fun.cu"
+#include "GateOptical_main.cu"
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Built-in variables of the kernels
+__thread uint3 threadIdx;
+__thread uint3 blockIdx;
+__thread uint3 blockDim;
+__thread uint3 gridDim;
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Pool of persistent threads running the kernels. The calling thread
+// also runs blocks, so n threads means n-1 workers. The blocks are
+// distributed one at a time: the tracking time of the particles is
+// very unequal, a static partition would leave threads idle.
+namespace {
+
+class GateCPUThreadPool {
+public:
+  GateCPUThreadPool();
+  ~GateCPUThreadPool();
+
+  void SetNumberOfThreads(int n);
+  int GetNumberOfThreads() const { return mNumberOfThreads; }
+  void Run(const dim3 & grid, const dim3 & block, const GateVCPUKernel & kernel);
+
+protected:
+  static void * Worker(void * arg);
+  void StartWorkers();
+  void StopWorkers();
+  void RunBlocks();
+
+  int mNumberOfThreads;
+  std::vector<pthread_t> mWorkers;
+  pthread_mutex_t mMutex;
+  pthread_cond_t mStartCondition;
+  pthread_cond_t mDoneCondition;
+  pthread_mutex_t mLaunchMutex;
+  unsigned long mGeneration;
+  bool mQuit;
+  int mNumberOfRunningWorkers;
+
+  // Current launch
+  const GateVCPUKernel * mKernel;
+  dim3 mGrid;
+  dim3 mBlock;
+  unsigned int mNumberOfBlocks;
+  volatile unsigned int mNextBlock;
+};
+
+//----------------------------------------------------------
+GateCPUThreadPool::GateCPUThreadPool()
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  mNumberOfThreads = (n > 0 ? (int)n : 1);
+  pthread_mutex_init(&mMutex, NULL);
+  pthread_mutex_init(&mLaunchMutex, NULL);
+  pthread_cond_init(&mStartCondition, NULL);
+  pthread_cond_init(&mDoneCondition, NULL);
+  mGeneration = 0;
+  mQuit = false;
+  mNumberOfRunningWorkers = 0;
+  mKernel = NULL;
+  mNumberOfBlocks = 0;
+  mNextBlock = 0;
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+GateCPUThreadPool::~GateCPUThreadPool()
+{
+  StopWorkers();
+  pthread_cond_destroy(&mDoneCondition);
+  pthread_cond_destroy(&mStartCondition);
+  pthread_mutex_destroy(&mLaunchMutex);
+  pthread_mutex_destroy(&mMutex);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPUThreadPool::SetNumberOfThreads(int n)
+{
+  if (n < 1) n = 1;
+  pthread_mutex_lock(&mLaunchMutex);
+  if (n != mNumberOfThreads) {
+    StopWorkers();
+    mNumberOfThreads = n;
+  }
+  pthread_mutex_unlock(&mLaunchMutex);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPUThreadPool::StartWorkers()
+{
+  mQuit = false;
+  mWorkers.resize(mNumberOfThreads-1);
+  for(unsigned int i=0; i<mWorkers.size(); i++) {
+    if (pthread_create(&mWorkers[i], NULL, Worker, this) != 0) {
+      GateWarning("GateCPUThreadPool: cannot start more than " << i+1 << " threads.");
+      mWorkers.resize(i);
+      mNumberOfThreads = i+1;
+    }
+  }
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPUThreadPool::StopWorkers()
+{
+  if (mWorkers.empty()) return;
+  pthread_mutex_lock(&mMutex);
+  mQuit = true;
+  pthread_cond_broadcast(&mStartCondition);
+  pthread_mutex_unlock(&mMutex);
+  for(unsigned int i=0; i<mWorkers.size(); i++) pthread_join(mWorkers[i], NULL);
+  mWorkers.clear();
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void * GateCPUThreadPool::Worker(void * arg)
+{
+  GateCPUThreadPool * pool = static_cast<GateCPUThreadPool*>(arg);
+  unsigned long generation = 0;
+  pthread_mutex_lock(&pool->mMutex);
+  while (true) {
+    while (!pool->mQuit && pool->mGeneration == generation)
+      pthread_cond_wait(&pool->mStartCondition, &pool->mMutex);
+    if (pool->mQuit) break;
+    generation = pool->mGeneration;
+    pthread_mutex_unlock(&pool->mMutex);
+
+    pool->RunBlocks();
+
+    pthread_mutex_lock(&pool->mMutex);
+    if (--pool->mNumberOfRunningWorkers == 0) pthread_cond_signal(&pool->mDoneCondition);
+  }
+  pthread_mutex_unlock(&pool->mMutex);
+  return NULL;
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPUThreadPool::RunBlocks()
+{
+  blockDim.x = mBlock.x; blockDim.y = mBlock.y; blockDim.z = mBlock.z;
+  gridDim.x = mGrid.x; gridDim.y = mGrid.y; gridDim.z = mGrid.z;
+  unsigned int b;
+  while ((b = __sync_fetch_and_add(&mNextBlock, 1)) < mNumberOfBlocks) {
+    blockIdx.x = b % mGrid.x;
+    blockIdx.y = (b / mGrid.x) % mGrid.y;
+    blockIdx.z = b / (mGrid.x * mGrid.y);
+    for(threadIdx.z=0; threadIdx.z<mBlock.z; threadIdx.z++)
+      for(threadIdx.y=0; threadIdx.y<mBlock.y; threadIdx.y++)
+        for(threadIdx.x=0; threadIdx.x<mBlock.x; threadIdx.x++)
+          mKernel->Run();
+  }
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPUThreadPool::Run(const dim3 & grid, const dim3 & block, const GateVCPUKernel & kernel)
+{
+  // One launch at a time (the actors may share the pool)
+  pthread_mutex_lock(&mLaunchMutex);
+  mKernel = &kernel;
+  mGrid = grid;
+  mBlock = block;
+  mNumberOfBlocks = grid.x * grid.y * grid.z;
+  mNextBlock = 0;
+
+  if (mNumberOfThreads > 1 && mNumberOfBlocks > 1) {
+    if (mWorkers.empty()) StartWorkers();
+    pthread_mutex_lock(&mMutex);
+    mNumberOfRunningWorkers = mWorkers.size();
+    mGeneration++;
+    pthread_cond_broadcast(&mStartCondition);
+    pthread_mutex_unlock(&mMutex);
+
+    RunBlocks();
+
+    pthread_mutex_lock(&mMutex);
+    while (mNumberOfRunningWorkers > 0) pthread_cond_wait(&mDoneCondition, &mMutex);
+    pthread_mutex_unlock(&mMutex);
+  }
+  else RunBlocks();
+
+  mKernel = NULL;
+  pthread_mutex_unlock(&mLaunchMutex);
+}
+//----------------------------------------------------------
+
+GateCPUThreadPool gPool;
+
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+void GateCPURunKernel(const dim3 & grid, const dim3 & block, const GateVCPUKernel & kernel)
+{
+  gPool.Run(grid, block, kernel);
+}
+
+void GateCPUSetNumberOfThreads(int n)
+{
+  gPool.SetNumberOfThreads(n);
+}
+
+int GateCPUGetNumberOfThreads()
+{
+  return gPool.GetNumberOfThreads();
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Transmission Tomography Application
+void CPU_GateTransTomo_init(const GateGPUIO_Input *input,
+                            Materials &materials_d, Volume &phantom_d,
+                            StackParticle &photons_d, StackParticle &photons_h,
+                            unsigned int nb_of_particles, unsigned int seed)
+{
+  GateCPUBackend::GPU_GateTransTomo_init(input, materials_d, phantom_d, photons_d, photons_h,
+                                         nb_of_particles, seed);
+}
+
+void CPU_GateTransTomo(Materials &materials_d, Volume &phantom_d,
+                       StackParticle &photons_d, StackParticle &photons_h,
+                       unsigned int nb_of_particles)
+{
+  GateCPUBackend::GPU_GateTransTomo(materials_d, phantom_d, photons_d, photons_h, nb_of_particles);
+}
+
+void CPU_GateTransTomo_end(Materials &materials_d, Volume &phantom_d,
+                           StackParticle &photons_d, StackParticle &photons_h)
+{
+  GateCPUBackend::GPU_GateTransTomo_end(materials_d, phantom_d, photons_d, photons_h);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Emission Tomography Application
+void CPU_GateEmisTomo_init(const GateGPUIO_Input *input,
+                           Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                           StackParticle &gamma1_d, StackParticle &gamma2_d,
+                           StackParticle &gamma1_h, StackParticle &gamma2_h,
+                           unsigned int nb_of_particles, unsigned int seed)
+{
+  GateCPUBackend::GPU_GateEmisTomo_init(input, materials_d, phantom_d, activities_d,
+                                        gamma1_d, gamma2_d, gamma1_h, gamma2_h,
+                                        nb_of_particles, seed);
+}
+
+void CPU_GateEmisTomo(Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                      StackParticle &gamma1_d, StackParticle &gamma2_d,
+                      StackParticle &gamma1_h, StackParticle &gamma2_h,
+                      unsigned int nb_of_particles)
+{
+  GateCPUBackend::GPU_GateEmisTomo(materials_d, phantom_d, activities_d,
+                                   gamma1_d, gamma2_d, gamma1_h, gamma2_h, nb_of_particles);
+}
+
+void CPU_GateEmisTomo_end(Materials &materials_d, Volume &phantom_d, Activities &activities_d,
+                          StackParticle &gamma1_d, StackParticle &gamma2_d,
+                          StackParticle &gamma1_h, StackParticle &gamma2_h)
+{
+  GateCPUBackend::GPU_GateEmisTomo_end(materials_d, phantom_d, activities_d,
+                                       gamma1_d, gamma2_d, gamma1_h, gamma2_h);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Photon Radiation Therapy
+void CPU_GatePhotRadThera_init(const GateGPUIO_Input *input, Dosimetry &dose_d,
+                               Materials &materials_d, Volume &phantom_d,
+                               StackParticle &photons_d, StackParticle &electrons_d,
+                               StackParticle &photons_h,
+                               unsigned int nb_of_particles, unsigned int seed)
+{
+  GateCPUBackend::GPU_GatePhotRadThera_init(input, dose_d, materials_d, phantom_d,
+                                            photons_d, electrons_d, photons_h,
+                                            nb_of_particles, seed);
+}
+
+void CPU_GatePhotRadThera(Dosimetry &dosemap_d, Materials &materials_d, Volume &phantom_d,
+                          StackParticle &photons_d, StackParticle &electrons_d,
+                          StackParticle &photons_h, unsigned int nb_of_particles)
+{
+  GateCPUBackend::GPU_GatePhotRadThera(dosemap_d, materials_d, phantom_d,
+                                       photons_d, electrons_d, photons_h, nb_of_particles);
+}
+
+void CPU_GatePhotRadThera_end(Dosimetry &dosemap_d, Materials &materials_d, Volume &phantom_d,
+                              StackParticle &photons_d, StackParticle &electrons_d,
+                              StackParticle &photons_h)
+{
+  GateCPUBackend::GPU_GatePhotRadThera_end(dosemap_d, materials_d, phantom_d,
+                                           photons_d, electrons_d, photons_h);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// SPECT Application
+void CPU_GateSPECT_init(const GateGPUCollimIO_Input *input, Colli &colli_d,
+                        CoordHex2 &centerOfHexagons_h, CoordHex2 &centerOfHexagons_d,
+                        StackParticle &photons_d, StackParticle &photons_h, Materials &materials_d,
+                        unsigned int nb_of_particles, unsigned int nb_of_hexagons, unsigned int seed)
+{
+  GateCPUBackend::GPU_GateSPECT_init(input, colli_d, centerOfHexagons_h, centerOfHexagons_d,
+                                     photons_d, photons_h, materials_d,
+                                     nb_of_particles, nb_of_hexagons, seed);
+}
+
+void CPU_GateSPECT(Colli &colli_d, CoordHex2 &centerOfHexagons_h, CoordHex2 &centerOfHexagons_d,
+                   StackParticle &photons_d, StackParticle &photons_h, Materials &materials_d,
+                   unsigned int nb_of_particles)
+{
+  GateCPUBackend::GPU_GateSPECT(colli_d, centerOfHexagons_h, centerOfHexagons_d,
+                                photons_d, photons_h, materials_d, nb_of_particles);
+}
+
+void CPU_GateSPECT_end(CoordHex2 &centerOfHexagons_d, StackParticle &photons_d, StackParticle &photons_h,
+                       Materials &materials_d)
+{
+  GateCPUBackend::GPU_GateSPECT_end(centerOfHexagons_d, photons_d, photons_h, materials_d);
+}
+//----------------------------------------------------------
+
+
+//----------------------------------------------------------
+// Optical photon
+void GateOpticalBiolum_CPU(const GateGPUIO_Input * input,
+                           GateGPUIO_Output * output)
+{
+  GateCPUBackend::GateOpticalBiolum_GPU(input, output);
+}
+//----------------------------------------------------------
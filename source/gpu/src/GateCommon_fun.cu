@@ -4,6 +4,12 @@
 #include <math.h>
 #include <float.h>
 
+// Kernels are launched with GATE_KERNEL_LAUNCH(kernel, grid, threads)(args)
+// so that the same code can be built for the CPU (see GateGPUEmulation.hh)
+#ifndef GATE_KERNEL_LAUNCH
+#define GATE_KERNEL_LAUNCH(kernel, grid, threads) kernel<<<grid, threads>>>
+#endif
+
 /***********************************************************
  * Vars
  ***********************************************************/
@@ -134,12 +134,12 @@ void GPU_GateEmisTomo(Materials &materials_d, Volume &phantom_d, Activities &act
     n=0; while (n<buffer_size) {tmp[n] = rand(); ++n;};
     cudaMemcpy(gamma2_d.seed, tmp, buffer_size * sizeof(int), cudaMemcpyHostToDevice);
     free(tmp);
-    kernel_brent_init<<<grid, threads>>>(gamma1_d);
-    kernel_brent_init<<<grid, threads>>>(gamma2_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(gamma1_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(gamma2_d);
     printf(" ::   Rnd ok\n");
 
     // Generation
-    kernel_voxelized_source_b2b<<<grid, threads>>>(gamma1_d, gamma2_d, activities_d, E,
+    GATE_KERNEL_LAUNCH(kernel_voxelized_source_b2b, grid, threads)(gamma1_d, gamma2_d, activities_d, E,
                                                    phantom_d.size_in_vox, phantom_d.voxel_size);
     cudaThreadSynchronize();
     printf(" ::   Generation ok\n");
@@ -149,10 +149,10 @@ void GPU_GateEmisTomo(Materials &materials_d, Volume &phantom_d, Activities &act
     while (gamma_sim_h < gamma_max_sim) {
         ++step;
         // Regular navigator
-        kernel_NavRegularPhan_Photon_NoSec<<<grid, threads>>>(gamma1_d, phantom_d,
+        GATE_KERNEL_LAUNCH(kernel_NavRegularPhan_Photon_NoSec, grid, threads)(gamma1_d, phantom_d,
                                                               materials_d, gamma_sim_d);
         
-        kernel_NavRegularPhan_Photon_NoSec<<<grid, threads>>>(gamma2_d, phantom_d,
+        GATE_KERNEL_LAUNCH(kernel_NavRegularPhan_Photon_NoSec, grid, threads)(gamma2_d, phantom_d,
                                                               materials_d, gamma_sim_d);
         
         cudaThreadSynchronize();
@@ -36,7 +36,7 @@ void GateOpticalBiolum_GPU(const GateGPUIO_Input * input,
   // Init random
   i=0; while(i < nb_of_particles) {photons_h.seed[i] = rand(); ++i;};
   stack_copy_host2device(photons_h, photons_d);
-  kernel_brent_init<<<grid, threads>>>(photons_d);
+  GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(photons_d);
     
   // Phantoms Mat
   Volume phantom_mat_d;
@@ -73,7 +73,7 @@ void GateOpticalBiolum_GPU(const GateGPUIO_Input * input,
 
   
   // Source
-  kernel_optical_voxelized_source<<<grid, threads>>>(photons_d, phantom_mat_d,
+  GATE_KERNEL_LAUNCH(kernel_optical_voxelized_source, grid, threads)(photons_d, phantom_mat_d,
                                                      phantom_act_d, phantom_ind_d, E);
   /*i
   stack_copy_device2host(photons_d, photons_h);
@@ -92,7 +92,7 @@ void GateOpticalBiolum_GPU(const GateGPUIO_Input * input,
     ++step;
     //DD(step);
     //DD(count_h);
-    kernel_optical_navigation_regular<<<grid, threads>>>(photons_d, phantom_mat_d, count_d);
+    GATE_KERNEL_LAUNCH(kernel_optical_navigation_regular, grid, threads)(photons_d, phantom_mat_d, count_d);
 
     // get back the number of simulated photons
     cudaMemcpy(&count_h, count_d, sizeof(int), cudaMemcpyDeviceToHost);
@@ -46,7 +46,7 @@ void GPU_GatePhotRadThera_init(const GateGPUIO_Input *input, Dosimetry &dose_d,
     int grid_size = (nb_of_particles + block_size - 1) / block_size;
     threads.x = block_size;
     grid.x = grid_size;
-    kernel_brent_init<<<grid, threads>>>(electrons_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(electrons_d);
     printf(" :: Stack init\n");
    
     // Dosemap
@@ -173,7 +173,7 @@ void GPU_GatePhotRadThera(Dosimetry &dosemap_d, Materials &materials_d,
     grid.x = grid_size;
 
     // Init random
-    kernel_brent_init<<<grid, threads>>>(photons_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(photons_d);
 
     // Count simulated photons
     int *count_phot_d, *count_elec_d;
@@ -195,7 +195,7 @@ void GPU_GatePhotRadThera(Dosimetry &dosemap_d, Materials &materials_d,
 
         //ta = time();
         // Regular photon navigator
-        kernel_NavRegularPhan_Photon_WiSec<<<grid, threads>>>(photons_d, electrons_d, 
+        GATE_KERNEL_LAUNCH(kernel_NavRegularPhan_Photon_WiSec, grid, threads)(photons_d, electrons_d, 
                                                               phantom_d, materials_d, 
                                                               dosemap_d,
                                                               count_phot_d, step_limiter);
@@ -204,7 +204,7 @@ void GPU_GatePhotRadThera(Dosimetry &dosemap_d, Materials &materials_d,
 
         //tb = time();
         // Regular electron navigator
-        kernel_NavRegularPhan_Electron_BdPhoton<<<grid, threads>>>(electrons_d, photons_d,
+        GATE_KERNEL_LAUNCH(kernel_NavRegularPhan_Electron_BdPhoton, grid, threads)(electrons_d, photons_d,
                                                                    phantom_d, materials_d,
                                                                    dosemap_d,
                                                                    count_elec_d, step_limiter);
@@ -156,7 +156,7 @@ void GPU_GateSPECT(Colli &colli_d, CoordHex2 &centerOfHexagons_h, CoordHex2 &cen
     //printf("threads %d grid %d \n", threads.x, grid.x);
 
     // Init random
-    kernel_brent_init<<<grid, threads>>>(photons_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(photons_d);
 
     // Count simulated photons
     int* count_d;
@@ -172,7 +172,7 @@ void GPU_GateSPECT(Colli &colli_d, CoordHex2 &centerOfHexagons_h, CoordHex2 &cen
         //kernel_NavRegularPhan_Photon_NoSec<<<grid, threads>>>(photons_d, phantom_d, 
           //                                                    materials_d, count_d);
 
-		kernel_NavHexaColli_Photon_NoSec<<<grid, threads>>>(photons_d, colli_d, centerOfHexagons_d, 
+		GATE_KERNEL_LAUNCH(kernel_NavHexaColli_Photon_NoSec, grid, threads)(photons_d, colli_d, centerOfHexagons_d, 
 															materials_d, count_d);
 
         // get back the number of simulated photons
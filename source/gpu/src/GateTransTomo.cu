@@ -97,7 +97,7 @@ void GPU_GateTransTomo(Materials &materials_d, Volume &phantom_d,
     grid.x = grid_size;
 
     // Init random
-    kernel_brent_init<<<grid, threads>>>(photons_d);
+    GATE_KERNEL_LAUNCH(kernel_brent_init, grid, threads)(photons_d);
 
     // Count simulated photons
     int* count_d;
@@ -110,7 +110,7 @@ void GPU_GateTransTomo(Materials &materials_d, Volume &phantom_d,
     while (count_h < nb_of_particles) {
         ++step;
         // Regular navigator
-        kernel_NavRegularPhan_Photon_NoSec<<<grid, threads>>>(photons_d, phantom_d, 
+        GATE_KERNEL_LAUNCH(kernel_NavRegularPhan_Photon_NoSec, grid, threads)(photons_d, phantom_d, 
                                                               materials_d, count_d);
 
         // get back the number of simulated photons
@@ -48,6 +48,10 @@ public:
 
   void SetGPUDeviceID(int n);
 
+  void EnableCPU(bool b);
+
+  void SetNumberOfCPUThreads(int n);
+
 protected:
 
   GateGPUEmisTomoMessenger* m_sourceGPUVoxellizedMessenger;
@@ -87,6 +91,8 @@ protected:
 
   int mCudaDeviceID;
 
+  bool mCPUEnabled;
+
   int mBeginRunFlag;
 
   //void GeneratePrimaryEventFromGPUOutput(const GateGPUIO_Particle & particle, G4Event * event);  
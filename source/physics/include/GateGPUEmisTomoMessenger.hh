@@ -12,6 +12,7 @@
 #include "GateSourceVoxellizedMessenger.hh"
 #include "G4UIcmdWithAString.hh"
 
+class G4UIcmdWithABool;
 class GateGPUEmisTomo;
 
 class GateGPUEmisTomoMessenger: public GateSourceVoxellizedMessenger
@@ -27,6 +28,8 @@ private:
   G4UIcmdWithAString * m_attach_to_cmd;
   G4UIcmdWithAnInteger * m_gpu_buffer_size_cmd;
   G4UIcmdWithAnInteger * m_gpu_device_id_cmd;
+  G4UIcmdWithABool * m_cpu_enable_cmd;
+  G4UIcmdWithAnInteger * m_cpu_threads_cmd;
 };
 
 #endif
@@ -47,6 +47,10 @@ public:
 
   void SetGPUDeviceID(int n);
 
+  void EnableCPU(bool b);
+
+  void SetNumberOfCPUThreads(int n);
+
 // vesna
   void SetGPUOpticalPhotonEnergy(double energy);
 // vesna
@@ -71,6 +75,8 @@ protected:
 
   int mCudaDeviceID;
 
+  bool mCPUEnabled;
+
   void GeneratePrimaryEventFromGPUOutput(const GateGPUIO_Particle & particle, G4Event * event);  
   void SetPhantomVolumeData();
 };
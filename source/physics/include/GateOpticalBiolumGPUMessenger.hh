@@ -13,6 +13,7 @@
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 
+class G4UIcmdWithABool;
 class GateOpticalBiolumGPU;
 
 class GateOpticalBiolumGPUMessenger: public GateSourceVoxellizedMessenger
@@ -28,6 +29,8 @@ private:
   G4UIcmdWithAString * m_attach_to_cmd;
   G4UIcmdWithAnInteger * m_gpu_buffer_size_cmd;
   G4UIcmdWithAnInteger * m_gpu_device_id_cmd;
+  G4UIcmdWithABool * m_cpu_enable_cmd;
+  G4UIcmdWithAnInteger * m_cpu_threads_cmd;
   G4UIcmdWithADoubleAndUnit * m_gpu_energy_cmd;
 };
 
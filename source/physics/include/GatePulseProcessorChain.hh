@@ -53,6 +53,14 @@ class GatePulseProcessorChain : public GateModuleListManager
      const G4String& GetOutputName() const
        { return m_outputName; }
 
+     //! When enabled, the pulse-processors that support it (see GateVPulseProcessor)
+     //! modify the pulse-list of the previous module of the chain instead of copying it.
+     //! The output of the previous module is then no longer available.
+     void SetInPlaceProcessing(G4bool val)
+       { m_isInPlaceProcessingEnabled = val; }
+     G4bool IsInPlaceProcessingEnabled() const
+       { return m_isInPlaceProcessingEnabled; }
+
      virtual inline GateVSystem* GetSystem() const
        { return m_system;}
      virtual inline void SetSystem(GateVSystem* aSystem)
@@ -63,6 +71,7 @@ class GatePulseProcessorChain : public GateModuleListManager
       GateVSystem *m_system;            //!< System to which the chain is attached
       G4String				   m_outputName;
       G4String                             m_inputName;
+      G4bool                               m_isInPlaceProcessingEnabled;
 };
 
 #endif
@@ -62,6 +62,7 @@ class GatePulseProcessorChainMessenger: public GateListMessenger
   private:
   
     G4UIcmdWithAString*         SetInputNameCmd;        //!< The UI command "set input name"
+    G4UIcmdWithABool*           SetInPlaceProcessingCmd; //!< The UI command "set in-place processing"
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "GateApplicationMgr.hh"
 #include "GateSourcePencilBeam.hh"
 #include "GateSourceTPSPencilBeam.hh"
+#include "GateAliasTable.hh"
 
 class GateSourceMgrMessenger;
 
@@ -38,6 +39,11 @@ class GateSourceMgrMessenger;
  * the beginning of the Run. 
  * For each event, it decides which source is to be used and it asks to this source
  * to generate the primary vertices.
+ * The pending decay time of each source with a constant activity is kept in a
+ * min-heap, so that only the source used for the event is resampled. Sources with
+ * a time-dependent activity (forced half-life, voxellized) are resampled at each
+ * event. In total-amount-of-primaries mode, the source is sampled from an alias
+ * table of the intensities. Both are rebuilt at the beginning of each run.
  * 
  * GateSourceMgr is a singleton.
  * @author G.Santin
@@ -85,6 +91,12 @@ public:
    */
   GateVSource* GetNextSource();
 
+  /** Must be called when the activity of a source is changed during a run
+   * (for example by GateWashOutActor): its pending decay time is resampled.
+   */
+  void RescheduleSource( GateVSource* source );
+  void InvalidateSourceSchedule() { m_sourceScheduleIsValid = false; }
+
   /** It is called by the PrimaryGeneratorAction
    * at each event, to prepare the Primary Vertices.
    */
@@ -128,6 +140,16 @@ public:
 protected:
   GateSourceMgr();
   G4int CheckSourceName( G4String sourceName );
+  void BuildSourceSchedule();
+  void ScheduleSource( G4int sourceIndex, G4double timeNow );
+
+  // Pending decay of a source, ordered for a min-heap (earliest on top)
+  struct ScheduledDecay {
+    G4double time;    // absolute time
+    G4int    source;  // index in mSources
+    G4int    version; // entry is outdated if != m_sourceVersion[source]
+    bool operator<(const ScheduledDecay & other) const { return time > other.time; }
+  };
 
   static GateSourceMgr*     mInstance;
   GateVSourceVector         mSources;
@@ -160,6 +182,12 @@ protected:
 
   std::vector<int>          mSourceID;
 
+  G4bool                      m_sourceScheduleIsValid;
+  std::vector<ScheduledDecay> m_sourceHeap;
+  std::vector<G4int>          m_sourceVersion; // -1 if not in the heap
+  std::vector<G4int>          m_unscheduledSources;
+  GateAliasTable              m_intensitySampler;
+
   /* PY Descourt 08/09/2008 */
    G4int m_currentSourceID; // for detector mode
    GateVSource* m_fictiveSource; // idem
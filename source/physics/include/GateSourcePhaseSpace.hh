@@ -33,6 +33,7 @@ See GATE/LICENSE.txt for further details
 
 #include "GateVSource.hh"
 #include "GateSourcePhaseSpaceMessenger.hh"
+#include "GateBinaryPhaseSpace.hh"
 
 //#include "GateRunManager.hh"
 
@@ -50,8 +51,12 @@ public:
   void Initialize();
   void GenerateROOTVertex( G4Event* );
   void GenerateIAEAVertex( G4Event* );
+  void GenerateBinaryVertex( G4Event* );
 
   G4int OpenIAEAFile(G4String file);
+  void OpenBinaryFiles();
+  void LoadBinaryRadiusIndex(unsigned int file);
+  void FillBinaryBuffer();
 
   G4int GeneratePrimaries( G4Event* event );
 
@@ -79,6 +84,11 @@ public:
 
   void SetRmax(float r){mRmax = r;}
 
+  // First particle used in a .gphsp file (for example to split a job
+  // in disjoint parts of the phase space), or a random one
+  void SetStartingParticleIndex(long i){mStartingParticleIndex = i;}
+  void SetUseRandomStartingParticle(bool b){mUseRandomStartingParticle = b;}
+
 protected:
 
   TChain *T;
@@ -146,6 +156,23 @@ protected:
   
   bool mUseNbOfParticleAsIntensity;
 
+  // .gphsp files, seen as one list of records
+  std::vector<GateBinaryPhaseSpaceReader*> mBinaryReaders;
+  std::vector<uint64_t> mBinaryFirstRecord; // index of the first record of each file
+  uint64_t mBinaryNbOfRecords;
+  uint64_t mBinaryCursor;                   // next record to decode
+  uint64_t mBinaryRangeBegin;               // records read by this process
+  uint64_t mBinaryRangeEnd;
+  // with mRmax>0, number of selected records in each block of
+  // mBinaryIndexBlockSize records of each file (see LoadBinaryRadiusIndex)
+  std::vector<std::vector<uint32_t> > mBinarySelectedPerBlock;
+  static const uint64_t mBinaryIndexBlockSize = 4096;
+  std::vector<GateBinaryPhaseSpaceRecord> mBinaryBuffer;
+  size_t mBinaryBufferSize;
+  size_t mBinaryBufferPosition;
+  long mStartingParticleIndex;
+  bool mUseRandomStartingParticle;
+  G4int mLastPDGCode;
 };
 
 #endif
@@ -49,6 +49,8 @@ private:
   G4UIcmdWithoutParameter* RandomSymmetryCmd;
   G4UIcmdWithABool*        setUseNbParticleAsIntensityCmd;
   G4UIcmdWithADoubleAndUnit * setRmaxCmd;
+  G4UIcmdWithAnInteger*    setStartingParticleIndexCmd;
+  G4UIcmdWithABool*        setUseRandomStartingParticleCmd;
 };
 //----------------------------------------------------------------------------------------
 
@@ -26,6 +26,8 @@ public:
   virtual ~GateSourceVoxellized();
 
   virtual G4double GetNextTime(G4double timeNow);
+  // the total activity is read from the voxel reader, it can change at each event
+  virtual G4bool HasConstantActivity() { return false; }
 
   virtual void Dump(G4int level);
 
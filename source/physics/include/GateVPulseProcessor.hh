@@ -48,6 +48,12 @@ class GatePulseProcessorChain;
       - The other option is to overload the method ProcessPulseList() (if the pulse-processing 
       	sequential mechanism provided by ProcessPulseList() is not appropriate. 
 	In that case, one should provide some dummy implementation (such as {;}) for ProcessOnePulse()
+
+    - Pulse-processors that output at most one pulse per input pulse, independently
+      of the other pulses (e.g. blurring, thresholder, efficiency), may also
+      implement ProcessOnePulseInPlace() and return true in IsInPlaceProcessingSupported().
+      When in-place processing is enabled for the chain, the pulse-list produced by the
+      previous module of the chain is then modified instead of being copied.
       	
       \sa GatePulseProcessorChainMessenger, GatePulse, GatePulseList
 */      
@@ -79,6 +85,19 @@ class GateVPulseProcessor : public GateClockDependent
     //! This function is called by ProcessPulseList() for each of the input pulses
     //! The result of the pulse-processing must be incorporated into the output pulse-list
     virtual void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)=0;
+
+    //! In-place version of ProcessPulseList(): the pulses of the list are processed
+    //! with ProcessOnePulseInPlace(), the rejected pulses are deleted, and the list
+    //! is renamed after the processor. Returns 0 if the input list is null or empty.
+    virtual GatePulseList* ProcessPulseListInPlace(GatePulseList* pulseList);
+
+    //! True if the processor implements ProcessOnePulseInPlace()
+    virtual G4bool IsInPlaceProcessingSupported() const
+      { return false; }
+
+    //! Process one pulse in place. Returns false if the pulse must be removed from the list
+    virtual G4bool ProcessOnePulseInPlace(GatePulse* )
+      { return true; }
     //@}
 
    
@@ -77,6 +77,9 @@ public:
   virtual void SetIonDefaultHalfLife();
   virtual void Update(double time);
   virtual G4double GetNextTime( G4double timeStart );
+  // True if the activity does not change with time once the source has
+  // started (the pending decay time can then be kept by GateSourceMgr)
+  virtual G4bool HasConstantActivity() { return !( m_forcedUnstableFlag && m_forcedLifeTime > 0. ); }
   //virtual G4double GetNextTimeInSuccessiveSourceMode(G4double timeStart, G4int mNbOfParticleInTheCurrentRun);
   virtual void Dump( G4int level );
   virtual void SetVerboseLevel( G4int value ) { nVerboseLevel = value; }
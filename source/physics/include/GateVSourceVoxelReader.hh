@@ -14,6 +14,7 @@
 #include <map>
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "GateAliasTable.hh"
 
 class GateVSource;
 class GateVSourceVoxelTranslator;
@@ -31,8 +32,24 @@ public:
 
   /** It is used internally by PrepareNextEvent
    * to decide which source has to be used for the current event.
+   * Return the linear index (ix + nx*iy + nx*ny*iz) of the chosen voxel,
+   * or -1 if there is no active voxel.
    */
-  virtual std::vector<G4int> GetNextSource();
+  virtual G4int GetNextSource();
+
+  // Image resolution used to compute the linear voxel indices. It must be
+  // set by the readers before the first call to AddVoxel.
+  void SetImageResolution(G4int nx, G4int ny, G4int nz);
+  inline G4int GetLinearIndex(G4int ix, G4int iy, G4int iz) const {
+    return ix + m_imageResolution[0]*(iy + m_imageResolution[1]*iz);
+  }
+  inline void GetVoxelCoordinates(G4int index, G4int & ix, G4int & iy, G4int & iz) const {
+    ix = index % m_imageResolution[0];
+    index /= m_imageResolution[0];
+    iy = index % m_imageResolution[1];
+    iz = index / m_imageResolution[1];
+  }
+  G4int GetNumberOfActiveVoxels() const { return m_voxelIndices.size(); }
 
   GateVSource* GetSource() { return m_source; };
 
@@ -78,19 +95,25 @@ public:
 
   virtual void Dump(G4int level);
 
+  // Map (ix,iy,iz) -> activity built from the flat activity store (used
+  // by the GPU sources at initialisation only, do not call per event)
   typedef std::map<std::vector<G4int>,G4double>   GateSourceActivityMap;
 
-  GateSourceActivityMap GetSourceActivityMap() { return m_sourceVoxelActivities; }
+  GateSourceActivityMap GetSourceActivityMap();
 
 protected:
   G4int nVerboseLevel;
   G4String                       m_name;
   G4String                       m_fileName;
   GateVSource*                   m_source;
-  std::vector<G4int>             m_firstSource;
-  typedef std::map<G4double,std::vector<G4int> >  GateSourceIntegratedActivityMap;
-  GateSourceActivityMap           m_sourceVoxelActivities;
-  GateSourceIntegratedActivityMap m_sourceVoxelIntegratedActivities;
+  // Flat activity store: linear indices of the active voxels (kept sorted)
+  // and their activities, plus the alias table used to sample them.
+  std::vector<G4int>             m_voxelIndices;
+  std::vector<G4double>          m_voxelActivities;
+  GateAliasTable                 m_activitySampler;
+  G4bool                         m_activitySamplerIsUpToDate;
+  G4int                          m_imageResolution[3];
+  G4int FindOrInsertVoxel(G4int index, G4bool & isNew);
   void PrepareIntegratedActivityMap();
   G4ThreeVector                  m_voxelSize;
   G4ThreeVector                  m_position;
@@ -49,6 +49,11 @@ GateGPUEmisTomo::GateGPUEmisTomo(G4String name)
   //mNumberOfNextTime = 1;
   //mCurrentTimeID = 0;
   mCudaDeviceID = 0;
+#ifdef GATE_USE_GPU
+  mCPUEnabled = false;
+#else
+  mCPUEnabled = true;
+#endif
   mBeginRunFlag = 0;
   max_buffer_size = 0;
   mUserCount = 0;
@@ -103,6 +108,24 @@ void GateGPUEmisTomo::SetGPUDeviceID(int n)
   m_gpu_input->cudaDeviceID = n;
 }
 
+//----------------------------------------------------------
+void GateGPUEmisTomo::EnableCPU(bool b)
+{
+#ifndef GATE_USE_GPU
+  if (!b) GateWarning("Gate is compiled without GPU support, the tracking stays on the CPU.");
+  b = true;
+#endif
+  mCPUEnabled = b;
+}
+//----------------------------------------------------------
+
+//----------------------------------------------------------
+void GateGPUEmisTomo::SetNumberOfCPUThreads(int n)
+{
+  GateCPUSetNumberOfThreads(n);
+}
+//----------------------------------------------------------
+
 //----------------------------------------------------------
 void GateGPUEmisTomo::Dump(G4int level) 
 {
@@ -161,12 +184,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
       current_time = 0.0;
       tot_p = 0;
 
-#ifdef GATE_USE_GPU
       // Init GPU' stuff
-      GPU_GateEmisTomo_init(m_gpu_input,
-                            gpu_materials, gpu_phantom, gpu_activities,
-                            gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                            max_buffer_size, seed);
+      if (mCPUEnabled)
+        CPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
+#ifdef GATE_USE_GPU
+      else
+        GPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
 #endif      
 
       mBeginRunFlag = 1;
@@ -175,13 +204,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
   // STEP 2 -- Fill buffer if need -------------------------------------
 
   if (nb_event_in_buffer <= 0) {
+    if (mCPUEnabled)
+      CPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
 #ifdef GATE_USE_GPU
-    GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
-                     gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                     max_buffer_size);
+    else
+      GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
+#endif    
     nb_event_in_buffer = max_buffer_size;
     id_event_in_buffer = 0;
-#endif    
   }
   
   // STEP 3 -- Generate one event ------------------------------------
@@ -488,12 +522,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
       current_time = 0.0;
       tot_p = 0;
 
-#ifdef GATE_USE_GPU
       // Init GPU' stuff
-      GPU_GateEmisTomo_init(m_gpu_input,
-                            gpu_materials, gpu_phantom, gpu_activities,
-                            gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                            max_buffer_size, seed);
+      if (mCPUEnabled)
+        CPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
+#ifdef GATE_USE_GPU
+      else
+        GPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
 #endif      
 
       mBeginRunFlag = 1;
@@ -502,13 +542,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
   // STEP 2 -- Fill buffer if need -------------------------------------
 
   if (nb_event_in_buffer <= 0) {
+    if (mCPUEnabled)
+      CPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
 #ifdef GATE_USE_GPU
-    GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
-                     gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                     max_buffer_size);
+    else
+      GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
+#endif    
     nb_event_in_buffer = max_buffer_size;
     id_event_in_buffer = 0;
-#endif    
   }
   
   // STEP 3 -- Generate one event ------------------------------------
@@ -665,12 +710,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
       nb_event_in_buffer = 0;
       current_time = 0.0;
 
-#ifdef GATE_USE_GPU
       // Init GPU' stuff
-      GPU_GateEmisTomo_init(m_gpu_input,
-                            gpu_materials, gpu_phantom, gpu_activities,
-                            gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                            max_buffer_size, seed);
+      if (mCPUEnabled)
+        CPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
+#ifdef GATE_USE_GPU
+      else
+        GPU_GateEmisTomo_init(m_gpu_input,
+                              gpu_materials, gpu_phantom, gpu_activities,
+                              gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                              max_buffer_size, seed);
 #endif      
 
       mBeginRunFlag = 1;
@@ -678,13 +729,18 @@ G4int GateGPUEmisTomo::GeneratePrimaries(G4Event* event)
 
   // STEP 2 -- Fill buffer if need -------------------------------------
   if (nb_event_in_buffer <= 0) {
+    if (mCPUEnabled)
+      CPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
 #ifdef GATE_USE_GPU
-    GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
-                     gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
-                     max_buffer_size);
+    else
+      GPU_GateEmisTomo(gpu_materials, gpu_phantom, gpu_activities,
+                       gpu_gamma1, gpu_gamma2, cpu_gamma1, cpu_gamma2,
+                       max_buffer_size);
+#endif    
     nb_event_in_buffer = max_buffer_size;
     id_event_in_buffer = 0;
-#endif    
   }
   
   // STEP 3 -- Generate one event ------------------------------------
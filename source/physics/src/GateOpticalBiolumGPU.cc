@@ -51,6 +51,11 @@ GateOpticalBiolumGPU::GateOpticalBiolumGPU(G4String name)
   mNumberOfNextTime = 1;
   mCurrentTimeID = 0;
   mCudaDeviceID = 0;
+#ifdef GATE_USE_GPU
+  mCPUEnabled = false;
+#else
+  mCPUEnabled = true;
+#endif
 }
 //----------------------------------------------------------
 
@@ -98,6 +103,24 @@ void GateOpticalBiolumGPU::SetGPUDeviceID(int n)
   m_gpu_input->cudaDeviceID = n;
 }
 
+//----------------------------------------------------------
+void GateOpticalBiolumGPU::EnableCPU(bool b)
+{
+#ifndef GATE_USE_GPU
+  if (!b) GateWarning("Gate is compiled without GPU support, the tracking stays on the CPU.");
+  b = true;
+#endif
+  mCPUEnabled = b;
+}
+//----------------------------------------------------------
+
+//----------------------------------------------------------
+void GateOpticalBiolumGPU::SetNumberOfCPUThreads(int n)
+{
+  GateCPUSetNumberOfThreads(n);
+}
+//----------------------------------------------------------
+
 
 // vesna
   void GateOpticalBiolumGPU::SetGPUOpticalPhotonEnergy(double energy)
@@ -171,8 +194,11 @@ G4int GateOpticalBiolumGPU::GeneratePrimaries(G4Event* event)
       static_cast<unsigned int>(*GateRandomEngine::GetInstance()->GetRandomEngine());
     //printf("seed from input %ld\n", m_gpu_input->seed);
 
+    if (mCPUEnabled)
+      GateOpticalBiolum_CPU(m_gpu_input, m_gpu_output);
 #ifdef GATE_USE_GPU
-    GateOpticalBiolum_GPU(m_gpu_input, m_gpu_output);
+    else
+      GateOpticalBiolum_GPU(m_gpu_input, m_gpu_output);
 #endif    
 
 
@@ -9,6 +9,7 @@
 #include "GateOpticalBiolumGPUMessenger.hh"
 #include "GateOpticalBiolumGPU.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
 
 //----------------------------------------------------------------------------------------
 GateOpticalBiolumGPUMessenger::GateOpticalBiolumGPUMessenger(GateOpticalBiolumGPU* source)
@@ -23,6 +24,14 @@ GateOpticalBiolumGPUMessenger::GateOpticalBiolumGPUMessenger(GateOpticalBiolumGP
   m_gpu_device_id_cmd = new G4UIcmdWithAnInteger((GetDirectoryName()+"setGPUDeviceID").c_str(),this);
   m_gpu_device_id_cmd->SetGuidance("Set the GPU Device ID");
 
+  m_cpu_enable_cmd = new G4UIcmdWithABool((GetDirectoryName()+"enableCPU").c_str(),this);
+  m_cpu_enable_cmd->SetGuidance("Track the particles with the CPU version of the gpu code");
+
+  m_cpu_threads_cmd = new G4UIcmdWithAnInteger((GetDirectoryName()+"setNumberOfCPUThreads").c_str(),this);
+  m_cpu_threads_cmd->SetGuidance("Set the number of threads of the CPU version (default: number of cores)");
+  m_cpu_threads_cmd->SetParameterName("Threads", false);
+  m_cpu_threads_cmd->SetRange("Threads>0");
+
 // vesna
   m_gpu_energy_cmd = new G4UIcmdWithADoubleAndUnit((GetDirectoryName() +"energy").c_str(),this);
   m_gpu_energy_cmd->SetGuidance("Set optical photon energy.");
@@ -47,6 +56,8 @@ void GateOpticalBiolumGPUMessenger::SetNewValue(G4UIcommand* command,G4String ne
   if (command == m_attach_to_cmd) m_gpu_source->AttachToVolume(newValue);
   if (command == m_gpu_buffer_size_cmd) m_gpu_source->SetGPUBufferSize(m_gpu_buffer_size_cmd->GetNewIntValue(newValue));
   if (command == m_gpu_device_id_cmd) m_gpu_source->SetGPUDeviceID(m_gpu_buffer_size_cmd->GetNewIntValue(newValue));
+  if (command == m_cpu_enable_cmd) m_gpu_source->EnableCPU(m_cpu_enable_cmd->GetNewBoolValue(newValue));
+  if (command == m_cpu_threads_cmd) m_gpu_source->SetNumberOfCPUThreads(m_cpu_threads_cmd->GetNewIntValue(newValue));
   GateSourceVoxellizedMessenger::SetNewValue(command,newValue);
 // vesna
   if (command == m_gpu_energy_cmd) m_gpu_source->SetGPUOpticalPhotonEnergy(m_gpu_energy_cmd->GetNewDoubleValue(newValue));
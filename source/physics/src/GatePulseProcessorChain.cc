@@ -25,7 +25,8 @@ GatePulseProcessorChain::GatePulseProcessorChain( GateDigitizer* itsDigitizer,
   : GateModuleListManager(itsDigitizer,itsDigitizer->GetObjectName() + "/" + itsOutputName,"pulse-processor"),
     m_system( itsDigitizer->GetSystem() ),
     m_outputName(itsOutputName),
-    m_inputName(GateHitConvertor::GetOutputAlias())
+    m_inputName(GateHitConvertor::GetOutputAlias()),
+    m_isInPlaceProcessingEnabled(false)
 {
 //  G4cout << " DEBUT Constructor GatePulseProcessorChain \n";
   m_messenger = new GatePulseProcessorChainMessenger(this);
@@ -59,6 +60,7 @@ void GatePulseProcessorChain::Describe(size_t indent)
   GateModuleListManager::Describe();
   G4cout << GateTools::Indent(indent) << "Input:              '" << m_inputName << "'\n";
   G4cout << GateTools::Indent(indent) << "Output:             '" << m_outputName << "'\n";
+  G4cout << GateTools::Indent(indent) << "In-place processing: " << (m_isInPlaceProcessingEnabled ? "on" : "off") << Gateendl;
 }
 
 void GatePulseProcessorChain::DescribeProcessors(size_t indent)
@@ -84,12 +86,25 @@ GatePulseList* GatePulseProcessorChain::ProcessPulseList()
   if (pulseList->empty())
     return 0;
 
+  // Only the lists produced by this chain may be modified in place:
+  // the input list may be shared with other chains
+  G4bool isOwnList = false;
+
   // Sequentially launch all pulse processors
   for (size_t processorID = 0 ; processorID < GetProcessorNumber(); processorID++) 
     if (GetProcessor(processorID)->IsEnabled()) {
-      pulseList = GetProcessor(processorID)->ProcessPulseList(pulseList);
-      if (pulseList) GateDigitizer::GetInstance()->StorePulseList(pulseList);
-      else break;
+      GateVPulseProcessor* processor = GetProcessor(processorID);
+      if (m_isInPlaceProcessingEnabled && isOwnList && processor->IsInPlaceProcessingSupported()) {
+        // The list is already stored by the digitizer
+        pulseList = processor->ProcessPulseListInPlace(pulseList);
+        if (!pulseList) break;
+      }
+      else {
+        pulseList = processor->ProcessPulseList(pulseList);
+        if (pulseList) GateDigitizer::GetInstance()->StorePulseList(pulseList);
+        else break;
+        isOwnList = true;
+      }
     }
 
   if (pulseList)  GateDigitizer::GetInstance()->StorePulseListAlias(m_outputName,pulseList);
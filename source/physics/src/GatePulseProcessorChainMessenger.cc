@@ -64,6 +64,12 @@ GatePulseProcessorChainMessenger::GatePulseProcessorChainMessenger(GatePulseProc
   SetInputNameCmd = new G4UIcmdWithAString(cmdName,this);
   SetInputNameCmd->SetGuidance("Set the name of the input pulse channel");
   SetInputNameCmd->SetParameterName("Name",false);
+
+  cmdName = GetDirectoryName()+"setInPlaceProcessing";
+  SetInPlaceProcessingCmd = new G4UIcmdWithABool(cmdName,this);
+  SetInPlaceProcessingCmd->SetGuidance("Let blurring, thresholder and efficiency modules modify the pulse-list of the previous module instead of copying it");
+  SetInPlaceProcessingCmd->SetGuidance("The output of the modified modules is then no longer available");
+  SetInPlaceProcessingCmd->SetParameterName("flag",false);
 }
 
 
@@ -72,6 +78,7 @@ GatePulseProcessorChainMessenger::GatePulseProcessorChainMessenger(GatePulseProc
 GatePulseProcessorChainMessenger::~GatePulseProcessorChainMessenger()
 {
   delete SetInputNameCmd;
+  delete SetInPlaceProcessingCmd;
 }
 
 
@@ -81,6 +88,8 @@ void GatePulseProcessorChainMessenger::SetNewValue(G4UIcommand* command,G4String
 { 
   if (command == SetInputNameCmd) 
     { GetProcessorChain()->SetInputName(newValue); }
+  else if (command == SetInPlaceProcessingCmd)
+    { GetProcessorChain()->SetInPlaceProcessing(SetInPlaceProcessingCmd->GetNewBoolValue(newValue)); }
   else
     GateListMessenger::SetNewValue(command,newValue);
 }
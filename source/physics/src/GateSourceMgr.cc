@@ -27,6 +27,7 @@
 #include "GateRTPhantomMgr.hh"
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include "GateActions.hh"
 #include "G4RunManager.hh"
 #include "GateSourceOfPromptGamma.hh"
@@ -52,6 +53,7 @@ GateSourceMgr::GateSourceMgr()
   m_currentSourceID = -1;
   mTotalIntensity=0.;
   m_launchLastBuffer = false;
+  m_sourceScheduleIsValid = false;
 }
 //----------------------------------------------------------------------------------------
 
@@ -74,6 +76,7 @@ GateSourceMgr::~GateSourceMgr()
 G4int GateSourceMgr::AddSource( GateVSource* pSource )
 {
   mSources.push_back( pSource );
+  m_sourceScheduleIsValid = false;
   return 0;
 }
 //----------------------------------------------------------------------------------------
@@ -83,6 +86,7 @@ G4int GateSourceMgr::AddSource( GateVSource* pSource )
 G4int GateSourceMgr::RemoveSource( G4String name )
 {
   G4int found = 0;
+  m_sourceScheduleIsValid = false;
   if( name == G4String( "all" ) )
     {
       for( size_t is = 0; is != mSources.size(); ++is )//Use an iterator??
@@ -244,6 +248,7 @@ G4int GateSourceMgr::AddSource( std::vector<G4String> sourceVec )
 
     mSources.push_back( source );
     m_sourceProgressiveNumber++;
+    m_sourceScheduleIsValid = false;
   }
   else
     G4cout << "GateSourceMgr::AddSource : WARNING: Source not added \n";
@@ -312,40 +317,64 @@ GateVSource* GateSourceMgr::GetNextSource()
     return NULL; // GateError ???
   }
 
+  if( !m_sourceScheduleIsValid ) BuildSourceSchedule();
+
   G4double aTime;
 
   if (IsTotalAmountOfPrimariesModeEnabled()) {
-    G4double randNumber = G4UniformRand()*mTotalIntensity;
-    G4double sumIntensity=0.;
-    G4int currentSourceNumber = 0;
-    while ( (currentSourceNumber<(int)mSources.size()) && (sumIntensity<=randNumber)){
-      pFirstSource = mSources[ currentSourceNumber ];
-      sumIntensity += pFirstSource->GetIntensity();
-      currentSourceNumber++;
-    }
+    G4int currentSourceNumber = m_intensitySampler.Sample();
+    if( currentSourceNumber < 0 ) currentSourceNumber = mSources.size()-1;
+    pFirstSource = mSources[ currentSourceNumber ];
 
     m_firstTime = GateApplicationMgr::GetInstance()->GetTimeStepInTotalAmountOfPrimariesMode();
   }
   else {
     // if there is at least one source
     // make a competition among all the available sources
-    // the source that proposes the shortest interval for the next event wins
-    GateVSourceVector::iterator itr;
-    for( itr = mSources.begin(); itr != mSources.end(); ++itr )
+    // the source that proposes the shortest interval for the next event wins.
+    // Sources with a time-dependent activity propose a new time at each event
+    for( size_t i = 0; i != m_unscheduledSources.size(); ++i )
       {
-        aTime = (*itr)->GetNextTime( m_time ); // compute random time for this source
+        GateVSource* source = mSources[ m_unscheduledSources[i] ];
+        aTime = source->GetNextTime( m_time ); // compute random time for this source
         if( mVerboseLevel > 1 )
           G4cout << "GateSourceMgr::GetNextSource : source "
-                 << (*itr)->GetName()
+                 << source->GetName()
                  << "    Next time (s) : " << aTime/s
                  << "   m_firstTime (s) : " << m_firstTime/s << Gateendl;
 
         if( m_firstTime < 0. || ( aTime < m_firstTime ) )
           {
             m_firstTime = aTime;
-            pFirstSource = *itr;
+            pFirstSource = source;
           }
       }
+
+    // The other ones keep their pending decay time in the heap (the
+    // interval distribution is memoryless), only the winner is resampled
+    while( !m_sourceHeap.empty() &&
+           m_sourceHeap.front().version != m_sourceVersion[ m_sourceHeap.front().source ] ) {
+      std::pop_heap( m_sourceHeap.begin(), m_sourceHeap.end() );
+      m_sourceHeap.pop_back();
+    }
+    if( !m_sourceHeap.empty() ) {
+      ScheduledDecay next = m_sourceHeap.front();
+      aTime = next.time - m_time;
+      if( mVerboseLevel > 1 )
+        G4cout << "GateSourceMgr::GetNextSource : source "
+               << mSources[ next.source ]->GetName()
+               << "    Next time (s) : " << aTime/s
+               << "   m_firstTime (s) : " << m_firstTime/s << Gateendl;
+
+      if( m_firstTime < 0. || ( aTime < m_firstTime ) )
+        {
+          m_firstTime = aTime;
+          pFirstSource = mSources[ next.source ];
+          std::pop_heap( m_sourceHeap.begin(), m_sourceHeap.end() );
+          m_sourceHeap.pop_back();
+          ScheduleSource( next.source, next.time );
+        }
+    }
   }
 
   m_currentSourceID = pFirstSource->GetSourceID(); /* PY Descourt 08/09/2009 */
@@ -355,6 +384,74 @@ GateVSource* GateSourceMgr::GetNextSource()
 //----------------------------------------------------------------------------------------
 
 
+//----------------------------------------------------------------------------------------
+void GateSourceMgr::BuildSourceSchedule()
+{
+  m_sourceHeap.clear();
+  m_unscheduledSources.clear();
+  m_sourceVersion.assign( mSources.size(), 0 );
+
+  std::vector<G4double> intensities( mSources.size() );
+  for( size_t i = 0; i != mSources.size(); ++i ) {
+    intensities[i] = mSources[i]->GetIntensity();
+    if( IsTotalAmountOfPrimariesModeEnabled() ) continue;
+    if( mSources[i]->HasConstantActivity() )
+      ScheduleSource( i, m_time );
+    else {
+      m_sourceVersion[i] = -1;
+      m_unscheduledSources.push_back( i );
+    }
+  }
+  m_intensitySampler.Build( intensities );
+  m_sourceScheduleIsValid = true;
+
+  if( mVerboseLevel > 1 )
+    G4cout << "GateSourceMgr::BuildSourceSchedule : " << m_sourceHeap.size()
+           << " scheduled source(s), " << m_unscheduledSources.size()
+           << " source(s) with time-dependent activity\n";
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+void GateSourceMgr::ScheduleSource( G4int sourceIndex, G4double timeNow )
+{
+  // Outdated entries are removed lazily; compact the heap if there are too many
+  if( m_sourceHeap.size() > 2*mSources.size() + 16 ) {
+    std::vector<ScheduledDecay> valid;
+    for( size_t i = 0; i != m_sourceHeap.size(); ++i )
+      if( m_sourceHeap[i].version == m_sourceVersion[ m_sourceHeap[i].source ] )
+        valid.push_back( m_sourceHeap[i] );
+    m_sourceHeap.swap( valid );
+    std::make_heap( m_sourceHeap.begin(), m_sourceHeap.end() );
+  }
+
+  // the activity is zero before the start time of the source
+  GateVSource* source = mSources[ sourceIndex ];
+  G4double start = std::max( timeNow, source->GetStartTime() );
+  ScheduledDecay decay;
+  decay.time = start + source->GetNextTime( start );
+  decay.source = sourceIndex;
+  decay.version = ++m_sourceVersion[ sourceIndex ];
+  m_sourceHeap.push_back( decay );
+  std::push_heap( m_sourceHeap.begin(), m_sourceHeap.end() );
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+void GateSourceMgr::RescheduleSource( GateVSource* source )
+{
+  if( !m_sourceScheduleIsValid ) return;
+  G4int i = source->GetSourceID();
+  if( i < 0 || i >= (G4int)mSources.size() || mSources[i] != source )
+    i = std::find( mSources.begin(), mSources.end(), source ) - mSources.begin();
+  if( i >= (G4int)mSources.size() || m_sourceVersion[i] < 0 ) return;
+  ScheduleSource( i, m_time );
+}
+//----------------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------------
 void GateSourceMgr::ListSources()
 {
@@ -435,6 +532,7 @@ void GateSourceMgr::Initialization()//std::vector<G4double> * time, std::vector<
       if((*itr)->GetIntensity()==0) GateError("Intensity of the source should not be null");
       mTotalIntensity += (*itr)->GetIntensity();// intensity;
     }
+  m_sourceScheduleIsValid = false;
 
 }
 //----------------------------------------------------------------------------------------
@@ -501,6 +599,9 @@ G4int GateSourceMgr::PrepareNextRun( const G4Run* r)
   for(GateVSourceVector::iterator itr = mSources.begin(); itr != mSources.end(); ++itr )
     (*itr)->Update(m_time);
 
+  // The clock has been updated: pending decay times and intensities are recomputed
+  m_sourceScheduleIsValid = false;
+
 
 //  m_runNumber++;
 
@@ -24,6 +24,14 @@ See GATE/LICENSE.txt for further details
 #include "G4ThreeVector.hh"
 #include "GateMiscFunctions.hh"
 #include "GateApplicationMgr.hh"
+#include "G4IonTable.hh"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
 
 typedef unsigned int uint;
 
@@ -84,6 +92,16 @@ GateSourcePhaseSpace::GateSourcePhaseSpace(G4String name ):GateVSource( name )
   mRmax=0;
   mCurrentParticleInIAEAFiles = 0;
   mCurrentUsedParticleInIAEAFiles = 0;
+
+  mBinaryNbOfRecords = 0;
+  mBinaryCursor = 0;
+  mBinaryRangeBegin = 0;
+  mBinaryRangeEnd = 0;
+  mBinaryBufferSize = 0;
+  mBinaryBufferPosition = 0;
+  mStartingParticleIndex = 0;
+  mUseRandomStartingParticle = false;
+  mLastPDGCode = 0;
 }
 // ----------------------------------------------------------------------------------
 
@@ -100,6 +118,9 @@ GateSourcePhaseSpace::~GateSourcePhaseSpace()
    free(pIAEARecordType);
    pIAEAheader = 0;
    pIAEARecordType = 0;
+
+   for(unsigned int i=0;i<mBinaryReaders.size();i++) delete mBinaryReaders[i];
+   mBinaryReaders.clear();
 }
 // ----------------------------------------------------------------------------------
 
@@ -165,7 +186,7 @@ void GateSourcePhaseSpace::Initialize()
         for(int j=0 ; j<totalEventInFile ; j++)
         {
           pIAEARecordType->read_particle();
-          if( abs(pIAEARecordType->x*cm)<mRmax && abs(pIAEARecordType->y*cm)<mRmax )  {pListOfSelectedEvents.push_back(totalEvent);G4cout<<" --> OK  "<<totalEvent<< Gateendl;}
+          if( abs(pIAEARecordType->x*cm)<mRmax && abs(pIAEARecordType->y*cm)<mRmax )  pListOfSelectedEvents.push_back(totalEvent);
           totalEvent++;
 	}
       }
@@ -173,6 +194,10 @@ void GateSourcePhaseSpace::Initialize()
     if(mRmax>0) mTotalNumberOfParticles = pListOfSelectedEvents.size();
   }
 
+  if(mFileType == "binaryFile") OpenBinaryFiles();
+  else if(mStartingParticleIndex != 0 || mUseRandomStartingParticle)
+    GateWarning("Phase space source '" << GetName() << "': the starting particle can only be set with .gphsp files, ignored.");
+
   mInitialized  = true;
 
   if (mUseNbOfParticleAsIntensity)
@@ -273,6 +298,205 @@ void GateSourcePhaseSpace::GenerateIAEAVertex( G4Event* /*aEvent*/ )
 // ----------------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::OpenBinaryFiles()
+{
+  mBinaryNbOfRecords = 0;
+  for(unsigned int i=0;i<listOfPhaseSpaceFile.size();i++) {
+    GateMessage("Beam", 1, "Phase Space Source. Read file " << listOfPhaseSpaceFile[i] << Gateendl);
+    GateBinaryPhaseSpaceReader * reader = new GateBinaryPhaseSpaceReader;
+    reader->Open(listOfPhaseSpaceFile[i]);
+    mBinaryReaders.push_back(reader);
+    mBinaryFirstRecord.push_back(mBinaryNbOfRecords);
+    mBinaryNbOfRecords += reader->GetNumberOfRecords();
+  }
+  mTotalNumberOfParticles = mBinaryNbOfRecords;
+
+  // In a multi-process acquisition, each worker reads its own part of
+  // the phase space, [id*N/workers, (id+1)*N/workers), so that no
+  // particle is used by two workers
+  mBinaryRangeBegin = 0;
+  mBinaryRangeEnd = mBinaryNbOfRecords;
+  GateApplicationMgr * appMgr = GateApplicationMgr::GetInstance();
+  if(appMgr->GetWorkerID() >= 0) {
+    uint64_t nWorkers = appMgr->GetNumberOfWorkers();
+    uint64_t id = appMgr->GetWorkerID();
+    mBinaryRangeBegin = mBinaryNbOfRecords*id/nWorkers;
+    mBinaryRangeEnd = mBinaryNbOfRecords*(id+1)/nWorkers;
+  }
+  uint64_t nParticlesInRange = mBinaryRangeEnd - mBinaryRangeBegin;
+
+  // The radius selection is applied while decoding. The selected
+  // particles are counted from the index of each file, the records are
+  // only read in the (at most two) blocks cut by the limits of the range
+  if(mRmax>0){
+    mTotalNumberOfParticles = 0;
+    nParticlesInRange = 0;
+    mBinarySelectedPerBlock.resize(mBinaryReaders.size());
+    for(unsigned int f=0;f<mBinaryReaders.size();f++) {
+      LoadBinaryRadiusIndex(f);
+      const std::vector<uint32_t> & counts = mBinarySelectedPerBlock[f];
+      uint64_t first = mBinaryFirstRecord[f];
+      uint64_t last = first + mBinaryReaders[f]->GetNumberOfRecords();
+      for(uint64_t b=0;b<counts.size();b++) {
+        mTotalNumberOfParticles += counts[b];
+        uint64_t begin = first + b*mBinaryIndexBlockSize;
+        uint64_t end = std::min(begin + mBinaryIndexBlockSize, last);
+        if(begin >= mBinaryRangeBegin && end <= mBinaryRangeEnd) nParticlesInRange += counts[b];
+        else if(counts[b] > 0 && end > mBinaryRangeBegin && begin < mBinaryRangeEnd) {
+          for(uint64_t i=std::max(begin, mBinaryRangeBegin);i<std::min(end, mBinaryRangeEnd);i++) {
+            const GateBinaryPhaseSpaceRecord & r = mBinaryReaders[f]->GetRecord(i-first);
+            if(std::fabs(r.x)<mRmax && std::fabs(r.y)<mRmax) nParticlesInRange++;
+          }
+        }
+      }
+    }
+  }
+  if(mTotalNumberOfParticles == 0) GateError("Phase space source '" << GetName() << "': no particle in the phase space.");
+  if(nParticlesInRange == 0)
+    GateError("Phase space source '" << GetName() << "': no particle in the part of the phase space of worker "
+              << appMgr->GetWorkerID() << " (too many workers for the phase space).");
+  mNumberOfParticlesInFile = mTotalNumberOfParticles;
+
+  // Starting particle, in the part of the phase space of this process
+  uint64_t rangeSize = mBinaryRangeEnd - mBinaryRangeBegin;
+  uint64_t start = (mStartingParticleIndex > 0 ? mStartingParticleIndex : 0);
+  if(mUseRandomStartingParticle) start = uint64_t(G4UniformRand()*rangeSize);
+  mBinaryCursor = mBinaryRangeBegin + start % rangeSize;
+  mBinaryBufferSize = 0;
+  mBinaryBufferPosition = 0;
+  GateMessage("Beam", 1, "Phase Space Source. Start at particle " << mBinaryCursor << Gateendl);
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+// Number of records selected by mRmax in each block of a .gphsp file. It
+// is computed once and stored next to the file ("<file>.rmax<r>.idx"),
+// with the size and modification time of the phase space it describes.
+void GateSourcePhaseSpace::LoadBinaryRadiusIndex(unsigned int f)
+{
+  const GateBinaryPhaseSpaceReader * reader = mBinaryReaders[f];
+  std::vector<uint32_t> & counts = mBinarySelectedPerBlock[f];
+  uint64_t nRecords = reader->GetNumberOfRecords();
+  uint64_t nBlocks = (nRecords + mBinaryIndexBlockSize - 1)/mBinaryIndexBlockSize;
+
+  struct stat st;
+  if(stat(reader->GetFilename().c_str(), &st) != 0)
+    GateError("Phase space source '" << GetName() << "': cannot stat " << reader->GetFilename());
+  int64_t key[4] = { (int64_t)nRecords, (int64_t)st.st_size, (int64_t)st.st_mtime, (int64_t)st.st_ino };
+  std::ostringstream name;
+  name << reader->GetFilename() << ".rmax" << mRmax << ".idx";
+
+  std::ifstream is(name.str().c_str(), std::ios::binary);
+  if(is) {
+    int64_t storedKey[4];
+    is.read((char*)storedKey, sizeof(storedKey));
+    counts.resize(nBlocks);
+    if(nBlocks > 0) is.read((char*)&counts[0], nBlocks*sizeof(uint32_t));
+    if(is && memcmp(key, storedKey, sizeof(key)) == 0) return;
+  }
+
+  GateMessage("Beam", 1, "Phase Space Source. Building the index of the particles selected by the radius in "
+              << name.str() << Gateendl);
+  counts.assign(nBlocks, 0);
+  for(uint64_t i=0;i<nRecords;i++) {
+    const GateBinaryPhaseSpaceRecord & r = reader->GetRecord(i);
+    if(std::fabs(r.x)<mRmax && std::fabs(r.y)<mRmax) counts[i/mBinaryIndexBlockSize]++;
+  }
+
+  // Written under a name unique to this process, then renamed, so that
+  // a concurrent job never reads a partial index
+  std::ostringstream tmpName;
+  tmpName << name.str() << "." << getpid() << ".tmp";
+  std::ofstream os(tmpName.str().c_str(), std::ios::binary);
+  os.write((const char*)key, sizeof(key));
+  if(nBlocks > 0) os.write((const char*)&counts[0], nBlocks*sizeof(uint32_t));
+  os.close();
+  if(!os || rename(tmpName.str().c_str(), name.str().c_str()) != 0) {
+    GateWarning("Could not store the index of the phase space in the file '" << name.str() << "'\n");
+    remove(tmpName.str().c_str());
+  }
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::FillBinaryBuffer()
+{
+  // Decode the next block of records (from the next file, or from
+  // the beginning of the part of the phase space, when its end is reached)
+  const uint64_t blockSize = mBinaryIndexBlockSize;
+  mBinaryBuffer.resize(blockSize);
+  mBinaryBufferSize = 0;
+  mBinaryBufferPosition = 0;
+  while(mBinaryBufferSize == 0) {
+    unsigned int f = std::upper_bound(mBinaryFirstRecord.begin(), mBinaryFirstRecord.end(), mBinaryCursor)
+      - mBinaryFirstRecord.begin() - 1;
+    // the blocks of the index are read one at a time, the blocks without
+    // selected particle are skipped without being decoded
+    uint64_t first = mBinaryCursor-mBinaryFirstRecord[f];
+    uint64_t n = std::min(blockSize - first%blockSize, mBinaryRangeEnd-mBinaryCursor);
+    if(mRmax>0 && mBinarySelectedPerBlock[f][first/mBinaryIndexBlockSize] == 0) {
+      mBinaryCursor += std::min(n, mBinaryReaders[f]->GetNumberOfRecords()-first);
+      if(mBinaryCursor >= mBinaryRangeEnd) mBinaryCursor = mBinaryRangeBegin;
+      continue;
+    }
+    n = mBinaryReaders[f]->ReadRecords(first, n, &mBinaryBuffer[0]);
+    mBinaryCursor += n;
+    if(mBinaryCursor >= mBinaryRangeEnd) mBinaryCursor = mBinaryRangeBegin;
+    if(mRmax>0){
+      for(uint64_t i=0;i<n;i++) {
+        const GateBinaryPhaseSpaceRecord & r = mBinaryBuffer[i];
+        if(std::fabs(r.x)<mRmax && std::fabs(r.y)<mRmax) mBinaryBuffer[mBinaryBufferSize++] = r;
+      }
+    }
+    else mBinaryBufferSize = n;
+  }
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::GenerateBinaryVertex( G4Event* /*aEvent*/ )
+{
+  if(mBinaryBufferPosition >= mBinaryBufferSize) FillBinaryBuffer();
+  const GateBinaryPhaseSpaceRecord & r = mBinaryBuffer[mBinaryBufferPosition++];
+
+  // the particle definition is only searched when the type changes
+  if(pParticleDefinition==0 || r.pdgCode != mLastPDGCode) {
+    mLastPDGCode = r.pdgCode;
+    pParticleDefinition = 0;
+    if(r.pdgCode != 0) {
+      pParticleDefinition = G4ParticleTable::GetParticleTable()->FindParticle(r.pdgCode);
+      if(pParticleDefinition==0) pParticleDefinition = G4IonTable::GetIonTable()->GetIon(r.pdgCode);
+    }
+    if(pParticleDefinition==0 && mParticleTypeNameGivenByUser != "none")
+      pParticleDefinition = G4ParticleTable::GetParticleTable()->FindParticle(mParticleTypeNameGivenByUser);
+    if(pParticleDefinition==0) GateError("Unknown particle type (PDG code " << r.pdgCode << ") in phase space file.");
+  }
+
+  mParticlePosition = G4ThreeVector(r.x*mm,r.y*mm,r.z*mm);
+
+  energy = r.energy;
+  if(energy<0) GateError("Energy < 0 in phase space file!");
+  if(energy==0) GateError("Energy = 0 in phase space file!");
+  double mass = pParticleDefinition->GetPDGMass();
+  mMomentum = std::sqrt(energy*energy+2*energy*mass);
+
+  double dtot = std::sqrt(r.dx*r.dx + r.dy*r.dy + r.dz*r.dz);
+  if(dtot==0) GateError("No momentum defined in phase space file!");
+  px = mMomentum*r.dx/dtot ;
+  py = mMomentum*r.dy/dtot ;
+  pz = mMomentum*r.dz/dtot ;
+  mParticleMomentum = G4ThreeVector(px,py,pz);
+
+  weight = r.weight;
+  mParticleTime = r.time;
+}
+// ----------------------------------------------------------------------------------
+
+
 // ----------------------------------------------------------------------------------
 G4int GateSourcePhaseSpace::GeneratePrimaries( G4Event* event )
 {
@@ -344,6 +568,10 @@ G4int GateSourcePhaseSpace::GeneratePrimaries( G4Event* event )
       mCurrentParticleInIAEAFiles++;
       mCurrentUsedParticleInIAEAFiles++;
     }
+   if(mFileType == "binaryFile") {
+     GenerateBinaryVertex( event );
+     mCurrentParticleNumberInFile++;
+   }
     mResidu = mRequestedNumberOfParticlesPerRun-mTotalNumberOfParticles*mLoop;
   }
 
@@ -419,14 +647,16 @@ void GateSourcePhaseSpace::AddFile(G4String file)
   if(listOfPhaseSpaceFile.size()==0){
      if (extension == "root") mFileType = "rootFile";
      else if (extension == "IAEAphsp" || extension == "IAEAheader" ) mFileType = "IAEAFile";
+     else if (extension == "gphsp") mFileType = "binaryFile";
      else GateError( "Unknow phase space file extension. Knowns extensions are : "
-    	               << Gateendl << ".IAEAphsp (or IAEAheader), .root\n");
+    	               << Gateendl << ".IAEAphsp (or IAEAheader), .root, .gphsp\n");
      listOfPhaseSpaceFile.push_back(file);
      return;
   }
 
   if(extension == "root" && mFileType == "rootFile") listOfPhaseSpaceFile.push_back(file);
   else if((extension == "IAEAphsp" || extension == "IAEAheader") && mFileType == "IAEAFile") listOfPhaseSpaceFile.push_back(file);
+  else if(extension == "gphsp" && mFileType == "binaryFile") listOfPhaseSpaceFile.push_back(file);
   else GateError( "Cannot add phase space files with different extension");
 
 }
@@ -60,6 +60,16 @@ GateSourcePhaseSpaceMessenger::GateSourcePhaseSpaceMessenger(GateSourcePhaseSpac
   setRmaxCmd = new G4UIcmdWithADoubleAndUnit(cmdName,this);
   setRmaxCmd->SetGuidance("set the value of R");
   setRmaxCmd->SetParameterName("R value",false);
+
+  cmdName = GetDirectoryName()+"setStartingParticleIndex";
+  setStartingParticleIndexCmd = new G4UIcmdWithAnInteger(cmdName,this);
+  setStartingParticleIndexCmd->SetGuidance("Index of the first particle used in the PhS (.gphsp files only)");
+  setStartingParticleIndexCmd->SetParameterName("Index",false);
+  setStartingParticleIndexCmd->SetRange("Index>=0");
+
+  cmdName = GetDirectoryName()+"useRandomStartingParticle";
+  setUseRandomStartingParticleCmd = new G4UIcmdWithABool(cmdName,this);
+  setUseRandomStartingParticleCmd->SetGuidance("Start at a random particle of the PhS (.gphsp files only)");
 }
 //----------------------------------------------------------------------------------------
 
@@ -74,6 +84,8 @@ GateSourcePhaseSpaceMessenger::~GateSourcePhaseSpaceMessenger()
   delete setParticleTypeCmd;
   delete setUseNbParticleAsIntensityCmd;
   delete setRmaxCmd;
+  delete setStartingParticleIndexCmd;
+  delete setUseRandomStartingParticleCmd;
 }
 //----------------------------------------------------------------------------------------
 
@@ -90,6 +102,10 @@ void GateSourcePhaseSpaceMessenger::SetNewValue(G4UIcommand* command, G4String n
   if (command == setUseNbParticleAsIntensityCmd) 
     pSource->SetUseNbOfParticleAsIntensity(setUseNbParticleAsIntensityCmd->GetNewBoolValue(newValue));
   if(command == setRmaxCmd) pSource->SetRmax(setRmaxCmd->GetNewDoubleValue(newValue));
+  if(command == setStartingParticleIndexCmd)
+    pSource->SetStartingParticleIndex(setStartingParticleIndexCmd->GetNewIntValue(newValue));
+  if(command == setUseRandomStartingParticleCmd)
+    pSource->SetUseRandomStartingParticle(setUseRandomStartingParticleCmd->GetNewBoolValue(newValue));
 }
 //----------------------------------------------------------------------------------------
 
@@ -56,6 +56,7 @@ void GateSourceVoxelImageReader::ReadFile(G4String filename)
   vz=image->GetVoxelSize()[2];
 
   SetVoxelSize( G4ThreeVector(vx, vy, vz) * mm );
+  SetImageResolution(nx, ny, nz);
 
   m_image_origin = image->GetOrigin();
 
@@ -108,6 +109,7 @@ void GateSourceVoxelImageReader::ReadRTFile(G4String , G4String fileName)
 
   inFile >> dx >> dy >> dz;
   SetVoxelSize( G4ThreeVector(dx, dy, dz) * mm );
+  SetImageResolution(nx, ny, nz);
 
   for (G4int iz=0; iz<nz; iz++) {
     for (G4int iy=0; iy<ny; iy++) {
@@ -71,6 +71,7 @@ void GateSourceVoxelInterfileReader::ReadFile(G4String headerFileName)
   dz = m_planeThickness;
 
   SetVoxelSize( G4ThreeVector(dx, dy, dz) * mm );
+  SetImageResolution(nx, ny, nz);
 
   for (G4int iz=0; iz<nz; iz++) {
       for (G4int iy=0; iy<ny; iy++) {
@@ -129,6 +130,7 @@ void GateSourceVoxelInterfileReader::ReadRTFile(G4String headerFileName, G4Strin
   dz = m_planeThickness;
 
   SetVoxelSize( G4ThreeVector(dx, dy, dz) * mm );
+  SetImageResolution(nx, ny, nz);
 
   for (G4int iz=0; iz<nz; iz++) {
       for (G4int iy=0; iy<ny; iy++) {
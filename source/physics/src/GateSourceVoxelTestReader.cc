@@ -13,6 +13,7 @@ See GATE/LICENSE.txt for further details
 //LF
 //#include "fstream.h"
 #include <fstream>
+#include <algorithm>
 //LF
 
 #include "G4PhysicalConstants.hh"
@@ -49,6 +50,9 @@ void GateSourceVoxelTestReader::ReadFile(G4String fileName)
   G4cout << "GateSourceVoxelTestReader::ReadFile : nVoxels: " << nVoxels << Gateendl;
 
   // read the list of voxels
+  std::vector<G4int> vx, vy, vz;
+  std::vector<G4double> va;
+  G4int nx = 1, ny = 1, nz = 1;
   for (G4int iV = 0; iV< nVoxels; iV++) {
     inFile >> ix >> iy >> iz >> activity;
     G4cout << "GateSourceVoxelTestReader::ReadFile : index: " 
@@ -57,11 +61,22 @@ void GateSourceVoxelTestReader::ReadFile(G4String fileName)
 
     // create a new voxel only if the corresponding activity is > 0.
     if (activity > 0.) {
-      AddVoxel(ix, iy, iz, activity*becquerel);
+      vx.push_back(ix); vy.push_back(iy); vz.push_back(iz);
+      va.push_back(activity*becquerel);
+      nx = std::max(nx, ix+1);
+      ny = std::max(ny, iy+1);
+      nz = std::max(nz, iz+1);
     }
 
   }
 
+  // the resolution is not given by this format: use the bounding box of
+  // the listed voxels to compute the linear indices
+  SetImageResolution(nx, ny, nz);
+  for (unsigned int i = 0; i < va.size(); i++) {
+    AddVoxel(vx[i], vy[i], vz[i], va[i]);
+  }
+
   inFile.close();
 
   PrepareIntegratedActivityMap();
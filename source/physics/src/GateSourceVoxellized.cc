@@ -92,7 +92,10 @@ G4int GateSourceVoxellized::GeneratePrimaries(G4Event* event)
     return 0;
   }
   // ask to the voxel reader to provide the active voxel for this event
-  std::vector<G4int> firstSource = m_voxelReader->GetNextSource();
+  G4int firstSource = m_voxelReader->GetNextSource();
+  if (firstSource < 0) return 0;
+  G4int ix, iy, iz;
+  m_voxelReader->GetVoxelCoordinates(firstSource, ix, iy, iz);
 
   // move the centre to the chosen voxel:
   // to the relative position and then to the global absolute position taking into account
@@ -100,9 +103,9 @@ G4int GateSourceVoxellized::GeneratePrimaries(G4Event* event)
 
   G4ThreeVector voxelSize = m_voxelReader->GetVoxelSize();
   // offset of the centre of the selected voxel wrt the matrix corner (as the (0,0,0) voxel is in the corner)
-  G4ThreeVector relativeVoxelOffset = G4ThreeVector( voxelSize.x()/2. + voxelSize.x() * firstSource[0],
-						     voxelSize.y()/2. + voxelSize.y() * firstSource[1],
-						     voxelSize.z()/2. + voxelSize.z() * firstSource[2]);
+  G4ThreeVector relativeVoxelOffset = G4ThreeVector( voxelSize.x()/2. + voxelSize.x() * ix,
+						     voxelSize.y()/2. + voxelSize.y() * iy,
+						     voxelSize.z()/2. + voxelSize.z() * iz);
 
   // m_sourcePosition and m_sourceRotation are NOT the ones in GPS, on the contrary they are used to set the
   // GPS position and "position rotation" (for the moment not the "direction rotation")
@@ -38,6 +38,7 @@ GatePulseList* GateVPulseProcessor::ProcessPulseList(const GatePulseList* inputP
     return 0;
 
   GatePulseList* outputPulseList = new GatePulseList(GetObjectName());
+  outputPulseList->reserve(n_pulses);
 
   GatePulseConstIterator iter;
   for (iter = inputPulseList->begin() ; iter != inputPulseList->end() ; ++iter)
@@ -55,6 +56,41 @@ GatePulseList* GateVPulseProcessor::ProcessPulseList(const GatePulseList* inputP
 
 
 
+GatePulseList* GateVPulseProcessor::ProcessPulseListInPlace(GatePulseList* pulseList)
+{
+  if (!pulseList)
+    return 0;
+
+  size_t n_pulses = pulseList->size();
+  if (nVerboseLevel==1)
+      	G4cout << "[" << GetObjectName() << "::ProcessPulseListInPlace]: processing input list with " << n_pulses << " entries\n";
+  if (!n_pulses)
+    return 0;
+
+  // Kept pulses are moved to the front of the list, in their original order
+  size_t n_kept = 0;
+  for (size_t i=0 ; i<n_pulses ; ++i) {
+      GatePulse* pulse = (*pulseList)[i];
+      if (ProcessOnePulseInPlace(pulse))
+      	(*pulseList)[n_kept++] = pulse;
+      else
+      	delete pulse;
+  }
+  pulseList->resize(n_kept);
+  pulseList->SetName(GetObjectName());
+
+  if (nVerboseLevel==1) {
+      G4cout << "[" << GetObjectName() << "::ProcessPulseListInPlace]: returning output pulse-list with " << pulseList->size() << " entries\n";
+      for (GatePulseConstIterator iter = pulseList->begin() ; iter != pulseList->end() ; ++iter)
+      	G4cout << **iter << Gateendl;
+      G4cout << Gateendl;
+  }
+
+  return pulseList;
+}
+
+
+
 // Method overloading GateClockDependent::Describe()
 // Print-out a description of the component
 // Calls the pure virtual method DecribeMyself()
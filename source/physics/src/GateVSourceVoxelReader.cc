@@ -11,6 +11,7 @@
 #include "GateSourceVoxelLinearTranslator.hh"
 #include "GateSourceVoxelRangeTranslator.hh"
 #include "GateSourceMgr.hh"
+#include <algorithm>
 
 //-------------------------------------------------------------------------------------------------
 GateVSourceVoxelReader::GateVSourceVoxelReader(GateVSource* source)
@@ -21,6 +22,8 @@ GateVSourceVoxelReader::GateVSourceVoxelReader(GateVSource* source)
   m_activityTotal = 0. * becquerel;
   m_activityMax   = 0. * becquerel;
   m_image_origin = G4ThreeVector(0);
+  m_activitySamplerIsUpToDate = false;
+  m_imageResolution[0] = m_imageResolution[1] = m_imageResolution[2] = 0;
 
   G4double voxelSize = 1.*mm;
   m_voxelSize = G4ThreeVector(voxelSize,voxelSize,voxelSize);
@@ -34,7 +37,6 @@ GateVSourceVoxelReader::~GateVSourceVoxelReader()
   if (m_voxelTranslator) {
     delete m_voxelTranslator;
   }
-  m_sourceVoxelIntegratedActivities.clear();
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -43,7 +45,7 @@ GateVSourceVoxelReader::~GateVSourceVoxelReader()
 void GateVSourceVoxelReader::Dump(G4int level)
 {
   G4cout << "  Voxel reader ----------> " << m_type << Gateendl
-	 << "  number of voxels       : " << m_sourceVoxelActivities.size() << Gateendl
+	 << "  number of voxels       : " << m_voxelIndices.size() << Gateendl
 	 << "  total activity (Bq)    : " << GetTotalActivity()/becquerel << Gateendl
 	 << "  position  (mm)         : "
 	 << GetPosition().x()/mm << " "
@@ -55,13 +57,14 @@ void GateVSourceVoxelReader::Dump(G4int level)
 	 << GetVoxelSize().z()/mm << Gateendl;
 
   if (level > 2) {
-    GateSourceActivityMap::iterator voxel;
-    for (voxel = m_sourceVoxelActivities.begin(); voxel != m_sourceVoxelActivities.end(); voxel++) {
+    G4int ix, iy, iz;
+    for (unsigned int i = 0; i < m_voxelIndices.size(); i++) {
+      GetVoxelCoordinates(m_voxelIndices[i], ix, iy, iz);
       G4cout << "   Index"
-	     << " " << (*voxel).first[0]
-	     << " " << (*voxel).first[1]
-	     << " " << (*voxel).first[2]
-	     << " Activity (Bq) " << (*voxel).second / becquerel << Gateendl;
+	     << " " << ix
+	     << " " << iy
+	     << " " << iz
+	     << " Activity (Bq) " << m_voxelActivities[i] / becquerel << Gateendl;
     }
   }
 }
@@ -69,63 +72,112 @@ void GateVSourceVoxelReader::Dump(G4int level)
 
 
 //-------------------------------------------------------------------------------------------------
-std::vector<G4int> GateVSourceVoxelReader::GetNextSource()
+G4int GateVSourceVoxelReader::GetNextSource()
 {
   // the method decides which is the source that has to be used for this event
-  std::vector<G4int> firstSource;
-
-  if (m_sourceVoxelActivities.size()==0) {
+  if (m_voxelIndices.size()==0) {
     G4cout << "GateVSourceVoxelReader::GetNextSource : WARNING: No source available\n";
-    return firstSource;
-  } else {
-    // if there is at least one voxel
+    return -1;
+  }
 
-    // now assign the event to one voxel, according to the relative activity
-    // integral method
-    // from STL doc: iterator upper_bound(const key_type& k)   Sorted Associative Container   Finds the first element whose key greater than k.
-    firstSource = (*(m_sourceVoxelIntegratedActivities.upper_bound(G4UniformRand() * m_activityTotal))).second;
+  // activities modified since the last preparation (AddVoxel without
+  // PrepareIntegratedActivityMap): rebuild the sampler first
+  if (!m_activitySamplerIsUpToDate) PrepareIntegratedActivityMap();
 
+  // now assign the event to one voxel, according to the relative activity,
+  // with the alias method (constant time whatever the number of voxels)
+  G4int slot = m_activitySampler.Sample(G4UniformRand());
+  if (slot < 0) {
+    G4cout << "GateVSourceVoxelReader::GetNextSource : WARNING: total activity is zero\n";
+    return -1;
   }
+  G4int firstSource = m_voxelIndices[slot];
 
-  if (nVerboseLevel>1)
+  if (nVerboseLevel>1) {
+    G4int ix, iy, iz;
+    GetVoxelCoordinates(firstSource, ix, iy, iz);
     G4cout << "GateVSourceVoxelReader::GetNextSource : source chosen : "
-	   << " " << firstSource[0]
-	   << " " << firstSource[1]
-	   << " " << firstSource[2]
+	   << " " << ix
+	   << " " << iy
+	   << " " << iz
 	   << Gateendl;
+  }
 
   return firstSource;
 }
 //-------------------------------------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------------------------------------
+void GateVSourceVoxelReader::SetImageResolution(G4int nx, G4int ny, G4int nz)
+{
+  if (nx <= 0 || ny <= 0 || nz <= 0) {
+    GateError("GateVSourceVoxelReader::SetImageResolution: wrong resolution "
+              << nx << " " << ny << " " << nz << Gateendl);
+  }
+  if (m_voxelIndices.size() != 0 &&
+      (nx != m_imageResolution[0] || ny != m_imageResolution[1] || nz != m_imageResolution[2])) {
+    GateError("GateVSourceVoxelReader::SetImageResolution: cannot change the resolution once voxels have been added\n");
+  }
+  m_imageResolution[0] = nx;
+  m_imageResolution[1] = ny;
+  m_imageResolution[2] = nz;
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+G4int GateVSourceVoxelReader::FindOrInsertVoxel(G4int index, G4bool & isNew)
+{
+  // Readers usually scan the image in increasing linear index order: in
+  // that case the voxel is simply appended, otherwise we keep the store
+  // sorted with a binary search.
+  isNew = true;
+  if (m_voxelIndices.size() == 0 || index > m_voxelIndices.back()) {
+    m_voxelIndices.push_back(index);
+    m_voxelActivities.push_back(0.);
+    return m_voxelIndices.size()-1;
+  }
+  std::vector<G4int>::iterator it = std::lower_bound(m_voxelIndices.begin(), m_voxelIndices.end(), index);
+  G4int slot = it - m_voxelIndices.begin();
+  if (*it == index) {
+    isNew = false;
+    return slot;
+  }
+  m_voxelIndices.insert(it, index);
+  m_voxelActivities.insert(m_voxelActivities.begin()+slot, 0.);
+  return slot;
+}
+//-------------------------------------------------------------------------------------------------
+
+
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::AddVoxel(G4int ix, G4int iy, G4int iz, G4double activity)
 {
   // this method is used by the ReadFile method.
   // Note: The decision to create a new voxel has already been taken before.
+  if (ix < 0 || iy < 0 || iz < 0 ||
+      ix >= m_imageResolution[0] || iy >= m_imageResolution[1] || iz >= m_imageResolution[2]) {
+    GateError("GateVSourceVoxelReader::AddVoxel: voxel " << ix << " " << iy << " " << iz
+              << " is outside the image resolution (SetImageResolution not called ?)\n");
+  }
 
-  // create the vector key
-  std::vector<G4int>* index = new std::vector<G4int>;
-  index->push_back(ix);
-  index->push_back(iy);
-  index->push_back(iz);
+  G4bool isNew;
+  G4int slot = FindOrInsertVoxel(GetLinearIndex(ix, iy, iz), isNew);
 
   // if a source had already been inserted with the same key (ix,iy,iz) this will substitute the previous one;
   // thus we must delete the previous from the sum of the activities and we recompute the maximum
-  if (m_sourceVoxelActivities[*index] != 0) {
+  if (!isNew && m_voxelActivities[slot] != 0) {
     G4cout << "GateVSourceVoxelReader::AddVoxel: already existing voxel, activity replaced\n";
-    m_activityTotal -= m_sourceVoxelActivities[*index];
+    m_activityTotal -= m_voxelActivities[slot];
 
     // loop over all the voxels to recompute the maximum of the activies
     // without this voxel
-    m_sourceVoxelActivities[*index] = 0. * becquerel;
-    GateSourceActivityMap::iterator voxel;
+    m_voxelActivities[slot] = 0. * becquerel;
     m_activityMax = 0. * becquerel;
-    for (voxel = m_sourceVoxelActivities.begin(); voxel != m_sourceVoxelActivities.end(); voxel++) {
-      G4double iterActivity = (*voxel).second;
-      if (iterActivity > m_activityMax) {
-	m_activityMax = iterActivity;
+    for (unsigned int i = 0; i < m_voxelActivities.size(); i++) {
+      if (m_voxelActivities[i] > m_activityMax) {
+	m_activityMax = m_voxelActivities[i];
       }
     }
 
@@ -137,8 +189,8 @@ void GateVSourceVoxelReader::AddVoxel(G4int ix, G4int iy, G4int iz, G4double act
     m_activityMax = activity;
   }
 
-  m_sourceVoxelActivities[*index] = activity;
-
+  m_voxelActivities[slot] = activity;
+  m_activitySamplerIsUpToDate = false;
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -146,16 +198,24 @@ void GateVSourceVoxelReader::AddVoxel(G4int ix, G4int iy, G4int iz, G4double act
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::AddVoxel_FAST(G4int ix, G4int iy, G4int iz, G4double activity)
 { // no check if Voxel already existed to speed-up
-  //
-  // create the vector key
-  std::vector<G4int> index;
-  index.push_back(ix);
-  index.push_back(iy);
-  index.push_back(iz);
-
+  G4bool isNew;
+  G4int slot = FindOrInsertVoxel(GetLinearIndex(ix, iy, iz), isNew);
+  m_voxelActivities[slot] = activity;
+  m_activitySamplerIsUpToDate = false;
+}
+//-------------------------------------------------------------------------------------------------
 
-  m_sourceVoxelActivities[index] = activity;
 
+//-------------------------------------------------------------------------------------------------
+GateVSourceVoxelReader::GateSourceActivityMap GateVSourceVoxelReader::GetSourceActivityMap()
+{
+  GateSourceActivityMap activities;
+  std::vector<G4int> index(3);
+  for (unsigned int i = 0; i < m_voxelIndices.size(); i++) {
+    GetVoxelCoordinates(m_voxelIndices[i], index[0], index[1], index[2]);
+    activities[index] = m_voxelActivities[i];
+  }
+  return activities;
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -195,32 +255,30 @@ void GateVSourceVoxelReader::RemoveTranslator()
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::PrepareIntegratedActivityMap()
 {
-  // erase all the elements of the old integrated activity map
-  m_sourceVoxelIntegratedActivities.clear();
+  // (re)build the alias table from the flat activity store. The table
+  // buffers are reused, so rebuilding after an activity update (time
+  // activity curves) does not reallocate.
+  m_activitySampler.Build(m_voxelActivities);
 
-  // create the new integrated activity map
   m_activityTotal = 0.;
-  GateSourceActivityMap::iterator voxel;
-  for (voxel = m_sourceVoxelActivities.begin(); voxel != m_sourceVoxelActivities.end(); voxel++) {
-    m_activityTotal += (*voxel).second;
-    G4double* intActivityKey = new G4double(m_activityTotal);
-    m_sourceVoxelIntegratedActivities[*intActivityKey] = (*voxel).first;
-
-    delete intActivityKey;
+  m_activityMax = 0.;
+  for (unsigned int i = 0; i < m_voxelActivities.size(); i++) {
+    m_activityTotal += m_voxelActivities[i];
+    if (m_voxelActivities[i] > m_activityMax) m_activityMax = m_voxelActivities[i];
   }
+  m_activitySamplerIsUpToDate = true;
 
   if (nVerboseLevel>1) {
-    G4int nVoxels = 0;
-    GateSourceActivityMap::iterator voxel = m_sourceVoxelActivities.begin();
-    GateSourceIntegratedActivityMap::iterator intVoxel;
-    for (intVoxel = m_sourceVoxelIntegratedActivities.begin(); intVoxel != m_sourceVoxelIntegratedActivities.end(); intVoxel++, voxel++) {
-      nVoxels++;
+    G4int ix, iy, iz;
+    for (unsigned int i = 0; i < m_voxelIndices.size(); i++) {
+      GetVoxelCoordinates(m_voxelIndices[i], ix, iy, iz);
       G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
-	     << "   voxel: " << ((*voxel).first)[0] << " " << ((*voxel).first)[1] << " " << ((*voxel).first)[2]
-	     << "   activity : (Bq) " << ((*voxel).second) / becquerel
-	     << "   intVoxel: " << ((*intVoxel).second)[0] << " " << ((*intVoxel).second)[1] << " " << ((*intVoxel).second)[2]
-	     << "   integrated: (Bq) " << ((*intVoxel).first)  / becquerel << Gateendl;
+	     << "   voxel: " << ix << " " << iy << " " << iz
+	     << "   activity : (Bq) " << m_voxelActivities[i] / becquerel << Gateendl;
     }
+    G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
+           << m_voxelIndices.size() << " voxels, total activity (Bq) "
+           << m_activityTotal / becquerel << Gateendl;
   }
   m_tactivityTotal = m_activityTotal;  // added by I. Martinez-Rovira (immamartinez@gmail.com)
 }
@@ -230,7 +288,11 @@ void GateVSourceVoxelReader::PrepareIntegratedActivityMap()
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::Initialize()
 {
-  m_sourceVoxelActivities.clear();
+  // clear() keeps the capacity: re-reading the activities of the same
+  // image (time activity curves) does not reallocate the store
+  m_voxelIndices.clear();
+  m_voxelActivities.clear();
+  m_activitySamplerIsUpToDate = false;
 }
 //-------------------------------------------------------------------------------------------------
 